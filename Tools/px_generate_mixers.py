@@ -0,0 +1,184 @@
+#!/usr/bin/env python
+############################################################################
+#
+#   Copyright (C) 2016 PX4 Development Team. All rights reserved.
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+"""
+px_generate_mixers.py:
+Precompile mixer definitions.
+
+This script converts the text mixer files (*.mix) in a folder into the
+binary format described by struct mixer_binary_header_s in
+src/drivers/drv_mixer.h, so they can be loaded at boot without parsing.
+Files that cannot be represented are left as text.
+"""
+
+from __future__ import print_function
+import argparse
+import os
+import struct
+import sys
+
+MIXER_BINARY_MAGIC = 0x4da5
+MIXER_BINARY_VERSION = 1
+
+# limits of the record and header length fields
+MAX_RECORD_LENGTH = 255
+MAX_RECORDS = 255
+MAX_IMAGE_LENGTH = 65535
+
+
+class MixerError(Exception):
+    pass
+
+
+def definition_lines(text):
+    """Lines that load_mixer_file() would pass on, split into fields"""
+    lines = []
+    for line in text.splitlines():
+        if len(line) < 2 or not line[0].isupper() or line[1] != ':':
+            continue
+        lines.append((line[0], line[2:].split()))
+    return lines
+
+
+def integers(fields, count, tag):
+    if len(fields) < count:
+        raise MixerError("'{}:' needs {} values".format(tag, count))
+    try:
+        return [int(f) for f in fields[:count]]
+    except ValueError:
+        raise MixerError("'{}:' has a bad value".format(tag))
+
+
+def scaler(values):
+    return struct.pack('<5f', *[v / 10000.0 for v in values])
+
+
+def find_tag(lines, index, tag):
+    """Next line with the tag, other lines are skipped like findtag() does"""
+    while index < len(lines):
+        if lines[index][0] == tag:
+            return index
+        index += 1
+    raise MixerError("missing '{}:'".format(tag))
+
+
+def record(tag, payload):
+    if len(payload) > MAX_RECORD_LENGTH:
+        raise MixerError("'{}:' mixer too large".format(tag))
+    return struct.pack('<BB', ord(tag), len(payload)) + payload
+
+
+def compile_mixer(text):
+    lines = definition_lines(text)
+    records = []
+    index = 0
+
+    while index < len(lines):
+        tag, fields = lines[index]
+        index += 1
+
+        if tag == 'Z':
+            records.append(record(tag, b''))
+
+        elif tag == 'M':
+            inputs = integers(fields, 1, tag)[0]
+            index = find_tag(lines, index, 'O')
+            payload = struct.pack('<B', inputs) + scaler(integers(lines[index][1], 5, 'O'))
+            index += 1
+
+            for i in range(inputs):
+                index = find_tag(lines, index, 'S')
+                values = integers(lines[index][1], 7, 'S')
+                payload += struct.pack('<BB', values[0], values[1]) + scaler(values[2:])
+                index += 1
+
+            records.append(record(tag, payload))
+
+        elif tag in ('R', 'A'):
+            if not fields or len(fields[0]) > 7:
+                raise MixerError("'{}:' has a bad geometry".format(tag))
+            geometry = fields[0].encode('ascii')
+            values = integers(fields[1:], 4, tag)
+            payload = struct.pack('<8s4f', geometry, *[v / 10000.0 for v in values])
+            records.append(record(tag, payload))
+
+        # stray lines are skipped, as the text loader does
+
+    data = b''.join(records)
+
+    if len(records) > MAX_RECORDS or len(data) > MAX_IMAGE_LENGTH:
+        raise MixerError("too many mixers")
+
+    header = struct.pack('<HBBH', MIXER_BINARY_MAGIC, MIXER_BINARY_VERSION, len(records), len(data))
+    return header + data
+
+
+def main():
+    # Parse commandline arguments
+    parser = argparse.ArgumentParser(description="Mixer precompiler.")
+    parser.add_argument('--folder', action="store", required=True,
+                        help="Folder with the mixer files, searched recursively.")
+    parser.add_argument('--output', action="store",
+                        help="Output folder, the mixer files are replaced if not given.")
+    args = parser.parse_args()
+
+    for (root, dirs, files) in os.walk(args.folder):
+        for file in files:
+            if not file.endswith(".mix"):
+                continue
+
+            file_path = os.path.join(root, file)
+
+            with open(file_path, "rb") as f:
+                text = f.read().decode("ascii", errors="replace")
+
+            try:
+                image = compile_mixer(text)
+            except MixerError as e:
+                print("{}: {}, kept as text".format(file_path, e), file=sys.stderr)
+                continue
+
+            if args.output:
+                out_path = os.path.join(args.output, os.path.relpath(file_path, args.folder))
+                if not os.path.isdir(os.path.dirname(out_path)):
+                    os.makedirs(os.path.dirname(out_path))
+            else:
+                out_path = file_path
+
+            with open(out_path, "wb") as f:
+                f.write(image)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,4 +1,15 @@
 #!/bin/bash
+#
+# Run several SITL instances, one px4 process per vehicle.
+#
+# Usage: Tools/sitl_multiple_run.sh [number of vehicles]
+#        Tools/sitl_multiple_run.sh stats
+#
+# 'stats' prints the CPU and memory footprint of each running vehicle.
+#
+# Several vehicles in one px4 process are not supported yet: the uORB
+# manager, the parameter store, the simulator and most modules are process
+# wide singletons.
 
 sitl_num=2
 
@@ -16,12 +27,43 @@ src_path=`pwd`
 rc_script="posix-configs/SITL/init/rcS_multiple"
 build_path=${src_path}/build_posix_sitl_default
 
+cd $build_path/src/firmware/posix
+
+if [ "$1" == "stats" ]; then
+ clk_tck=`getconf CLK_TCK`
+ printf "%-8s %8s %8s %10s %8s\n" "vehicle" "pid" "cpu %" "rss kB" "threads"
+
+ for pidfile in `ls */px4.pid 2>/dev/null | sort -n`; do
+  n=`dirname $pidfile`
+  pid=`cat $pidfile`
+
+  if [ ! -d /proc/$pid ]; then
+   printf "%-8s %8s %8s\n" $n $pid "exited"
+   continue
+  fi
+
+  # utime + stime, sampled over one second
+  t0=`awk '{print $14 + $15}' /proc/$pid/stat`
+  sleep 1
+  t1=`awk '{print $14 + $15}' /proc/$pid/stat`
+  cpu=$(( (t1 - t0) * 100 / clk_tck ))
+
+  rss=`awk '/^VmRSS/ {print $2}' /proc/$pid/status`
+  threads=`awk '/^Threads/ {print $2}' /proc/$pid/status`
+
+  printf "%-8s %8s %8s %10s %8s\n" $n $pid $cpu $rss $threads
+ done
+
+ exit 0
+fi
+
+if [ -n "$1" ]; then
+ sitl_num=$1
+fi
+
 pkill px4
 sleep 2
 
-cd $build_path/src/firmware/posix
-
-user=`whoami`
 n=1
 while [ $n -le $sitl_num ]; do
  if [ ! -d $n ]; then
@@ -33,13 +75,14 @@ while [ $n -le $sitl_num ]; do
   touch rootfs/eeprom/parameters
 
   cp ${src_path}/ROMFS/px4fmu_common/mixers/quad_w.main.mix ./
-  cat ${src_path}/${rc_script}_gazebo_iris | sed s/_SIMPORT_/${sim_port}/ | sed s/_MAVPORT_/${mav_port}/g | sed s/_MAVOPORT_/${mav_oport}/ | sed s/_MAVPORT2_/${mav_port2}/ | sed s/_MAVOPORT2_/${mav_oport2}/ > rcS
+  cat ${src_path}/${rc_script}_gazebo_iris | sed s/_SIMPORT_/${sim_port}/ | sed s/_MAVPORT_/${mav_port}/g | sed s/_MAVOPORT_/${mav_oport}/ | sed s/_MAVPORT2_/${mav_port2}/ | sed s/_MAVOPORT2_/${mav_oport2}/ | sed s/_SYSID_/${n}/ > rcS
   cd ../
  fi
 
  cd $n
 
- sudo -b -u $user ../px4 -d rcS >out.log 2>err.log
+ nohup ../px4 -d rcS >out.log 2>err.log &
+ echo $! > px4.pid
 
  cd ../
 
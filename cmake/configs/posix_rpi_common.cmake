@@ -34,6 +34,7 @@ set(config_module_list
 	systemcmds/reboot
 	systemcmds/topic_listener
 	systemcmds/perf
+	systemcmds/rtconfig
 
 	#
 	# Estimation modules
@@ -62,8 +63,10 @@ set(config_module_list
 	modules/systemlib
 	modules/systemlib/mixer
 	modules/uORB
+	modules/muorb/shm
 	modules/dataman
 	modules/land_detector
+	modules/load_mon
 	modules/navigator
 	modules/mavlink
 
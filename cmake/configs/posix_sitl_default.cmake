@@ -25,6 +25,7 @@ set(config_module_list
 	systemcmds/mixer
 	systemcmds/param
 	systemcmds/perf
+	systemcmds/rtconfig
 	systemcmds/reboot
 	systemcmds/sd_bench
 	systemcmds/topic_listener
@@ -39,6 +40,7 @@ set(config_module_list
 	modules/fw_att_control
 	modules/fw_pos_control_l1
 	modules/land_detector
+	modules/load_mon
 	modules/logger
 	modules/mavlink
 	modules/mc_att_control
@@ -54,6 +56,7 @@ set(config_module_list
 	modules/systemlib
 	modules/systemlib/mixer
 	modules/uORB
+	modules/muorb/shm
 	modules/vtol_att_control
 
 	lib/controllib
@@ -87,6 +90,7 @@ set(config_module_list
 	#modules/mavlink/mavlink_tests #TODO: fix mavlink_tests
 	modules/unit_test
 	modules/uORB/uORB_tests
+	platforms/posix/tests/hrt_test
 	systemcmds/tests
 
 	)
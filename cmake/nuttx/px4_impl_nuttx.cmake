@@ -312,6 +312,7 @@ function(px4_nuttx_add_romfs)
 	set(romfs_src_dir ${CMAKE_SOURCE_DIR}/${ROOT})
 	set(romfs_autostart ${CMAKE_SOURCE_DIR}/Tools/px_process_airframes.py)
 	set(romfs_pruner ${CMAKE_SOURCE_DIR}/Tools/px_romfs_pruner.py)
+	set(romfs_mixers ${CMAKE_SOURCE_DIR}/Tools/px_generate_mixers.py)
 	set(bin_to_obj ${CMAKE_SOURCE_DIR}/cmake/nuttx/bin_to_obj.py)
 	set(extras_dir ${CMAKE_CURRENT_BINARY_DIR}/extras)
 
@@ -341,6 +342,8 @@ function(px4_nuttx_add_romfs)
 			-s ${romfs_temp_dir}/init.d/rc.autostart
 		COMMAND ${PYTHON_EXECUTABLE} ${romfs_pruner}
 			--folder ${romfs_temp_dir}
+		COMMAND ${PYTHON_EXECUTABLE} ${romfs_mixers}
+			--folder ${romfs_temp_dir}
 		COMMAND ${GENROMFS} -f ${CMAKE_CURRENT_BINARY_DIR}/romfs.bin
 			-d ${romfs_temp_dir} -V "NSHInitVol"
 		#COMMAND cmake -E remove_directory ${romfs_temp_dir}
@@ -63,7 +63,7 @@
 
 #include <drivers/device/spi.h>
 #include <drivers/drv_accel.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 
 #define ACCEL_DEVICE_PATH	"/dev/bma180"
 
@@ -149,7 +149,7 @@ private:
 	struct hrt_call		_call;
 	unsigned		_call_interval;
 
-	ringbuffer::RingBuffer		*_reports;
+	ringbuffer::SPSCRingBuffer		*_reports;
 
 	struct accel_calibration_s	_accel_scale;
 	float			_accel_range_scale;
@@ -283,7 +283,7 @@ BMA180::init()
 	}
 
 	/* allocate basic report buffers */
-	_reports = new ringbuffer::RingBuffer(2, sizeof(accel_report));
+	_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(accel_report));
 
 	if (_reports == nullptr) {
 		goto out;
@@ -374,12 +374,7 @@ BMA180::read(struct file *filp, char *buffer, size_t buflen)
 		 * Note that we may be pre-empted by the measurement code while we are doing this;
 		 * we are careful to avoid racing with it.
 		 */
-		while (count--) {
-			if (_reports->get(arp)) {
-				ret += sizeof(*arp);
-				arp++;
-			}
-		}
+		ret = _reports->get_n(arp, count) * sizeof(*arp);
 
 		/* if there was no data, warn the caller */
 		return ret ? ret : -EAGAIN;
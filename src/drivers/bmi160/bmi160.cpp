@@ -49,15 +49,10 @@ BMI160::BMI160(int bus, const char *path_accel, const char *path_gyro, spi_dev_e
 	_controller_latency_perf(perf_alloc_once(PC_ELAPSED, "ctrl_latency")),
 	_register_wait(0),
 	_reset_wait(0),
-	_accel_filter_x(BMI160_ACCEL_DEFAULT_RATE, BMI160_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_y(BMI160_ACCEL_DEFAULT_RATE, BMI160_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_z(BMI160_ACCEL_DEFAULT_RATE, BMI160_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_x(BMI160_GYRO_DEFAULT_RATE, BMI160_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_y(BMI160_GYRO_DEFAULT_RATE, BMI160_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_z(BMI160_GYRO_DEFAULT_RATE, BMI160_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_int(1000000 / BMI160_ACCEL_MAX_RATE),
-	_gyro_int(1000000 / BMI160_GYRO_MAX_RATE, true),
-	_rotation(rotation),
+	_accel_pipeline(BMI160_ACCEL_DEFAULT_RATE, BMI160_ACCEL_DEFAULT_DRIVER_FILTER_FREQ,
+			1000000 / BMI160_ACCEL_MAX_RATE),
+	_gyro_pipeline(BMI160_GYRO_DEFAULT_RATE, BMI160_GYRO_DEFAULT_DRIVER_FILTER_FREQ,
+		       1000000 / BMI160_GYRO_MAX_RATE, true),
 	_checked_next(0),
 	_last_temperature(0),
 	_last_accel{},
@@ -88,6 +83,9 @@ BMI160::BMI160(int bus, const char *path_accel, const char *path_gyro, spi_dev_e
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
 
+	_accel_pipeline.set_rotation(rotation);
+	_gyro_pipeline.set_rotation(rotation);
+
 	memset(&_call, 0, sizeof(_call));
 }
 
@@ -139,13 +137,13 @@ BMI160::init()
 	}
 
 	/* allocate basic report buffers */
-	_accel_reports = new ringbuffer::RingBuffer(2, sizeof(accel_report));
+	_accel_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(accel_report));
 
 	if (_accel_reports == nullptr) {
 		goto out;
 	}
 
-	_gyro_reports = new ringbuffer::RingBuffer(2, sizeof(gyro_report));
+	_gyro_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(gyro_report));
 
 	if (_gyro_reports == nullptr) {
 		goto out;
@@ -170,6 +168,9 @@ BMI160::init()
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
 
+	_accel_pipeline.set_calibration(_accel_scale);
+	_gyro_pipeline.set_calibration(_gyro_scale);
+
 
 	/* do CDev init for the gyro device node, keep it optional */
 	ret = _gyro->init();
@@ -471,16 +472,7 @@ BMI160::read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	accel_report *arp = reinterpret_cast<accel_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_accel_reports->get(arp)) {
-			break;
-		}
-
-		transferred++;
-		arp++;
-	}
+	int transferred = _accel_reports->get_n(arp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(accel_report));
@@ -623,16 +615,7 @@ BMI160::gyro_read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	gyro_report *grp = reinterpret_cast<gyro_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_gyro_reports->get(grp)) {
-			break;
-		}
-
-		transferred++;
-		grp++;
-	}
+	int transferred = _gyro_reports->get_n(grp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(gyro_report));
@@ -692,19 +675,15 @@ BMI160::ioctl(struct file *filp, int cmd, unsigned long arg)
 					}
 
 					// adjust filters
-					float cutoff_freq_hz = _accel_filter_x.get_cutoff_freq();
+					float cutoff_freq_hz = _accel_pipeline.get_cutoff_freq();
 					float sample_rate = 1.0e6f / ticks;
 					_set_dlpf_filter(cutoff_freq_hz);
-					_accel_filter_x.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
-					_accel_filter_y.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
-					_accel_filter_z.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
+					_accel_pipeline.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
 
 
-					float cutoff_freq_hz_gyro = _gyro_filter_x.get_cutoff_freq();
+					float cutoff_freq_hz_gyro = _gyro_pipeline.get_cutoff_freq();
 					_set_dlpf_filter(cutoff_freq_hz_gyro);
-					_gyro_filter_x.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
-					_gyro_filter_y.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
-					_gyro_filter_z.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
+					_gyro_pipeline.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
 
 					/* update interval for next measurement */
 					/* XXX this is a bit shady, but no other way to adjust... */
@@ -763,13 +742,11 @@ BMI160::ioctl(struct file *filp, int cmd, unsigned long arg)
 		return accel_set_sample_rate(arg);
 
 	case ACCELIOCGLOWPASS:
-		return _accel_filter_x.get_cutoff_freq();
+		return _accel_pipeline.get_cutoff_freq();
 
 	case ACCELIOCSLOWPASS:
 		// set software filtering
-		_accel_filter_x.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_accel_filter_y.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_accel_filter_z.set_cutoff_frequency(1.0e6f / _call_interval, arg);
+		_accel_pipeline.set_cutoff_frequency(1.0e6f / _call_interval, arg);
 		return OK;
 
 	case ACCELIOCSSCALE: {
@@ -779,6 +756,7 @@ BMI160::ioctl(struct file *filp, int cmd, unsigned long arg)
 
 			if (sum > 2.0f && sum < 4.0f) {
 				memcpy(&_accel_scale, s, sizeof(_accel_scale));
+				_accel_pipeline.set_calibration(_accel_scale);
 				return OK;
 
 			} else {
@@ -859,18 +837,17 @@ BMI160::gyro_ioctl(struct file *filp, int cmd, unsigned long arg)
 		return gyro_set_sample_rate(arg);
 
 	case GYROIOCGLOWPASS:
-		return _gyro_filter_x.get_cutoff_freq();
+		return _gyro_pipeline.get_cutoff_freq();
 
 	case GYROIOCSLOWPASS:
 		// set software filtering
-		_gyro_filter_x.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_gyro_filter_y.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_gyro_filter_z.set_cutoff_frequency(1.0e6f / _call_interval, arg);
+		_gyro_pipeline.set_cutoff_frequency(1.0e6f / _call_interval, arg);
 		return OK;
 
 	case GYROIOCSSCALE:
 		/* copy scale in */
 		memcpy(&_gyro_scale, (struct gyro_calibration_s *) arg, sizeof(_gyro_scale));
+		_gyro_pipeline.set_calibration(_gyro_scale);
 		return OK;
 
 	case GYROIOCGSCALE:
@@ -1007,6 +984,7 @@ BMI160::set_accel_range(unsigned max_g)
 	}
 
 	_accel_range_scale = (BMI160_ONE_G / lsb_per_g);
+	_accel_pipeline.set_range_scale(_accel_range_scale);
 	_accel_range_m_s2 = max_accel_g * BMI160_ONE_G;
 
 	modify_reg(BMIREG_ACC_RANGE, clearbits, setbits);
@@ -1057,6 +1035,7 @@ BMI160::set_gyro_range(unsigned max_dps)
 
 	_gyro_range_rad_s = (max_gyro_dps / 180.0f * M_PI_F);
 	_gyro_range_scale = (M_PI_F / (180.0f * lsb_per_dps));
+	_gyro_pipeline.set_range_scale(_gyro_range_scale);
 
 	modify_reg(BMIREG_GYR_RANGE, clearbits, setbits);
 
@@ -1235,10 +1214,7 @@ BMI160::measure()
 	accel_report		arb;
 	gyro_report		grb;
 
-	/*
-	 * Adjust and scale results to m/s^2.
-	 */
-	grb.timestamp = arb.timestamp = hrt_absolute_time();
+	hrt_abstime timestamp = hrt_absolute_time();
 
 	// report the error count as the sum of the number of bad
 	// transfers and bad register reads. This allows the higher
@@ -1247,51 +1223,16 @@ BMI160::measure()
 	grb.error_count = arb.error_count = perf_event_count(_bad_transfers) + perf_event_count(_bad_registers);
 
 	/*
-	 * 1) Scale raw value to SI units using scaling from datasheet.
-	 * 2) Subtract static offset (in SI units)
-	 * 3) Scale the statically calibrated values with a linear
-	 *    dynamically obtained factor
-	 *
-	 * Note: the static sensor offset is the number the sensor outputs
-	 * 	 at a nominally 'zero' input. Therefore the offset has to
-	 * 	 be subtracted.
-	 *
-	 *	 Example: A gyro outputs a value of 74 at zero angular rate
-	 *	 	  the offset is 74 from the origin and subtracting
-	 *		  74 from all measurements centers them around zero.
+	 * The pipelines rotate, scale to SI units, apply the calibration,
+	 * filter and integrate. The static sensor offset is the number the
+	 * sensor outputs at a nominally 'zero' input, so it is subtracted
+	 * after scaling.
 	 */
 
-
 	/* NOTE: Axes have been swapped to match the board a few lines above. */
 
-	arb.x_raw = report.accel_x;
-	arb.y_raw = report.accel_y;
-	arb.z_raw = report.accel_z;
-
-	float xraw_f = report.accel_x;
-	float yraw_f = report.accel_y;
-	float zraw_f = report.accel_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float x_in_new = ((xraw_f * _accel_range_scale) - _accel_scale.x_offset) * _accel_scale.x_scale;
-	float y_in_new = ((yraw_f * _accel_range_scale) - _accel_scale.y_offset) * _accel_scale.y_scale;
-	float z_in_new = ((zraw_f * _accel_range_scale) - _accel_scale.z_offset) * _accel_scale.z_scale;
-
-	arb.x = _accel_filter_x.apply(x_in_new);
-	arb.y = _accel_filter_y.apply(y_in_new);
-	arb.z = _accel_filter_z.apply(z_in_new);
-
-	math::Vector<3> aval(x_in_new, y_in_new, z_in_new);
-	math::Vector<3> aval_integrated;
-
-	bool accel_notify = _accel_int.put(arb.timestamp, aval, aval_integrated, arb.integral_dt);
-	arb.x_integral = aval_integrated(0);
-	arb.y_integral = aval_integrated(1);
-	arb.z_integral = aval_integrated(2);
+	bool accel_notify = _accel_pipeline.put(timestamp, report.accel_x, report.accel_y, report.accel_z, arb);
 
-	arb.scaling = _accel_range_scale;
 	arb.range_m_s2 = _accel_range_m_s2;
 
 	_last_temperature = 23 + report.temp * 1.0f / 512.0f;
@@ -1299,34 +1240,8 @@ BMI160::measure()
 	arb.temperature_raw = report.temp;
 	arb.temperature = _last_temperature;
 
-	grb.x_raw = report.gyro_x;
-	grb.y_raw = report.gyro_y;
-	grb.z_raw = report.gyro_z;
-
-	xraw_f = report.gyro_x;
-	yraw_f = report.gyro_y;
-	zraw_f = report.gyro_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float x_gyro_in_new = ((xraw_f * _gyro_range_scale) - _gyro_scale.x_offset) * _gyro_scale.x_scale;
-	float y_gyro_in_new = ((yraw_f * _gyro_range_scale) - _gyro_scale.y_offset) * _gyro_scale.y_scale;
-	float z_gyro_in_new = ((zraw_f * _gyro_range_scale) - _gyro_scale.z_offset) * _gyro_scale.z_scale;
-
-	grb.x = _gyro_filter_x.apply(x_gyro_in_new);
-	grb.y = _gyro_filter_y.apply(y_gyro_in_new);
-	grb.z = _gyro_filter_z.apply(z_gyro_in_new);
-
-	math::Vector<3> gval(x_gyro_in_new, y_gyro_in_new, z_gyro_in_new);
-	math::Vector<3> gval_integrated;
-
-	bool gyro_notify = _gyro_int.put(arb.timestamp, gval, gval_integrated, grb.integral_dt);
-	grb.x_integral = gval_integrated(0);
-	grb.y_integral = gval_integrated(1);
-	grb.z_integral = gval_integrated(2);
+	bool gyro_notify = _gyro_pipeline.put(timestamp, report.gyro_x, report.gyro_y, report.gyro_z, grb);
 
-	grb.scaling = _gyro_range_scale;
 	grb.range_rad_s = _gyro_range_rad_s;
 
 	grb.temperature_raw = report.temp;
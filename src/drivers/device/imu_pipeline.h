@@ -0,0 +1,238 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file imu_pipeline.h
+ *
+ * Sample processing shared by the inertial sensor drivers.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <drivers/drv_hrt.h>
+#include <lib/conversion/rotation.h>
+#include <mathlib/math/filter/LowPassFilter2pVector3f.hpp>
+#include <mathlib/math/filter/DynamicNotch.hpp>
+
+#include "integrator.h"
+
+/**
+ * Turns raw 3-axis samples into sensor_accel / sensor_gyro style reports.
+ *
+ * The board rotation and the range scaling are folded into one matrix,
+ * followed by the calibration, the optional dynamic notch, the low pass
+ * filter and the integrator, so a driver only has to read the samples
+ * from its bus and publish the reports.
+ *
+ * The DriverFramework wrappers (df_*_wrapper) do not use it: they get
+ * float samples in SI units, integrate every FIFO sample with
+ * Integrator::put_with_interval() and only filter the published average.
+ *
+ * @tparam Report	Report type with the common accel/gyro fields
+ *			(x, y, z, *_raw, *_integral, integral_dt, scaling).
+ */
+template<typename Report>
+class IMUPipeline
+{
+public:
+	/**
+	 * @param sample_rate		Rate in Hz at which put() is called.
+	 * @param cutoff_freq		Low pass filter cutoff frequency in Hz, 0 to disable.
+	 * @param integral_interval	Integration interval in us, see Integrator.
+	 * @param coning_compensation	Enable coning compensation, see Integrator.
+	 */
+	IMUPipeline(float sample_rate, float cutoff_freq, uint64_t integral_interval, bool coning_compensation = false) :
+		_filter(sample_rate, cutoff_freq),
+		_integrator(integral_interval, coning_compensation),
+		_notch(nullptr),
+		_rotation(ROTATION_NONE),
+		_range_scale(1.0f),
+		_offset(0.0f, 0.0f, 0.0f),
+		_scale(1.0f, 1.0f, 1.0f),
+		_sample(0.0f, 0.0f, 0.0f)
+	{
+		update_matrix();
+	}
+
+	~IMUPipeline()
+	{
+		delete _notch;
+	}
+
+	/**
+	 * Notch the strongest vibration peak between min_freq and max_freq
+	 * before the low pass filter and the integrator.
+	 *
+	 * @return	false if the notch could not be allocated.
+	 */
+	bool enable_dynamic_notch(float sample_rate, float min_freq, float max_freq, float q)
+	{
+		if (_notch == nullptr) {
+			_notch = new math::DynamicNotch();
+
+			if (_notch == nullptr) {
+				return false;
+			}
+		}
+
+		_notch->init(sample_rate, min_freq, max_freq, q);
+		return true;
+	}
+
+	/**
+	 * The dynamic notch, nullptr if not enabled.
+	 */
+	math::DynamicNotch *dynamic_notch() { return _notch; }
+
+	/**
+	 * Set the rotation from board axes to vehicle axes.
+	 */
+	void set_rotation(enum Rotation rotation)
+	{
+		_rotation = rotation;
+		update_matrix();
+	}
+
+	/**
+	 * Set the scale from raw sensor values to SI units.
+	 */
+	void set_range_scale(float range_scale)
+	{
+		_range_scale = range_scale;
+		update_matrix();
+	}
+
+	float get_range_scale() const { return _range_scale; }
+
+	/**
+	 * Set the calibration, applied in SI units after the rotation.
+	 *
+	 * @param cal	accel_calibration_s or gyro_calibration_s.
+	 */
+	template<typename Calibration>
+	void set_calibration(const Calibration &cal)
+	{
+		_offset = math::Vector<3>(cal.x_offset, cal.y_offset, cal.z_offset);
+		_scale = math::Vector<3>(cal.x_scale, cal.y_scale, cal.z_scale);
+	}
+
+	void set_cutoff_frequency(float sample_rate, float cutoff_freq) { _filter.set_cutoff_frequency(sample_rate, cutoff_freq); }
+
+	float get_cutoff_freq() const { return _filter.get_cutoff_freq(); }
+
+	/**
+	 * The last calibrated sample in SI units, before the notch and the
+	 * low pass filter.
+	 */
+	const math::Vector<3> &sample() const { return _sample; }
+
+	/**
+	 * Process one raw sample.
+	 *
+	 * Fills the sample dependent fields of the report, the driver fills
+	 * the rest (error count, temperature, range).
+	 *
+	 * @param timestamp	Time the sample was taken.
+	 * @param x		Raw value of the board x axis.
+	 * @param y		Raw value of the board y axis.
+	 * @param z		Raw value of the board z axis.
+	 * @param report	Report to fill.
+	 * @return		true if an integration interval completed and the report should be published.
+	 */
+	bool put(hrt_abstime timestamp, int16_t x, int16_t y, int16_t z, Report &report)
+	{
+		math::Vector<3> raw(x, y, z);
+		_sample = (_matrix * raw - _offset).emult(_scale);
+		math::Vector<3> val = _sample;
+
+		if (_notch != nullptr) {
+			_notch->apply(val.data);
+		}
+
+		math::Vector<3> filtered = _filter.apply(val);
+		math::Vector<3> integral;
+
+		bool notify = _integrator.put(timestamp, val, integral, report.integral_dt);
+
+		report.timestamp = timestamp;
+
+		report.x_raw = x;
+		report.y_raw = y;
+		report.z_raw = z;
+
+		report.x = filtered(0);
+		report.y = filtered(1);
+		report.z = filtered(2);
+
+		report.x_integral = integral(0);
+		report.y_integral = integral(1);
+		report.z_integral = integral(2);
+
+		report.scaling = _range_scale;
+
+		return notify;
+	}
+
+private:
+	math::LowPassFilter2pVector3f	_filter;
+	Integrator			_integrator;
+	math::DynamicNotch		*_notch;
+
+	enum Rotation			_rotation;
+	float				_range_scale;
+	math::Matrix<3, 3>		_matrix;	///< rotation and range scaling
+	math::Vector<3>			_offset;
+	math::Vector<3>			_scale;
+	math::Vector<3>			_sample;	///< last calibrated sample
+
+	void update_matrix()
+	{
+		// build the matrix column by column from rotate_3f, so the
+		// result is exactly what rotating every sample would give
+		for (unsigned i = 0; i < 3; i++) {
+			float axis[3] = {};
+			axis[i] = _range_scale;
+			rotate_3f(_rotation, axis[0], axis[1], axis[2]);
+
+			for (unsigned j = 0; j < 3; j++) {
+				_matrix.data[j][i] = axis[j];
+			}
+		}
+	}
+
+	/* we don't want this class to be copied */
+	IMUPipeline(const IMUPipeline &);
+	IMUPipeline operator=(const IMUPipeline &);
+};
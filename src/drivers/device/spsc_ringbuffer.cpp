@@ -0,0 +1,310 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file spsc_ringbuffer.cpp
+ *
+ * A lock-free ringbuffer for one producer and one consumer.
+ */
+
+#include "spsc_ringbuffer.h"
+#include <string.h>
+
+namespace ringbuffer
+{
+
+static inline unsigned load_acquire(volatile unsigned *ptr)
+{
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(volatile unsigned *ptr, unsigned val)
+{
+	__atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+
+static inline bool compare_and_swap(volatile unsigned *ptr, unsigned expected, unsigned desired)
+{
+#ifdef __PX4_QURT
+	// FIXME - clang crashes on the atomic compare and swap, see ringbuffer.cpp
+	if (*ptr == expected) {
+		*ptr = desired;
+		return true;
+	}
+
+	return false;
+#else
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+SPSCRingBuffer::SPSCRingBuffer(unsigned num_items, size_t item_size) :
+	_num_items(0),
+	_mask(0),
+	_item_size(item_size),
+	_buf(nullptr),
+	_head(0),
+	_tail(0)
+{
+	_allocate(num_items);
+}
+
+SPSCRingBuffer::~SPSCRingBuffer()
+{
+	if (_buf != nullptr) {
+		delete[] _buf;
+	}
+}
+
+bool
+SPSCRingBuffer::_allocate(unsigned num_items)
+{
+	unsigned storage = 1;
+
+	while (storage < num_items) {
+		storage <<= 1;
+	}
+
+	char *buf = new char[storage * _item_size];
+
+	if (buf == nullptr) {
+		return false;
+	}
+
+	if (_buf != nullptr) {
+		delete[] _buf;
+	}
+
+	_buf = buf;
+	_num_items = num_items;
+	_mask = storage - 1;
+	_head = 0;
+	_tail = 0;
+	return true;
+}
+
+void
+SPSCRingBuffer::_copy_in(unsigned index, const void *vals, unsigned n)
+{
+	const unsigned start = index & _mask;
+	const unsigned first = (n < _mask + 1 - start) ? n : (_mask + 1 - start);
+
+	memcpy(&_buf[start * _item_size], vals, first * _item_size);
+
+	if (n > first) {
+		memcpy(_buf, static_cast<const char *>(vals) + first * _item_size, (n - first) * _item_size);
+	}
+}
+
+void
+SPSCRingBuffer::_copy_out(unsigned index, void *vals, unsigned n)
+{
+	const unsigned start = index & _mask;
+	const unsigned first = (n < _mask + 1 - start) ? n : (_mask + 1 - start);
+
+	memcpy(vals, &_buf[start * _item_size], first * _item_size);
+
+	if (n > first) {
+		memcpy(static_cast<char *>(vals) + first * _item_size, _buf, (n - first) * _item_size);
+	}
+}
+
+bool
+SPSCRingBuffer::put(const void *val)
+{
+	const unsigned head = _head;
+
+	if (head - load_acquire(&_tail) >= _num_items) {
+		return false;
+	}
+
+	memcpy(&_buf[(head & _mask) * _item_size], val, _item_size);
+	store_release(&_head, head + 1);
+	return true;
+}
+
+unsigned
+SPSCRingBuffer::put_n(const void *vals, unsigned n)
+{
+	const unsigned head = _head;
+	const unsigned used = head - load_acquire(&_tail);
+	const unsigned space_left = (used < _num_items) ? (_num_items - used) : 0;
+
+	if (n > space_left) {
+		n = space_left;
+	}
+
+	if (n > 0) {
+		_copy_in(head, vals, n);
+
+		/* publish the items only after they were written */
+		store_release(&_head, head + n);
+	}
+
+	return n;
+}
+
+bool
+SPSCRingBuffer::force(const void *val)
+{
+	bool overwrote = false;
+
+	if (_num_items == 0) {
+		return false;
+	}
+
+	while (!put(val)) {
+		/* drop the oldest item, unless the consumer just took it */
+		unsigned tail = load_acquire(&_tail);
+
+		if (_head - tail >= _num_items && compare_and_swap(&_tail, tail, tail + 1)) {
+			overwrote = true;
+		}
+	}
+
+	return overwrote;
+}
+
+bool
+SPSCRingBuffer::get(void *val)
+{
+	for (;;) {
+		const unsigned tail = load_acquire(&_tail);
+
+		if (tail == load_acquire(&_head)) {
+			return false;
+		}
+
+		if (val != NULL) {
+			memcpy(val, &_buf[(tail & _mask) * _item_size], _item_size);
+		}
+
+		/* if force() dropped this item while we were copying, the copy may be torn, retry */
+		if (compare_and_swap(&_tail, tail, tail + 1)) {
+			return true;
+		}
+	}
+}
+
+unsigned
+SPSCRingBuffer::get_n(void *vals, unsigned n)
+{
+	for (;;) {
+		const unsigned tail = load_acquire(&_tail);
+		unsigned available = load_acquire(&_head) - tail;
+
+		if (available == 0 || n == 0) {
+			return 0;
+		}
+
+		/* can only exceed the capacity if force() moved the tail meanwhile, the CAS fails then */
+		if (available > _num_items) {
+			available = _num_items;
+		}
+
+		const unsigned got = (n < available) ? n : available;
+
+		_copy_out(tail, vals, got);
+
+		/* if force() dropped items while we were copying, the copy may be torn, retry */
+		if (compare_and_swap(&_tail, tail, tail + got)) {
+			return got;
+		}
+	}
+}
+
+unsigned
+SPSCRingBuffer::space(void)
+{
+	return _num_items - count();
+}
+
+unsigned
+SPSCRingBuffer::count(void)
+{
+	unsigned tail = load_acquire(&_tail);
+	unsigned used = load_acquire(&_head) - tail;
+
+	return (used < _num_items) ? used : _num_items;
+}
+
+bool
+SPSCRingBuffer::empty()
+{
+	return count() == 0;
+}
+
+bool
+SPSCRingBuffer::full()
+{
+	return count() == _num_items;
+}
+
+unsigned
+SPSCRingBuffer::size()
+{
+	return (_buf != nullptr) ? _num_items : 0;
+}
+
+void
+SPSCRingBuffer::flush()
+{
+	for (;;) {
+		unsigned tail = load_acquire(&_tail);
+		unsigned head = load_acquire(&_head);
+
+		if (tail == head || compare_and_swap(&_tail, tail, head)) {
+			break;
+		}
+	}
+}
+
+bool
+SPSCRingBuffer::resize(unsigned new_size)
+{
+	return _allocate(new_size);
+}
+
+void
+SPSCRingBuffer::print_info(const char *name)
+{
+	printf("%s	%u/%lu (%u/%u @ %p)\n",
+	       name,
+	       _num_items,
+	       (unsigned long)_num_items * _item_size,
+	       _head,
+	       _tail,
+	       _buf);
+}
+
+} // namespace ringbuffer
@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file spsc_ringbuffer.h
+ *
+ * A lock-free ringbuffer for one producer and one consumer.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace ringbuffer __EXPORT
+{
+
+/**
+ * Ringbuffer for exactly one producer (usually the sensor interrupt or
+ * work queue) and one consumer (usually read()).
+ *
+ * Unlike RingBuffer, neither side has to disable interrupts, several
+ * items can be moved with one call, and the indices run freely and are
+ * masked with a power-of-two storage size instead of wrapped by compares.
+ * The producer owns the head and the consumer the tail, and they are kept
+ * on separate cache lines.
+ *
+ * force() discards the oldest item from the producer side. It moves the
+ * tail with the same compare-and-swap the consumer uses, so a consumer
+ * that raced with it retries instead of returning an overwritten item.
+ * For the same reason several readers of one device node are safe, only
+ * the producer must be unique.
+ */
+class SPSCRingBuffer
+{
+public:
+	SPSCRingBuffer(unsigned num_items, size_t item_size);
+	~SPSCRingBuffer();
+
+	/**
+	 * Put an item into the buffer (producer).
+	 *
+	 * @param val		Item to put
+	 * @return		true if the item was put, false if the buffer is full
+	 */
+	bool			put(const void *val);
+
+	/**
+	 * Put up to n items into the buffer (producer).
+	 *
+	 * @param vals		Array of items to put
+	 * @param n		Number of items in vals
+	 * @return		Number of items put, less than n if the buffer became full
+	 */
+	unsigned		put_n(const void *vals, unsigned n);
+
+	/**
+	 * Force an item into the buffer, discarding the oldest item if there is not space (producer).
+	 *
+	 * @param val		Item to put
+	 * @return		true if an item was discarded to make space
+	 */
+	bool			force(const void *val);
+
+	/**
+	 * Get an item from the buffer (consumer).
+	 *
+	 * @param val		Item that was gotten, may be NULL to drop it
+	 * @return		true if an item was got, false if the buffer was empty.
+	 */
+	bool			get(void *val);
+
+	/**
+	 * Get up to n items from the buffer, oldest first (consumer).
+	 *
+	 * @param vals		Array with space for n items
+	 * @param n		Maximum number of items to get
+	 * @return		Number of items got
+	 */
+	unsigned		get_n(void *vals, unsigned n);
+
+	/*
+	 * Get the number of slots free in the buffer.
+	 */
+	unsigned		space(void);
+
+	/*
+	 * Get the number of items in the buffer.
+	 */
+	unsigned		count(void);
+
+	/*
+	 * Returns true if the buffer is empty.
+	 */
+	bool			empty();
+
+	/*
+	 * Returns true if the buffer is full.
+	 */
+	bool			full();
+
+	/*
+	 * Returns the capacity of the buffer, or zero if the buffer could
+	 * not be allocated.
+	 */
+	unsigned		size();
+
+	/*
+	 * Empties the buffer (consumer).
+	 */
+	void			flush();
+
+	/*
+	 * resize the buffer. This is unsafe to be called while
+	 * a producer or consuming is running. Caller is responsible
+	 * for any locking needed
+	 *
+	 * @param new_size	new size for buffer
+	 * @return		true if the resize succeeds, false if
+	 * 			not (allocation error)
+	 */
+	bool			resize(unsigned new_size);
+
+	/*
+	 * printf() some info on the buffer
+	 */
+	void			print_info(const char *name);
+
+private:
+	static const unsigned	CACHE_LINE_SIZE = 64;
+
+	/* read-only while running */
+	unsigned		_num_items;	/**< capacity */
+	unsigned		_mask;		/**< storage size - 1, storage size is a power of two */
+	const size_t		_item_size;
+	char			*_buf;
+
+	char			_pad0[CACHE_LINE_SIZE];
+	volatile unsigned	_head;		/**< items ever put, written by the producer only */
+	char			_pad1[CACHE_LINE_SIZE - sizeof(unsigned)];
+	volatile unsigned	_tail;		/**< items ever removed, see force() */
+	char			_pad2[CACHE_LINE_SIZE - sizeof(unsigned)];
+
+	bool			_allocate(unsigned num_items);
+	void			_copy_in(unsigned index, const void *vals, unsigned n);
+	void			_copy_out(unsigned index, void *vals, unsigned n);
+
+	/* we don't want this class to be copied */
+	SPSCRingBuffer(const SPSCRingBuffer &);
+	SPSCRingBuffer operator=(const SPSCRingBuffer &);
+};
+
+} // namespace ringbuffer
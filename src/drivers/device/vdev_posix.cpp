@@ -40,6 +40,8 @@
 #include <px4_log.h>
 #include <px4_posix.h>
 #include <px4_time.h>
+#include <px4_tasks.h>
+#include <drivers/drv_hrt.h>
 #include "device.h"
 #include "vfile.h"
 
@@ -287,6 +289,7 @@ extern "C" {
 			fds[i].sem     = &sem;
 			fds[i].revents = 0;
 			fds[i].priv    = NULL;
+			fds[i].notify_time = 0;
 
 			VDev *dev = get_vdev(fds[i].fd);
 
@@ -312,30 +315,9 @@ extern "C" {
 		if (fd_pollable) {
 			if (timeout > 0) {
 
-				// Get the current time
-				struct timespec ts;
-				// FIXME: check if QURT should probably be using CLOCK_MONOTONIC
-				px4_clock_gettime(CLOCK_REALTIME, &ts);
-
-				// Calculate an absolute time in the future
-				const unsigned billion = (1000 * 1000 * 1000);
-				unsigned tdiff = timeout;
-				uint64_t nsecs = ts.tv_nsec + (tdiff * 1000 * 1000);
-				ts.tv_sec += nsecs / billion;
-				nsecs -= (nsecs / billion) * billion;
-				ts.tv_nsec = nsecs;
-
-				// Execute a blocking wait for that time in the future
-				errno = 0;
-				ret = px4_sem_timedwait(&sem, &ts);
-#ifndef __PX4_DARWIN
-				ret = errno;
-#endif
-
-				// Ensure ret is negative on failure
-				if (ret > 0) {
-					ret = -ret;
-				}
+				// Execute a blocking wait for the timeout, in HRT time so
+				// that it follows the simulated time in lockstep
+				ret = hrt_sem_timedwait(&sem, (hrt_abstime)timeout * 1000);
 
 				if (ret && ret != -ETIMEDOUT) {
 					PX4_WARN("%s: px4_poll() sem error", thread_name);
@@ -345,6 +327,19 @@ extern "C" {
 				px4_sem_wait(&sem);
 			}
 
+			// Account the time from the first notification to resuming here
+			hrt_abstime notify_time = 0;
+
+			for (i = 0; i < nfds; ++i) {
+				if (fds[i].notify_time != 0 && (notify_time == 0 || fds[i].notify_time < notify_time)) {
+					notify_time = fds[i].notify_time;
+				}
+			}
+
+			if (notify_time != 0) {
+				px4_task_wakeup_latency(hrt_elapsed_time(&notify_time));
+			}
+
 			// We have waited now (or not, depending on timeout),
 			// go through all fds and count how many have data
 			for (i = 0; i < nfds; ++i) {
@@ -46,6 +46,10 @@
 #include <px4_time.h>
 #include <queue.h>
 
+#ifdef __PX4_POSIX
+#include <px4_sem.h>
+#endif
+
 __BEGIN_DECLS
 
 /**
@@ -186,6 +190,32 @@ __EXPORT extern	void	hrt_start_delay(void);
  */
 __EXPORT extern void	hrt_stop_delay(void);
 
+/**
+ * Switch the HRT to lockstep: from now on the time only advances with
+ * hrt_lockstep_set_time(), typically on each sensor message of a simulator.
+ */
+__EXPORT extern void	hrt_lockstep_enable(void);
+
+/**
+ * Return true if the HRT runs in lockstep.
+ */
+__EXPORT extern bool	hrt_lockstep_enabled(void);
+
+/**
+ * Advance the lockstep time to the given value, then run the callouts and
+ * wake up the hrt_sem_timedwait() callers whose deadline has passed.
+ * The time never goes backwards.
+ */
+__EXPORT extern void	hrt_lockstep_set_time(hrt_abstime time);
+
+/**
+ * Wait on a semaphore for at most timeout us of HRT time, which is the
+ * simulated time in lockstep.
+ *
+ * @return 0 if the semaphore was taken, -ETIMEDOUT on timeout, else -errno
+ */
+__EXPORT extern int	hrt_sem_timedwait(px4_sem_t *sem, hrt_abstime timeout);
+
 #endif
 
 __END_DECLS
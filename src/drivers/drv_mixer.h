@@ -109,6 +109,57 @@ struct mixer_simple_s {
  */
 #define MIXERIOCLOADBUF		_MIXERIOC(5)
 
+/**
+ * Add mixer(s) from the precompiled image in (const struct mixer_binary_header_s *)arg
+ */
+#define MIXERIOCLOADBIN		_MIXERIOC(6)
+
+/*
+ * Precompiled mixer image, generated at build time from the mixer text
+ * files by Tools/px_generate_mixers.py.
+ *
+ * The image is a header followed by one record per mixer.  Each record
+ * starts with the same tag letter as the text definition and carries the
+ * already scaled values, so loading it does not involve any parsing.
+ * All values are little endian.
+ */
+#pragma pack(push, 1)
+struct mixer_binary_header_s {
+	uint16_t		magic;
+#define MIXER_BINARY_MAGIC	0x4da5
+	uint8_t			version;
+#define MIXER_BINARY_VERSION	1
+	uint8_t			count;		/**< number of mixer records */
+	uint16_t		length;		/**< length of the records following the header */
+};
+
+struct mixer_binary_record_s {
+	uint8_t			type;		/**< 'Z', 'M', 'R' or 'A' as in the text format */
+	uint8_t			length;		/**< length of the payload following the record header */
+};
+
+/* 'M' payload, followed by control_count struct mixer_binary_control_s */
+struct mixer_binary_simple_s {
+	uint8_t			control_count;
+	struct mixer_scaler_s	output_scaler;
+};
+
+struct mixer_binary_control_s {
+	uint8_t			control_group;
+	uint8_t			control_index;
+	struct mixer_scaler_s	scaler;
+};
+
+/* 'R' and 'A' payload */
+struct mixer_binary_multirotor_s {
+	char			geometry[8];	/**< geometry name, nul padded */
+	float			roll_scale;
+	float			pitch_scale;
+	float			yaw_scale;
+	float			idle_speed;
+};
+#pragma pack(pop)
+
 /*
  * XXX Thoughts for additional operations:
  *
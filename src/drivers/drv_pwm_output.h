@@ -352,6 +352,17 @@ __EXPORT extern int	up_pwm_servo_set_rate_group_update(unsigned group, unsigned
  */
 __EXPORT extern int	up_pwm_servo_set(unsigned channel, servo_position_t value);
 
+/**
+ * Set the output values of several channels at once.
+ *
+ * All channels of a timer take their new value in the same PWM period.
+ * Channels that are not configured as PWM outputs are skipped.
+ *
+ * @param values	The output pulse widths in microseconds, indexed by channel.
+ * @param count		The number of entries in values.
+ */
+__EXPORT extern int	up_pwm_servo_set_multi(const servo_position_t *values, unsigned count);
+
 /**
  * Get the current output value for a channel.
  *
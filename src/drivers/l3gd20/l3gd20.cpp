@@ -65,11 +65,11 @@
 #include <drivers/drv_hrt.h>
 #include <drivers/device/spi.h>
 #include <drivers/drv_gyro.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/device/integrator.h>
+#include <drivers/device/imu_pipeline.h>
 
 #include <board_config.h>
-#include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
 
 #define L3GD20_DEVICE_PATH "/dev/l3gd20"
@@ -233,7 +233,7 @@ private:
 	struct hrt_call		_call;
 	unsigned		_call_interval;
 
-	ringbuffer::RingBuffer	*_reports;
+	ringbuffer::SPSCRingBuffer	*_reports;
 
 	struct gyro_calibration_s	_gyro_scale;
 	float			_gyro_range_scale;
@@ -254,17 +254,11 @@ private:
 
 	uint8_t			_register_wait;
 
-	math::LowPassFilter2p	_gyro_filter_x;
-	math::LowPassFilter2p	_gyro_filter_y;
-	math::LowPassFilter2p	_gyro_filter_z;
-
-	Integrator		_gyro_int;
+	IMUPipeline<gyro_report>	_gyro_pipeline;
 
 	/* true if an L3G4200D is detected */
 	bool	_is_l3g4200d;
 
-	enum Rotation		_rotation;
-
 	// this is used to support runtime checking of key
 	// configuration registers to detect SPI bus errors and sensor
 	// reset
@@ -430,12 +424,8 @@ L3GD20::L3GD20(int bus, const char *path, spi_dev_e device, enum Rotation rotati
 	_bad_registers(perf_alloc(PC_COUNT, "l3gd20_bad_reg")),
 	_duplicates(perf_alloc(PC_COUNT, "l3gd20_dupe")),
 	_register_wait(0),
-	_gyro_filter_x(L3GD20_DEFAULT_RATE, L3GD20_DEFAULT_FILTER_FREQ),
-	_gyro_filter_y(L3GD20_DEFAULT_RATE, L3GD20_DEFAULT_FILTER_FREQ),
-	_gyro_filter_z(L3GD20_DEFAULT_RATE, L3GD20_DEFAULT_FILTER_FREQ),
-	_gyro_int(1000000 / L3GD20_MAX_OUTPUT_RATE, true),
+	_gyro_pipeline(L3GD20_DEFAULT_RATE, L3GD20_DEFAULT_FILTER_FREQ, 1000000 / L3GD20_MAX_OUTPUT_RATE, true),
 	_is_l3g4200d(false),
-	_rotation(rotation),
 	_checked_next(0)
 {
 	// enable debug() calls
@@ -450,6 +440,8 @@ L3GD20::L3GD20(int bus, const char *path, spi_dev_e device, enum Rotation rotati
 	_gyro_scale.y_scale  = 1.0f;
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
+
+	_gyro_pipeline.set_rotation(rotation);
 }
 
 L3GD20::~L3GD20()
@@ -484,7 +476,7 @@ L3GD20::init()
 	}
 
 	/* allocate basic report buffers */
-	_reports = new ringbuffer::RingBuffer(2, sizeof(gyro_report));
+	_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(gyro_report));
 
 	if (_reports == nullptr) {
 		goto out;
@@ -566,12 +558,7 @@ L3GD20::read(struct file *filp, char *buffer, size_t buflen)
 		 * Note that we may be pre-empted by the measurement code while we are doing this;
 		 * we are careful to avoid racing with it.
 		 */
-		while (count--) {
-			if (_reports->get(gbuf)) {
-				ret += sizeof(*gbuf);
-				gbuf++;
-			}
-		}
+		ret = _reports->get_n(gbuf, count) * sizeof(*gbuf);
 
 		/* if there was no data, warn the caller */
 		return ret ? ret : -EAGAIN;
@@ -639,7 +626,7 @@ L3GD20::ioctl(struct file *filp, int cmd, unsigned long arg)
 					_call.period = _call_interval - L3GD20_TIMER_REDUCTION;
 
 					/* adjust filters */
-					float cutoff_freq_hz = _gyro_filter_x.get_cutoff_freq();
+					float cutoff_freq_hz = _gyro_pipeline.get_cutoff_freq();
 					float sample_rate = 1.0e6f / ticks;
 					set_driver_lowpass_filter(sample_rate, cutoff_freq_hz);
 
@@ -700,11 +687,12 @@ L3GD20::ioctl(struct file *filp, int cmd, unsigned long arg)
 		}
 
 	case GYROIOCGLOWPASS:
-		return static_cast<int>(_gyro_filter_x.get_cutoff_freq());
+		return static_cast<int>(_gyro_pipeline.get_cutoff_freq());
 
 	case GYROIOCSSCALE:
 		/* copy scale in */
 		memcpy(&_gyro_scale, (struct gyro_calibration_s *) arg, sizeof(_gyro_scale));
+		_gyro_pipeline.set_calibration(_gyro_scale);
 		return OK;
 
 	case GYROIOCGSCALE:
@@ -809,6 +797,7 @@ L3GD20::set_range(unsigned max_dps)
 
 	_gyro_range_rad_s = new_range / 180.0f * M_PI_F;
 	_gyro_range_scale = new_range_scale_dps_digit / 180.0f * M_PI_F;
+	_gyro_pipeline.set_range_scale(_gyro_range_scale);
 	write_checked_reg(ADDR_CTRL_REG4, bits);
 
 	return OK;
@@ -855,9 +844,7 @@ L3GD20::set_samplerate(unsigned frequency)
 void
 L3GD20::set_driver_lowpass_filter(float samplerate, float bandwidth)
 {
-	_gyro_filter_x.set_cutoff_frequency(samplerate, bandwidth);
-	_gyro_filter_y.set_cutoff_frequency(samplerate, bandwidth);
-	_gyro_filter_z.set_cutoff_frequency(samplerate, bandwidth);
+	_gyro_pipeline.set_cutoff_frequency(samplerate, bandwidth);
 }
 
 void
@@ -1005,20 +992,12 @@ L3GD20::measure()
 	}
 
 	/*
-	 * 1) Scale raw value to SI units using scaling from datasheet.
-	 * 2) Subtract static offset (in SI units)
-	 * 3) Scale the statically calibrated values with a linear
-	 *    dynamically obtained factor
-	 *
-	 * Note: the static sensor offset is the number the sensor outputs
-	 * 	 at a nominally 'zero' input. Therefore the offset has to
-	 * 	 be subtracted.
-	 *
-	 *	 Example: A gyro outputs a value of 74 at zero angular rate
-	 *	 	  the offset is 74 from the origin and subtracting
-	 *		  74 from all measurements centers them around zero.
+	 * The pipeline rotates, scales to SI units, applies the calibration,
+	 * filters and integrates. The static sensor offset is the number the
+	 * sensor outputs at a nominally 'zero' input, so it is subtracted
+	 * after scaling.
 	 */
-	report.timestamp = hrt_absolute_time();
+	hrt_abstime timestamp = hrt_absolute_time();
 	report.error_count = perf_event_count(_bad_registers);
 
 	switch (_orientation) {
@@ -1072,32 +1051,10 @@ L3GD20::measure()
 
 	report.temperature_raw = raw_report.temp;
 
-	float xraw_f = report.x_raw;
-	float yraw_f = report.y_raw;
-	float zraw_f = report.z_raw;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float xin = ((xraw_f * _gyro_range_scale) - _gyro_scale.x_offset) * _gyro_scale.x_scale;
-	float yin = ((yraw_f * _gyro_range_scale) - _gyro_scale.y_offset) * _gyro_scale.y_scale;
-	float zin = ((zraw_f * _gyro_range_scale) - _gyro_scale.z_offset) * _gyro_scale.z_scale;
-
-	report.x = _gyro_filter_x.apply(xin);
-	report.y = _gyro_filter_y.apply(yin);
-	report.z = _gyro_filter_z.apply(zin);
-
-	math::Vector<3> gval(xin, yin, zin);
-	math::Vector<3> gval_integrated;
-
-	bool gyro_notify = _gyro_int.put(report.timestamp, gval, gval_integrated, report.integral_dt);
-	report.x_integral = gval_integrated(0);
-	report.y_integral = gval_integrated(1);
-	report.z_integral = gval_integrated(2);
+	bool gyro_notify = _gyro_pipeline.put(timestamp, report.x_raw, report.y_raw, report.z_raw, report);
 
 	report.temperature = L3GD20_TEMP_OFFSET_CELSIUS - raw_report.temp;
 
-	report.scaling = _gyro_range_scale;
 	report.range_rad_s = _gyro_range_rad_s;
 
 	_reports->force(&report);
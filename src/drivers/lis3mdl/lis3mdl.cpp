@@ -67,7 +67,7 @@
 
 #include <drivers/drv_mag.h>
 #include <drivers/drv_hrt.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/drv_device.h>
 
 #include <uORB/uORB.h>
@@ -148,7 +148,7 @@ private:
 	work_s			_work;
 	unsigned		_measure_ticks;
 
-	ringbuffer::RingBuffer	*_reports;
+	ringbuffer::SPSCRingBuffer	*_reports;
 	struct mag_calibration_s	_scale;
 	float 			_range_scale;
 	float 			_range_ga;
@@ -168,7 +168,7 @@ private:
 	bool			_sensor_ok;		/**< sensor was found and reports ok */
 	bool			_calibrated;		/**< the calibration is valid */
 
-	enum Rotation		_rotation;
+	RotationMatrix		_rotation;
 
 	struct mag_report	_last_report;           /**< used for info() */
 
@@ -416,7 +416,7 @@ LIS3MDL::init()
 	}
 
 	/* allocate basic report buffers */
-	_reports = new ringbuffer::RingBuffer(2, sizeof(mag_report));
+	_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(mag_report));
 
 	if (_reports == nullptr) {
 		goto out;
@@ -589,12 +589,7 @@ LIS3MDL::read(struct file *filp, char *buffer, size_t buflen)
 		 * Note that we may be pre-empted by the workq thread while we are doing this;
 		 * we are careful to avoid racing with them.
 		 */
-		while (count--) {
-			if (_reports->get(mag_buf)) {
-				ret += sizeof(struct mag_report);
-				mag_buf++;
-			}
-		}
+		ret = _reports->get_n(mag_buf, count) * sizeof(struct mag_report);
 
 		/* if there was no data, warn the caller */
 		return ret ? ret : -EAGAIN;
@@ -967,7 +962,7 @@ LIS3MDL::collect()
 	zraw_f = report.z;
 
 	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+	_rotation.rotate(xraw_f, yraw_f, zraw_f);
 
 	new_report.x = ((xraw_f * _range_scale) - _scale.x_offset) * _scale.x_scale;
 	/* flip axes and negate value for y */
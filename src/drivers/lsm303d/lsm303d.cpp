@@ -64,11 +64,11 @@
 #include <drivers/device/spi.h>
 #include <drivers/drv_accel.h>
 #include <drivers/drv_mag.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/device/integrator.h>
+#include <drivers/device/imu_pipeline.h>
 
 #include <board_config.h>
-#include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
 
 /* oddly, ERROR is not defined for c++ */
@@ -276,8 +276,8 @@ private:
 	unsigned		_call_accel_interval;
 	unsigned		_call_mag_interval;
 
-	ringbuffer::RingBuffer	*_accel_reports;
-	ringbuffer::RingBuffer		*_mag_reports;
+	ringbuffer::SPSCRingBuffer	*_accel_reports;
+	ringbuffer::SPSCRingBuffer		*_mag_reports;
 
 	struct accel_calibration_s	_accel_scale;
 	unsigned		_accel_range_m_s2;
@@ -305,13 +305,9 @@ private:
 
 	uint8_t			_register_wait;
 
-	math::LowPassFilter2p	_accel_filter_x;
-	math::LowPassFilter2p	_accel_filter_y;
-	math::LowPassFilter2p	_accel_filter_z;
+	IMUPipeline<accel_report>	_accel_pipeline;
 
-	Integrator		_accel_int;
-
-	enum Rotation		_rotation;
+	RotationMatrix		_rotation;	///< used by the magnetometer
 
 	// values used to
 	float			_last_accel[3];
@@ -579,10 +575,8 @@ LSM303D::LSM303D(int bus, const char *path, spi_dev_e device, enum Rotation rota
 	_bad_values(perf_alloc(PC_COUNT, "lsm303d_bad_val")),
 	_accel_duplicates(perf_alloc(PC_COUNT, "lsm303d_acc_dupe")),
 	_register_wait(0),
-	_accel_filter_x(LSM303D_ACCEL_DEFAULT_RATE, LSM303D_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_y(LSM303D_ACCEL_DEFAULT_RATE, LSM303D_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_z(LSM303D_ACCEL_DEFAULT_RATE, LSM303D_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_int(1000000 / LSM303D_ACCEL_MAX_OUTPUT_RATE, true),
+	_accel_pipeline(LSM303D_ACCEL_DEFAULT_RATE, LSM303D_ACCEL_DEFAULT_DRIVER_FILTER_FREQ,
+			1000000 / LSM303D_ACCEL_MAX_OUTPUT_RATE, true),
 	_rotation(rotation),
 	_constant_accel_count(0),
 	_last_temperature(0),
@@ -614,6 +608,8 @@ LSM303D::LSM303D(int bus, const char *path, spi_dev_e device, enum Rotation rota
 	_mag_scale.y_scale = 1.0f;
 	_mag_scale.z_offset = 0.0f;
 	_mag_scale.z_scale = 1.0f;
+
+	_accel_pipeline.set_rotation(rotation);
 }
 
 LSM303D::~LSM303D()
@@ -656,13 +652,13 @@ LSM303D::init()
 	}
 
 	/* allocate basic report buffers */
-	_accel_reports = new ringbuffer::RingBuffer(2, sizeof(accel_report));
+	_accel_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(accel_report));
 
 	if (_accel_reports == nullptr) {
 		goto out;
 	}
 
-	_mag_reports = new ringbuffer::RingBuffer(2, sizeof(mag_report));
+	_mag_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(mag_report));
 
 	if (_mag_reports == nullptr) {
 		goto out;
@@ -792,12 +788,7 @@ LSM303D::read(struct file *filp, char *buffer, size_t buflen)
 		/*
 		 * While there is space in the caller's buffer, and reports, copy them.
 		 */
-		while (count--) {
-			if (_accel_reports->get(arb)) {
-				ret += sizeof(*arb);
-				arb++;
-			}
-		}
+		ret = _accel_reports->get_n(arb, count) * sizeof(*arb);
 
 		/* if there was no data, warn the caller */
 		return ret ? ret : -EAGAIN;
@@ -832,12 +823,7 @@ LSM303D::mag_read(struct file *filp, char *buffer, size_t buflen)
 		/*
 		 * While there is space in the caller's buffer, and reports, copy them.
 		 */
-		while (count--) {
-			if (_mag_reports->get(mrb)) {
-				ret += sizeof(*mrb);
-				mrb++;
-			}
-		}
+		ret = _mag_reports->get_n(mrb, count) * sizeof(*mrb);
 
 		/* if there was no data, warn the caller */
 		return ret ? ret : -EAGAIN;
@@ -897,7 +883,7 @@ LSM303D::ioctl(struct file *filp, int cmd, unsigned long arg)
 					}
 
 					/* adjust filters */
-					accel_set_driver_lowpass_filter((float)arg, _accel_filter_x.get_cutoff_freq());
+					accel_set_driver_lowpass_filter((float)arg, _accel_pipeline.get_cutoff_freq());
 
 					/* update interval for next measurement */
 					/* XXX this is a bit shady, but no other way to adjust... */
@@ -958,7 +944,7 @@ LSM303D::ioctl(struct file *filp, int cmd, unsigned long arg)
 		}
 
 	case ACCELIOCGLOWPASS:
-		return static_cast<int>(_accel_filter_x.get_cutoff_freq());
+		return static_cast<int>(_accel_pipeline.get_cutoff_freq());
 
 	case ACCELIOCSSCALE: {
 			/* copy scale, but only if off by a few percent */
@@ -967,6 +953,7 @@ LSM303D::ioctl(struct file *filp, int cmd, unsigned long arg)
 
 			if (sum > 2.0f && sum < 4.0f) {
 				memcpy(&_accel_scale, s, sizeof(_accel_scale));
+				_accel_pipeline.set_calibration(_accel_scale);
 				return OK;
 
 			} else {
@@ -1274,6 +1261,7 @@ LSM303D::accel_set_range(unsigned max_g)
 	}
 
 	_accel_range_scale = new_scale_g_digit * LSM303D_ONE_G;
+	_accel_pipeline.set_range_scale(_accel_range_scale);
 
 
 	modify_reg(ADDR_CTRL_REG2, clearbits, setbits);
@@ -1361,9 +1349,7 @@ LSM303D::accel_set_onchip_lowpass_filter_bandwidth(unsigned bandwidth)
 int
 LSM303D::accel_set_driver_lowpass_filter(float samplerate, float bandwidth)
 {
-	_accel_filter_x.set_cutoff_frequency(samplerate, bandwidth);
-	_accel_filter_y.set_cutoff_frequency(samplerate, bandwidth);
-	_accel_filter_z.set_cutoff_frequency(samplerate, bandwidth);
+	_accel_pipeline.set_cutoff_frequency(samplerate, bandwidth);
 
 	return OK;
 }
@@ -1560,22 +1546,12 @@ LSM303D::measure()
 	}
 
 	/*
-	 * 1) Scale raw value to SI units using scaling from datasheet.
-	 * 2) Subtract static offset (in SI units)
-	 * 3) Scale the statically calibrated values with a linear
-	 *    dynamically obtained factor
-	 *
-	 * Note: the static sensor offset is the number the sensor outputs
-	 * 	 at a nominally 'zero' input. Therefore the offset has to
-	 * 	 be subtracted.
-	 *
-	 *	 Example: A gyro outputs a value of 74 at zero angular rate
-	 *	 	  the offset is 74 from the origin and subtracting
-	 *		  74 from all measurements centers them around zero.
+	 * The pipeline rotates, scales to SI units, applies the calibration,
+	 * filters and integrates. The static sensor offset is the number the
+	 * sensor outputs at a nominally 'zero' input, so it is subtracted
+	 * after scaling.
 	 */
-
-
-	accel_report.timestamp = hrt_absolute_time();
+	hrt_abstime timestamp = hrt_absolute_time();
 
 #if defined(CONFIG_ARCH_BOARD_MINDPX_V2)
 	int16_t tx = raw_accel_report.y;
@@ -1604,20 +1580,13 @@ LSM303D::measure()
 	// whether it has had failures
 	accel_report.error_count = perf_event_count(_bad_registers) + perf_event_count(_bad_values);
 
-	accel_report.x_raw = raw_accel_report.x;
-	accel_report.y_raw = raw_accel_report.y;
-	accel_report.z_raw = raw_accel_report.z;
-
-	float xraw_f = raw_accel_report.x;
-	float yraw_f = raw_accel_report.y;
-	float zraw_f = raw_accel_report.z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+	bool accel_notify = _accel_pipeline.put(timestamp, raw_accel_report.x, raw_accel_report.y, raw_accel_report.z,
+						accel_report);
 
-	float x_in_new = ((xraw_f * _accel_range_scale) - _accel_scale.x_offset) * _accel_scale.x_scale;
-	float y_in_new = ((yraw_f * _accel_range_scale) - _accel_scale.y_offset) * _accel_scale.y_scale;
-	float z_in_new = ((zraw_f * _accel_range_scale) - _accel_scale.z_offset) * _accel_scale.z_scale;
+	const math::Vector<3> &aval = _accel_pipeline.sample();
+	float x_in_new = aval(0);
+	float y_in_new = aval(1);
+	float z_in_new = aval(2);
 
 	/*
 	  we have logs where the accelerometers get stuck at a fixed
@@ -1651,19 +1620,6 @@ LSM303D::measure()
 	_last_accel[1] = y_in_new;
 	_last_accel[2] = z_in_new;
 
-	accel_report.x = _accel_filter_x.apply(x_in_new);
-	accel_report.y = _accel_filter_y.apply(y_in_new);
-	accel_report.z = _accel_filter_z.apply(z_in_new);
-
-	math::Vector<3> aval(x_in_new, y_in_new, z_in_new);
-	math::Vector<3> aval_integrated;
-
-	bool accel_notify = _accel_int.put(accel_report.timestamp, aval, aval_integrated, accel_report.integral_dt);
-	accel_report.x_integral = aval_integrated(0);
-	accel_report.y_integral = aval_integrated(1);
-	accel_report.z_integral = aval_integrated(2);
-
-	accel_report.scaling = _accel_range_scale;
 	accel_report.range_m_s2 = _accel_range_m_s2;
 
 	_accel_reports->force(&accel_report);
@@ -1756,7 +1712,7 @@ LSM303D::mag_measure()
 	float zraw_f = mag_report.z_raw;
 
 	/* apply user specified rotation */
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+	_rotation.rotate(xraw_f, yraw_f, zraw_f);
 
 	mag_report.x = ((xraw_f * _mag_range_scale) - _mag_scale.x_offset) * _mag_scale.x_scale;
 	mag_report.y = ((yraw_f * _mag_range_scale) - _mag_scale.y_offset) * _mag_scale.y_scale;
@@ -73,6 +73,7 @@
 #include <getopt.h>
 
 #include <systemlib/perf_counter.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/err.h>
 #include <systemlib/conversions.h>
 #include <systemlib/px4_macros.h>
@@ -86,12 +87,13 @@
 
 #include <drivers/device/spi.h>
 #include <drivers/device/i2c.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/device/integrator.h>
+#include <drivers/device/imu_pipeline.h>
 #include <drivers/drv_accel.h>
 #include <drivers/drv_gyro.h>
-#include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
+#include <uORB/topics/gyro_spectrum.h>
 
 #include "mpu6000.h"
 
@@ -123,7 +125,7 @@ class MPU6000 : public device::CDev
 {
 public:
 	MPU6000(device::Device *interface, const char *path_accel, const char *path_gyro, enum Rotation rotation,
-		int device_type);
+		int device_type, unsigned fifo_samples, bool dynamic_notch);
 	virtual ~MPU6000();
 
 	virtual int		init();
@@ -176,7 +178,7 @@ private:
 	struct hrt_call		_call;
 	unsigned		_call_interval;
 
-	ringbuffer::RingBuffer	*_accel_reports;
+	ringbuffer::SPSCRingBuffer	*_accel_reports;
 
 	struct accel_calibration_s	_accel_scale;
 	float			_accel_range_scale;
@@ -185,7 +187,7 @@ private:
 	int			_accel_orb_class_instance;
 	int			_accel_class_instance;
 
-	ringbuffer::RingBuffer	*_gyro_reports;
+	ringbuffer::SPSCRingBuffer	*_gyro_reports;
 
 	struct gyro_calibration_s	_gyro_scale;
 	float			_gyro_range_scale;
@@ -202,25 +204,39 @@ private:
 	perf_counter_t		_duplicates;
 	perf_counter_t		_controller_latency_perf;
 
+	// FIFO mode: drain _fifo_samples samples per measure() in one burst
+	unsigned		_fifo_samples;
+	struct MPUFIFOReport	_fifo_report;
+	hrt_abstime		_fifo_last_read;
+	perf_counter_t		_fifo_sample_perf;
+	perf_counter_t		_fifo_overflows;
+	perf_counter_t		_fifo_missed;
+
 	uint8_t			_register_wait;
 	uint64_t		_reset_wait;
 
-	math::LowPassFilter2p	_accel_filter_x;
-	math::LowPassFilter2p	_accel_filter_y;
-	math::LowPassFilter2p	_accel_filter_z;
-	math::LowPassFilter2p	_gyro_filter_x;
-	math::LowPassFilter2p	_gyro_filter_y;
-	math::LowPassFilter2p	_gyro_filter_z;
+	IMUPipeline<accel_report>	_accel_pipeline;
+	IMUPipeline<gyro_report>	_gyro_pipeline;
 
-	Integrator		_accel_int;
-	Integrator		_gyro_int;
+	// dynamic notch on the gyro, its spectrum is published for tuning
+	bool			_dynamic_notch;
+	orb_advert_t		_spectrum_topic;
+	int			_spectrum_orb_class_instance;
 
-	enum Rotation		_rotation;
+	/**
+	 * (Re)configure the gyro dynamic notch for a new sample rate.
+	 */
+	void			update_dynamic_notch(float sample_rate);
+
+	/**
+	 * Publish the gyro spectrum if the notch analysis produced a new one.
+	 */
+	void			publish_spectrum(hrt_abstime timestamp);
 
 	// this is used to support runtime checking of key
 	// configuration registers to detect SPI bus errors and sensor
 	// reset
-#define MPU6000_NUM_CHECKED_REGISTERS 10
+#define MPU6000_NUM_CHECKED_REGISTERS 11
 	static const uint8_t	_checked_registers[MPU6000_NUM_CHECKED_REGISTERS];
 	uint8_t			_checked_values[MPU6000_NUM_CHECKED_REGISTERS];
 	uint8_t			_checked_next;
@@ -236,6 +252,16 @@ private:
 	uint16_t		_last_accel[3];
 	bool			_got_duplicate;
 
+	struct Report {
+		int16_t		accel_x;
+		int16_t		accel_y;
+		int16_t		accel_z;
+		int16_t		temp;
+		int16_t		gyro_x;
+		int16_t		gyro_y;
+		int16_t		gyro_z;
+	};
+
 	/**
 	 * Start automatic measurement.
 	 */
@@ -262,6 +288,11 @@ private:
 	 */
 	bool 		is_mpu_device() { return _device_type == 6000;}
 
+	/**
+	 * size of the sensor FIFO in bytes
+	 */
+	unsigned	fifo_size() { return is_icm_device() ? ICM20608_FIFO_SIZE : MPU6000_FIFO_SIZE; }
+
 
 #if defined(USE_I2C)
 	/**
@@ -311,6 +342,30 @@ private:
 	 */
 	int			measure();
 
+	/**
+	 * Drain the sensor FIFO in a single burst transfer and process
+	 * every sample in it.
+	 */
+	int			measure_fifo();
+
+	/**
+	 * Discard the content of the sensor FIFO.
+	 */
+	void			fifo_reset();
+
+	/**
+	 * Scale, filter and integrate one raw sample and publish the result.
+	 *
+	 * @param report	The raw sample in sensor axes.
+	 * @param timestamp	The time the sample was taken.
+	 */
+	void			process_report(Report &report, hrt_abstime timestamp);
+
+	/**
+	 * Interval between two measure() calls in microseconds.
+	 */
+	unsigned		measure_interval();
+
 	/**
 	 * Read a register from the MPU6000
 	 *
@@ -427,7 +482,8 @@ const uint8_t MPU6000::_checked_registers[MPU6000_NUM_CHECKED_REGISTERS] = { MPU
 									     MPUREG_ACCEL_CONFIG,
 									     MPUREG_INT_ENABLE,
 									     MPUREG_INT_PIN_CFG,
-									     MPUREG_ICM_UNDOC1
+									     MPUREG_ICM_UNDOC1,
+									     MPUREG_FIFO_EN
 									   };
 
 
@@ -466,7 +522,7 @@ private:
 extern "C" { __EXPORT int mpu6000_main(int argc, char *argv[]); }
 
 MPU6000::MPU6000(device::Device *interface, const char *path_accel, const char *path_gyro, enum Rotation rotation,
-		 int device_type) :
+		 int device_type, unsigned fifo_samples, bool dynamic_notch) :
 	CDev("MPU6000", path_accel),
 	_interface(interface),
 	_device_type(device_type),
@@ -499,17 +555,21 @@ MPU6000::MPU6000(device::Device *interface, const char *path_accel, const char *
 	_reset_retries(perf_alloc(PC_COUNT, "mpu6k_reset")),
 	_duplicates(perf_alloc(PC_COUNT, "mpu6k_duplicates")),
 	_controller_latency_perf(perf_alloc_once(PC_ELAPSED, "ctrl_latency")),
+	_fifo_samples(fifo_samples),
+	_fifo_report{},
+	_fifo_last_read(0),
+	_fifo_sample_perf(perf_alloc(PC_ELAPSED, "mpu6k_fifo_sample")),
+	_fifo_overflows(perf_alloc(PC_COUNT, "mpu6k_fifo_oflow")),
+	_fifo_missed(perf_alloc(PC_COUNT, "mpu6k_fifo_missed")),
 	_register_wait(0),
 	_reset_wait(0),
-	_accel_filter_x(MPU6000_ACCEL_DEFAULT_RATE, MPU6000_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_y(MPU6000_ACCEL_DEFAULT_RATE, MPU6000_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_z(MPU6000_ACCEL_DEFAULT_RATE, MPU6000_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_x(MPU6000_GYRO_DEFAULT_RATE, MPU6000_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_y(MPU6000_GYRO_DEFAULT_RATE, MPU6000_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_z(MPU6000_GYRO_DEFAULT_RATE, MPU6000_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_int(1000000 / MPU6000_ACCEL_MAX_OUTPUT_RATE),
-	_gyro_int(1000000 / MPU6000_GYRO_MAX_OUTPUT_RATE, true),
-	_rotation(rotation),
+	_accel_pipeline(MPU6000_ACCEL_DEFAULT_RATE, MPU6000_ACCEL_DEFAULT_DRIVER_FILTER_FREQ,
+			1000000 / MPU6000_ACCEL_MAX_OUTPUT_RATE),
+	_gyro_pipeline(MPU6000_GYRO_DEFAULT_RATE, MPU6000_GYRO_DEFAULT_DRIVER_FILTER_FREQ,
+		       1000000 / MPU6000_GYRO_MAX_OUTPUT_RATE, true),
+	_dynamic_notch(dynamic_notch),
+	_spectrum_topic(nullptr),
+	_spectrum_orb_class_instance(-1),
 	_checked_next(0),
 	_in_factory_test(false),
 	_last_temperature(0),
@@ -545,6 +605,9 @@ MPU6000::MPU6000(device::Device *interface, const char *path_accel, const char *
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
 
+	_accel_pipeline.set_rotation(rotation);
+	_gyro_pipeline.set_rotation(rotation);
+
 	memset(&_call, 0, sizeof(_call));
 }
 
@@ -569,6 +632,10 @@ MPU6000::~MPU6000()
 		unregister_class_devname(ACCEL_BASE_DEVICE_PATH, _accel_class_instance);
 	}
 
+	if (_spectrum_topic != nullptr) {
+		orb_unadvertise(_spectrum_topic);
+	}
+
 	/* delete the perf counter */
 	perf_free(_sample_perf);
 	perf_free(_accel_reads);
@@ -578,6 +645,9 @@ MPU6000::~MPU6000()
 	perf_free(_good_transfers);
 	perf_free(_reset_retries);
 	perf_free(_duplicates);
+	perf_free(_fifo_sample_perf);
+	perf_free(_fifo_overflows);
+	perf_free(_fifo_missed);
 }
 
 int
@@ -614,13 +684,13 @@ MPU6000::init()
 
 	ret = -ENOMEM;
 	/* allocate basic report buffers */
-	_accel_reports = new ringbuffer::RingBuffer(2, sizeof(accel_report));
+	_accel_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(accel_report));
 
 	if (_accel_reports == nullptr) {
 		goto out;
 	}
 
-	_gyro_reports = new ringbuffer::RingBuffer(2, sizeof(gyro_report));
+	_gyro_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(gyro_report));
 
 	if (_gyro_reports == nullptr) {
 		goto out;
@@ -647,6 +717,9 @@ MPU6000::init()
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
 
+	_accel_pipeline.set_calibration(_accel_scale);
+	_gyro_pipeline.set_calibration(_gyro_scale);
+
 
 	/* do CDev init for the gyro device node, keep it optional */
 	ret = _gyro->init();
@@ -659,6 +732,11 @@ MPU6000::init()
 
 	_accel_class_instance = register_class_devname(ACCEL_BASE_DEVICE_PATH);
 
+	if (_fifo_samples > 0) {
+		/* the FIFO was just reset, let it collect a few samples */
+		usleep(3 * 1000000 / _sample_rate);
+	}
+
 	measure();
 
 	/* advertise sensor topic, measure manually to initialize valid report */
@@ -685,6 +763,18 @@ MPU6000::init()
 		warnx("ADVERT FAIL");
 	}
 
+	if (_dynamic_notch) {
+		/* advertise here, the spectrum is published from interrupt context */
+		struct gyro_spectrum_s spectrum = {};
+		spectrum.device_id = _gyro->_device_id.devid;
+		_spectrum_topic = orb_advertise_multi(ORB_ID(gyro_spectrum), &spectrum,
+						      &_spectrum_orb_class_instance, ORB_PRIO_DEFAULT);
+
+		if (_spectrum_topic == nullptr) {
+			warnx("ADVERT FAIL");
+		}
+	}
+
 out:
 	return ret;
 }
@@ -754,6 +844,7 @@ int MPU6000::reset()
 	// scaling factor:
 	// 1/(2^15)*(2000/180)*PI
 	_gyro_range_scale = (0.0174532 / 16.4);//1.0f / (32768.0f * (2000.0f / 180.0f) * M_PI_F);
+	_gyro_pipeline.set_range_scale(_gyro_range_scale);
 	_gyro_range_rad_s = (2000.0f / 180.0f) * M_PI_F;
 
 	set_accel_range(8);
@@ -770,6 +861,17 @@ int MPU6000::reset()
 		write_checked_reg(MPUREG_ICM_UNDOC1, MPUREG_ICM_UNDOC1_VALUE);
 	}
 
+	// FIFO: accel, temperature and gyro in register order, so every
+	// sample has the layout of the sensor registers
+	if (_fifo_samples > 0) {
+		write_checked_reg(MPUREG_FIFO_EN, BITS_FIFO_EN_TEMP_GYRO_ACCEL);
+		write_checked_reg(MPUREG_USER_CTRL, read_reg(MPUREG_USER_CTRL) | BIT_USER_CTRL_FIFO_EN);
+		fifo_reset();
+
+	} else {
+		write_checked_reg(MPUREG_FIFO_EN, 0);
+	}
+
 	// Oscillator set
 	// write_reg(MPUREG_PWR_MGMT_1,MPU_CLK_SEL_PLLGYROZ);
 	usleep(1000);
@@ -836,6 +938,11 @@ MPU6000::_set_sample_rate(unsigned desired_sample_rate_hz)
 
 	write_checked_reg(MPUREG_SMPLRT_DIV, div - 1);
 	_sample_rate = 1000 / div;
+
+	if (_fifo_samples > 0 && _call_interval != 0) {
+		/* keep draining the same number of samples per read */
+		_call.period = measure_interval();
+	}
 }
 
 /*
@@ -905,16 +1012,7 @@ MPU6000::read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	accel_report *arp = reinterpret_cast<accel_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_accel_reports->get(arp)) {
-			break;
-		}
-
-		transferred++;
-		arp++;
-	}
+	int transferred = _accel_reports->get_n(arp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(accel_report));
@@ -1223,16 +1321,7 @@ MPU6000::gyro_read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	gyro_report *grp = reinterpret_cast<gyro_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_gyro_reports->get(grp)) {
-			break;
-		}
-
-		transferred++;
-		grp++;
-	}
+	int transferred = _gyro_reports->get_n(grp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(gyro_report));
@@ -1273,9 +1362,6 @@ MPU6000::ioctl(struct file *filp, int cmd, unsigned long arg)
 
 			/* adjust to a legal polling interval in Hz */
 			default: {
-					/* do we need to start internal polling? */
-					bool want_start = (_call_interval == 0);
-
 					/* convert hz to hrt interval via microseconds */
 					unsigned ticks = 1000000 / arg;
 
@@ -1284,20 +1370,20 @@ MPU6000::ioctl(struct file *filp, int cmd, unsigned long arg)
 						return -EINVAL;
 					}
 
-					// adjust filters
-					float cutoff_freq_hz = _accel_filter_x.get_cutoff_freq();
-					float sample_rate = 1.0e6f / ticks;
+					/* measure() must not run the filters while they are reconfigured */
+					stop();
+
+					// adjust filters, in FIFO mode they see every sensor sample
+					float cutoff_freq_hz = _accel_pipeline.get_cutoff_freq();
+					float sample_rate = (_fifo_samples > 0) ? _sample_rate : 1.0e6f / ticks;
 					_set_dlpf_filter(cutoff_freq_hz);
-					_accel_filter_x.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
-					_accel_filter_y.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
-					_accel_filter_z.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
+					_accel_pipeline.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
 
 
-					float cutoff_freq_hz_gyro = _gyro_filter_x.get_cutoff_freq();
+					float cutoff_freq_hz_gyro = _gyro_pipeline.get_cutoff_freq();
 					_set_dlpf_filter(cutoff_freq_hz_gyro);
-					_gyro_filter_x.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
-					_gyro_filter_y.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
-					_gyro_filter_z.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
+					_gyro_pipeline.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
+					update_dynamic_notch(sample_rate);
 
 					/* update interval for next measurement */
 					/* XXX this is a bit shady, but no other way to adjust... */
@@ -1314,13 +1400,11 @@ MPU6000::ioctl(struct file *filp, int cmd, unsigned long arg)
 					if (!is_i2c())
 #endif
 					{
-						_call.period = _call_interval - MPU6000_TIMER_REDUCTION;
+						_call.period = measure_interval();
 					}
 
-					/* if we need to start the poll state machine, do it */
-					if (want_start) {
-						start();
-					}
+					/* (re)start the poll state machine */
+					start();
 
 					return OK;
 				}
@@ -1363,15 +1447,13 @@ MPU6000::ioctl(struct file *filp, int cmd, unsigned long arg)
 		return OK;
 
 	case ACCELIOCGLOWPASS:
-		return _accel_filter_x.get_cutoff_freq();
+		return _accel_pipeline.get_cutoff_freq();
 
 	case ACCELIOCSLOWPASS:
 		// set hardware filtering
 		_set_dlpf_filter(arg);
 		// set software filtering
-		_accel_filter_x.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_accel_filter_y.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_accel_filter_z.set_cutoff_frequency(1.0e6f / _call_interval, arg);
+		_accel_pipeline.set_cutoff_frequency(1.0e6f / _call_interval, arg);
 		return OK;
 
 	case ACCELIOCSSCALE: {
@@ -1381,6 +1463,7 @@ MPU6000::ioctl(struct file *filp, int cmd, unsigned long arg)
 
 			if (sum > 2.0f && sum < 4.0f) {
 				memcpy(&_accel_scale, s, sizeof(_accel_scale));
+				_accel_pipeline.set_calibration(_accel_scale);
 				return OK;
 
 			} else {
@@ -1456,19 +1539,18 @@ MPU6000::gyro_ioctl(struct file *filp, int cmd, unsigned long arg)
 		return OK;
 
 	case GYROIOCGLOWPASS:
-		return _gyro_filter_x.get_cutoff_freq();
+		return _gyro_pipeline.get_cutoff_freq();
 
 	case GYROIOCSLOWPASS:
 		// set hardware filtering
 		_set_dlpf_filter(arg);
-		_gyro_filter_x.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_gyro_filter_y.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_gyro_filter_z.set_cutoff_frequency(1.0e6f / _call_interval, arg);
+		_gyro_pipeline.set_cutoff_frequency(1.0e6f / _call_interval, arg);
 		return OK;
 
 	case GYROIOCSSCALE:
 		/* copy scale in */
 		memcpy(&_gyro_scale, (struct gyro_calibration_s *) arg, sizeof(_gyro_scale));
+		_gyro_pipeline.set_calibration(_gyro_scale);
 		return OK;
 
 	case GYROIOCGSCALE:
@@ -1572,6 +1654,7 @@ MPU6000::set_accel_range(unsigned max_g_in)
 	case MPU6000_REV_C5:
 		write_checked_reg(MPUREG_ACCEL_CONFIG, 1 << 3);
 		_accel_range_scale = (MPU6000_ONE_G / 4096.0f);
+		_accel_pipeline.set_range_scale(_accel_range_scale);
 		_accel_range_m_s2 = 8.0f * MPU6000_ONE_G;
 		return OK;
 	}
@@ -1603,6 +1686,7 @@ MPU6000::set_accel_range(unsigned max_g_in)
 
 	write_checked_reg(MPUREG_ACCEL_CONFIG, afs_sel << 3);
 	_accel_range_scale = (MPU6000_ONE_G / lsb_per_g);
+	_accel_pipeline.set_range_scale(_accel_range_scale);
 	_accel_range_m_s2 = max_accel_g * MPU6000_ONE_G;
 
 	return OK;
@@ -1618,6 +1702,10 @@ MPU6000::start()
 	_accel_reports->flush();
 	_gyro_reports->flush();
 
+	if (_fifo_samples > 0) {
+		fifo_reset();
+	}
+
 #if defined(USE_I2C)
 
 	if (_use_hrt) {
@@ -1625,7 +1713,7 @@ MPU6000::start()
 		/* start polling at the specified rate */
 		hrt_call_every(&_call,
 			       1000,
-			       _call_interval - MPU6000_TIMER_REDUCTION,
+			       measure_interval(),
 			       (hrt_callout)&MPU6000::measure_trampoline, this);
 #if defined(USE_I2C)
 
@@ -1687,11 +1775,22 @@ MPU6000::cycle()
 			   &_work,
 			   (worker_t)&MPU6000::cycle_trampoline,
 			   this,
-			   USEC2TICK(_call_interval - MPU6000_TIMER_REDUCTION));
+			   USEC2TICK(measure_interval()));
 	}
 }
 #endif
 
+unsigned
+MPU6000::measure_interval()
+{
+	if (_fifo_samples > 0) {
+		/* the FIFO absorbs the timing jitter, no need to run faster */
+		return _fifo_samples * 1000000 / _sample_rate;
+	}
+
+	return _call_interval - MPU6000_TIMER_REDUCTION;
+}
+
 void
 MPU6000::measure_trampoline(void *arg)
 {
@@ -1774,17 +1873,13 @@ MPU6000::measure()
 		return OK;
 	}
 
+	if (_fifo_samples > 0) {
+		return measure_fifo();
+	}
+
 	struct MPUReport mpu_report;
 
-	struct Report {
-		int16_t		accel_x;
-		int16_t		accel_y;
-		int16_t		accel_z;
-		int16_t		temp;
-		int16_t		gyro_x;
-		int16_t		gyro_y;
-		int16_t		gyro_z;
-	} report;
+	struct Report report;
 
 	/* start measuring */
 	perf_begin(_sample_perf);
@@ -1863,7 +1958,132 @@ MPU6000::measure()
 		return OK;
 	}
 
+	process_report(report, hrt_absolute_time());
+
+	/* stop measuring */
+	perf_end(_sample_perf);
+	return OK;
+}
+
+int
+MPU6000::measure_fifo()
+{
+	/* start measuring */
+	perf_begin(_sample_perf);
+
+	// FIFO count and data are read at high clock speed like the sensor registers
+	uint8_t fifo_count[2];
+
+	if (sizeof(fifo_count) != _interface->read(MPU6000_HIGH_SPEED_OP(MPUREG_FIFO_COUNTH), fifo_count,
+			sizeof(fifo_count))) {
+		return -EIO;
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+	const unsigned fifo_bytes = (fifo_count[0] << 8) | fifo_count[1];
+	const unsigned sample_interval = 1000000 / _sample_rate;
+
+	if (fifo_bytes > fifo_size() - sizeof(MPUFIFOSample)) {
+		/*
+		  the FIFO overflowed: samples were lost and the content
+		  is not sample aligned anymore. Estimate how many samples
+		  we missed from the time since the last read and start over.
+		 */
+		unsigned expected = (now - _fifo_last_read) / sample_interval;
+		unsigned stored = fifo_bytes / sizeof(MPUFIFOSample);
+
+		if (_fifo_last_read != 0 && expected > stored) {
+			perf_set_count(_fifo_missed, perf_event_count(_fifo_missed) + expected - stored);
+		}
 
+		perf_count(_fifo_overflows);
+		fifo_reset();
+		_fifo_last_read = now;
+		perf_end(_sample_perf);
+		return OK;
+	}
+
+	const unsigned samples = fifo_bytes / sizeof(MPUFIFOSample);
+
+	/*
+	  a burst must be at least sizeof(MPUReport) long for the
+	  interface to treat it as a sensor transfer, so a single sample
+	  is left for the next call
+	 */
+	if (samples < 2) {
+		perf_end(_sample_perf);
+		return OK;
+	}
+
+	const unsigned count = samples > MPU6000_FIFO_MAX_SAMPLES ? MPU6000_FIFO_MAX_SAMPLES : samples;
+	const int transfer_size = offsetof(MPUFIFOReport, samples) + count * sizeof(MPUFIFOSample);
+
+	if (transfer_size != _interface->read(MPU6000_HIGH_SPEED_OP(MPUREG_FIFO_R_W), (uint8_t *)&_fifo_report,
+					      transfer_size)) {
+		return -EIO;
+	}
+
+	_fifo_last_read = now;
+
+	check_registers();
+
+	for (unsigned i = 0; i < count; i++) {
+		MPUFIFOSample &sample = _fifo_report.samples[i];
+		struct Report report;
+
+		report.accel_x = int16_t_from_bytes(sample.accel_x);
+		report.accel_y = int16_t_from_bytes(sample.accel_y);
+		report.accel_z = int16_t_from_bytes(sample.accel_z);
+
+		report.temp = int16_t_from_bytes(sample.temp);
+
+		report.gyro_x = int16_t_from_bytes(sample.gyro_x);
+		report.gyro_y = int16_t_from_bytes(sample.gyro_y);
+		report.gyro_z = int16_t_from_bytes(sample.gyro_z);
+
+		if (report.accel_x == 0 &&
+		    report.accel_y == 0 &&
+		    report.accel_z == 0 &&
+		    report.temp == 0 &&
+		    report.gyro_x == 0 &&
+		    report.gyro_y == 0 &&
+		    report.gyro_z == 0) {
+			// all zero data - probably a SPI bus error, the rest
+			// of the FIFO can't be trusted either
+			perf_count(_bad_transfers);
+			fifo_reset();
+			perf_end(_sample_perf);
+			return -EIO;
+		}
+
+		perf_count(_good_transfers);
+
+		if (_register_wait != 0) {
+			_register_wait--;
+			continue;
+		}
+
+		/* samples still in the FIFO are newer than the ones we read */
+		perf_begin(_fifo_sample_perf);
+		process_report(report, now - (samples - 1 - i) * sample_interval);
+		perf_end(_fifo_sample_perf);
+	}
+
+	/* stop measuring */
+	perf_end(_sample_perf);
+	return OK;
+}
+
+void
+MPU6000::fifo_reset()
+{
+	// the reset bit clears itself, keep it out of the checked value
+	modify_reg(MPUREG_USER_CTRL, 0, BIT_USER_CTRL_FIFO_RESET);
+}
+
+void
+MPU6000::process_report(Report &report, hrt_abstime timestamp)
+{
 	/*
 	 * Swap axes and negate y
 	 */
@@ -1887,11 +2107,6 @@ MPU6000::measure()
 	accel_report	arb;
 	gyro_report		grb;
 
-	/*
-	 * Adjust and scale results to m/s^2.
-	 */
-	grb.timestamp = arb.timestamp = hrt_absolute_time();
-
 	// report the error count as the sum of the number of bad
 	// transfers and bad register reads. This allows the higher
 	// level code to decide if it should use this sensor based on
@@ -1899,51 +2114,16 @@ MPU6000::measure()
 	grb.error_count = arb.error_count = perf_event_count(_bad_transfers) + perf_event_count(_bad_registers);
 
 	/*
-	 * 1) Scale raw value to SI units using scaling from datasheet.
-	 * 2) Subtract static offset (in SI units)
-	 * 3) Scale the statically calibrated values with a linear
-	 *    dynamically obtained factor
-	 *
-	 * Note: the static sensor offset is the number the sensor outputs
-	 * 	 at a nominally 'zero' input. Therefore the offset has to
-	 * 	 be subtracted.
-	 *
-	 *	 Example: A gyro outputs a value of 74 at zero angular rate
-	 *	 	  the offset is 74 from the origin and subtracting
-	 *		  74 from all measurements centers them around zero.
+	 * The pipelines rotate, scale to SI units, apply the calibration,
+	 * filter and integrate. The static sensor offset is the number the
+	 * sensor outputs at a nominally 'zero' input, so it is subtracted
+	 * after scaling.
 	 */
 
-
 	/* NOTE: Axes have been swapped to match the board a few lines above. */
 
-	arb.x_raw = report.accel_x;
-	arb.y_raw = report.accel_y;
-	arb.z_raw = report.accel_z;
-
-	float xraw_f = report.accel_x;
-	float yraw_f = report.accel_y;
-	float zraw_f = report.accel_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float x_in_new = ((xraw_f * _accel_range_scale) - _accel_scale.x_offset) * _accel_scale.x_scale;
-	float y_in_new = ((yraw_f * _accel_range_scale) - _accel_scale.y_offset) * _accel_scale.y_scale;
-	float z_in_new = ((zraw_f * _accel_range_scale) - _accel_scale.z_offset) * _accel_scale.z_scale;
-
-	arb.x = _accel_filter_x.apply(x_in_new);
-	arb.y = _accel_filter_y.apply(y_in_new);
-	arb.z = _accel_filter_z.apply(z_in_new);
-
-	math::Vector<3> aval(x_in_new, y_in_new, z_in_new);
-	math::Vector<3> aval_integrated;
+	bool accel_notify = _accel_pipeline.put(timestamp, report.accel_x, report.accel_y, report.accel_z, arb);
 
-	bool accel_notify = _accel_int.put(arb.timestamp, aval, aval_integrated, arb.integral_dt);
-	arb.x_integral = aval_integrated(0);
-	arb.y_integral = aval_integrated(1);
-	arb.z_integral = aval_integrated(2);
-
-	arb.scaling = _accel_range_scale;
 	arb.range_m_s2 = _accel_range_m_s2;
 
 	if (is_icm_device()) { // if it is an ICM20608
@@ -1956,34 +2136,8 @@ MPU6000::measure()
 	arb.temperature_raw = report.temp;
 	arb.temperature = _last_temperature;
 
-	grb.x_raw = report.gyro_x;
-	grb.y_raw = report.gyro_y;
-	grb.z_raw = report.gyro_z;
-
-	xraw_f = report.gyro_x;
-	yraw_f = report.gyro_y;
-	zraw_f = report.gyro_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float x_gyro_in_new = ((xraw_f * _gyro_range_scale) - _gyro_scale.x_offset) * _gyro_scale.x_scale;
-	float y_gyro_in_new = ((yraw_f * _gyro_range_scale) - _gyro_scale.y_offset) * _gyro_scale.y_scale;
-	float z_gyro_in_new = ((zraw_f * _gyro_range_scale) - _gyro_scale.z_offset) * _gyro_scale.z_scale;
-
-	grb.x = _gyro_filter_x.apply(x_gyro_in_new);
-	grb.y = _gyro_filter_y.apply(y_gyro_in_new);
-	grb.z = _gyro_filter_z.apply(z_gyro_in_new);
-
-	math::Vector<3> gval(x_gyro_in_new, y_gyro_in_new, z_gyro_in_new);
-	math::Vector<3> gval_integrated;
+	bool gyro_notify = _gyro_pipeline.put(timestamp, report.gyro_x, report.gyro_y, report.gyro_z, grb);
 
-	bool gyro_notify = _gyro_int.put(arb.timestamp, gval, gval_integrated, grb.integral_dt);
-	grb.x_integral = gval_integrated(0);
-	grb.y_integral = gval_integrated(1);
-	grb.z_integral = gval_integrated(2);
-
-	grb.scaling = _gyro_range_scale;
 	grb.range_rad_s = _gyro_range_rad_s;
 
 	grb.temperature_raw = report.temp;
@@ -2011,11 +2165,52 @@ MPU6000::measure()
 	if (gyro_notify && !(_pub_blocked)) {
 		/* publish it */
 		orb_publish(ORB_ID(sensor_gyro), _gyro->_gyro_topic, &grb);
+		latency_trace_stamp(LATENCY_TRACE_IMU, grb.timestamp);
 	}
 
-	/* stop measuring */
-	perf_end(_sample_perf);
-	return OK;
+	publish_spectrum(timestamp);
+}
+
+void
+MPU6000::update_dynamic_notch(float sample_rate)
+{
+	if (!_dynamic_notch) {
+		return;
+	}
+
+	/* keep the searched band below the Nyquist frequency of the gyro samples */
+	float max_freq = fminf(MPU6000_NOTCH_MAX_FREQ, 0.45f * sample_rate);
+
+	if (max_freq <= MPU6000_NOTCH_MIN_FREQ) {
+		warnx("sample rate too low for the dynamic notch");
+		return;
+	}
+
+	if (!_gyro_pipeline.enable_dynamic_notch(sample_rate, MPU6000_NOTCH_MIN_FREQ, max_freq, MPU6000_NOTCH_Q)) {
+		warnx("dynamic notch alloc failed");
+	}
+}
+
+void
+MPU6000::publish_spectrum(hrt_abstime timestamp)
+{
+	math::DynamicNotch *notch = _gyro_pipeline.dynamic_notch();
+
+	if (notch == nullptr || _spectrum_topic == nullptr || !notch->spectrum_updated() || _pub_blocked) {
+		return;
+	}
+
+	struct gyro_spectrum_s spectrum;
+
+	spectrum.timestamp = timestamp;
+	spectrum.device_id = _gyro->_device_id.devid;
+	spectrum.bin_count = notch->get_spectrum(spectrum.magnitude, spectrum.start_freq, spectrum.resolution,
+			     spectrum.sample_rate);
+	spectrum.peak_freq = notch->get_peak_freq();
+	spectrum.peak_snr = notch->get_peak_snr();
+	spectrum.notch_freq = notch->get_notch_freq();
+
+	orb_publish(ORB_ID(gyro_spectrum), _spectrum_topic, &spectrum);
 }
 
 void
@@ -2029,6 +2224,21 @@ MPU6000::print_info()
 	perf_print_counter(_good_transfers);
 	perf_print_counter(_reset_retries);
 	perf_print_counter(_duplicates);
+
+	if (_fifo_samples > 0) {
+		::printf("fifo: %u samples per read at %u Hz\n", _fifo_samples, _sample_rate);
+		perf_print_counter(_fifo_sample_perf);
+		perf_print_counter(_fifo_overflows);
+		perf_print_counter(_fifo_missed);
+	}
+
+	math::DynamicNotch *notch = _gyro_pipeline.dynamic_notch();
+
+	if (notch != nullptr) {
+		::printf("dynamic notch: %.1f Hz, peak %.1f Hz snr %.1f\n", (double)notch->get_notch_freq(),
+			 (double)notch->get_peak_freq(), (double)notch->get_peak_snr());
+	}
+
 	_accel_reports->print_info("accel queue");
 	_gyro_reports->print_info("gyro queue");
 	::printf("checked_next: %u\n", _checked_next);
@@ -2163,8 +2373,10 @@ struct mpu6000_bus_option {
 #define NUM_BUS_OPTIONS (sizeof(bus_options)/sizeof(bus_options[0]))
 
 
-void	start(enum MPU6000_BUS busid, enum Rotation rotation, int range, int device_type, bool external);
-bool 	start_bus(struct mpu6000_bus_option &bus, enum Rotation rotation, int range, int device_type, bool external);
+void	start(enum MPU6000_BUS busid, enum Rotation rotation, int range, int device_type, bool external,
+	      unsigned fifo_samples, bool dynamic_notch);
+bool 	start_bus(struct mpu6000_bus_option &bus, enum Rotation rotation, int range, int device_type, bool external,
+		  unsigned fifo_samples, bool dynamic_notch);
 void	stop(enum MPU6000_BUS busid);
 void	test(enum MPU6000_BUS busid);
 static struct mpu6000_bus_option &find_bus(enum MPU6000_BUS busid);
@@ -2194,7 +2406,8 @@ struct mpu6000_bus_option &find_bus(enum MPU6000_BUS busid)
  * start driver for a specific bus option
  */
 bool
-start_bus(struct mpu6000_bus_option &bus, enum Rotation rotation, int range, int device_type, bool external)
+start_bus(struct mpu6000_bus_option &bus, enum Rotation rotation, int range, int device_type, bool external,
+	  unsigned fifo_samples, bool dynamic_notch)
 {
 	int fd = -1;
 
@@ -2203,6 +2416,12 @@ start_bus(struct mpu6000_bus_option &bus, enum Rotation rotation, int range, int
 		return false;
 	}
 
+	/* the FIFO burst read relies on the SPI transfer layout of MPUFIFOReport */
+	if (fifo_samples > 0 && (bus.busid == MPU6000_BUS_I2C_INTERNAL || bus.busid == MPU6000_BUS_I2C_EXTERNAL)) {
+		warnx("FIFO mode (-F) is not supported on I2C");
+		return false;
+	}
+
 	device::Device *interface = bus.interface_constructor(bus.busnum, device_type, external);
 
 	if (interface == nullptr) {
@@ -2216,7 +2435,8 @@ start_bus(struct mpu6000_bus_option &bus, enum Rotation rotation, int range, int
 		return false;
 	}
 
-	bus.dev = new MPU6000(interface, bus.accelpath, bus.gyropath, rotation, device_type);
+	bus.dev = new MPU6000(interface, bus.accelpath, bus.gyropath, rotation, device_type, fifo_samples,
+			      dynamic_notch);
 
 	if (bus.dev == nullptr) {
 		delete interface;
@@ -2268,7 +2488,8 @@ fail:
  * or failed to detect the sensor.
  */
 void
-start(enum MPU6000_BUS busid, enum Rotation rotation, int range, int device_type, bool external)
+start(enum MPU6000_BUS busid, enum Rotation rotation, int range, int device_type, bool external,
+      unsigned fifo_samples, bool dynamic_notch)
 {
 
 	bool started = false;
@@ -2284,7 +2505,7 @@ start(enum MPU6000_BUS busid, enum Rotation rotation, int range, int device_type
 			continue;
 		}
 
-		started |= start_bus(bus_options[i], rotation, range, device_type, external);
+		started |= start_bus(bus_options[i], rotation, range, device_type, external, fifo_samples, dynamic_notch);
 	}
 
 	exit(started ? 0 : 1);
@@ -2503,6 +2724,8 @@ usage()
 	warnx("    -T 6000|20608 (default 6000)");
 	warnx("    -R rotation");
 	warnx("    -a accel range (in g)");
+	warnx("    -F samples per read from the sensor FIFO (%u-%u, default 0: no FIFO), SPI only", 2, MPU6000_FIFO_MAX_SAMPLES);
+	warnx("    -N    (dynamic gyro notch, %u-%u Hz)", MPU6000_NOTCH_MIN_FREQ, MPU6000_NOTCH_MAX_FREQ);
 }
 
 } // namespace
@@ -2516,9 +2739,11 @@ mpu6000_main(int argc, char *argv[])
 	bool external = false;
 	enum Rotation rotation = ROTATION_NONE;
 	int accel_range = 8;
+	unsigned fifo_samples = 0;
+	bool dynamic_notch = false;
 
 	/* jump over start/off/etc and look at options first */
-	while ((ch = getopt(argc, argv, "T:XISsR:a:")) != EOF) {
+	while ((ch = getopt(argc, argv, "T:XISsR:a:F:N")) != EOF) {
 		switch (ch) {
 		case 'X':
 			busid = MPU6000_BUS_I2C_EXTERNAL;
@@ -2548,6 +2773,20 @@ mpu6000_main(int argc, char *argv[])
 			accel_range = atoi(optarg);
 			break;
 
+		case 'F':
+			fifo_samples = atoi(optarg);
+
+			if (fifo_samples < 2 || fifo_samples > MPU6000_FIFO_MAX_SAMPLES) {
+				mpu6000::usage();
+				exit(1);
+			}
+
+			break;
+
+		case 'N':
+			dynamic_notch = true;
+			break;
+
 		default:
 			mpu6000::usage();
 			exit(0);
@@ -2563,7 +2802,7 @@ mpu6000_main(int argc, char *argv[])
 
 	 */
 	if (!strcmp(verb, "start")) {
-		mpu6000::start(busid, rotation, accel_range, device_type, external);
+		mpu6000::start(busid, rotation, accel_range, device_type, external, fifo_samples, dynamic_notch);
 	}
 
 	if (!strcmp(verb, "stop")) {
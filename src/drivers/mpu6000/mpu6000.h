@@ -118,6 +118,9 @@
 #define BIT_RAW_RDY_EN			0x01
 #define BIT_I2C_IF_DIS			0x10
 #define BIT_INT_STATUS_DATA		0x01
+#define BIT_USER_CTRL_FIFO_EN		0x40
+#define BIT_USER_CTRL_FIFO_RESET	0x04
+#define BITS_FIFO_EN_TEMP_GYRO_ACCEL	0xF8
 
 #define MPU_WHOAMI_6000			0x68
 #define ICM_WHOAMI_20608		0xaf
@@ -166,8 +169,17 @@
 
 #define MPU6000_DEFAULT_ONCHIP_FILTER_FREQ			42
 
+/* dynamic gyro notch, searched band and quality */
+#define MPU6000_NOTCH_MIN_FREQ			80
+#define MPU6000_NOTCH_MAX_FREQ			400
+#define MPU6000_NOTCH_Q				3
+
 #define MPU6000_ONE_G					9.80665f
 
+#define MPU6000_FIFO_SIZE				1024
+#define ICM20608_FIFO_SIZE				512
+#define MPU6000_FIFO_MAX_SAMPLES		16
+
 #ifdef PX4_SPI_BUS_EXT
 #define EXTERNAL_BUS PX4_SPI_BUS_EXT
 #else
@@ -192,6 +204,30 @@ struct MPUReport {
 	uint8_t		gyro_y[2];
 	uint8_t		gyro_z[2];
 };
+
+/**
+ * One sample as the MPU6000 stores it in the FIFO with accel,
+ * temperature and gyro enabled.
+ */
+struct MPUFIFOSample {
+	uint8_t		accel_x[2];
+	uint8_t		accel_y[2];
+	uint8_t		accel_z[2];
+	uint8_t		temp[2];
+	uint8_t		gyro_x[2];
+	uint8_t		gyro_y[2];
+	uint8_t		gyro_z[2];
+};
+
+/**
+ * FIFO burst transfer, including the command byte. Like MPUReport the
+ * interfaces treat it as a sensor transfer as long as it is at least
+ * sizeof(MPUReport) long, i.e. it holds two or more samples.
+ */
+struct MPUFIFOReport {
+	uint8_t		cmd;
+	MPUFIFOSample	samples[MPU6000_FIFO_MAX_SAMPLES];
+};
 #pragma pack(pop)
 
 #define MPU_MAX_READ_BUFFER_SIZE (sizeof(MPUReport) + 1)
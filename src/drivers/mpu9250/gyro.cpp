@@ -57,12 +57,12 @@
 #include <drivers/drv_hrt.h>
 
 #include <drivers/device/spi.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/device/integrator.h>
+#include <drivers/device/imu_pipeline.h>
 #include <drivers/drv_accel.h>
 #include <drivers/drv_gyro.h>
 #include <drivers/drv_mag.h>
-#include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
 
 #include "mag.h"
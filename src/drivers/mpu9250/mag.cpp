@@ -56,12 +56,12 @@
 #include <drivers/drv_hrt.h>
 
 #include <drivers/device/spi.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/device/integrator.h>
+#include <drivers/device/imu_pipeline.h>
 #include <drivers/drv_accel.h>
 #include <drivers/drv_gyro.h>
 #include <drivers/drv_mag.h>
-#include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
 
 #include "mag.h"
@@ -210,7 +210,7 @@ MPU9250_mag::init()
 		return ret;
 	}
 
-	_mag_reports = new ringbuffer::RingBuffer(2, sizeof(mag_report));
+	_mag_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(mag_report));
 
 	if (_mag_reports == nullptr) {
 		goto out;
@@ -294,7 +294,7 @@ MPU9250_mag::measure(struct ak8963_regs data)
 	#endif
 
 	/* apply user specified rotation */
-	rotate_3f(_parent->_rotation, xraw_f, yraw_f, zraw_f);
+	_parent->_rotation.rotate(xraw_f, yraw_f, zraw_f);
 
 	mrb.x = ((xraw_f * _mag_range_scale * _mag_asa_x) - _mag_scale.x_offset) * _mag_scale.x_scale;
 	mrb.y = ((yraw_f * _mag_range_scale * _mag_asa_y) - _mag_scale.y_offset) * _mag_scale.y_scale;
@@ -346,16 +346,7 @@ MPU9250_mag::read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	mag_report *mrp = reinterpret_cast<mag_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_mag_reports->get(mrp)) {
-			break;
-		}
-
-		transferred++;
-		mrp++;
-	}
+	int transferred = _mag_reports->get_n(mrp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(mag_report));
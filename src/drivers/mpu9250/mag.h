@@ -78,7 +78,7 @@ private:
 	int _mag_orb_class_instance;
 	int _mag_class_instance;
 	bool _mag_reading_data;
-	ringbuffer::RingBuffer *_mag_reports;
+	ringbuffer::SPSCRingBuffer *_mag_reports;
 	struct mag_calibration_s _mag_scale;
 	float _mag_range_scale;
 	perf_counter_t _mag_reads;
@@ -69,12 +69,12 @@
 #include <drivers/drv_hrt.h>
 
 #include <drivers/device/spi.h>
-#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
 #include <drivers/device/integrator.h>
+#include <drivers/device/imu_pipeline.h>
 #include <drivers/drv_accel.h>
 #include <drivers/drv_gyro.h>
 #include <drivers/drv_mag.h>
-#include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/conversion/rotation.h>
 
 #include "mag.h"
@@ -247,14 +247,10 @@ MPU9250::MPU9250(int bus, const char *path_accel, const char *path_gyro, const c
 	_controller_latency_perf(perf_alloc_once(PC_ELAPSED, "ctrl_latency")),
 	_register_wait(0),
 	_reset_wait(0),
-	_accel_filter_x(MPU9250_ACCEL_DEFAULT_RATE, MPU9250_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_y(MPU9250_ACCEL_DEFAULT_RATE, MPU9250_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_filter_z(MPU9250_ACCEL_DEFAULT_RATE, MPU9250_ACCEL_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_x(MPU9250_GYRO_DEFAULT_RATE, MPU9250_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_y(MPU9250_GYRO_DEFAULT_RATE, MPU9250_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_gyro_filter_z(MPU9250_GYRO_DEFAULT_RATE, MPU9250_GYRO_DEFAULT_DRIVER_FILTER_FREQ),
-	_accel_int(1000000 / MPU9250_ACCEL_MAX_OUTPUT_RATE),
-	_gyro_int(1000000 / MPU9250_GYRO_MAX_OUTPUT_RATE, true),
+	_accel_pipeline(MPU9250_ACCEL_DEFAULT_RATE, MPU9250_ACCEL_DEFAULT_DRIVER_FILTER_FREQ,
+			1000000 / MPU9250_ACCEL_MAX_OUTPUT_RATE),
+	_gyro_pipeline(MPU9250_GYRO_DEFAULT_RATE, MPU9250_GYRO_DEFAULT_DRIVER_FILTER_FREQ,
+		       1000000 / MPU9250_GYRO_MAX_OUTPUT_RATE, true),
 	_rotation(rotation),
 	_checked_next(0),
 	_last_temperature(0),
@@ -290,6 +286,9 @@ MPU9250::MPU9250(int bus, const char *path_accel, const char *path_gyro, const c
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
 
+	_accel_pipeline.set_rotation(rotation);
+	_gyro_pipeline.set_rotation(rotation);
+
 	memset(&_call, 0, sizeof(_call));
 }
 
@@ -350,13 +349,13 @@ MPU9250::init()
 	}
 
 	/* allocate basic report buffers */
-	_accel_reports = new ringbuffer::RingBuffer(2, sizeof(accel_report));
+	_accel_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(accel_report));
 
 	if (_accel_reports == nullptr) {
 		goto out;
 	}
 
-	_gyro_reports = new ringbuffer::RingBuffer(2, sizeof(gyro_report));
+	_gyro_reports = new ringbuffer::SPSCRingBuffer(2, sizeof(gyro_report));
 
 	if (_gyro_reports == nullptr) {
 		goto out;
@@ -381,6 +380,9 @@ MPU9250::init()
 	_gyro_scale.z_offset = 0;
 	_gyro_scale.z_scale  = 1.0f;
 
+	_accel_pipeline.set_calibration(_accel_scale);
+	_gyro_pipeline.set_calibration(_gyro_scale);
+
 	/* do CDev init for the gyro device node, keep it optional */
 	ret = _gyro->init();
 
@@ -461,6 +463,7 @@ int MPU9250::reset()
 	// scaling factor:
 	// 1/(2^15)*(2000/180)*PI
 	_gyro_range_scale = (0.0174532 / 16.4);//1.0f / (32768.0f * (2000.0f / 180.0f) * M_PI_F);
+	_gyro_pipeline.set_range_scale(_gyro_range_scale);
 	_gyro_range_rad_s = (2000.0f / 180.0f) * M_PI_F;
 
 	set_accel_range(16);
@@ -614,16 +617,7 @@ MPU9250::read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	accel_report *arp = reinterpret_cast<accel_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_accel_reports->get(arp)) {
-			break;
-		}
-
-		transferred++;
-		arp++;
-	}
+	int transferred = _accel_reports->get_n(arp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(accel_report));
@@ -772,16 +766,7 @@ MPU9250::gyro_read(struct file *filp, char *buffer, size_t buflen)
 
 	/* copy reports out of our buffer to the caller */
 	gyro_report *grp = reinterpret_cast<gyro_report *>(buffer);
-	int transferred = 0;
-
-	while (count--) {
-		if (!_gyro_reports->get(grp)) {
-			break;
-		}
-
-		transferred++;
-		grp++;
-	}
+	int transferred = _gyro_reports->get_n(grp, count);
 
 	/* return the number of bytes transferred */
 	return (transferred * sizeof(gyro_report));
@@ -832,19 +817,15 @@ MPU9250::ioctl(struct file *filp, int cmd, unsigned long arg)
 					}
 
 					// adjust filters
-					float cutoff_freq_hz = _accel_filter_x.get_cutoff_freq();
+					float cutoff_freq_hz = _accel_pipeline.get_cutoff_freq();
 					float sample_rate = 1.0e6f / ticks;
 					_set_dlpf_filter(cutoff_freq_hz);
-					_accel_filter_x.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
-					_accel_filter_y.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
-					_accel_filter_z.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
+					_accel_pipeline.set_cutoff_frequency(sample_rate, cutoff_freq_hz);
 
 
-					float cutoff_freq_hz_gyro = _gyro_filter_x.get_cutoff_freq();
+					float cutoff_freq_hz_gyro = _gyro_pipeline.get_cutoff_freq();
 					_set_dlpf_filter(cutoff_freq_hz_gyro);
-					_gyro_filter_x.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
-					_gyro_filter_y.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
-					_gyro_filter_z.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
+					_gyro_pipeline.set_cutoff_frequency(sample_rate, cutoff_freq_hz_gyro);
 
 					/* update interval for next measurement */
 					/* XXX this is a bit shady, but no other way to adjust... */
@@ -904,13 +885,11 @@ MPU9250::ioctl(struct file *filp, int cmd, unsigned long arg)
 		return OK;
 
 	case ACCELIOCGLOWPASS:
-		return _accel_filter_x.get_cutoff_freq();
+		return _accel_pipeline.get_cutoff_freq();
 
 	case ACCELIOCSLOWPASS:
 		// set software filtering
-		_accel_filter_x.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_accel_filter_y.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_accel_filter_z.set_cutoff_frequency(1.0e6f / _call_interval, arg);
+		_accel_pipeline.set_cutoff_frequency(1.0e6f / _call_interval, arg);
 		return OK;
 
 	case ACCELIOCSSCALE: {
@@ -920,6 +899,7 @@ MPU9250::ioctl(struct file *filp, int cmd, unsigned long arg)
 
 			if (sum > 2.0f && sum < 4.0f) {
 				memcpy(&_accel_scale, s, sizeof(_accel_scale));
+				_accel_pipeline.set_calibration(_accel_scale);
 				return OK;
 
 			} else {
@@ -1000,18 +980,17 @@ MPU9250::gyro_ioctl(struct file *filp, int cmd, unsigned long arg)
 		return OK;
 
 	case GYROIOCGLOWPASS:
-		return _gyro_filter_x.get_cutoff_freq();
+		return _gyro_pipeline.get_cutoff_freq();
 
 	case GYROIOCSLOWPASS:
 		// set software filtering
-		_gyro_filter_x.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_gyro_filter_y.set_cutoff_frequency(1.0e6f / _call_interval, arg);
-		_gyro_filter_z.set_cutoff_frequency(1.0e6f / _call_interval, arg);
+		_gyro_pipeline.set_cutoff_frequency(1.0e6f / _call_interval, arg);
 		return OK;
 
 	case GYROIOCSSCALE:
 		/* copy scale in */
 		memcpy(&_gyro_scale, (struct gyro_calibration_s *) arg, sizeof(_gyro_scale));
+		_gyro_pipeline.set_calibration(_gyro_scale);
 		return OK;
 
 	case GYROIOCGSCALE:
@@ -1145,6 +1124,7 @@ MPU9250::set_accel_range(unsigned max_g_in)
 
 	write_checked_reg(MPUREG_ACCEL_CONFIG, afs_sel << 3);
 	_accel_range_scale = (MPU9250_ONE_G / lsb_per_g);
+	_accel_pipeline.set_range_scale(_accel_range_scale);
 	_accel_range_m_s2 = max_accel_g * MPU9250_ONE_G;
 
 	return OK;
@@ -1384,10 +1364,7 @@ MPU9250::measure()
 	accel_report		arb;
 	gyro_report		grb;
 
-	/*
-	 * Adjust and scale results to m/s^2.
-	 */
-	grb.timestamp = arb.timestamp = hrt_absolute_time();
+	hrt_abstime timestamp = hrt_absolute_time();
 
 	// report the error count as the sum of the number of bad
 	// transfers and bad register reads. This allows the higher
@@ -1396,50 +1373,16 @@ MPU9250::measure()
 	grb.error_count = arb.error_count = perf_event_count(_bad_transfers) + perf_event_count(_bad_registers);
 
 	/*
-	 * 1) Scale raw value to SI units using scaling from datasheet.
-	 * 2) Subtract static offset (in SI units)
-	 * 3) Scale the statically calibrated values with a linear
-	 *    dynamically obtained factor
-	 *
-	 * Note: the static sensor offset is the number the sensor outputs
-	 * 	 at a nominally 'zero' input. Therefore the offset has to
-	 * 	 be subtracted.
-	 *
-	 *	 Example: A gyro outputs a value of 74 at zero angular rate
-	 *	 	  the offset is 74 from the origin and subtracting
-	 *		  74 from all measurements centers them around zero.
+	 * The pipelines rotate, scale to SI units, apply the calibration,
+	 * filter and integrate. The static sensor offset is the number the
+	 * sensor outputs at a nominally 'zero' input, so it is subtracted
+	 * after scaling.
 	 */
 
 	/* NOTE: Axes have been swapped to match the board a few lines above. */
 
-	arb.x_raw = report.accel_x;
-	arb.y_raw = report.accel_y;
-	arb.z_raw = report.accel_z;
-
-	float xraw_f = report.accel_x;
-	float yraw_f = report.accel_y;
-	float zraw_f = report.accel_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float x_in_new = ((xraw_f * _accel_range_scale) - _accel_scale.x_offset) * _accel_scale.x_scale;
-	float y_in_new = ((yraw_f * _accel_range_scale) - _accel_scale.y_offset) * _accel_scale.y_scale;
-	float z_in_new = ((zraw_f * _accel_range_scale) - _accel_scale.z_offset) * _accel_scale.z_scale;
-
-	arb.x = _accel_filter_x.apply(x_in_new);
-	arb.y = _accel_filter_y.apply(y_in_new);
-	arb.z = _accel_filter_z.apply(z_in_new);
-
-	math::Vector<3> aval(x_in_new, y_in_new, z_in_new);
-	math::Vector<3> aval_integrated;
-
-	bool accel_notify = _accel_int.put(arb.timestamp, aval, aval_integrated, arb.integral_dt);
-	arb.x_integral = aval_integrated(0);
-	arb.y_integral = aval_integrated(1);
-	arb.z_integral = aval_integrated(2);
+	bool accel_notify = _accel_pipeline.put(timestamp, report.accel_x, report.accel_y, report.accel_z, arb);
 
-	arb.scaling = _accel_range_scale;
 	arb.range_m_s2 = _accel_range_m_s2;
 
 	_last_temperature = (report.temp) / 361.0f + 35.0f;
@@ -1447,34 +1390,8 @@ MPU9250::measure()
 	arb.temperature_raw = report.temp;
 	arb.temperature = _last_temperature;
 
-	grb.x_raw = report.gyro_x;
-	grb.y_raw = report.gyro_y;
-	grb.z_raw = report.gyro_z;
-
-	xraw_f = report.gyro_x;
-	yraw_f = report.gyro_y;
-	zraw_f = report.gyro_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	float x_gyro_in_new = ((xraw_f * _gyro_range_scale) - _gyro_scale.x_offset) * _gyro_scale.x_scale;
-	float y_gyro_in_new = ((yraw_f * _gyro_range_scale) - _gyro_scale.y_offset) * _gyro_scale.y_scale;
-	float z_gyro_in_new = ((zraw_f * _gyro_range_scale) - _gyro_scale.z_offset) * _gyro_scale.z_scale;
-
-	grb.x = _gyro_filter_x.apply(x_gyro_in_new);
-	grb.y = _gyro_filter_y.apply(y_gyro_in_new);
-	grb.z = _gyro_filter_z.apply(z_gyro_in_new);
-
-	math::Vector<3> gval(x_gyro_in_new, y_gyro_in_new, z_gyro_in_new);
-	math::Vector<3> gval_integrated;
-
-	bool gyro_notify = _gyro_int.put(arb.timestamp, gval, gval_integrated, grb.integral_dt);
-	grb.x_integral = gval_integrated(0);
-	grb.y_integral = gval_integrated(1);
-	grb.z_integral = gval_integrated(2);
+	bool gyro_notify = _gyro_pipeline.put(timestamp, report.gyro_x, report.gyro_y, report.gyro_z, grb);
 
-	grb.scaling = _gyro_range_scale;
 	grb.range_rad_s = _gyro_range_rad_s;
 
 	grb.temperature_raw = report.temp;
@@ -56,7 +56,7 @@ private:
 	struct hrt_call		_call;
 	unsigned		_call_interval;
 
-	ringbuffer::RingBuffer	*_accel_reports;
+	ringbuffer::SPSCRingBuffer	*_accel_reports;
 
 	struct accel_calibration_s	_accel_scale;
 	float			_accel_range_scale;
@@ -65,7 +65,7 @@ private:
 	int			_accel_orb_class_instance;
 	int			_accel_class_instance;
 
-	ringbuffer::RingBuffer	*_gyro_reports;
+	ringbuffer::SPSCRingBuffer	*_gyro_reports;
 
 	struct gyro_calibration_s	_gyro_scale;
 	float			_gyro_range_scale;
@@ -87,17 +87,10 @@ private:
 	uint8_t			_register_wait;
 	uint64_t		_reset_wait;
 
-	math::LowPassFilter2p	_accel_filter_x;
-	math::LowPassFilter2p	_accel_filter_y;
-	math::LowPassFilter2p	_accel_filter_z;
-	math::LowPassFilter2p	_gyro_filter_x;
-	math::LowPassFilter2p	_gyro_filter_y;
-	math::LowPassFilter2p	_gyro_filter_z;
+	IMUPipeline<accel_report>	_accel_pipeline;
+	IMUPipeline<gyro_report>	_gyro_pipeline;
 
-	Integrator		_accel_int;
-	Integrator		_gyro_int;
-
-	enum Rotation		_rotation;
+	RotationMatrix		_rotation;	///< used by the magnetometer
 
 	// this is used to support runtime checking of key
 	// configuration registers to detect SPI bus errors and sensor
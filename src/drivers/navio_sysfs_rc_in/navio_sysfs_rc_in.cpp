@@ -64,6 +64,7 @@ public:
 		_shouldExit(false),
 		_isRunning(false),
 		_work{},
+		_wq(HPWORK),
 		_rcinput_pub(nullptr),
 		_channels(8), //D8R-II plus
 		_data{}
@@ -72,7 +73,7 @@ public:
 	}
 	~RcInput()
 	{
-		work_cancel(HPWORK, &_work);
+		work_cancel(_wq, &_work);
 		_isRunning = false;
 	}
 
@@ -94,6 +95,7 @@ private:
 	bool _shouldExit;
 	bool _isRunning;
 	struct work_s _work;
+	int _wq;
 
 	orb_advert_t _rcinput_pub;
 
@@ -148,7 +150,8 @@ int RcInput::start()
 	}
 
 	_isRunning = true;
-	result = work_queue(HPWORK, &_work, (worker_t)&RcInput::cycle_trampoline, this, 0);
+	_wq = work_queue_find("wq_io1");
+	result = work_queue(_wq, &_work, (worker_t)&RcInput::cycle_trampoline, this, 0);
 
 	if (result == -1) {
 		_isRunning = false;
@@ -173,7 +176,7 @@ void RcInput::_cycle()
 	_measure();
 
 	if (!_shouldExit) {
-		work_queue(HPWORK, &_work, (worker_t)&RcInput::cycle_trampoline, this,
+		work_queue(_wq, &_work, (worker_t)&RcInput::cycle_trampoline, this,
 			   USEC2TICK(RCINPUT_MEASURE_INTERVAL_US));
 	}
 }
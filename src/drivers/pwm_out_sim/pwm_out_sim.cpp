@@ -74,6 +74,7 @@
 #include <drivers/drv_mixer.h>
 
 #include <systemlib/systemlib.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/mixer/mixer.h>
 
 #include <uORB/topics/actuator_controls.h>
@@ -438,11 +439,13 @@ PWMSim::task_main()
 
 		/* get controls for required topics */
 		unsigned poll_id = 0;
+		bool main_updated = false;
 
 		for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
 			if (_control_subs[i] >= 0) {
 				if (_poll_fds[poll_id].revents & POLLIN) {
 					orb_copy(_control_topics[i], _control_subs[i], &_controls[i]);
+					main_updated |= (i == 0);
 				}
 
 				poll_id++;
@@ -511,6 +514,10 @@ PWMSim::task_main()
 
 			/* and publish for anyone that cares to see */
 			orb_publish(ORB_ID(actuator_outputs), _outputs_pub, &outputs);
+
+			if (main_updated) {
+				latency_trace_stamp(LATENCY_TRACE_OUTPUT, _controls[0].timestamp_sample);
+			}
 		}
 
 		/* how about an arming update? */
@@ -775,9 +782,11 @@ PWMSim::pwm_ioctl(device::file_t *filp, int cmd, unsigned long arg)
 			break;
 		}
 
-	case MIXERIOCLOADBUF: {
+	case MIXERIOCLOADBUF:
+	case MIXERIOCLOADBIN: {
 			const char *buf = (const char *)arg;
-			unsigned buflen = strnlen(buf, 1024);
+			bool binary = (cmd == MIXERIOCLOADBIN);
+			unsigned buflen = binary ? MixerGroup::binary_length(buf) : strnlen(buf, 1024);
 
 			if (_mixers == nullptr) {
 				_mixers = new MixerGroup(control_callback, (uintptr_t)&_controls);
@@ -789,7 +798,7 @@ PWMSim::pwm_ioctl(device::file_t *filp, int cmd, unsigned long arg)
 
 			} else {
 
-				ret = _mixers->load_from_buf(buf, buflen);
+				ret = binary ? _mixers->load_from_bin(buf, buflen) : _mixers->load_from_buf(buf, buflen);
 
 				if (ret != 0) {
 					PX4_ERR("mixer load failed with %d", ret);
@@ -65,6 +65,9 @@
 
 #include <systemlib/px4_macros.h>
 #include <systemlib/systemlib.h>
+#include <systemlib/perf_counter.h>
+#include <systemlib/scheduling_priorities.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/err.h>
 #include <systemlib/mixer/mixer.h>
 #include <systemlib/pwm_limit/pwm_limit.h>
@@ -93,7 +96,7 @@
 
 #include <systemlib/circuit_breaker.h>
 
-#define SCHEDULE_INTERVAL	2000	/**< The schedule interval in usec (500 Hz) */
+#define SCHEDULE_INTERVAL	2000	/**< The housekeeping interval in usec (500 Hz) while no controls arrive */
 #define NAN_VALUE	(0.0f/0.0f)		/**< NaN value for throttle lock mode */
 #define BUTTON_SAFETY	px4_arch_gpioread(GPIO_BTN_SAFETY)
 #define CYCLE_COUNT 10			/* safety switch must be held for 1 second to activate */
@@ -140,6 +143,8 @@ public:
 	int		set_pwm_alt_rate(unsigned rate);
 	int		set_pwm_alt_channels(uint32_t channels);
 
+	void		print_info();
+
 	static int	set_i2c_bus_clock(unsigned bus, unsigned clock_hz);
 
 	static void	capture_trampoline(void *context, uint32_t chan_index,
@@ -178,7 +183,8 @@ private:
 	unsigned	_pwm_alt_rate;
 	uint32_t	_pwm_alt_rate_channels;
 	unsigned	_current_update_rate;
-	struct work_s	_work;
+	int		_task;
+	volatile bool	_task_should_exit;
 	int		_armed_sub;
 	int		_param_sub;
 	int		_adc_sub;
@@ -221,15 +227,16 @@ private:
 	bool		_safety_disabled;
 	orb_advert_t		_to_safety;
 
+	perf_counter_t	_perf_control_latency;
+
 	static bool	arm_nothrottle()
 	{
 		return ((_armed.prearmed && !_armed.armed) || _armed.in_esc_calibration_mode);
 	}
 
-	static void	cycle_trampoline(void *arg);
+	static void	task_main_trampoline(int argc, char *argv[]);
+	void		task_main();
 	void		cycle();
-	void		work_start();
-	void		work_stop();
 
 	static int	control_callback(uintptr_t handle,
 					 uint8_t control_group,
@@ -243,7 +250,7 @@ private:
 	void		update_pwm_rev_mask();
 	void		publish_pwm_outputs(uint16_t *values, size_t numvalues);
 	void		update_pwm_out_state(bool on);
-	void		pwm_output_set(unsigned i, unsigned value);
+	void		pwm_outputs_set(const uint16_t *values, unsigned count);
 
 	struct GPIOConfig {
 		uint32_t	input;
@@ -299,7 +306,8 @@ PX4FMU::PX4FMU() :
 	_pwm_alt_rate(50),
 	_pwm_alt_rate_channels(0),
 	_current_update_rate(0),
-	_work{},
+	_task(-1),
+	_task_should_exit(false),
 	_armed_sub(-1),
 	_param_sub(-1),
 	_adc_sub(-1),
@@ -328,7 +336,8 @@ PX4FMU::PX4FMU() :
 	_num_disarmed_set(0),
 	_safety_off(false),
 	_safety_disabled(false),
-	_to_safety(nullptr)
+	_to_safety(nullptr),
+	_perf_control_latency(perf_alloc(PC_ELAPSED, "fmu control latency"))
 {
 	for (unsigned i = 0; i < _max_actuators; i++) {
 		_min_pwm[i] = PWM_DEFAULT_MIN;
@@ -371,23 +380,24 @@ PX4FMU::PX4FMU() :
 
 PX4FMU::~PX4FMU()
 {
-	if (_initialized) {
-		/* tell the task we want it to go away */
-		work_stop();
-
-		int i = 10;
+	/* tell the task we want it to go away */
+	_task_should_exit = true;
 
-		do {
-			/* wait 50ms - it should wake every 100ms or so worst-case */
-			usleep(50000);
-			i--;
+	/* spin waiting for the task to stop, it wakes at least every SCHEDULE_INTERVAL */
+	for (unsigned i = 0; (i < 10) && (_task != -1); i++) {
+		usleep(50000);
+	}
 
-		} while (_initialized && i > 0);
+	/* well, kill it anyway, though this will probably crash */
+	if (_task != -1) {
+		task_delete(_task);
 	}
 
 	/* clean up the alternate device node */
 	unregister_class_devname(PWM_OUTPUT_BASE_DEVICE_PATH, _class_instance);
 
+	perf_free(_perf_control_latency);
+
 	g_fmu = nullptr;
 }
 
@@ -418,7 +428,18 @@ PX4FMU::init()
 
 	_safety_disabled = circuit_breaker_enabled("CBRK_IO_SAFETY", CBRK_IO_SAFETY_KEY);
 
-	work_start();
+	/* run the output task, it wakes on every actuator_controls publication */
+	_task = px4_task_spawn_cmd("fmu",
+				   SCHED_DEFAULT,
+				   SCHED_PRIORITY_ACTUATOR_OUTPUTS,
+				   1400,
+				   (main_t)&PX4FMU::task_main_trampoline,
+				   nullptr);
+
+	if (_task < 0) {
+		DEVICE_DEBUG("task start failed: %d", errno);
+		return -errno;
+	}
 
 	return OK;
 }
@@ -688,6 +709,12 @@ PX4FMU::set_i2c_bus_clock(unsigned bus, unsigned clock_hz)
 	return device::I2C::set_bus_clock(bus, clock_hz);
 }
 
+void
+PX4FMU::print_info()
+{
+	perf_print_counter(_perf_control_latency);
+}
+
 void
 PX4FMU::subscribe()
 {
@@ -758,18 +785,39 @@ PX4FMU::publish_pwm_outputs(uint16_t *values, size_t numvalues)
 
 
 void
-PX4FMU::work_start()
+PX4FMU::task_main_trampoline(int argc, char *argv[])
 {
-	/* schedule a cycle to start things */
-	work_queue(HPWORK, &_work, (worker_t)&PX4FMU::cycle_trampoline, this, 0);
+	g_fmu->task_main();
 }
 
 void
-PX4FMU::cycle_trampoline(void *arg)
+PX4FMU::task_main()
 {
-	PX4FMU *dev = reinterpret_cast<PX4FMU *>(arg);
+	while (!_task_should_exit) {
+		cycle();
+	}
+
+	for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
+		if (_control_subs[i] > 0) {
+			::close(_control_subs[i]);
+			_control_subs[i] = -1;
+		}
+	}
+
+	::close(_armed_sub);
+	::close(_param_sub);
+
+	/* make sure servos are off */
+	up_pwm_servo_deinit();
 
-	dev->cycle();
+	DEVICE_LOG("stopping");
+
+	/* note - someone else is responsible for restoring the GPIO config */
+
+	/* tell the dtor that we are exiting */
+	_initialized = false;
+	_task = -1;
+	_exit(0);
 }
 
 void
@@ -873,10 +921,10 @@ void PX4FMU::rc_io_invert(bool invert)
 #endif
 
 void
-PX4FMU::pwm_output_set(unsigned i, unsigned value)
+PX4FMU::pwm_outputs_set(const uint16_t *values, unsigned count)
 {
 	if (_pwm_initialized) {
-		up_pwm_servo_set(i, value);
+		up_pwm_servo_set_multi(values, count);
 	}
 }
 
@@ -974,11 +1022,15 @@ PX4FMU::cycle()
 		_current_update_rate = max_rate;
 	}
 
-	/* check if anything updated */
-	int ret = ::poll(_poll_fds, _poll_fds_num, 0);
+	/* wait for a control update, the rest of the cycle runs at least every SCHEDULE_INTERVAL */
+	int ret = 0;
 
-	/* log if main actuator updated and sync */
-	int main_out_latency = 0;
+	if (_poll_fds_num > 0) {
+		ret = ::poll(_poll_fds, _poll_fds_num, SCHEDULE_INTERVAL / 1000);
+
+	} else {
+		usleep(SCHEDULE_INTERVAL);
+	}
 
 	/* this would be bad... */
 	if (ret < 0) {
@@ -992,26 +1044,13 @@ PX4FMU::cycle()
 
 		/* get controls for required topics */
 		unsigned poll_id = 0;
+		bool main_updated = false;
 
 		for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
 			if (_control_subs[i] > 0) {
 				if (_poll_fds[poll_id].revents & POLLIN) {
 					orb_copy(_control_topics[i], _control_subs[i], &_controls[i]);
-
-					/* main outputs */
-					if (i == 0) {
-//						main_out_latency = hrt_absolute_time() - _controls[i].timestamp - 250;
-//						warnx("lat: %llu", hrt_absolute_time() - _controls[i].timestamp);
-
-						/* do only correct within the current phase */
-						if (abs(main_out_latency) > SCHEDULE_INTERVAL) {
-							main_out_latency = SCHEDULE_INTERVAL;
-						}
-
-						if (main_out_latency < 250) {
-							main_out_latency = 0;
-						}
-					}
+					main_updated |= (i == 0);
 				}
 
 				poll_id++;
@@ -1090,8 +1129,11 @@ PX4FMU::cycle()
 			}
 
 			/* output to the servos */
-			for (size_t i = 0; i < num_outputs; i++) {
-				pwm_output_set(i, pwm_limited[i]);
+			pwm_outputs_set(pwm_limited, num_outputs);
+
+			if (main_updated) {
+				perf_set_elapsed(_perf_control_latency, hrt_elapsed_time(&_controls[0].timestamp_sample));
+				latency_trace_stamp(LATENCY_TRACE_OUTPUT, _controls[0].timestamp_sample);
 			}
 
 			publish_pwm_outputs(pwm_limited, num_outputs);
@@ -1312,16 +1354,12 @@ PX4FMU::cycle()
 
 			if (newBytes > 0) {
 				// parse new data
-				uint8_t st24_rssi, rx_count;
-
-				rc_updated = false;
+				uint8_t st24_rssi = RC_INPUT_RSSI_MAX;
+				uint8_t rx_count;
 
-				for (unsigned i = 0; i < (unsigned)newBytes; i++) {
-					/* set updated flag if one complete packet was parsed */
-					st24_rssi = RC_INPUT_RSSI_MAX;
-					rc_updated = (OK == st24_decode(_rcs_buf[i], &st24_rssi, &rx_count,
-									&raw_rc_count, raw_rc_values, input_rc_s::RC_INPUT_MAX_CHANNELS));
-				}
+				/* set updated flag if one complete packet was parsed */
+				rc_updated = (OK == st24_parse(&_rcs_buf[0], newBytes, &st24_rssi, &rx_count,
+							       &raw_rc_count, raw_rc_values, input_rc_s::RC_INPUT_MAX_CHANNELS));
 
 				if (rc_updated) {
 					// we have a new ST24 frame. Publish it.
@@ -1351,16 +1389,12 @@ PX4FMU::cycle()
 
 			if (newBytes > 0) {
 				// parse new data
-				uint8_t sumd_rssi, rx_count;
+				uint8_t sumd_rssi = RC_INPUT_RSSI_MAX;
+				uint8_t rx_count;
 
-				rc_updated = false;
-
-				for (unsigned i = 0; i < (unsigned)newBytes; i++) {
-					/* set updated flag if one complete packet was parsed */
-					sumd_rssi = RC_INPUT_RSSI_MAX;
-					rc_updated = (OK == sumd_decode(_rcs_buf[i], &sumd_rssi, &rx_count,
-									&raw_rc_count, raw_rc_values, input_rc_s::RC_INPUT_MAX_CHANNELS));
-				}
+				/* set updated flag if one complete packet was parsed */
+				rc_updated = (OK == sumd_parse(&_rcs_buf[0], newBytes, &sumd_rssi, &rx_count,
+							       &raw_rc_count, raw_rc_values, input_rc_s::RC_INPUT_MAX_CHANNELS));
 
 				if (rc_updated) {
 					// we have a new SUMD frame. Publish it.
@@ -1442,34 +1476,6 @@ PX4FMU::cycle()
 			orb_publish(ORB_ID(input_rc), _to_input_rc, &_rc_in);
 		}
 	}
-
-	work_queue(HPWORK, &_work, (worker_t)&PX4FMU::cycle_trampoline, this,
-		   USEC2TICK(SCHEDULE_INTERVAL - main_out_latency));
-}
-
-void PX4FMU::work_stop()
-{
-	work_cancel(HPWORK, &_work);
-
-	for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
-		if (_control_subs[i] > 0) {
-			::close(_control_subs[i]);
-			_control_subs[i] = -1;
-		}
-	}
-
-	::close(_armed_sub);
-	::close(_param_sub);
-
-	/* make sure servos are off */
-	up_pwm_servo_deinit();
-
-	DEVICE_LOG("stopping");
-
-	/* note - someone else is responsible for restoring the GPIO config */
-
-	/* tell the dtor that we are exiting */
-	_initialized = false;
 }
 
 int
@@ -2100,9 +2106,11 @@ PX4FMU::pwm_ioctl(file *filp, int cmd, unsigned long arg)
 			break;
 		}
 
-	case MIXERIOCLOADBUF: {
+	case MIXERIOCLOADBUF:
+	case MIXERIOCLOADBIN: {
 			const char *buf = (const char *)arg;
-			unsigned buflen = strnlen(buf, 1024);
+			bool binary = (cmd == MIXERIOCLOADBIN);
+			unsigned buflen = binary ? MixerGroup::binary_length(buf) : strnlen(buf, 1024);
 
 			if (_mixers == nullptr) {
 				_mixers = new MixerGroup(control_callback, (uintptr_t)_controls);
@@ -2114,7 +2122,7 @@ PX4FMU::pwm_ioctl(file *filp, int cmd, unsigned long arg)
 
 			} else {
 
-				ret = _mixers->load_from_buf(buf, buflen);
+				ret = binary ? _mixers->load_from_bin(buf, buflen) : _mixers->load_from_buf(buf, buflen);
 
 				if (ret != 0) {
 					DEVICE_DEBUG("mixer load failed with %d", ret);
@@ -3039,6 +3047,7 @@ fmu_main(int argc, char *argv[])
 #ifdef RC_SERIAL_PORT
 		warnx("frame drops: %u", sbus_dropped_frames());
 #endif
+		g_fmu->print_info();
 		return 0;
 	}
 
@@ -446,7 +446,7 @@ private:
 	/**
 	 * Send mixer definition text to IO
 	 */
-	int			mixer_send(const char *buf, unsigned buflen, unsigned retries = 3);
+	int			mixer_send(const char *buf, unsigned buflen, bool binary = false, unsigned retries = 3);
 
 	/**
 	 * Handle a status update from IO.
@@ -2126,7 +2126,7 @@ PX4IO::print_debug()
 }
 
 int
-PX4IO::mixer_send(const char *buf, unsigned buflen, unsigned retries)
+PX4IO::mixer_send(const char *buf, unsigned buflen, bool binary, unsigned retries)
 {
 	/* get debug level */
 	int debuglevel = io_reg_get(PX4IO_PAGE_SETUP, PX4IO_P_SETUP_SET_DEBUG);
@@ -2139,7 +2139,7 @@ PX4IO::mixer_send(const char *buf, unsigned buflen, unsigned retries)
 		unsigned max_len = _max_transfer - sizeof(px4io_mixdata);
 
 		msg->f2i_mixer_magic = F2I_MIXER_MAGIC;
-		msg->action = F2I_MIXER_ACTION_RESET;
+		msg->action = binary ? F2I_MIXER_ACTION_RESET_BINARY : F2I_MIXER_ACTION_RESET;
 
 		do {
 			unsigned count = buflen;
@@ -2188,7 +2188,12 @@ PX4IO::mixer_send(const char *buf, unsigned buflen, unsigned retries)
 			/* print mixer chunk */
 			if (debuglevel > 5 || ret) {
 
-				warnx("fmu sent: \"%s\"", msg->text);
+				if (binary) {
+					warnx("fmu sent: %u bytes", count);
+
+				} else {
+					warnx("fmu sent: \"%s\"", msg->text);
+				}
 
 				/* read IO's output */
 				print_debug();
@@ -2203,13 +2208,13 @@ PX4IO::mixer_send(const char *buf, unsigned buflen, unsigned retries)
 
 		} while (buflen > 0);
 
-		int ret;
+		int ret = 0;
 
-		/* send the closing newline */
+		/* send the closing newline, a precompiled image has no line endings */
 		msg->text[0] = '\n';
 		msg->text[1] = '\0';
 
-		for (int i = 0; i < 30; i++) {
+		for (int i = 0; !binary && i < 30; i++) {
 			/* failed, but give it a 2nd shot */
 			ret = io_reg_set(PX4IO_PAGE_MIXERLOAD, 0, (uint16_t *)frame, (sizeof(px4io_mixdata) + 2) / 2);
 
@@ -2880,6 +2885,19 @@ PX4IO::ioctl(file *filep, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCLOADBIN: {
+			const char *buf = (const char *)arg;
+			unsigned buflen = MixerGroup::binary_length(buf);
+
+			if (buflen == 0) {
+				ret = -EINVAL;
+				break;
+			}
+
+			ret = mixer_send(buf, buflen, true);
+			break;
+		}
+
 	case RC_INPUT_GET: {
 			uint16_t status;
 			rc_input_values *rc_val = (rc_input_values *)arg;
@@ -710,6 +710,44 @@ int io_timer_set_ccr(unsigned channel, uint16_t value)
 	return rv;
 }
 
+int io_timer_set_ccrs(const uint16_t *values, unsigned count)
+{
+	uint32_t pwm_channels = channel_allocations[IOTimerChanMode_PWMOut];
+
+	irqstate_t flags = px4_enter_critical_section();
+
+	for (unsigned timer = 0; timer < MAX_IO_TIMERS; timer++) {
+		uint32_t channels = get_timer_channels(timer) & pwm_channels;
+
+		if (channels == 0) {
+			continue;
+		}
+
+		/* hold off the update event so the preloaded channels of this timer switch in the same period */
+		rCR1(timer) |= GTIM_CR1_UDIS;
+
+		for (unsigned channel = io_timers[timer].first_channel_index;
+		     channel <= io_timers[timer].last_channel_index && channel < count; channel++) {
+
+			if (channels & (1 << channel)) {
+				uint16_t value = values[channel];
+
+				if (value > 0) {
+					value--;
+				}
+
+				REG(timer, timer_io_channels[channel].ccr_offset) = value;
+			}
+		}
+
+		rCR1(timer) &= ~GTIM_CR1_UDIS;
+	}
+
+	px4_leave_critical_section(flags);
+
+	return 0;
+}
+
 uint16_t io_channel_get_ccr(unsigned channel)
 {
 	uint16_t value = 0;
@@ -112,6 +112,7 @@ __EXPORT int io_timer_set_enable(bool state, io_timer_channel_mode_t mode,
 __EXPORT int io_timer_set_rate(unsigned timer, unsigned rate);
 __EXPORT uint16_t io_channel_get_ccr(unsigned channel);
 __EXPORT int io_timer_set_ccr(unsigned channel, uint16_t value);
+__EXPORT int io_timer_set_ccrs(const uint16_t *values, unsigned count);
 __EXPORT uint32_t io_timer_get_group(unsigned timer);
 __EXPORT int io_timer_validate_channel_index(unsigned channel);
 __EXPORT int io_timer_is_channel_free(unsigned channel);
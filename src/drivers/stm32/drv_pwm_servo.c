@@ -73,6 +73,11 @@ int up_pwm_servo_set(unsigned channel, servo_position_t value)
 	return io_timer_set_ccr(channel, value);
 }
 
+int up_pwm_servo_set_multi(const servo_position_t *values, unsigned count)
+{
+	return io_timer_set_ccrs(values, count);
+}
+
 servo_position_t up_pwm_servo_get(unsigned channel)
 {
 	return io_channel_get_ccr(channel);
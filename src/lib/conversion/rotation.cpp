@@ -50,210 +50,71 @@ get_rot_matrix(enum Rotation rot, math::Matrix<3, 3> *rot_matrix)
 	rot_matrix->from_euler(roll, pitch, yaw);
 }
 
-#define HALF_SQRT_2 0.70710678118654757f
-
 __EXPORT void
 rotate_3f(enum Rotation rot, float &x, float &y, float &z)
 {
-	float tmp;
-
-	switch (rot) {
-	case ROTATION_NONE:
-	case ROTATION_MAX:
-		return;
-
-	case ROTATION_YAW_45: {
-			tmp = HALF_SQRT_2 * (x - y);
-			y   = HALF_SQRT_2 * (x + y);
-			x = tmp;
-			return;
-		}
-
-	case ROTATION_YAW_90: {
-			tmp = x; x = -y; y = tmp;
-			return;
-		}
-
-	case ROTATION_YAW_135: {
-			tmp = -HALF_SQRT_2 * (x + y);
-			y   =  HALF_SQRT_2 * (x - y);
-			x = tmp;
-			return;
-		}
-
-	case ROTATION_YAW_180:
-		x = -x; y = -y;
-		return;
-
-	case ROTATION_YAW_225: {
-			tmp = HALF_SQRT_2 * (y - x);
-			y   = -HALF_SQRT_2 * (x + y);
-			x = tmp;
-			return;
-		}
-
-	case ROTATION_YAW_270: {
-			tmp = x; x = y; y = -tmp;
-			return;
-		}
-
-	case ROTATION_YAW_315: {
-			tmp = HALF_SQRT_2 * (x + y);
-			y   = HALF_SQRT_2 * (y - x);
-			x = tmp;
-			return;
-		}
-
-	case ROTATION_ROLL_180: {
-			y = -y; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_180_YAW_45: {
-			tmp = HALF_SQRT_2 * (x + y);
-			y   = HALF_SQRT_2 * (x - y);
-			x = tmp; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_180_YAW_90: {
-			tmp = x; x = y; y = tmp; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_180_YAW_135: {
-			tmp = HALF_SQRT_2 * (y - x);
-			y   = HALF_SQRT_2 * (y + x);
-			x = tmp; z = -z;
-			return;
-		}
-
-	case ROTATION_PITCH_180: {
-			x = -x; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_180_YAW_225: {
-			tmp = -HALF_SQRT_2 * (x + y);
-			y   =  HALF_SQRT_2 * (y - x);
-			x = tmp; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_180_YAW_270: {
-			tmp = x; x = -y; y = -tmp; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_180_YAW_315: {
-			tmp =  HALF_SQRT_2 * (x - y);
-			y   = -HALF_SQRT_2 * (x + y);
-			x = tmp; z = -z;
-			return;
-		}
-
-	case ROTATION_ROLL_90: {
-			tmp = z; z = y; y = -tmp;
-			return;
-		}
-
-	case ROTATION_ROLL_90_YAW_45: {
-			tmp = z; z = y; y = -tmp;
-			tmp = HALF_SQRT_2 * (x - y);
-			y   = HALF_SQRT_2 * (x + y);
-			x = tmp;
-			return;
-		}
-
-	case ROTATION_ROLL_90_YAW_90: {
-			tmp = z; z = y; y = -tmp;
-			tmp = x; x = -y; y = tmp;
-			return;
-		}
-
-	case ROTATION_ROLL_90_YAW_135: {
-			tmp = z; z = y; y = -tmp;
-			tmp = -HALF_SQRT_2 * (x + y);
-			y   =  HALF_SQRT_2 * (x - y);
-			x = tmp;
-			return;
-		}
-
-	case ROTATION_ROLL_270: {
-			tmp = z; z = -y; y = tmp;
-			return;
-		}
-
-	case ROTATION_ROLL_270_YAW_45: {
-			tmp = z; z = -y; y = tmp;
-			tmp = HALF_SQRT_2 * (x - y);
-			y   = HALF_SQRT_2 * (x + y);
-			x = tmp;
-			return;
-		}
+	rotate_3f_inline(rot, x, y, z);
+}
 
-	case ROTATION_ROLL_270_YAW_90: {
-			tmp = z; z = -y; y = tmp;
-			tmp = x; x = -y; y = tmp;
-			return;
-		}
+void
+RotationMatrix::set(enum Rotation rot)
+{
+	_rot = rot;
+	_permutation = true;
 
-	case ROTATION_ROLL_270_YAW_135: {
-			tmp = z; z = -y; y = tmp;
-			tmp = -HALF_SQRT_2 * (x + y);
-			y   =  HALF_SQRT_2 * (x - y);
-			x = tmp;
-			return;
-		}
+	// build the matrix column by column from the reference rotation
+	for (unsigned j = 0; j < 3; j++) {
+		float axis[3] = {};
+		axis[j] = 1.0f;
+		rotate_3f_inline(rot, axis[0], axis[1], axis[2]);
 
-	case ROTATION_ROLL_270_YAW_270: {
-			tmp = z; z = -y; y = tmp;
-			tmp = x; x = y; y = -tmp;
-			return;
+		for (unsigned i = 0; i < 3; i++) {
+			_m[i][j] = axis[i];
 		}
+	}
 
-	case ROTATION_PITCH_90: {
-			tmp = z; z = -x; x = tmp;
-			return;
-		}
+	for (unsigned i = 0; i < 3; i++) {
+		unsigned nonzero = 0;
 
-	case ROTATION_PITCH_270: {
-			tmp = z; z = x; x = -tmp;
-			return;
-		}
+		for (unsigned j = 0; j < 3; j++) {
+			if (_m[i][j] == 1.0f || _m[i][j] == -1.0f) {
+				_index[i] = j;
+				_sign[i] = _m[i][j];
+				nonzero++;
 
-	case ROTATION_ROLL_180_PITCH_270: {
-			tmp = z; z = x; x = tmp;
-			y = -y;
-			return;
+			} else if (_m[i][j] != 0.0f) {
+				nonzero = 2;
+			}
 		}
 
-	case ROTATION_PITCH_90_YAW_180: {
-			tmp = x; x = z; z = tmp;
-			y = -y;
-			return;
-		}
-
-	case ROTATION_PITCH_90_ROLL_90: {
-			tmp = x; x = y;
-			y = -z; z = -tmp;
-			return;
+		if (nonzero != 1) {
+			_permutation = false;
 		}
+	}
+}
 
-	case ROTATION_YAW_293_PITCH_68_ROLL_90: {
-			float tmpx = x;
-			float tmpy = y;
-			float tmpz = z;
-			x =  0.143039f * tmpx +  0.368776f * tmpy + -0.918446f * tmpz;
-			y = -0.332133f * tmpx + -0.856289f * tmpy + -0.395546f * tmpz;
-			z = -0.932324f * tmpx +  0.361625f * tmpy +  0.000000f * tmpz;
-			return;
-		}
+void
+RotationMatrix::rotate_n(float *xyz, unsigned n) const
+{
+	if (_rot == ROTATION_NONE) {
+		return;
+	}
 
-	case ROTATION_PITCH_90_ROLL_270: {
-			tmp = x; x = -y;
-			y = z; z = -tmp;
-			return;
+	// branch once per batch instead of once per vector
+	if (_permutation) {
+		for (unsigned k = 0; k < n; k++, xyz += 3) {
+			const float v[3] = {xyz[0], xyz[1], xyz[2]};
+			xyz[0] = _sign[0] * v[_index[0]];
+			xyz[1] = _sign[1] * v[_index[1]];
+			xyz[2] = _sign[2] * v[_index[2]];
+		}
+
+	} else {
+		for (unsigned k = 0; k < n; k++, xyz += 3) {
+			const float v[3] = {xyz[0], xyz[1], xyz[2]};
+			xyz[0] = _m[0][0] * v[0] + _m[0][1] * v[1] + _m[0][2] * v[2];
+			xyz[1] = _m[1][0] * v[0] + _m[1][1] * v[1] + _m[1][2] * v[2];
+			xyz[2] = _m[2][0] * v[0] + _m[2][1] * v[1] + _m[2][2] * v[2];
 		}
 	}
 }
@@ -137,5 +137,284 @@ get_rot_matrix(enum Rotation rot, math::Matrix<3, 3> *rot_matrix);
 __EXPORT void
 rotate_3f(enum Rotation rot, float &x, float &y, float &z);
 
+/**
+ * rotate a 3 element float vector in-place, inlined so that the switch
+ * folds away when rot is known at compile time
+ */
+static inline __attribute__((always_inline)) void
+rotate_3f_inline(enum Rotation rot, float &x, float &y, float &z)
+{
+	static constexpr float HALF_SQRT_2 = 0.70710678118654757f;
+	float tmp;
+
+	switch (rot) {
+	case ROTATION_NONE:
+	case ROTATION_MAX:
+		return;
+
+	case ROTATION_YAW_45: {
+			tmp = HALF_SQRT_2 * (x - y);
+			y   = HALF_SQRT_2 * (x + y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_YAW_90: {
+			tmp = x; x = -y; y = tmp;
+			return;
+		}
+
+	case ROTATION_YAW_135: {
+			tmp = -HALF_SQRT_2 * (x + y);
+			y   =  HALF_SQRT_2 * (x - y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_YAW_180:
+		x = -x; y = -y;
+		return;
+
+	case ROTATION_YAW_225: {
+			tmp = HALF_SQRT_2 * (y - x);
+			y   = -HALF_SQRT_2 * (x + y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_YAW_270: {
+			tmp = x; x = y; y = -tmp;
+			return;
+		}
+
+	case ROTATION_YAW_315: {
+			tmp = HALF_SQRT_2 * (x + y);
+			y   = HALF_SQRT_2 * (y - x);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_180: {
+			y = -y; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_180_YAW_45: {
+			tmp = HALF_SQRT_2 * (x + y);
+			y   = HALF_SQRT_2 * (x - y);
+			x = tmp; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_180_YAW_90: {
+			tmp = x; x = y; y = tmp; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_180_YAW_135: {
+			tmp = HALF_SQRT_2 * (y - x);
+			y   = HALF_SQRT_2 * (y + x);
+			x = tmp; z = -z;
+			return;
+		}
+
+	case ROTATION_PITCH_180: {
+			x = -x; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_180_YAW_225: {
+			tmp = -HALF_SQRT_2 * (x + y);
+			y   =  HALF_SQRT_2 * (y - x);
+			x = tmp; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_180_YAW_270: {
+			tmp = x; x = -y; y = -tmp; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_180_YAW_315: {
+			tmp =  HALF_SQRT_2 * (x - y);
+			y   = -HALF_SQRT_2 * (x + y);
+			x = tmp; z = -z;
+			return;
+		}
+
+	case ROTATION_ROLL_90: {
+			tmp = z; z = y; y = -tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_90_YAW_45: {
+			tmp = z; z = y; y = -tmp;
+			tmp = HALF_SQRT_2 * (x - y);
+			y   = HALF_SQRT_2 * (x + y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_90_YAW_90: {
+			tmp = z; z = y; y = -tmp;
+			tmp = x; x = -y; y = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_90_YAW_135: {
+			tmp = z; z = y; y = -tmp;
+			tmp = -HALF_SQRT_2 * (x + y);
+			y   =  HALF_SQRT_2 * (x - y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_270: {
+			tmp = z; z = -y; y = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_270_YAW_45: {
+			tmp = z; z = -y; y = tmp;
+			tmp = HALF_SQRT_2 * (x - y);
+			y   = HALF_SQRT_2 * (x + y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_270_YAW_90: {
+			tmp = z; z = -y; y = tmp;
+			tmp = x; x = -y; y = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_270_YAW_135: {
+			tmp = z; z = -y; y = tmp;
+			tmp = -HALF_SQRT_2 * (x + y);
+			y   =  HALF_SQRT_2 * (x - y);
+			x = tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_270_YAW_270: {
+			tmp = z; z = -y; y = tmp;
+			tmp = x; x = y; y = -tmp;
+			return;
+		}
+
+	case ROTATION_PITCH_90: {
+			tmp = z; z = -x; x = tmp;
+			return;
+		}
+
+	case ROTATION_PITCH_270: {
+			tmp = z; z = x; x = -tmp;
+			return;
+		}
+
+	case ROTATION_ROLL_180_PITCH_270: {
+			tmp = z; z = x; x = tmp;
+			y = -y;
+			return;
+		}
+
+	case ROTATION_PITCH_90_YAW_180: {
+			tmp = x; x = z; z = tmp;
+			y = -y;
+			return;
+		}
+
+	case ROTATION_PITCH_90_ROLL_90: {
+			tmp = x; x = y;
+			y = -z; z = -tmp;
+			return;
+		}
+
+	case ROTATION_YAW_293_PITCH_68_ROLL_90: {
+			float tmpx = x;
+			float tmpy = y;
+			float tmpz = z;
+			x =  0.143039f * tmpx +  0.368776f * tmpy + -0.918446f * tmpz;
+			y = -0.332133f * tmpx + -0.856289f * tmpy + -0.395546f * tmpz;
+			z = -0.932324f * tmpx +  0.361625f * tmpy +  0.000000f * tmpz;
+			return;
+		}
+
+	case ROTATION_PITCH_90_ROLL_270: {
+			tmp = x; x = -y;
+			y = z; z = -tmp;
+			return;
+		}
+	}
+}
+
+/**
+ * rotate a 3 element float vector in-place, for a rotation known at compile time
+ */
+template<enum Rotation R>
+inline void
+rotate_3f(float &x, float &y, float &z)
+{
+	rotate_3f_inline(R, x, y, z);
+}
+
+/**
+ * A rotation resolved once into a matrix, for per-sample use.
+ *
+ * Rotations by multiples of 90 degrees are applied as a signed
+ * permutation of the axes, all others as a matrix product.
+ */
+class __EXPORT RotationMatrix
+{
+public:
+	RotationMatrix(enum Rotation rot = ROTATION_NONE) { set(rot); }
+
+	/**
+	 * Resolve a rotation, not to be called while rotate() runs concurrently.
+	 */
+	void set(enum Rotation rot);
+
+	enum Rotation get() const { return _rot; }
+
+	/**
+	 * rotate a 3 element float vector in-place
+	 */
+	void rotate(float &x, float &y, float &z) const
+	{
+		const float v[3] = {x, y, z};
+
+		if (_permutation) {
+			x = _sign[0] * v[_index[0]];
+			y = _sign[1] * v[_index[1]];
+			z = _sign[2] * v[_index[2]];
+
+		} else {
+			x = _m[0][0] * v[0] + _m[0][1] * v[1] + _m[0][2] * v[2];
+			y = _m[1][0] * v[0] + _m[1][1] * v[1] + _m[1][2] * v[2];
+			z = _m[2][0] * v[0] + _m[2][1] * v[1] + _m[2][2] * v[2];
+		}
+	}
+
+	/**
+	 * rotate n interleaved 3 element float vectors in-place
+	 *
+	 * @param xyz	n vectors, x y z each
+	 * @param n	number of vectors
+	 */
+	void rotate_n(float *xyz, unsigned n) const;
+
+	/**
+	 * element of the matrix, row i column j
+	 */
+	float operator()(unsigned i, unsigned j) const { return _m[i][j]; }
+
+private:
+	enum Rotation	_rot;
+	float		_m[3][3];
+	bool		_permutation;	///< every row holds a single +-1
+	uint8_t		_index[3];	///< source axis of each output axis if _permutation
+	float		_sign[3];	///< sign of each output axis if _permutation
+};
+
 
 #endif /* ROTATION_H_ */
@@ -0,0 +1,292 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file DynamicNotch.cpp
+ */
+
+#include <px4_defines.h>
+#include "DynamicNotch.hpp"
+
+namespace math
+{
+
+// damping of the sliding DFT, keeps rounding errors from accumulating
+static const float SDFT_DAMPING = 0.999f;
+
+// peak magnitude over the mean of the other bins needed to follow a peak
+static const float PEAK_MIN_SNR = 4.0f;
+
+// spectrum updates the notch is kept after the peak disappeared
+static const unsigned NOTCH_HOLD_UPDATES = 4;
+
+DynamicNotch::DynamicNotch() :
+	_sample_freq(0.0f),
+	_analysis_freq(0.0f),
+	_q(1.0f),
+	_decimation(1),
+	_decimation_count(0),
+	_decimation_sum{},
+	_bin_min(0),
+	_bin_count(0),
+	_twiddle_re{},
+	_twiddle_im{},
+	_re{},
+	_im{},
+	_history{},
+	_history_index(0),
+	_damping_window(1.0f),
+	_magnitude{},
+	_samples_since_update(0),
+	_spectrum_updated(false),
+	_peak_freq(0.0f),
+	_peak_snr(0.0f),
+	_notch_freq(0.0f),
+	_notch_hold(0),
+	_external_freq(0.0f),
+	_external_timeout(0)
+{
+}
+
+void DynamicNotch::init(float sample_freq, float min_freq, float max_freq, float q)
+{
+	_sample_freq = sample_freq;
+	_q = q;
+
+	// analyse at about 2.5 times the highest frequency of interest
+	_decimation = (unsigned)(sample_freq / (2.5f * max_freq));
+
+	if (_decimation < 1) {
+		_decimation = 1;
+	}
+
+	_analysis_freq = sample_freq / _decimation;
+
+	const float resolution = _analysis_freq / WINDOW;
+	unsigned bin_min = (unsigned)(min_freq / resolution + 0.5f);
+	unsigned bin_max = (unsigned)(max_freq / resolution + 0.5f);
+
+	if (bin_min < 1) {
+		bin_min = 1;
+	}
+
+	if (bin_max > MAX_BINS - 1) {
+		bin_max = MAX_BINS - 1;
+	}
+
+	_bin_min = bin_min;
+	_bin_count = (bin_max >= bin_min) ? bin_max - bin_min + 1 : 0;
+
+	for (unsigned i = 0; i < _bin_count; i++) {
+		float angle = 2.0f * M_PI_F * (_bin_min + i) / WINDOW;
+		_twiddle_re[i] = SDFT_DAMPING * cosf(angle);
+		_twiddle_im[i] = SDFT_DAMPING * sinf(angle);
+	}
+
+	_damping_window = powf(SDFT_DAMPING, WINDOW);
+
+	memset(_re, 0, sizeof(_re));
+	memset(_im, 0, sizeof(_im));
+	memset(_history, 0, sizeof(_history));
+	memset(_decimation_sum, 0, sizeof(_decimation_sum));
+	_decimation_count = 0;
+	_history_index = 0;
+	_samples_since_update = 0;
+
+	set_notch(0.0f);
+}
+
+void DynamicNotch::set_external_frequency(float freq)
+{
+	_external_freq = freq;
+	_external_timeout = (unsigned)(_sample_freq / 10.0f);
+}
+
+void DynamicNotch::apply(float sample[3])
+{
+	if (_bin_count == 0) {
+		return;
+	}
+
+	// analyse the input, not the notched output
+	for (unsigned axis = 0; axis < 3; axis++) {
+		_decimation_sum[axis] += sample[axis];
+	}
+
+	if (++_decimation_count >= _decimation) {
+		float average[3];
+
+		for (unsigned axis = 0; axis < 3; axis++) {
+			average[axis] = _decimation_sum[axis] / _decimation_count;
+			_decimation_sum[axis] = 0.0f;
+		}
+
+		_decimation_count = 0;
+		analyse(average);
+	}
+
+	if (_external_timeout > 0) {
+		_external_timeout--;
+	}
+
+	_notch.apply(sample);
+}
+
+void DynamicNotch::analyse(const float sample[3])
+{
+	float delta[3];
+
+	for (unsigned axis = 0; axis < 3; axis++) {
+		delta[axis] = sample[axis] - _damping_window * _history[_history_index][axis];
+		_history[_history_index][axis] = sample[axis];
+	}
+
+	_history_index = (_history_index + 1) % WINDOW;
+
+	// X_k = r * e^(j*2*pi*k/N) * (X_k + x_new - r^N * x_old)
+	for (unsigned i = 0; i < _bin_count; i++) {
+		const float tr = _twiddle_re[i];
+		const float ti = _twiddle_im[i];
+
+		for (unsigned axis = 0; axis < 3; axis++) {
+			float re = _re[i][axis] + delta[axis];
+			float im = _im[i][axis];
+			_re[i][axis] = re * tr - im * ti;
+			_im[i][axis] = re * ti + im * tr;
+		}
+	}
+
+	if (++_samples_since_update >= WINDOW / 4) {
+		_samples_since_update = 0;
+		update_peak();
+	}
+}
+
+void DynamicNotch::update_peak()
+{
+	float sum = 0.0f;
+	float best = 0.0f;
+	unsigned best_index = 0;
+
+	for (unsigned i = 0; i < _bin_count; i++) {
+		float power = 0.0f;
+
+		for (unsigned axis = 0; axis < 3; axis++) {
+			power += _re[i][axis] * _re[i][axis] + _im[i][axis] * _im[i][axis];
+		}
+
+		// amplitude of a sine in the input
+		_magnitude[i] = sqrtf(power) * (2.0f / WINDOW);
+		sum += _magnitude[i];
+
+		if (_magnitude[i] > best) {
+			best = _magnitude[i];
+			best_index = i;
+		}
+	}
+
+	_spectrum_updated = true;
+
+	const float mean_others = (_bin_count > 1) ? (sum - best) / (_bin_count - 1) : 0.0f;
+	_peak_snr = (mean_others > 0.0f) ? best / mean_others : 0.0f;
+
+	// a maximum at the edge of the searched range is usually leakage of
+	// the body motion at low frequencies, not a vibration line
+	const bool local_maximum = best_index > 0 && best_index + 1 < _bin_count;
+
+	if (_peak_snr >= PEAK_MIN_SNR && local_maximum) {
+		// parabolic interpolation between the neighbouring bins
+		float left = _magnitude[best_index - 1];
+		float right = _magnitude[best_index + 1];
+		float denominator = left - 2.0f * best + right;
+		float offset = 0.0f;
+
+		if (denominator < 0.0f) {
+			offset = 0.5f * (left - right) / denominator;
+		}
+
+		_peak_freq = (_bin_min + best_index + offset) * _analysis_freq / WINDOW;
+		_notch_hold = NOTCH_HOLD_UPDATES;
+
+	} else {
+		_peak_freq = 0.0f;
+
+		if (_notch_hold > 0) {
+			_notch_hold--;
+		}
+	}
+
+	float target = 0.0f;
+
+	if (_external_timeout > 0 && _external_freq > 0.0f) {
+		target = _external_freq;
+
+	} else if (_peak_freq > 0.0f) {
+		target = _peak_freq;
+
+	} else if (_notch_hold > 0) {
+		target = _notch_freq;
+	}
+
+	if (target > 0.0f && _notch_freq > 0.0f) {
+		// move smoothly, coefficient jumps excite the filter state
+		target = _notch_freq + 0.5f * (target - _notch_freq);
+	}
+
+	set_notch(target);
+}
+
+void DynamicNotch::set_notch(float freq)
+{
+	if (freq <= 0.0f || freq >= 0.5f * _sample_freq) {
+		_notch_freq = 0.0f;
+		_notch.set_stage(0, BiquadCoefficients::passthrough());
+		return;
+	}
+
+	_notch_freq = freq;
+	_notch.set_stage(0, BiquadCoefficients::notch(_sample_freq, freq, freq / _q));
+}
+
+unsigned DynamicNotch::get_spectrum(float magnitude[MAX_BINS], float &start_freq, float &resolution,
+				    float &analysis_freq)
+{
+	memcpy(magnitude, _magnitude, sizeof(_magnitude));
+	resolution = _analysis_freq / WINDOW;
+	start_freq = _bin_min * resolution;
+	analysis_freq = _analysis_freq;
+	_spectrum_updated = false;
+	return _bin_count;
+}
+
+} // namespace math
@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file DynamicNotch.hpp
+ *
+ * Notch filter for three axes that follows the strongest vibration peak,
+ * found with a sliding DFT over the incoming samples.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "FilterBank.hpp"
+
+namespace math
+{
+
+class __EXPORT DynamicNotch
+{
+public:
+	static const unsigned WINDOW = 64;		///< sliding DFT length
+	static const unsigned MAX_BINS = WINDOW / 2;	///< bins up to the Nyquist frequency of the analysed stream
+
+	DynamicNotch();
+
+	/**
+	 * Configure the analysis and the notch.
+	 *
+	 * Samples above roughly twice max_freq are averaged down before the
+	 * analysis, so the DFT cost and resolution do not grow with the sample rate.
+	 *
+	 * @param sample_freq	Rate in Hz at which apply() is called.
+	 * @param min_freq	Lowest frequency in Hz searched for a peak.
+	 * @param max_freq	Highest frequency in Hz searched for a peak.
+	 * @param q		Quality of the notch, center frequency over bandwidth.
+	 */
+	void init(float sample_freq, float min_freq, float max_freq, float q);
+
+	/**
+	 * Feed one sample of the three axes into the analysis and notch it in place.
+	 */
+	void apply(float sample[3]);
+
+	/**
+	 * Follow an externally known vibration frequency (e.g. from ESC RPM)
+	 * instead of the DFT peak for the next 100 ms.
+	 */
+	void set_external_frequency(float freq);
+
+	float get_notch_freq() const { return _notch_freq; }
+	float get_peak_freq() const { return _peak_freq; }
+	float get_peak_snr() const { return _peak_snr; }
+
+	/**
+	 * True if the spectrum was updated since the last get_spectrum().
+	 */
+	bool spectrum_updated() const { return _spectrum_updated; }
+
+	/**
+	 * Copy out the magnitude of the searched bins.
+	 *
+	 * @param magnitude	Destination, MAX_BINS entries.
+	 * @param start_freq	Frequency in Hz of magnitude[0].
+	 * @param resolution	Bin width in Hz.
+	 * @param analysis_freq	Rate in Hz of the analysed stream.
+	 * @return		Number of valid bins.
+	 */
+	unsigned get_spectrum(float magnitude[MAX_BINS], float &start_freq, float &resolution, float &analysis_freq);
+
+private:
+	float		_sample_freq;
+	float		_analysis_freq;
+	float		_q;
+	unsigned	_decimation;
+	unsigned	_decimation_count;
+	float		_decimation_sum[3];
+
+	unsigned	_bin_min;
+	unsigned	_bin_count;
+	float		_twiddle_re[MAX_BINS];
+	float		_twiddle_im[MAX_BINS];
+	float		_re[MAX_BINS][3];
+	float		_im[MAX_BINS][3];
+	float		_history[WINDOW][3];
+	unsigned	_history_index;
+	float		_damping_window;	///< damping factor to the power of WINDOW
+
+	float		_magnitude[MAX_BINS];
+	unsigned	_samples_since_update;
+	bool		_spectrum_updated;
+
+	float		_peak_freq;
+	float		_peak_snr;
+	float		_notch_freq;
+	unsigned	_notch_hold;
+
+	float		_external_freq;
+	unsigned	_external_timeout;
+
+	FilterBank<3>	_notch;
+
+	void analyse(const float sample[3]);
+	void update_peak();
+	void set_notch(float freq);
+};
+
+} // namespace math
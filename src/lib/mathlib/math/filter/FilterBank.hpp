@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file FilterBank.hpp
+ *
+ * Cascaded biquad filters applied to N channels at once.
+ *
+ * All channels share the coefficients of a stage and the state is kept
+ * per stage as contiguous channel arrays, so one stage is a straight
+ * pass over the channels. On targets with SSE or NEON four channels are
+ * processed per instruction using the GCC vector extensions, with the
+ * state padded to whole vectors so that e.g. the three axes of a sensor
+ * take a single pass. Otherwise (e.g. Cortex-M4) a scalar loop does the
+ * same work.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <string.h>
+
+#include <px4_defines.h>
+
+#if defined(__GNUC__) && (defined(__SSE__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define FILTERBANK_SIMD 1
+#endif
+
+#ifndef M_PI_F
+#define M_PI_F 3.14159f
+#endif
+
+namespace math
+{
+
+/**
+ * Biquad coefficients, normalized to a0 = 1.
+ */
+struct BiquadCoefficients {
+	float b0;
+	float b1;
+	float b2;
+	float a1;
+	float a2;
+
+	/**
+	 * Pass the input through unchanged.
+	 */
+	static BiquadCoefficients passthrough()
+	{
+		BiquadCoefficients c = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+		return c;
+	}
+
+	/**
+	 * Second order Butterworth low pass, the same filter as LowPassFilter2p.
+	 * A cutoff frequency <= 0 disables filtering.
+	 */
+	static BiquadCoefficients lowpass2p(float sample_freq, float cutoff_freq)
+	{
+		if (cutoff_freq <= 0.0f) {
+			return passthrough();
+		}
+
+		BiquadCoefficients c;
+		float fr = sample_freq / cutoff_freq;
+		float ohm = tanf(M_PI_F / fr);
+		float k = 1.0f + 2.0f * cosf(M_PI_F / 4.0f) * ohm + ohm * ohm;
+		c.b0 = ohm * ohm / k;
+		c.b1 = 2.0f * c.b0;
+		c.b2 = c.b0;
+		c.a1 = 2.0f * (ohm * ohm - 1.0f) / k;
+		c.a2 = (1.0f - 2.0f * cosf(M_PI_F / 4.0f) * ohm + ohm * ohm) / k;
+		return c;
+	}
+
+	/**
+	 * Notch filter removing center_freq with the given -3 dB bandwidth.
+	 * A center frequency or bandwidth <= 0 disables filtering.
+	 */
+	static BiquadCoefficients notch(float sample_freq, float center_freq, float bandwidth)
+	{
+		if (center_freq <= 0.0f || bandwidth <= 0.0f) {
+			return passthrough();
+		}
+
+		BiquadCoefficients c;
+		float w0 = 2.0f * M_PI_F * center_freq / sample_freq;
+		float alpha = sinf(w0) / (2.0f * center_freq / bandwidth);
+		float a0 = 1.0f + alpha;
+		c.b0 = 1.0f / a0;
+		c.b1 = -2.0f * cosf(w0) / a0;
+		c.b2 = c.b0;
+		c.a1 = c.b1;
+		c.a2 = (1.0f - alpha) / a0;
+		return c;
+	}
+};
+
+/**
+ * N channel filter of STAGES cascaded biquads (direct form II, like
+ * LowPassFilter2p). Non-finite intermediate values are replaced by the
+ * stage input so bad samples don't propagate via the filter state.
+ */
+template<unsigned N, unsigned STAGES = 1>
+class FilterBank
+{
+public:
+	FilterBank()
+	{
+		for (unsigned s = 0; s < STAGES; s++) {
+			_coeff[s] = BiquadCoefficients::passthrough();
+		}
+
+		memset(_delay_element_1, 0, sizeof(_delay_element_1));
+		memset(_delay_element_2, 0, sizeof(_delay_element_2));
+	}
+
+	/**
+	 * Set the coefficients of one stage, keeping the filter state.
+	 */
+	void set_stage(unsigned stage, const BiquadCoefficients &coeff)
+	{
+		if (stage < STAGES) {
+			_coeff[stage] = coeff;
+		}
+	}
+
+	const BiquadCoefficients &get_stage(unsigned stage) const { return _coeff[stage]; }
+
+	/**
+	 * Filter one sample of every channel in place.
+	 */
+	void apply(float sample[N])
+	{
+		for (unsigned s = 0; s < STAGES; s++) {
+			apply_stage(s, sample);
+		}
+	}
+
+	/**
+	 * Filter a block of interleaved samples, in[count][N] to out[count][N].
+	 * in and out may be the same buffer.
+	 */
+	void apply(const float *in, float *out, unsigned count)
+	{
+		for (unsigned i = 0; i < count; i++) {
+			if (out != in) {
+				memcpy(&out[i * N], &in[i * N], sizeof(float) * N);
+			}
+
+			apply(&out[i * N]);
+		}
+	}
+
+	/**
+	 * Reset the filter state to the steady state of a constant input and
+	 * filter that input.
+	 */
+	void reset(float sample[N])
+	{
+		for (unsigned s = 0; s < STAGES; s++) {
+			const BiquadCoefficients &c = _coeff[s];
+			const float gain = c.b0 + c.b1 + c.b2;
+
+			for (unsigned ch = 0; ch < N; ch++) {
+				float dval = (gain != 0.0f) ? sample[ch] / gain : 0.0f;
+				_delay_element_1[s][ch] = dval;
+				_delay_element_2[s][ch] = dval;
+			}
+
+			apply_stage(s, sample);
+		}
+	}
+
+private:
+#if defined(FILTERBANK_SIMD)
+	static const unsigned LANES = (N + 3u) & ~3u;	///< N rounded up to whole vectors
+#else
+	static const unsigned LANES = N;
+#endif
+
+	BiquadCoefficients _coeff[STAGES];
+	float _delay_element_1[STAGES][LANES];	// buffered sample -1
+	float _delay_element_2[STAGES][LANES];	// buffered sample -2
+
+	void apply_stage(unsigned s, float sample[N])
+	{
+		const BiquadCoefficients &c = _coeff[s];
+		float *d1 = _delay_element_1[s];
+		float *d2 = _delay_element_2[s];
+		unsigned ch = 0;
+
+#if defined(FILTERBANK_SIMD)
+		typedef float v4sf __attribute__((vector_size(16)));
+		typedef int v4si __attribute__((vector_size(16)));
+
+		for (; ch < N; ch += 4) {
+			// the last vector may be partial: its lanes are moved one by
+			// one and the padding lanes are fed zeros, so their state
+			// stays zero
+			const unsigned lanes = (N - ch < 4) ? N - ch : 4;
+			v4sf x = {0.0f, 0.0f, 0.0f, 0.0f};
+			v4sf e1, e2;
+
+			if (lanes == 4) {
+				memcpy(&x, &sample[ch], sizeof(x));
+
+			} else {
+				for (unsigned k = 0; k < lanes; k++) {
+					x[k] = sample[ch + k];
+				}
+			}
+
+			memcpy(&e1, &d1[ch], sizeof(e1));
+			memcpy(&e2, &d2[ch], sizeof(e2));
+
+			v4sf e0 = x - e1 * c.a1 - e2 * c.a2;
+
+			// x - x is 0 for finite values and NaN otherwise
+			v4si finite = ((e0 - e0) == 0.0f);
+			e0 = (v4sf)(((v4si)e0 & finite) | ((v4si)x & ~finite));
+
+			v4sf y = e0 * c.b0 + e1 * c.b1 + e2 * c.b2;
+
+			memcpy(&d2[ch], &e1, sizeof(e1));
+			memcpy(&d1[ch], &e0, sizeof(e0));
+
+			if (lanes == 4) {
+				memcpy(&sample[ch], &y, sizeof(y));
+
+			} else {
+				for (unsigned k = 0; k < lanes; k++) {
+					sample[ch + k] = y[k];
+				}
+			}
+		}
+
+#endif
+
+		for (; ch < N; ch++) {
+			float e0 = sample[ch] - d1[ch] * c.a1 - d2[ch] * c.a2;
+
+			if (!PX4_ISFINITE(e0)) {
+				e0 = sample[ch];
+			}
+
+			float y = e0 * c.b0 + d1[ch] * c.b1 + d2[ch] * c.b2;
+
+			d2[ch] = d1[ch];
+			d1[ch] = e0;
+			sample[ch] = y;
+		}
+	}
+};
+
+} // namespace math
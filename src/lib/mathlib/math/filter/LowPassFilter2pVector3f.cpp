@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file LowPassFilter2pVector3f.cpp
+ */
+
+#include "LowPassFilter2pVector3f.hpp"
+
+namespace math
+{
+
+void LowPassFilter2pVector3f::set_cutoff_frequency(float sample_freq, float cutoff_freq)
+{
+	_cutoff_freq = cutoff_freq;
+
+	if (_cutoff_freq <= 0.0f) {
+		// no filtering
+		_filter.set_stage(0, BiquadCoefficients::passthrough());
+		return;
+	}
+
+	_filter.set_stage(0, BiquadCoefficients::lowpass2p(sample_freq, cutoff_freq));
+}
+
+Vector<3> LowPassFilter2pVector3f::apply(const Vector<3> &sample)
+{
+	Vector<3> output(sample);
+	_filter.apply(output.data);
+	return output;
+}
+
+Vector<3> LowPassFilter2pVector3f::reset(const Vector<3> &sample)
+{
+	Vector<3> output(sample);
+	_filter.reset(output.data);
+	return output;
+}
+
+} // namespace math
@@ -46,6 +46,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <termios.h>
+#include <string.h>
 
 #include "dsm.h"
 #include <drivers/drv_hrt.h>
@@ -59,23 +60,18 @@
 
 //#define DSM_DEBUG
 
-static enum DSM_DECODE_STATE {
+enum DSM_DECODE_STATE {
 	DSM_DECODE_STATE_DESYNC = 0,
 	DSM_DECODE_STATE_SYNC
-} dsm_decode_state = DSM_DECODE_STATE_DESYNC;
+};
 
 static int dsm_fd = -1;						/**< File handle to the DSM UART */
-static hrt_abstime dsm_last_rx_time;            /**< Timestamp when we last received data */
-static hrt_abstime dsm_last_frame_time;		/**< Timestamp for start of last valid dsm frame */
-static uint8_t dsm_frame[DSM_BUFFER_SIZE];	/**< DSM dsm frame receive buffer */
 static uint8_t dsm_buf[DSM_FRAME_SIZE * 2];
-static unsigned dsm_partial_frame_count;	/**< Count of bytes received for current dsm frame */
-static unsigned dsm_channel_shift = 0;			/**< Channel resolution, 0=unknown, 1=10 bit, 2=11 bit */
-static unsigned dsm_frame_drops = 0;			/**< Count of incomplete DSM frames */
-static uint16_t dsm_chan_count = 0;         /**< DSM channel count */
+static dsm_decoder_t dsm_default_decoder;	/**< Decoder behind the dsm_* entry points */
 
 static bool
-dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool *dsm_11_bit, unsigned max_values);
+dsm_decode(dsm_decoder_t *decoder, hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool *dsm_11_bit,
+	   unsigned max_values);
 
 /**
  * Attempt to decode a single channel raw channel datum
@@ -123,52 +119,49 @@ dsm_decode_channel(uint16_t raw, unsigned shift, unsigned *channel, unsigned *va
 /**
  * Attempt to guess if receiving 10 or 11 bit channel values
  *
+ * @param[in] decoder decoder whose current frame is sniffed
  * @param[in] reset true=reset the 10/11 bit state to unknown
  */
 static bool
-dsm_guess_format(bool reset)
+dsm_guess_format(dsm_decoder_t *decoder, bool reset)
 {
-	static uint32_t	cs10 = 0;
-	static uint32_t	cs11 = 0;
-	static unsigned samples = 0;
-
 	/* reset the 10/11 bit sniffed channel masks */
 	if (reset) {
-		cs10 = 0;
-		cs11 = 0;
-		samples = 0;
-		dsm_channel_shift = 0;
+		decoder->cs10 = 0;
+		decoder->cs11 = 0;
+		decoder->samples = 0;
+		decoder->channel_shift = 0;
 		return false;
 	}
 
 	/* scan the channels in the current dsm_frame in both 10- and 11-bit mode */
 	for (unsigned i = 0; i < DSM_FRAME_CHANNELS; i++) {
 
-		uint8_t *dp = &dsm_frame[2 + (2 * i)];
+		uint8_t *dp = &decoder->frame[2 + (2 * i)];
 		uint16_t raw = (dp[0] << 8) | dp[1];
 		unsigned channel, value;
 
 		/* if the channel decodes, remember the assigned number */
 		if (dsm_decode_channel(raw, 10, &channel, &value) && (channel < 31)) {
-			cs10 |= (1 << channel);
+			decoder->cs10 |= (1 << channel);
 		}
 
 		if (dsm_decode_channel(raw, 11, &channel, &value) && (channel < 31)) {
-			cs11 |= (1 << channel);
+			decoder->cs11 |= (1 << channel);
 		}
 
 		/* XXX if we cared, we could look for the phase bit here to decide 1 vs. 2-dsm_frame format */
 	}
 
-	samples++;
+	decoder->samples++;
 
 #ifdef DSM_DEBUG
-	printf("dsm guess format: samples: %d %s\n", samples,
+	printf("dsm guess format: samples: %d %s\n", decoder->samples,
 	       (reset) ? "RESET" : "");
 #endif
 
 	/* wait until we have seen plenty of frames - 5 should normally be enough */
-	if (samples < 5) {
+	if (decoder->samples < 5) {
 		return false;
 	}
 
@@ -197,17 +190,17 @@ dsm_guess_format(bool reset)
 
 	for (unsigned i = 0; i < (sizeof(masks) / sizeof(masks[0])); i++) {
 
-		if (cs10 == masks[i]) {
+		if (decoder->cs10 == masks[i]) {
 			votes10++;
 		}
 
-		if (cs11 == masks[i]) {
+		if (decoder->cs11 == masks[i]) {
 			votes11++;
 		}
 	}
 
 	if ((votes11 == 1) && (votes10 == 0)) {
-		dsm_channel_shift = 11;
+		decoder->channel_shift = 11;
 #ifdef DSM_DEBUG
 		printf("DSM: 11-bit format\n");
 #endif
@@ -215,7 +208,7 @@ dsm_guess_format(bool reset)
 	}
 
 	if ((votes10 == 1) && (votes11 == 0)) {
-		dsm_channel_shift = 10;
+		decoder->channel_shift = 10;
 #ifdef DSM_DEBUG
 		printf("DSM: 10-bit format\n");
 #endif
@@ -224,12 +217,19 @@ dsm_guess_format(bool reset)
 
 	/* call ourselves to reset our state ... we have to try again */
 #ifdef DSM_DEBUG
-	printf("DSM: format detect fail, 10: 0x%08x %d 11: 0x%08x %d\n", cs10, votes10, cs11, votes11);
+	printf("DSM: format detect fail, 10: 0x%08x %d 11: 0x%08x %d\n", decoder->cs10, votes10, decoder->cs11, votes11);
 #endif
-	dsm_guess_format(true);
+	dsm_guess_format(decoder, true);
 	return false;
 }
 
+void
+dsm_decoder_init(dsm_decoder_t *decoder)
+{
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->decode_state = DSM_DECODE_STATE_DESYNC;
+}
+
 int
 dsm_config(int fd)
 {
@@ -251,11 +251,11 @@ dsm_config(int fd)
 		tcsetattr(fd, TCSANOW, &t);
 
 		/* initialise the decoder */
-		dsm_partial_frame_count = 0;
-		dsm_last_rx_time = hrt_absolute_time();
+		dsm_default_decoder.partial_frame_count = 0;
+		dsm_default_decoder.last_rx_time = hrt_absolute_time();
 
 		/* reset the format detector */
-		dsm_guess_format(true);
+		dsm_guess_format(&dsm_default_decoder, true);
 
 		ret = 0;
 	}
@@ -278,10 +278,7 @@ dsm_init(const char *device)
 		dsm_fd = open(device, O_RDONLY | O_NONBLOCK);
 	}
 
-	dsm_channel_shift = 0;
-	dsm_frame_drops = 0;
-	dsm_chan_count = 0;
-	dsm_decode_state = DSM_DECODE_STATE_DESYNC;
+	dsm_decoder_init(&dsm_default_decoder);
 
 	int ret = dsm_config(dsm_fd);
 
@@ -319,7 +316,7 @@ dsm_bind(uint16_t cmd, int pulses)
 
 		/*power up DSM satellite*/
 		POWER_SPEKTRUM(1);
-		dsm_guess_format(true);
+		dsm_guess_format(&dsm_default_decoder, true);
 		break;
 
 	case DSM_CMD_BIND_SET_RX_OUT:
@@ -353,14 +350,18 @@ dsm_bind(uint16_t cmd, int pulses)
 /**
  * Decode the entire dsm frame (all contained channels)
  *
+ * @param[in] decoder decoder holding the complete frame
  * @param[in] frame_time timestamp when this dsm frame was received. Used to detect RX loss in order to reset 10/11 bit guess.
  * @param[out] values pointer to per channel array of decoded values
  * @param[out] num_values pointer to number of raw channel values returned
  * @return true=DSM frame successfully decoded, false=no update
  */
 bool
-dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool *dsm_11_bit, unsigned max_values)
+dsm_decode(dsm_decoder_t *decoder, hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool *dsm_11_bit,
+	   unsigned max_values)
 {
+	const uint8_t *dsm_frame = decoder->frame;
+
 	/*
 	debug("DSM dsm_frame %02x%02x %02x%02x %02x%02x %02x%02x %02x%02x %02x%02x %02x%02x %02x%02x",
 		dsm_frame[0], dsm_frame[1], dsm_frame[2], dsm_frame[3], dsm_frame[4], dsm_frame[5], dsm_frame[6], dsm_frame[7],
@@ -370,13 +371,13 @@ dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool
 	 * If we have lost signal for at least a second, reset the
 	 * format guessing heuristic.
 	 */
-	if (((frame_time - dsm_last_frame_time) > 1000000) && (dsm_channel_shift != 0)) {
-		dsm_guess_format(true);
+	if (((frame_time - decoder->last_frame_time) > 1000000) && (decoder->channel_shift != 0)) {
+		dsm_guess_format(decoder, true);
 	}
 
 	/* if we don't know the dsm_frame format, update the guessing state machine */
-	if (dsm_channel_shift == 0) {
-		if (!dsm_guess_format(false)) {
+	if (decoder->channel_shift == 0) {
+		if (!dsm_guess_format(decoder, false)) {
 			return false;
 		}
 	}
@@ -394,17 +395,17 @@ dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool
 
 	for (unsigned i = 0; i < DSM_FRAME_CHANNELS; i++) {
 
-		uint8_t *dp = &dsm_frame[2 + (2 * i)];
+		const uint8_t *dp = &dsm_frame[2 + (2 * i)];
 		uint16_t raw = (dp[0] << 8) | dp[1];
 		unsigned channel, value;
 
-		if (!dsm_decode_channel(raw, dsm_channel_shift, &channel, &value)) {
+		if (!dsm_decode_channel(raw, decoder->channel_shift, &channel, &value)) {
 			continue;
 		}
 
 		/* reset bit guessing state machine if the channel index is out of bounds */
 		if (channel > DSM_MAX_CHANNEL_COUNT) {
-			dsm_guess_format(true);
+			dsm_guess_format(decoder, true);
 			return false;
 		}
 
@@ -419,7 +420,7 @@ dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool
 		}
 
 		/* convert 0-1024 / 0-2048 values to 1000-2000 ppm encoding. */
-		if (dsm_channel_shift == 10) {
+		if (decoder->channel_shift == 10) {
 			value *= 2;
 		}
 
@@ -476,10 +477,10 @@ dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool
 	}
 
 	/* Set the 11-bit data indicator */
-	*dsm_11_bit = (dsm_channel_shift == 11);
+	*dsm_11_bit = (decoder->channel_shift == 11);
 
 	/* we have received something we think is a dsm_frame */
-	dsm_last_frame_time = frame_time;
+	decoder->last_frame_time = frame_time;
 
 	/*
 	 * XXX Note that we may be in failsafe here; we need to work out how to detect that.
@@ -496,7 +497,7 @@ dsm_decode(hrt_abstime frame_time, uint16_t *values, uint16_t *num_values, bool
 #ifdef DSM_DEBUG
 			printf("DSM: VALUE RANGE FAIL\n");
 #endif
-			dsm_chan_count = 0;
+			decoder->chan_count = 0;
 			return false;
 		}
 	}
@@ -568,13 +569,27 @@ dsm_input(int fd, uint16_t *values, uint16_t *num_values, bool *dsm_11_bit, uint
 	/*
 	 * Try to decode something with what we got
 	 */
-	return dsm_parse(now, &dsm_buf[0], ret, values, num_values, dsm_11_bit, &dsm_frame_drops, max_values);
+	return dsm_parse(now, &dsm_buf[0], ret, values, num_values, dsm_11_bit, NULL, max_values);
 }
 
 bool
 dsm_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 	  uint16_t *num_values, bool *dsm_11_bit, unsigned *frame_drops, uint16_t max_channels)
 {
+	bool decode_ret = dsm_decoder_parse(&dsm_default_decoder, now, frame, len, values, num_values,
+					    dsm_11_bit, max_channels);
+
+	if (frame_drops) {
+		*frame_drops = dsm_default_decoder.frame_drops;
+	}
+
+	return decode_ret;
+}
+
+bool
+dsm_decoder_parse(dsm_decoder_t *decoder, uint64_t now, const uint8_t *buf, unsigned len, uint16_t *values,
+		  uint16_t *num_values, bool *dsm_11_bit, uint16_t max_channels)
+{
 
 	/* this is set by the decoding state machine and will default to false
 	 * once everything that was decodable has been decoded.
@@ -585,50 +600,61 @@ dsm_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 	for (unsigned d = 0; d < len; d++) {
 
 		/* overflow check */
-		if (dsm_partial_frame_count == sizeof(dsm_frame) / sizeof(dsm_frame[0])) {
-			dsm_partial_frame_count = 0;
-			dsm_decode_state = DSM_DECODE_STATE_DESYNC;
+		if (decoder->partial_frame_count == sizeof(decoder->frame) / sizeof(decoder->frame[0])) {
+			decoder->partial_frame_count = 0;
+			decoder->decode_state = DSM_DECODE_STATE_DESYNC;
 #ifdef DSM_DEBUG
 			printf("DSM: RESET (BUF LIM)\n");
 #endif
 		}
 
-		if (dsm_partial_frame_count == DSM_FRAME_SIZE) {
-			dsm_partial_frame_count = 0;
-			dsm_decode_state = DSM_DECODE_STATE_DESYNC;
+		if (decoder->partial_frame_count == DSM_FRAME_SIZE) {
+			decoder->partial_frame_count = 0;
+			decoder->decode_state = DSM_DECODE_STATE_DESYNC;
 #ifdef DSM_DEBUG
 			printf("DSM: RESET (PACKET LIM)\n");
 #endif
 		}
 
 #ifdef DSM_DEBUG
-#if 1
 		printf("dsm state: %s%s, count: %d, val: %02x\n",
-		       (dsm_decode_state == DSM_DECODE_STATE_DESYNC) ? "DSM_DECODE_STATE_DESYNC" : "",
-		       (dsm_decode_state == DSM_DECODE_STATE_SYNC) ? "DSM_DECODE_STATE_SYNC" : "",
-		       dsm_partial_frame_count,
-		       (unsigned)frame[d]);
-#endif
+		       (decoder->decode_state == DSM_DECODE_STATE_DESYNC) ? "DSM_DECODE_STATE_DESYNC" : "",
+		       (decoder->decode_state == DSM_DECODE_STATE_SYNC) ? "DSM_DECODE_STATE_SYNC" : "",
+		       decoder->partial_frame_count,
+		       (unsigned)buf[d]);
 #endif
 
-		switch (dsm_decode_state) {
+		switch (decoder->decode_state) {
 		case DSM_DECODE_STATE_DESYNC:
 
-			/* we are de-synced and only interested in the frame marker */
-			if ((now - dsm_last_rx_time) > 5000) {
-				dsm_decode_state = DSM_DECODE_STATE_SYNC;
-				dsm_partial_frame_count = 0;
-				dsm_chan_count = 0;
-				dsm_frame[dsm_partial_frame_count++] = frame[d];
+			/* we are de-synced and only interested in the frame marker,
+			 * without a gap before this buffer none of its bytes can start a frame */
+			if ((now - decoder->last_rx_time) <= 5000) {
+				d = len;
+				break;
 			}
 
+			decoder->decode_state = DSM_DECODE_STATE_SYNC;
+			decoder->partial_frame_count = 0;
+			decoder->chan_count = 0;
+			decoder->frame[decoder->partial_frame_count++] = buf[d];
+
 			break;
 
 		case DSM_DECODE_STATE_SYNC: {
-				dsm_frame[dsm_partial_frame_count++] = frame[d];
+				/* take as much of the frame as is available in one go */
+				unsigned count = DSM_FRAME_SIZE - decoder->partial_frame_count;
+
+				if (count > len - d) {
+					count = len - d;
+				}
+
+				memcpy(&decoder->frame[decoder->partial_frame_count], &buf[d], count);
+				decoder->partial_frame_count += count;
+				d += count - 1;
 
 				/* decode whatever we got and expect */
-				if (dsm_partial_frame_count < DSM_FRAME_SIZE) {
+				if (decoder->partial_frame_count < DSM_FRAME_SIZE) {
 					break;
 				}
 
@@ -636,15 +662,15 @@ dsm_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 				 * Great, it looks like we might have a frame.  Go ahead and
 				 * decode it.
 				 */
-				decode_ret = dsm_decode(now, values, &dsm_chan_count, dsm_11_bit, max_channels);
+				decode_ret = dsm_decode(decoder, now, values, &decoder->chan_count, dsm_11_bit, max_channels);
 
 				/* we consumed the partial frame, reset */
-				dsm_partial_frame_count = 0;
+				decoder->partial_frame_count = 0;
 
 				/* if decoding failed, set proto to desync */
 				if (decode_ret == false) {
-					dsm_decode_state = DSM_DECODE_STATE_DESYNC;
-					dsm_frame_drops++;
+					decoder->decode_state = DSM_DECODE_STATE_DESYNC;
+					decoder->frame_drops++;
 				}
 			}
 			break;
@@ -659,15 +685,11 @@ dsm_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 
 	}
 
-	if (frame_drops) {
-		*frame_drops = dsm_frame_drops;
-	}
-
 	if (decode_ret) {
-		*num_values = dsm_chan_count;
+		*num_values = decoder->chan_count;
 	}
 
-	dsm_last_rx_time = now;
+	decoder->last_rx_time = now;
 
 	/* return false as default */
 	return decode_ret;
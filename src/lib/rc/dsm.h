@@ -53,6 +53,39 @@ __BEGIN_DECLS
 #define DSM_MAX_CHANNEL_COUNT   18  /**< Max channel count of any DSM RC */
 #define DSM_BUFFER_SIZE		(DSM_FRAME_SIZE + DSM_FRAME_SIZE / 2)
 
+/**
+ * DSM decoder state
+ *
+ * Each receiver needs its own instance, the dsm_* entry points
+ * below operate on a single shared one.
+ */
+typedef struct {
+	uint64_t	last_rx_time;			/**< Timestamp when we last received data */
+	uint64_t	last_frame_time;		/**< Timestamp for start of last valid dsm frame */
+	unsigned	decode_state;			/**< Framing state */
+	unsigned	partial_frame_count;		/**< Count of bytes received for current dsm frame */
+	unsigned	channel_shift;			/**< Channel resolution, 0=unknown, 10=10 bit, 11=11 bit */
+	unsigned	frame_drops;			/**< Count of incomplete DSM frames */
+	uint16_t	chan_count;			/**< DSM channel count */
+	uint32_t	cs10;				/**< Channels seen while guessing 10 bit format */
+	uint32_t	cs11;				/**< Channels seen while guessing 11 bit format */
+	unsigned	samples;			/**< Frames seen while guessing the format */
+	uint8_t		frame[DSM_BUFFER_SIZE];		/**< DSM frame receive buffer */
+} dsm_decoder_t;
+
+/**
+ * Reset a decoder to the unsynced state and restart format detection
+ */
+__EXPORT void	dsm_decoder_init(dsm_decoder_t *decoder);
+
+/**
+ * Feed a buffer of received bytes into a decoder
+ *
+ * @return true if the last frame completed in buf was decoded
+ */
+__EXPORT bool	dsm_decoder_parse(dsm_decoder_t *decoder, uint64_t now, const uint8_t *buf, unsigned len,
+				  uint16_t *values, uint16_t *num_values, bool *dsm_11_bit, uint16_t max_channels);
+
 __EXPORT int	dsm_init(const char *device);
 __EXPORT int	dsm_config(int dsm_fd);
 __EXPORT bool	dsm_input(int dsm_fd, uint16_t *values, uint16_t *num_values, bool *dsm_11_bit, uint8_t *n_bytes,
@@ -3,6 +3,7 @@
 #include <systemlib/err.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <drivers/drv_hrt.h>
@@ -21,6 +22,331 @@
 
 extern "C" __EXPORT int rc_tests_main(int argc, char *argv[]);
 
+namespace
+{
+
+/* adapters giving all decoders the same shape for the generic tests below */
+struct SbusDecoder {
+	sbus_decoder_t decoder;
+	void init() { sbus_decoder_init(&decoder); }
+	bool parse(hrt_abstime now, const uint8_t *buf, unsigned len, uint16_t *values, uint16_t *num_values,
+		   uint16_t max_channels)
+	{
+		bool failsafe, frame_drop;
+		return sbus_decoder_parse(&decoder, now, buf, len, values, num_values, &failsafe, &frame_drop, max_channels);
+	}
+};
+
+struct DsmDecoder {
+	dsm_decoder_t decoder;
+	void init() { dsm_decoder_init(&decoder); }
+	bool parse(hrt_abstime now, const uint8_t *buf, unsigned len, uint16_t *values, uint16_t *num_values,
+		   uint16_t max_channels)
+	{
+		bool dsm_11_bit;
+		return dsm_decoder_parse(&decoder, now, buf, len, values, num_values, &dsm_11_bit, max_channels);
+	}
+};
+
+struct St24Decoder {
+	st24_decoder_t decoder;
+	void init() { st24_decoder_init(&decoder); }
+	bool parse(hrt_abstime now, const uint8_t *buf, unsigned len, uint16_t *values, uint16_t *num_values,
+		   uint16_t max_channels)
+	{
+		uint8_t rssi, rx_count;
+		return st24_decoder_parse(&decoder, buf, len, &rssi, &rx_count, num_values, values, max_channels) == 0;
+	}
+};
+
+struct SumdDecoder {
+	sumd_decoder_t decoder;
+	void init() { sumd_decoder_init(&decoder); }
+	bool parse(hrt_abstime now, const uint8_t *buf, unsigned len, uint16_t *values, uint16_t *num_values,
+		   uint16_t max_channels)
+	{
+		uint8_t rssi, rx_count = 0;
+		return sumd_decoder_parse(&decoder, buf, len, &rssi, &rx_count, num_values, values, max_channels) == 0;
+	}
+};
+
+/* a recorded byte stream, one byte and its arrival time per line */
+struct Stream {
+	static const unsigned max_bytes = 20000;
+	uint8_t bytes[max_bytes];
+	hrt_abstime times[max_bytes];
+	unsigned count;
+};
+
+Stream g_stream;
+
+bool load_stream(const char *filepath)
+{
+	g_stream.count = 0;
+	FILE *fp = fopen(filepath, "rt");
+
+	if (fp == nullptr) {
+		return false;
+	}
+
+	// Trash the first 20 lines
+	for (unsigned i = 0; i < 20; i++) {
+		char buf[200];
+		(void)fgets(buf, sizeof(buf), fp);
+	}
+
+	float f;
+	unsigned x;
+
+	while (g_stream.count < Stream::max_bytes && fscanf(fp, "%f,%x,,", &f, &x) == 2) {
+		g_stream.bytes[g_stream.count] = x;
+		g_stream.times[g_stream.count] = f * 1e6f;
+		g_stream.count++;
+	}
+
+	fclose(fp);
+	return g_stream.count > 0;
+}
+
+unsigned next_random(unsigned &seed)
+{
+	seed = seed * 1103515245u + 12345u;
+	return seed >> 8;
+}
+
+struct DecodeResult {
+	unsigned frames;
+	uint16_t num_values;
+	uint16_t values[32];
+};
+
+/* decode the loaded stream in random chunks of 1..max_chunk bytes */
+template<class D>
+void decode_stream(D &decoder, unsigned seed, unsigned max_chunk, DecodeResult &result)
+{
+	memset(&result, 0, sizeof(result));
+
+	for (unsigned pos = 0; pos < g_stream.count;) {
+		unsigned len = 1 + next_random(seed) % max_chunk;
+
+		if (len > g_stream.count - pos) {
+			len = g_stream.count - pos;
+		}
+
+		if (decoder.parse(g_stream.times[pos], &g_stream.bytes[pos], len, result.values, &result.num_values, 18)) {
+			result.frames++;
+		}
+
+		pos += len;
+	}
+}
+
+/* feed noise into a second decoder between every chunk, the first one must not notice */
+template<class D>
+bool multi_instance(const char *filepath)
+{
+	if (!load_stream(filepath)) {
+		return false;
+	}
+
+	D single, first, second;
+	single.init();
+	first.init();
+	second.init();
+
+	DecodeResult expected, result;
+	decode_stream(single, 7, 40, expected);
+
+	memset(&result, 0, sizeof(result));
+	unsigned seed = 7;
+	unsigned noise_seed = 11;
+
+	for (unsigned pos = 0; pos < g_stream.count;) {
+		unsigned len = 1 + next_random(seed) % 40;
+
+		if (len > g_stream.count - pos) {
+			len = g_stream.count - pos;
+		}
+
+		if (first.parse(g_stream.times[pos], &g_stream.bytes[pos], len, result.values, &result.num_values, 18)) {
+			result.frames++;
+		}
+
+		uint8_t noise[16];
+		uint16_t values[32];
+		uint16_t num_values;
+
+		for (unsigned i = 0; i < sizeof(noise); i++) {
+			noise[i] = next_random(noise_seed);
+		}
+
+		second.parse(g_stream.times[pos], noise, sizeof(noise), values, &num_values, 18);
+		pos += len;
+	}
+
+	return expected.frames > 0 && memcmp(&expected, &result, sizeof(result)) == 0;
+}
+
+/* bulk parsing must report the same frames as parsing the same chunks byte by byte */
+template<class D>
+bool chunked(const char *filepath)
+{
+	if (!load_stream(filepath)) {
+		return false;
+	}
+
+	D bulk, bytewise;
+	bulk.init();
+	bytewise.init();
+	unsigned seed = 3;
+	unsigned frames = 0;
+
+	for (unsigned pos = 0; pos < g_stream.count;) {
+		unsigned len = 1 + next_random(seed) % 64;
+
+		if (len > g_stream.count - pos) {
+			len = g_stream.count - pos;
+		}
+
+		uint16_t values[32], bytewise_values[32];
+		uint16_t num_values = 0, bytewise_num_values = 0;
+		bool decoded = bulk.parse(g_stream.times[pos], &g_stream.bytes[pos], len, values, &num_values, 18);
+		bool bytewise_decoded = false;
+
+		for (unsigned i = 0; i < len; i++) {
+			bytewise_decoded |= bytewise.parse(g_stream.times[pos], &g_stream.bytes[pos + i], 1, bytewise_values,
+							   &bytewise_num_values, 18);
+		}
+
+		if (decoded != bytewise_decoded) {
+			return false;
+		}
+
+		if (decoded) {
+			if (num_values != bytewise_num_values
+			    || memcmp(values, bytewise_values, num_values * sizeof(values[0])) != 0) {
+				return false;
+			}
+
+			frames++;
+		}
+
+		pos += len;
+	}
+
+	return frames > 0;
+}
+
+/* random and corrupted input must never produce more channels than asked for */
+template<class D>
+bool fuzz(const char *filepath, uint8_t sync_byte)
+{
+	if (!load_stream(filepath)) {
+		return false;
+	}
+
+	static const uint16_t max_channels = 18;
+	static const uint16_t guard = 0xa5a5;
+	D decoder;
+	decoder.init();
+	unsigned seed = 5;
+	hrt_abstime now = 0;
+
+	for (unsigned round = 0; round < 20000; round++) {
+		uint8_t buf[64];
+		unsigned len = 1 + next_random(seed) % sizeof(buf);
+		unsigned mode = next_random(seed) % 3;
+
+		if (mode == 0) {
+			/* plain noise */
+			for (unsigned i = 0; i < len; i++) {
+				buf[i] = next_random(seed);
+			}
+
+		} else {
+			/* a piece of the recording with some bytes broken or replaced by sync markers */
+			unsigned start = next_random(seed) % (g_stream.count - len);
+			memcpy(buf, &g_stream.bytes[start], len);
+
+			for (unsigned i = 0; i < len; i++) {
+				unsigned r = next_random(seed) % 32;
+
+				if (r == 0) {
+					buf[i] = next_random(seed);
+
+				} else if (r == 1 && mode == 2) {
+					buf[i] = sync_byte;
+				}
+			}
+		}
+
+		uint16_t values[max_channels + 16];
+		uint16_t num_values = 0;
+
+		for (unsigned i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+			values[i] = guard;
+		}
+
+		/* vary the gaps so the time based framing gets exercised as well */
+		now += next_random(seed) % 10000;
+
+		if (decoder.parse(now, buf, len, values, &num_values, max_channels) && num_values > max_channels) {
+			return false;
+		}
+
+		for (unsigned i = max_channels; i < sizeof(values) / sizeof(values[0]); i++) {
+			if (values[i] != guard) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template<class D>
+void benchmark(const char *name, const char *filepath)
+{
+	if (!load_stream(filepath)) {
+		return;
+	}
+
+	static const unsigned rounds = 50;
+	D decoder;
+	uint16_t values[32];
+	uint16_t num_values;
+
+	decoder.init();
+	hrt_abstime start = hrt_absolute_time();
+
+	for (unsigned k = 0; k < rounds; k++) {
+		for (unsigned i = 0; i < g_stream.count; i++) {
+			decoder.parse(g_stream.times[i], &g_stream.bytes[i], 1, values, &num_values, 18);
+		}
+	}
+
+	hrt_abstime bytewise = hrt_elapsed_time(&start);
+
+	decoder.init();
+	start = hrt_absolute_time();
+
+	for (unsigned k = 0; k < rounds; k++) {
+		/* chunks as a UART read would deliver them */
+		for (unsigned pos = 0; pos < g_stream.count; pos += SBUS_FRAME_SIZE) {
+			unsigned len = (g_stream.count - pos < SBUS_FRAME_SIZE) ? g_stream.count - pos : SBUS_FRAME_SIZE;
+			decoder.parse(g_stream.times[pos], &g_stream.bytes[pos], len, values, &num_values, 18);
+		}
+	}
+
+	hrt_abstime bulk = hrt_elapsed_time(&start);
+	unsigned bytes = rounds * g_stream.count;
+
+	warnx("%s: %u bytes, byte by byte %.1f ns/byte, bulk %.1f ns/byte", name, bytes,
+	      (double)bytewise * 1000.0 / bytes, (double)bulk * 1000.0 / bytes);
+}
+
+} // namespace
+
 class RCTest : public UnitTest
 {
 public:
@@ -31,6 +357,10 @@ private:
 	bool sbus2Test();
 	bool st24Test();
 	bool sumdTest();
+	bool multiInstanceTest();
+	bool chunkedTest();
+	bool fuzzTest();
+	bool benchmarkTest();
 };
 
 bool RCTest::run_tests(void)
@@ -39,6 +369,10 @@ bool RCTest::run_tests(void)
 	ut_run_test(sbus2Test);
 	ut_run_test(st24Test);
 	ut_run_test(sumdTest);
+	ut_run_test(multiInstanceTest);
+	ut_run_test(chunkedTest);
+	ut_run_test(fuzzTest);
+	ut_run_test(benchmarkTest);
 
 	return (_tests_failed == 0);
 }
@@ -300,7 +634,44 @@ bool RCTest::sumdTest(void)
 	return true;
 }
 
+bool RCTest::multiInstanceTest(void)
+{
+	ut_assert_true(multi_instance<SbusDecoder>(TEST_DATA_PATH "sbus2_r7008SB.txt"));
+	ut_assert_true(multi_instance<DsmDecoder>(TEST_DATA_PATH "dsm_x_data.txt"));
+	ut_assert_true(multi_instance<St24Decoder>(TEST_DATA_PATH "st24_data.txt"));
+	ut_assert_true(multi_instance<SumdDecoder>(TEST_DATA_PATH "sumd_data.txt"));
 
+	return true;
+}
 
-ut_declare_test_c(rc_tests_main, RCTest)
+bool RCTest::chunkedTest(void)
+{
+	// DSM frames by the gap between reads, so its result depends on the chunking itself
+	ut_assert_true(chunked<SbusDecoder>(TEST_DATA_PATH "sbus2_r7008SB.txt"));
+	ut_assert_true(chunked<St24Decoder>(TEST_DATA_PATH "st24_data.txt"));
+	ut_assert_true(chunked<SumdDecoder>(TEST_DATA_PATH "sumd_data.txt"));
+
+	return true;
+}
+
+bool RCTest::fuzzTest(void)
+{
+	ut_assert_true(fuzz<SbusDecoder>(TEST_DATA_PATH "sbus2_r7008SB.txt", 0x0f));
+	ut_assert_true(fuzz<DsmDecoder>(TEST_DATA_PATH "dsm_x_data.txt", 0x00));
+	ut_assert_true(fuzz<St24Decoder>(TEST_DATA_PATH "st24_data.txt", ST24_STX1));
+	ut_assert_true(fuzz<SumdDecoder>(TEST_DATA_PATH "sumd_data.txt", SUMD_HEADER_ID));
 
+	return true;
+}
+
+bool RCTest::benchmarkTest(void)
+{
+	benchmark<SbusDecoder>("sbus", TEST_DATA_PATH "sbus2_r7008SB.txt");
+	benchmark<DsmDecoder>("dsm", TEST_DATA_PATH "dsm_x_data.txt");
+	benchmark<St24Decoder>("st24", TEST_DATA_PATH "st24_data.txt");
+	benchmark<SumdDecoder>("sumd", TEST_DATA_PATH "sumd_data.txt");
+
+	return true;
+}
+
+ut_declare_test_c(rc_tests_main, RCTest)
@@ -96,14 +96,12 @@
 #define SBUS_SCALE_FACTOR ((SBUS_TARGET_MAX - SBUS_TARGET_MIN) / (SBUS_RANGE_MAX - SBUS_RANGE_MIN))
 #define SBUS_SCALE_OFFSET (int)(SBUS_TARGET_MIN - (SBUS_SCALE_FACTOR * SBUS_RANGE_MIN + 0.5f))
 
-static hrt_abstime last_rx_time;
-static hrt_abstime last_frame_time;
 static hrt_abstime last_txframe_time = 0;
 
 #define SBUS2_FRAME_SIZE_RX_VOLTAGE	3
 #define SBUS2_FRAME_SIZE_GPS_DIGIT	3
 
-static enum SBUS2_DECODE_STATE {
+enum SBUS2_DECODE_STATE {
 	SBUS2_DECODE_STATE_DESYNC = 0xFFF,
 	SBUS2_DECODE_STATE_SBUS_START = 0x2FF,
 	SBUS2_DECODE_STATE_SBUS1_SYNC = 0x00,
@@ -112,25 +110,30 @@ static enum SBUS2_DECODE_STATE {
 	SBUS2_DECODE_STATE_SBUS2_GPS = 0x14,
 	SBUS2_DECODE_STATE_SBUS2_DATA1 = 0x24,
 	SBUS2_DECODE_STATE_SBUS2_DATA2 = 0x34
-} sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
-
-static uint8_t	sbus_frame[SBUS_FRAME_SIZE + (SBUS_FRAME_SIZE / 2)];
+};
 
-static unsigned partial_frame_count;
 static unsigned sbus1_frame_delay = (1000U * 1000U) / SBUS1_DEFAULT_RATE_HZ;
 
-static unsigned sbus_frame_drops;
+/* decoder behind the sbus_* entry points */
+static sbus_decoder_t sbus_default_decoder = { .decode_state = SBUS2_DECODE_STATE_DESYNC };
 
 unsigned
 sbus_dropped_frames()
 {
-	return sbus_frame_drops;
+	return sbus_default_decoder.frame_drops;
 }
 
 static bool
-sbus_decode(uint64_t frame_time, uint8_t *frame, uint16_t *values, uint16_t *num_values,
+sbus_decode(sbus_decoder_t *decoder, uint64_t frame_time, uint16_t *values, uint16_t *num_values,
 	    bool *sbus_failsafe, bool *sbus_frame_drop, uint16_t max_values);
 
+void
+sbus_decoder_init(sbus_decoder_t *decoder)
+{
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
+}
+
 int
 sbus_init(const char *device, bool singlewire)
 {
@@ -168,10 +171,9 @@ sbus_config(int sbus_fd, bool singlewire)
 		}
 
 		/* initialise the decoder */
-		partial_frame_count = 0;
-		last_rx_time = hrt_absolute_time();
-		last_frame_time = last_rx_time;
-		sbus_frame_drops = 0;
+		sbus_decoder_init(&sbus_default_decoder);
+		sbus_default_decoder.last_rx_time = hrt_absolute_time();
+		sbus_default_decoder.last_frame_time = sbus_default_decoder.last_rx_time;
 
 		ret = 0;
 	}
@@ -265,8 +267,8 @@ sbus_input(int sbus_fd, uint16_t *values, uint16_t *num_values, bool *sbus_fails
 	/*
 	 * Try to decode something with what we got
 	 */
-	if (sbus_parse(now, &buf[0], ret, values, num_values, sbus_failsafe,
-		       sbus_frame_drop, &sbus_frame_drops, max_channels)) {
+	if (sbus_decoder_parse(&sbus_default_decoder, now, &buf[0], ret, values, num_values, sbus_failsafe,
+			       sbus_frame_drop, max_channels)) {
 
 		sbus_decoded = true;
 	}
@@ -278,8 +280,23 @@ bool
 sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 	   uint16_t *num_values, bool *sbus_failsafe, bool *sbus_frame_drop, unsigned *frame_drops, uint16_t max_channels)
 {
+	bool decode_ret = sbus_decoder_parse(&sbus_default_decoder, now, frame, len, values, num_values,
+					     sbus_failsafe, sbus_frame_drop, max_channels);
+
+	if (frame_drops) {
+		*frame_drops = sbus_default_decoder.frame_drops;
+	}
+
+	return decode_ret;
+}
+
+bool
+sbus_decoder_parse(sbus_decoder_t *decoder, uint64_t now, const uint8_t *buf, unsigned len, uint16_t *values,
+		   uint16_t *num_values, bool *sbus_failsafe, bool *sbus_frame_drop, uint16_t max_channels)
+{
+	uint8_t *sbus_frame = decoder->frame;
 
-	last_rx_time = now;
+	decoder->last_rx_time = now;
 
 	/* this is set by the decoding state machine and will default to false
 	 * once everything that was decodable has been decoded.
@@ -290,46 +307,37 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 	for (unsigned d = 0; d < len; d++) {
 
 		/* overflow check */
-		if (partial_frame_count == sizeof(sbus_frame) / sizeof(sbus_frame[0])) {
-			partial_frame_count = 0;
-			sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
+		if (decoder->partial_frame_count == sizeof(decoder->frame) / sizeof(decoder->frame[0])) {
+			decoder->partial_frame_count = 0;
+			decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
 #ifdef SBUS_DEBUG
 			printf("SBUS2: RESET (BUF LIM)\n");
 #endif
 		}
 
-		if (partial_frame_count == SBUS_FRAME_SIZE) {
-			partial_frame_count = 0;
-			sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
+		if (decoder->partial_frame_count == SBUS_FRAME_SIZE) {
+			decoder->partial_frame_count = 0;
+			decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
 #ifdef SBUS_DEBUG
 			printf("SBUS2: RESET (PACKET LIM)\n");
 #endif
 		}
 
-#ifdef SBUS_DEBUG
-#if 0
-		printf("sbus state: %s%s%s%s%s%s, count: %d, val: %02x\n",
-		       (sbus_decode_state == SBUS2_DECODE_STATE_DESYNC) ? "SBUS2_DECODE_STATE_DESYNC" : "",
-		       (sbus_decode_state == SBUS2_DECODE_STATE_SBUS_START) ? "SBUS2_DECODE_STATE_SBUS_START" : "",
-		       (sbus_decode_state == SBUS2_DECODE_STATE_SBUS1_SYNC) ? "SBUS2_DECODE_STATE_SBUS1_SYNC" : "",
-		       (sbus_decode_state == SBUS2_DECODE_STATE_SBUS2_SYNC) ? "SBUS2_DECODE_STATE_SBUS2_SYNC" : "",
-		       (sbus_decode_state == SBUS2_DECODE_STATE_SBUS2_RX_VOLTAGE) ? "SBUS2_DECODE_STATE_SBUS2_RX_VOLTAGE" : "",
-		       (sbus_decode_state == SBUS2_DECODE_STATE_SBUS2_GPS) ? "SBUS2_DECODE_STATE_SBUS2_GPS" : "",
-		       partial_frame_count,
-		       (unsigned)frame[d]);
-#endif
-#endif
+		switch (decoder->decode_state) {
+		case SBUS2_DECODE_STATE_DESYNC: {
+				/* we are de-synced and only interested in the frame marker */
+				const uint8_t *start = (const uint8_t *)memchr(&buf[d], SBUS_START_SYMBOL, len - d);
 
-		switch (sbus_decode_state) {
-		case SBUS2_DECODE_STATE_DESYNC:
+				if (start == NULL) {
+					d = len;
+					break;
+				}
 
-			/* we are de-synced and only interested in the frame marker */
-			if (frame[d] == SBUS_START_SYMBOL) {
-				sbus_decode_state = SBUS2_DECODE_STATE_SBUS_START;
-				partial_frame_count = 0;
-				sbus_frame[partial_frame_count++] = frame[d];
+				d = start - buf;
+				decoder->decode_state = SBUS2_DECODE_STATE_SBUS_START;
+				decoder->partial_frame_count = 0;
+				sbus_frame[decoder->partial_frame_count++] = buf[d];
 			}
-
 			break;
 
 		/* fall through */
@@ -338,10 +346,19 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 
 		/* fall through */
 		case SBUS2_DECODE_STATE_SBUS2_SYNC: {
-				sbus_frame[partial_frame_count++] = frame[d];
+				/* take as much of the frame as is available in one go */
+				unsigned count = SBUS_FRAME_SIZE - decoder->partial_frame_count;
+
+				if (count > len - d) {
+					count = len - d;
+				}
+
+				memcpy(&sbus_frame[decoder->partial_frame_count], &buf[d], count);
+				decoder->partial_frame_count += count;
+				d += count - 1;
 
 				/* decode whatever we got and expect */
-				if (partial_frame_count < SBUS_FRAME_SIZE) {
+				if (decoder->partial_frame_count < SBUS_FRAME_SIZE) {
 					break;
 				}
 
@@ -349,7 +366,13 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 				 * Great, it looks like we might have a frame.  Go ahead and
 				 * decode it.
 				 */
-				decode_ret = sbus_decode(now, sbus_frame, values, num_values, sbus_failsafe, sbus_frame_drop, max_channels);
+				bool frame_decoded = sbus_decode(decoder, now, values, num_values, sbus_failsafe, sbus_frame_drop,
+								 max_channels);
+
+				/* a later broken frame must not hide one decoded earlier in this buffer */
+				if (frame_decoded) {
+					decode_ret = true;
+				}
 
 				/*
 				 * Offset recovery: If decoding failed, check if there is a second
@@ -357,9 +380,9 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 				 */
 				unsigned start_index = 0;
 
-				if (!decode_ret && sbus_decode_state == SBUS2_DECODE_STATE_DESYNC) {
+				if (!frame_decoded && decoder->decode_state == SBUS2_DECODE_STATE_DESYNC) {
 
-					for (unsigned i = 1; i < partial_frame_count; i++) {
+					for (unsigned i = 1; i < decoder->partial_frame_count; i++) {
 						if (sbus_frame[i] == SBUS_START_SYMBOL) {
 							start_index = i;
 							break;
@@ -369,12 +392,12 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 					/* we found a second start marker */
 					if (start_index != 0) {
 						/* shift everything in the buffer and reset the state machine */
-						for (unsigned i = 0; i < partial_frame_count - start_index; i++) {
+						for (unsigned i = 0; i < decoder->partial_frame_count - start_index; i++) {
 							sbus_frame[i] = sbus_frame[i + start_index];
 						}
 
-						partial_frame_count -= start_index;
-						sbus_decode_state = SBUS2_DECODE_STATE_SBUS_START;
+						decoder->partial_frame_count -= start_index;
+						decoder->decode_state = SBUS2_DECODE_STATE_SBUS_START;
 
 #ifdef SBUS_DEBUG
 						printf("DECODE RECOVERY: %d\n", start_index);
@@ -387,21 +410,21 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 				 * unsuccessful decode runs.
 				 */
 				if (start_index == 0) {
-					partial_frame_count = 0;
+					decoder->partial_frame_count = 0;
 				}
 
 			}
 			break;
 
 		case SBUS2_DECODE_STATE_SBUS2_RX_VOLTAGE: {
-				sbus_frame[partial_frame_count++] = frame[d];
+				sbus_frame[decoder->partial_frame_count++] = buf[d];
 
-				if (partial_frame_count == 1 && sbus_frame[0] == SBUS_START_SYMBOL) {
+				if (decoder->partial_frame_count == 1 && sbus_frame[0] == SBUS_START_SYMBOL) {
 					/* this slot is unused and in fact S.BUS2 sync */
-					sbus_decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
+					decoder->decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
 				}
 
-				if (partial_frame_count < SBUS2_FRAME_SIZE_RX_VOLTAGE) {
+				if (decoder->partial_frame_count < SBUS2_FRAME_SIZE_RX_VOLTAGE) {
 					break;
 				}
 
@@ -419,27 +442,27 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 #endif
 					}
 
-					partial_frame_count = 0;
+					decoder->partial_frame_count = 0;
 					break;
 
 				default:
 					/* this is not what we expect it to be, go back to sync */
-					sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
-					sbus_frame_drops++;
+					decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
+					decoder->frame_drops++;
 				}
 
 			}
 			break;
 
 		case SBUS2_DECODE_STATE_SBUS2_GPS: {
-				sbus_frame[partial_frame_count++] = frame[d];
+				sbus_frame[decoder->partial_frame_count++] = buf[d];
 
-				if (partial_frame_count == 1 && sbus_frame[0] == SBUS_START_SYMBOL) {
+				if (decoder->partial_frame_count == 1 && sbus_frame[0] == SBUS_START_SYMBOL) {
 					/* this slot is unused and in fact S.BUS2 sync */
-					sbus_decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
+					decoder->decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
 				}
 
-				if (partial_frame_count < 24) {
+				if (decoder->partial_frame_count < 24) {
 					break;
 				}
 
@@ -447,18 +470,18 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 				switch (sbus_frame[0]) {
 				case 0x13: {
 #ifdef SBUS_DEBUG
-						uint16_t gps_something = (frame[1] << 8) | frame[2];
+						uint16_t gps_something = (sbus_frame[1] << 8) | sbus_frame[2];
 						printf("gps_something %d\n", (int)gps_something);
 #endif
 					}
 
-					partial_frame_count = 0;
+					decoder->partial_frame_count = 0;
 					break;
 
 				default:
 					/* this is not what we expect it to be, go back to sync */
-					sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
-					sbus_frame_drops++;
+					decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
+					decoder->frame_drops++;
 					/* throw unknown bytes away */
 				}
 			}
@@ -474,10 +497,6 @@ sbus_parse(uint64_t now, uint8_t *frame, unsigned len, uint16_t *values,
 
 	}
 
-	if (frame_drops) {
-		*frame_drops = sbus_frame_drops;
-	}
-
 	/* return false as default */
 	return decode_ret;
 }
@@ -519,13 +538,14 @@ static const struct sbus_bit_pick sbus_decoder[SBUS_INPUT_CHANNELS][3] = {
 };
 
 bool
-sbus_decode(uint64_t frame_time, uint8_t *frame, uint16_t *values, uint16_t *num_values,
+sbus_decode(sbus_decoder_t *decoder, uint64_t frame_time, uint16_t *values, uint16_t *num_values,
 	    bool *sbus_failsafe, bool *sbus_frame_drop, uint16_t max_values)
 {
+	const uint8_t *frame = decoder->frame;
 
 	/* check frame boundary markers to avoid out-of-sync cases */
 	if ((frame[0] != SBUS_START_SYMBOL)) {
-		sbus_frame_drops++;
+		decoder->frame_drops++;
 #ifdef SBUS_DEBUG
 		printf("DECODE FAIL: ");
 
@@ -535,46 +555,46 @@ sbus_decode(uint64_t frame_time, uint8_t *frame, uint16_t *values, uint16_t *num
 
 		printf("\n");
 #endif
-		sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
+		decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
 		return false;
 	}
 
 	switch (frame[24]) {
 	case 0x00:
 		/* this is S.BUS 1 */
-		sbus_decode_state = SBUS2_DECODE_STATE_SBUS1_SYNC;
+		decoder->decode_state = SBUS2_DECODE_STATE_SBUS1_SYNC;
 		break;
 
 	case 0x04:
 		/* receiver voltage */
-		sbus_decode_state = SBUS2_DECODE_STATE_SBUS2_RX_VOLTAGE;
+		decoder->decode_state = SBUS2_DECODE_STATE_SBUS2_RX_VOLTAGE;
 		break;
 
 	case 0x14:
 		/* GPS / baro */
-		sbus_decode_state = SBUS2_DECODE_STATE_SBUS2_GPS;
+		decoder->decode_state = SBUS2_DECODE_STATE_SBUS2_GPS;
 		break;
 
 	case 0x24:
 		/* Unknown SBUS2 data */
-		sbus_decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
+		decoder->decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
 		break;
 
 	case 0x34:
 		/* Unknown SBUS2 data */
-		sbus_decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
+		decoder->decode_state = SBUS2_DECODE_STATE_SBUS2_SYNC;
 		break;
 
 	default:
 #ifdef SBUS_DEBUG
 		printf("DECODE FAIL: END MARKER\n");
 #endif
-		sbus_decode_state = SBUS2_DECODE_STATE_DESYNC;
+		decoder->decode_state = SBUS2_DECODE_STATE_DESYNC;
 		return false;
 	}
 
 	/* we have received something we think is a frame */
-	last_frame_time = frame_time;
+	decoder->last_frame_time = frame_time;
 
 	unsigned chancount = (max_values > SBUS_INPUT_CHANNELS) ?
 			     SBUS_INPUT_CHANNELS : max_values;
@@ -49,6 +49,35 @@ __BEGIN_DECLS
 #define SBUS_FRAME_SIZE			25
 #define SBUS_BUFFER_SIZE		(SBUS_FRAME_SIZE + SBUS_FRAME_SIZE / 2)
 
+/**
+ * S.BUS decoder state
+ *
+ * Each receiver needs its own instance, the sbus_* entry points
+ * below operate on a single shared one.
+ */
+typedef struct {
+	uint64_t	last_rx_time;			///< time of the last parse call
+	uint64_t	last_frame_time;		///< time of the last decoded frame
+	unsigned	decode_state;			///< state of the S.BUS2 slot machine
+	unsigned	partial_frame_count;		///< bytes collected in frame
+	unsigned	frame_drops;			///< incomplete or invalid frames
+	uint8_t		frame[SBUS_BUFFER_SIZE];
+} sbus_decoder_t;
+
+/**
+ * Reset a decoder to the unsynced state
+ */
+__EXPORT void	sbus_decoder_init(sbus_decoder_t *decoder);
+
+/**
+ * Feed a buffer of received bytes into a decoder
+ *
+ * @return true if at least one frame was decoded, values hold the latest one
+ */
+__EXPORT bool	sbus_decoder_parse(sbus_decoder_t *decoder, uint64_t now, const uint8_t *buf, unsigned len,
+				   uint16_t *values, uint16_t *num_values, bool *sbus_failsafe, bool *sbus_frame_drop,
+				   uint16_t max_channels);
+
 __EXPORT int	sbus_init(const char *device, bool singlewire);
 
 /**
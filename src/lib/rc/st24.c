@@ -41,6 +41,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include "st24.h"
 
 enum ST24_DECODE_STATE {
@@ -71,10 +72,8 @@ const char *decode_states[] = {"UNSYNCED",
 #define ST24_SCALE_FACTOR ((ST24_TARGET_MAX - ST24_TARGET_MIN) / (ST24_RANGE_MAX - ST24_RANGE_MIN))
 #define ST24_SCALE_OFFSET (int)(ST24_TARGET_MIN - (ST24_SCALE_FACTOR * ST24_RANGE_MIN + 0.5f))
 
-static enum ST24_DECODE_STATE _decode_state = ST24_DECODE_STATE_UNSYNCED;
-static uint8_t _rxlen;
-
-static ReceiverFcPacket _rxpacket;
+/* decoder behind st24_decode() and st24_parse() */
+static st24_decoder_t _default_decoder = { .decode_state = ST24_DECODE_STATE_UNSYNCED };
 
 uint8_t st24_common_crc8(uint8_t *ptr, uint8_t len)
 {
@@ -103,152 +102,194 @@ uint8_t st24_common_crc8(uint8_t *ptr, uint8_t len)
 }
 
 
+void st24_decoder_init(st24_decoder_t *decoder)
+{
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->decode_state = ST24_DECODE_STATE_UNSYNCED;
+}
+
 int st24_decode(uint8_t byte, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count, uint16_t *channels,
 		uint16_t max_chan_count)
 {
+	return st24_decoder_parse(&_default_decoder, &byte, 1, rssi, rx_count, channel_count, channels, max_chan_count);
+}
+
+int st24_parse(const uint8_t *buf, unsigned len, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count,
+	       uint16_t *channels, uint16_t max_chan_count)
+{
+	return st24_decoder_parse(&_default_decoder, buf, len, rssi, rx_count, channel_count, channels, max_chan_count);
+}
 
+int st24_decoder_parse(st24_decoder_t *decoder, const uint8_t *buf, unsigned len, uint8_t *rssi, uint8_t *rx_count,
+		       uint16_t *channel_count, uint16_t *channels, uint16_t max_chan_count)
+{
+	ReceiverFcPacket *rxpacket = &decoder->rxpacket;
+	bool decoded = false;
 	int ret = 1;
 
-	switch (_decode_state) {
-	case ST24_DECODE_STATE_UNSYNCED:
-		if (byte == ST24_STX1) {
-			_decode_state = ST24_DECODE_STATE_GOT_STX1;
+	for (unsigned pos = 0; pos < len; pos++) {
+		uint8_t byte = buf[pos];
+		ret = 1;
 
-		} else {
-			ret = 3;
-		}
+		switch (decoder->decode_state) {
+		case ST24_DECODE_STATE_UNSYNCED: {
+				/* skip ahead to the next start marker */
+				const uint8_t *start = memchr(&buf[pos], ST24_STX1, len - pos);
 
-		break;
+				if (start == NULL) {
+					pos = len;
+					ret = 3;
+					break;
+				}
 
-	case ST24_DECODE_STATE_GOT_STX1:
-		if (byte == ST24_STX2) {
-			_decode_state = ST24_DECODE_STATE_GOT_STX2;
+				pos = start - buf;
+				decoder->decode_state = ST24_DECODE_STATE_GOT_STX1;
+			}
+			break;
 
-		} else {
-			_decode_state = ST24_DECODE_STATE_UNSYNCED;
-		}
+		case ST24_DECODE_STATE_GOT_STX1:
+			if (byte == ST24_STX2) {
+				decoder->decode_state = ST24_DECODE_STATE_GOT_STX2;
+
+			} else {
+				decoder->decode_state = ST24_DECODE_STATE_UNSYNCED;
+			}
 
-		break;
+			break;
 
-	case ST24_DECODE_STATE_GOT_STX2:
+		case ST24_DECODE_STATE_GOT_STX2:
 
-		/* ensure no data overflow failure or hack is possible */
-		if ((unsigned)byte <= sizeof(_rxpacket.length) + sizeof(_rxpacket.type) + sizeof(_rxpacket.st24_data)) {
-			_rxpacket.length = byte;
-			_rxlen = 0;
-			_decode_state = ST24_DECODE_STATE_GOT_LEN;
+			/* ensure no data overflow failure or hack is possible, a packet carries at least one data byte */
+			if ((unsigned)byte <= sizeof(rxpacket->length) + sizeof(rxpacket->type) + sizeof(rxpacket->st24_data)
+			    && byte >= sizeof(rxpacket->type) + 1 + sizeof(rxpacket->crc8)) {
+				rxpacket->length = byte;
+				decoder->rxlen = 0;
+				decoder->decode_state = ST24_DECODE_STATE_GOT_LEN;
 
-		} else {
-			_decode_state = ST24_DECODE_STATE_UNSYNCED;
-		}
+			} else {
+				decoder->decode_state = ST24_DECODE_STATE_UNSYNCED;
+			}
 
-		break;
+			break;
 
-	case ST24_DECODE_STATE_GOT_LEN:
-		_rxpacket.type = byte;
-		_rxlen++;
-		_decode_state = ST24_DECODE_STATE_GOT_TYPE;
-		break;
+		case ST24_DECODE_STATE_GOT_LEN:
+			rxpacket->type = byte;
+			decoder->rxlen++;
+			decoder->decode_state = ST24_DECODE_STATE_GOT_TYPE;
+			break;
 
-	case ST24_DECODE_STATE_GOT_TYPE:
-		_rxpacket.st24_data[_rxlen - 1] = byte;
-		_rxlen++;
+		case ST24_DECODE_STATE_GOT_TYPE: {
+				/* take as much of the payload as is available in one go */
+				unsigned count = (rxpacket->length - 1) - decoder->rxlen;
 
-		if (_rxlen == (_rxpacket.length - 1)) {
-			_decode_state = ST24_DECODE_STATE_GOT_DATA;
-		}
+				if (count > len - pos) {
+					count = len - pos;
+				}
 
-		break;
+				memcpy(&rxpacket->st24_data[decoder->rxlen - 1], &buf[pos], count);
+				decoder->rxlen += count;
+				pos += count - 1;
 
-	case ST24_DECODE_STATE_GOT_DATA:
-		_rxpacket.crc8 = byte;
-		_rxlen++;
+				if (decoder->rxlen == (rxpacket->length - 1)) {
+					decoder->decode_state = ST24_DECODE_STATE_GOT_DATA;
+				}
+			}
+			break;
 
-		if (st24_common_crc8((uint8_t *) & (_rxpacket.length), _rxlen) == _rxpacket.crc8) {
+		case ST24_DECODE_STATE_GOT_DATA:
+			rxpacket->crc8 = byte;
+			decoder->rxlen++;
 
-			ret = 0;
+			if (st24_common_crc8(&rxpacket->length, decoder->rxlen) == rxpacket->crc8) {
 
-			/* decode the actual packet */
+				ret = 0;
 
-			switch (_rxpacket.type) {
+				/* decode the actual packet */
 
-			case ST24_PACKET_TYPE_CHANNELDATA12: {
-					ChannelData12 *d = (ChannelData12 *)_rxpacket.st24_data;
+				switch (rxpacket->type) {
 
-					*rssi = d->rssi;
-					*rx_count = d->packet_count;
+				case ST24_PACKET_TYPE_CHANNELDATA12: {
+						ChannelData12 *d = (ChannelData12 *)rxpacket->st24_data;
 
-					/* this can lead to rounding of the strides */
-					*channel_count = (max_chan_count < 12) ? max_chan_count : 12;
+						*rssi = d->rssi;
+						*rx_count = d->packet_count;
 
-					unsigned stride_count = (*channel_count * 3) / 2;
-					unsigned chan_index = 0;
+						/* this can lead to rounding of the strides */
+						*channel_count = (max_chan_count < 12) ? max_chan_count : 12;
 
-					for (unsigned i = 0; i < stride_count; i += 3) {
-						channels[chan_index] = ((uint16_t)d->channel[i] << 4);
-						channels[chan_index] |= ((uint16_t)(0xF0 & d->channel[i + 1]) >> 4);
-						/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
-						channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
-						chan_index++;
+						unsigned stride_count = (*channel_count * 3) / 2;
+						unsigned chan_index = 0;
 
-						channels[chan_index] = ((uint16_t)d->channel[i + 2]);
-						channels[chan_index] |= (((uint16_t)(0x0F & d->channel[i + 1])) << 8);
-						/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
-						channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
-						chan_index++;
+						for (unsigned i = 0; i < stride_count; i += 3) {
+							channels[chan_index] = ((uint16_t)d->channel[i] << 4);
+							channels[chan_index] |= ((uint16_t)(0xF0 & d->channel[i + 1]) >> 4);
+							/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
+							channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
+							chan_index++;
+
+							channels[chan_index] = ((uint16_t)d->channel[i + 2]);
+							channels[chan_index] |= (((uint16_t)(0x0F & d->channel[i + 1])) << 8);
+							/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
+							channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
+							chan_index++;
+						}
 					}
-				}
-				break;
+					break;
 
-			case ST24_PACKET_TYPE_CHANNELDATA24: {
-					ChannelData24 *d = (ChannelData24 *)&_rxpacket.st24_data;
+				case ST24_PACKET_TYPE_CHANNELDATA24: {
+						ChannelData24 *d = (ChannelData24 *)rxpacket->st24_data;
 
-					*rssi = d->rssi;
-					*rx_count = d->packet_count;
+						*rssi = d->rssi;
+						*rx_count = d->packet_count;
 
-					/* this can lead to rounding of the strides */
-					*channel_count = (max_chan_count < 24) ? max_chan_count : 24;
+						/* this can lead to rounding of the strides */
+						*channel_count = (max_chan_count < 24) ? max_chan_count : 24;
 
-					unsigned stride_count = (*channel_count * 3) / 2;
-					unsigned chan_index = 0;
+						unsigned stride_count = (*channel_count * 3) / 2;
+						unsigned chan_index = 0;
 
-					for (unsigned i = 0; i < stride_count; i += 3) {
-						channels[chan_index] = ((uint16_t)d->channel[i] << 4);
-						channels[chan_index] |= ((uint16_t)(0xF0 & d->channel[i + 1]) >> 4);
-						/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
-						channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
-						chan_index++;
+						for (unsigned i = 0; i < stride_count; i += 3) {
+							channels[chan_index] = ((uint16_t)d->channel[i] << 4);
+							channels[chan_index] |= ((uint16_t)(0xF0 & d->channel[i + 1]) >> 4);
+							/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
+							channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
+							chan_index++;
 
-						channels[chan_index] = ((uint16_t)d->channel[i + 2]);
-						channels[chan_index] |= (((uint16_t)(0x0F & d->channel[i + 1])) << 8);
-						/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
-						channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
-						chan_index++;
+							channels[chan_index] = ((uint16_t)d->channel[i + 2]);
+							channels[chan_index] |= (((uint16_t)(0x0F & d->channel[i + 1])) << 8);
+							/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
+							channels[chan_index] = (uint16_t)(channels[chan_index] * ST24_SCALE_FACTOR + .5f) + ST24_SCALE_OFFSET;
+							chan_index++;
+						}
 					}
-				}
-				break;
+					break;
 
-			case ST24_PACKET_TYPE_TRANSMITTERGPSDATA: {
+				case ST24_PACKET_TYPE_TRANSMITTERGPSDATA: {
 
-					// ReceiverFcPacket* d = (ReceiverFcPacket*)&_rxpacket.st24_data;
-					/* we silently ignore this data for now, as it is unused */
+						// ReceiverFcPacket* d = (ReceiverFcPacket*)rxpacket->st24_data;
+						/* we silently ignore this data for now, as it is unused */
+						ret = 2;
+					}
+					break;
+
+				default:
 					ret = 2;
+					break;
 				}
-				break;
 
-			default:
-				ret = 2;
-				break;
+			} else {
+				/* decoding failed */
+				ret = 4;
 			}
 
-		} else {
-			/* decoding failed */
-			ret = 4;
+			decoder->decode_state = ST24_DECODE_STATE_UNSYNCED;
+			break;
 		}
 
-		_decode_state = ST24_DECODE_STATE_UNSYNCED;
-		break;
+		if (ret == 0) {
+			decoded = true;
+		}
 	}
 
-	return ret;
+	return decoded ? 0 : ret;
 }
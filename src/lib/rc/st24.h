@@ -138,6 +138,18 @@ typedef struct {
 
 #pragma pack(pop)
 
+/**
+ * ST24 decoder state
+ *
+ * Each receiver needs its own instance, st24_decode() and st24_parse()
+ * operate on a single shared one.
+ */
+typedef struct {
+	unsigned		decode_state;	///< from enum ST24_DECODE_STATE
+	uint8_t			rxlen;		///< bytes received after the length field
+	ReceiverFcPacket	rxpacket;	///< packet being received
+} st24_decoder_t;
+
 /**
  * CRC8 implementation for ST24 protocol
  *
@@ -160,4 +172,27 @@ uint8_t st24_common_crc8(uint8_t *ptr, uint8_t len);
 __EXPORT int st24_decode(uint8_t byte, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count,
 			 uint16_t *channels, uint16_t max_chan_count);
 
+/**
+ * Decode a buffer of ST24 bytes
+ *
+ * Same as st24_decode() for every byte of buf, but packet payloads are copied in one go.
+ *
+ * @param buf received bytes
+ * @param len number of bytes in buf
+ * @return 0 if at least one channel packet was decoded (outputs hold the latest), else the result of the last byte
+ */
+__EXPORT int st24_parse(const uint8_t *buf, unsigned len, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count,
+			uint16_t *channels, uint16_t max_chan_count);
+
+/**
+ * Reset a decoder to the unsynced state
+ */
+__EXPORT void st24_decoder_init(st24_decoder_t *decoder);
+
+/**
+ * Decode a buffer of ST24 bytes with the given decoder, see st24_parse()
+ */
+__EXPORT int st24_decoder_parse(st24_decoder_t *decoder, const uint8_t *buf, unsigned len, uint8_t *rssi,
+				uint8_t *rx_count, uint16_t *channel_count, uint16_t *channels, uint16_t max_chan_count);
+
 __END_DECLS
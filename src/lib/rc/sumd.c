@@ -41,6 +41,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include "sumd.h"
 
 
@@ -67,10 +68,6 @@ const char *decode_states[] = {"UNSYNCED",
 			      };
 */
 
-uint8_t 	_crc8 	= 0x00;
-uint16_t 	_crc16 = 0x0000;
-bool 		_sumd 		= true;
-bool		_crcOK		= false;
 bool		_debug		= false;
 
 
@@ -85,10 +82,8 @@ bool		_debug		= false;
 #define SUMD_SCALE_FACTOR ((SUMD_TARGET_MAX - SUMD_TARGET_MIN) / (SUMD_RANGE_MAX - SUMD_RANGE_MIN))
 #define SUMD_SCALE_OFFSET (int)(SUMD_TARGET_MIN - (SUMD_SCALE_FACTOR * SUMD_RANGE_MIN + 0.5f))
 
-static enum SUMD_DECODE_STATE _decode_state = SUMD_DECODE_STATE_UNSYNCED;
-static uint8_t _rxlen;
-
-static ReceiverFcPacketHoTT _rxpacket;
+/* decoder behind sumd_decode() and sumd_parse() */
+static sumd_decoder_t _default_decoder = { .decode_state = SUMD_DECODE_STATE_UNSYNCED, .sumd = true };
 
 
 uint16_t sumd_crc16(uint16_t crc, uint8_t value)
@@ -109,257 +104,303 @@ uint8_t sumd_crc8(uint8_t crc, uint8_t value)
 	return crc;
 }
 
+void sumd_decoder_init(sumd_decoder_t *decoder)
+{
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->decode_state = SUMD_DECODE_STATE_UNSYNCED;
+	decoder->sumd = true;
+}
+
 int sumd_decode(uint8_t byte, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count, uint16_t *channels,
 		uint16_t max_chan_count)
 {
+	return sumd_decoder_parse(&_default_decoder, &byte, 1, rssi, rx_count, channel_count, channels, max_chan_count);
+}
 
+int sumd_parse(const uint8_t *buf, unsigned len, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count,
+	       uint16_t *channels, uint16_t max_chan_count)
+{
+	return sumd_decoder_parse(&_default_decoder, buf, len, rssi, rx_count, channel_count, channels, max_chan_count);
+}
+
+int sumd_decoder_parse(sumd_decoder_t *decoder, const uint8_t *buf, unsigned len, uint8_t *rssi, uint8_t *rx_count,
+		       uint16_t *channel_count, uint16_t *channels, uint16_t max_chan_count)
+{
+	ReceiverFcPacketHoTT *rxpacket = &decoder->rxpacket;
+	bool decoded = false;
 	int ret = 1;
 
-	switch (_decode_state) {
-	case SUMD_DECODE_STATE_UNSYNCED:
-		if (_debug) {
-			printf(" SUMD_DECODE_STATE_UNSYNCED \n") ;
-		}
+	for (unsigned pos = 0; pos < len; pos++) {
+		uint8_t byte = buf[pos];
+		ret = 1;
 
-		if (byte == SUMD_HEADER_ID) {
-			_rxpacket.header = byte;
-			_sumd = true;
-			_rxlen = 0;
-			_crc16 = 0x0000;
-			_crc8 = 0x00;
-			_crcOK = false;
-			_crc16 = sumd_crc16(_crc16, byte);
-			_crc8 = sumd_crc8(_crc8, byte);
-			_decode_state = SUMD_DECODE_STATE_GOT_HEADER;
+		switch (decoder->decode_state) {
+		case SUMD_DECODE_STATE_UNSYNCED: {
+				if (_debug) {
+					printf(" SUMD_DECODE_STATE_UNSYNCED \n") ;
+				}
 
-			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_HEADER: %x \n", byte) ;
-			}
+				/* skip ahead to the next header */
+				const uint8_t *start = memchr(&buf[pos], SUMD_HEADER_ID, len - pos);
 
-		} else {
-			ret = 3;
-		}
+				if (start == NULL) {
+					pos = len;
+					ret = 3;
+					break;
+				}
 
-		break;
+				pos = start - buf;
+				byte = SUMD_HEADER_ID;
 
-	case SUMD_DECODE_STATE_GOT_HEADER:
-		if (byte == SUMD_ID_SUMD || byte == SUMD_ID_SUMH) {
-			_rxpacket.status = byte;
+				rxpacket->header = byte;
+				decoder->sumd = true;
+				decoder->rxlen = 0;
+				decoder->crc16 = 0x0000;
+				decoder->crc8 = 0x00;
+				decoder->crcOK = false;
+				decoder->crc16 = sumd_crc16(decoder->crc16, byte);
+				decoder->crc8 = sumd_crc8(decoder->crc8, byte);
+				decoder->decode_state = SUMD_DECODE_STATE_GOT_HEADER;
 
-			if (byte == SUMD_ID_SUMH) {
-				_sumd = false;
+				if (_debug) {
+					printf(" SUMD_DECODE_STATE_GOT_HEADER: %x \n", byte) ;
+				}
 			}
+			break;
+
+		case SUMD_DECODE_STATE_GOT_HEADER:
+			if (byte == SUMD_ID_SUMD || byte == SUMD_ID_SUMH) {
+				rxpacket->status = byte;
+
+				if (byte == SUMD_ID_SUMH) {
+					decoder->sumd = false;
+				}
+
+				if (decoder->sumd) {
+					decoder->crc16 = sumd_crc16(decoder->crc16, byte);
 
-			if (_sumd) {
-				_crc16 = sumd_crc16(_crc16, byte);
+				} else {
+					decoder->crc8 = sumd_crc8(decoder->crc8, byte);
+				}
+
+				decoder->decode_state = SUMD_DECODE_STATE_GOT_STATE;
+
+				if (_debug) {
+					printf(" SUMD_DECODE_STATE_GOT_STATE: %x \n", byte) ;
+				}
 
 			} else {
-				_crc8 = sumd_crc8(_crc8, byte);
+				decoder->decode_state = SUMD_DECODE_STATE_UNSYNCED;
 			}
 
-			_decode_state = SUMD_DECODE_STATE_GOT_STATE;
+			break;
 
-			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_STATE: %x \n", byte) ;
-			}
+		case SUMD_DECODE_STATE_GOT_STATE:
+			if (byte >= 2 && byte <= SUMD_MAX_CHANNELS) {
+				rxpacket->length = byte;
 
-		} else {
-			_decode_state = SUMD_DECODE_STATE_UNSYNCED;
-		}
+				if (decoder->sumd) {
+					decoder->crc16 = sumd_crc16(decoder->crc16, byte);
 
-		break;
+				} else {
+					decoder->crc8 = sumd_crc8(decoder->crc8, byte);
+				}
 
-	case SUMD_DECODE_STATE_GOT_STATE:
-		if (byte >= 2 && byte <= SUMD_MAX_CHANNELS) {
-			_rxpacket.length = byte;
+				decoder->rxlen++;
+				decoder->decode_state = SUMD_DECODE_STATE_GOT_LEN;
 
-			if (_sumd) {
-				_crc16 = sumd_crc16(_crc16, byte);
+				if (_debug) {
+					printf(" SUMD_DECODE_STATE_GOT_LEN: %x (%d) \n", byte, byte) ;
+				}
 
 			} else {
-				_crc8 = sumd_crc8(_crc8, byte);
+				decoder->decode_state = SUMD_DECODE_STATE_UNSYNCED;
 			}
 
-			_rxlen++;
-			_decode_state = SUMD_DECODE_STATE_GOT_LEN;
+			break;
 
-			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_LEN: %x (%d) \n", byte, byte) ;
-			}
+		case SUMD_DECODE_STATE_GOT_LEN: {
+				/* take as much of the channel data as is available in one go */
+				unsigned count = rxpacket->length * 2 + 1 - decoder->rxlen;
 
-		} else {
-			_decode_state = SUMD_DECODE_STATE_UNSYNCED;
-		}
+				if (count > len - pos) {
+					count = len - pos;
+				}
 
-		break;
+				for (unsigned i = 0; i < count; i++) {
+					byte = buf[pos + i];
+					rxpacket->sumd_data[decoder->rxlen] = byte;
 
-	case SUMD_DECODE_STATE_GOT_LEN:
-		_rxpacket.sumd_data[_rxlen] = byte;
+					if (decoder->sumd) {
+						decoder->crc16 = sumd_crc16(decoder->crc16, byte);
 
-		if (_sumd) {
-			_crc16 = sumd_crc16(_crc16, byte);
+					} else {
+						decoder->crc8 = sumd_crc8(decoder->crc8, byte);
+					}
 
-		} else {
-			_crc8 = sumd_crc8(_crc8, byte);
-		}
+					decoder->rxlen++;
 
-		_rxlen++;
+					if (_debug) {
+						printf(" SUMD_DECODE_STATE_GOT_DATA[%d]: %x\n", decoder->rxlen - 2, byte) ;
+					}
+				}
 
-		if (_rxlen <= ((_rxpacket.length * 2))) {
-			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_DATA[%d]: %x\n", _rxlen - 2, byte) ;
+				pos += count - 1;
+
+				if (decoder->rxlen > ((rxpacket->length * 2))) {
+					decoder->decode_state = SUMD_DECODE_STATE_GOT_DATA;
+
+					if (_debug) {
+						printf(" SUMD_DECODE_STATE_GOT_DATA -- finish --\n") ;
+					}
+				}
 			}
+			break;
 
-		} else {
-			_decode_state = SUMD_DECODE_STATE_GOT_DATA;
+		case SUMD_DECODE_STATE_GOT_DATA:
+			rxpacket->crc16_high = byte;
 
 			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_DATA -- finish --\n") ;
+				printf(" SUMD_DECODE_STATE_GOT_CRC16[1]: %x   [%x]\n", byte, ((decoder->crc16 >> 8) & 0xff)) ;
 			}
 
-		}
-
-		break;
+			if (decoder->sumd) {
+				decoder->decode_state = SUMD_DECODE_STATE_GOT_CRC;
 
-	case SUMD_DECODE_STATE_GOT_DATA:
-		_rxpacket.crc16_high = byte;
+			} else {
+				decoder->decode_state = SUMD_DECODE_STATE_GOT_CRC16_BYTE_1;
+			}
 
-		if (_debug) {
-			printf(" SUMD_DECODE_STATE_GOT_CRC16[1]: %x   [%x]\n", byte, ((_crc16 >> 8) & 0xff)) ;
-		}
+			break;
 
-		if (_sumd) {
-			_decode_state = SUMD_DECODE_STATE_GOT_CRC;
+		case SUMD_DECODE_STATE_GOT_CRC16_BYTE_1:
+			rxpacket->crc16_low = byte;
 
-		} else {
-			_decode_state = SUMD_DECODE_STATE_GOT_CRC16_BYTE_1;
-		}
+			if (_debug) {
+				printf(" SUMD_DECODE_STATE_GOT_CRC16[2]: %x   [%x]\n", byte, (decoder->crc16 & 0xff)) ;
+			}
 
-		break;
+			decoder->decode_state = SUMD_DECODE_STATE_GOT_CRC16_BYTE_2;
 
-	case SUMD_DECODE_STATE_GOT_CRC16_BYTE_1:
-		_rxpacket.crc16_low = byte;
+			break;
 
-		if (_debug) {
-			printf(" SUMD_DECODE_STATE_GOT_CRC16[2]: %x   [%x]\n", byte, (_crc16 & 0xff)) ;
-		}
+		case SUMD_DECODE_STATE_GOT_CRC16_BYTE_2:
+			rxpacket->telemetry = byte;
 
-		_decode_state = SUMD_DECODE_STATE_GOT_CRC16_BYTE_2;
+			if (_debug) {
+				printf(" SUMD_DECODE_STATE_GOT_SUMH_TELEMETRY: %x\n", byte) ;
+			}
 
-		break;
+			decoder->decode_state = SUMD_DECODE_STATE_GOT_CRC;
 
-	case SUMD_DECODE_STATE_GOT_CRC16_BYTE_2:
-		_rxpacket.telemetry = byte;
+			break;
 
-		if (_debug) {
-			printf(" SUMD_DECODE_STATE_GOT_SUMH_TELEMETRY: %x\n", byte) ;
-		}
+		case SUMD_DECODE_STATE_GOT_CRC:
+			if (decoder->sumd) {
+				rxpacket->crc16_low = byte;
 
-		_decode_state = SUMD_DECODE_STATE_GOT_CRC;
+				if (_debug) {
+					printf(" SUMD_DECODE_STATE_GOT_CRC[2]: %x   [%x]\n\n", byte, (decoder->crc16 & 0xff)) ;
+				}
 
-		break;
+				if (decoder->crc16 == (uint16_t)(rxpacket->crc16_high << 8) + rxpacket->crc16_low) {
+					decoder->crcOK = true;
+				}
 
-	case SUMD_DECODE_STATE_GOT_CRC:
-		if (_sumd) {
-			_rxpacket.crc16_low = byte;
+			} else {
+				rxpacket->crc8 = byte;
 
-			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_CRC[2]: %x   [%x]\n\n", byte, (_crc16 & 0xff)) ;
-			}
+				if (_debug) {
+					printf(" SUMD_DECODE_STATE_GOT_CRC8_SUMH: %x   [%x]\n\n", byte, decoder->crc8) ;
+				}
 
-			if (_crc16 == (uint16_t)(_rxpacket.crc16_high << 8) + _rxpacket.crc16_low) {
-				_crcOK = true;
+				if (decoder->crc8 == rxpacket->crc8) {
+					decoder->crcOK = true;
+				}
 			}
 
-		} else {
-			_rxpacket.crc8 = byte;
-
-			if (_debug) {
-				printf(" SUMD_DECODE_STATE_GOT_CRC8_SUMH: %x   [%x]\n\n", byte, _crc8) ;
-			}
+			if (decoder->crcOK) {
+				if (_debug) {
+					printf(" CRC - OK \n") ;
+				}
 
-			if (_crc8 == _rxpacket.crc8) {
-				_crcOK = true;
-			}
-		}
+				if (decoder->sumd) {
+					if (_debug) {
+						printf(" Got valid SUMD Packet\n") ;
+					}
 
-		if (_crcOK) {
-			if (_debug) {
-				printf(" CRC - OK \n") ;
-			}
+				} else {
+					if (_debug) {
+						printf(" Got valid SUMH Packet\n") ;
+					}
 
-			if (_sumd) {
-				if (_debug) {
-					printf(" Got valid SUMD Packet\n") ;
 				}
 
-			} else {
 				if (_debug) {
-					printf(" Got valid SUMH Packet\n") ;
+					printf(" RXLEN: %d  [Chans: %d] \n\n", decoder->rxlen - 1, (decoder->rxlen - 1) / 2) ;
 				}
 
-			}
+				ret = 0;
+				unsigned i;
+				uint8_t _cnt = *rx_count + 1;
+				*rx_count = _cnt;
 
-			if (_debug) {
-				printf(" RXLEN: %d  [Chans: %d] \n\n", _rxlen - 1, (_rxlen - 1) / 2) ;
-			}
+				*rssi = 100;
 
-			ret = 0;
-			unsigned i;
-			uint8_t _cnt = *rx_count + 1;
-			*rx_count = _cnt;
+				/* received Channels */
+				if ((uint16_t)rxpacket->length > max_chan_count) {
+					rxpacket->length = (uint8_t) max_chan_count;
+				}
 
-			*rssi = 100;
+				*channel_count = (uint16_t)rxpacket->length;
 
-			/* received Channels */
-			if ((uint16_t)_rxpacket.length > max_chan_count) {
-				_rxpacket.length = (uint8_t) max_chan_count;
-			}
+				/* decode the actual packet */
+				/* reorder first 4 channels */
 
-			*channel_count = (uint16_t)_rxpacket.length;
+				/* ch1 = roll -> sumd = ch2 */
+				channels[0] = (uint16_t)((rxpacket->sumd_data[1 * 2 + 1] << 8) | rxpacket->sumd_data[1 * 2 + 2]) >> 3;
+				/* ch2 = pitch -> sumd = ch2 */
+				channels[1] = (uint16_t)((rxpacket->sumd_data[2 * 2 + 1] << 8) | rxpacket->sumd_data[2 * 2 + 2]) >> 3;
+				/* ch3 = throttle -> sumd = ch2 */
+				channels[2] = (uint16_t)((rxpacket->sumd_data[0 * 2 + 1] << 8) | rxpacket->sumd_data[0 * 2 + 2]) >> 3;
+				/* ch4 = yaw -> sumd = ch2 */
+				channels[3] = (uint16_t)((rxpacket->sumd_data[3 * 2 + 1] << 8) | rxpacket->sumd_data[3 * 2 + 2]) >> 3;
 
-			/* decode the actual packet */
-			/* reorder first 4 channels */
+				/* we start at channel 5(index 4) */
+				unsigned chan_index = 4;
 
-			/* ch1 = roll -> sumd = ch2 */
-			channels[0] = (uint16_t)((_rxpacket.sumd_data[1 * 2 + 1] << 8) | _rxpacket.sumd_data[1 * 2 + 2]) >> 3;
-			/* ch2 = pitch -> sumd = ch2 */
-			channels[1] = (uint16_t)((_rxpacket.sumd_data[2 * 2 + 1] << 8) | _rxpacket.sumd_data[2 * 2 + 2]) >> 3;
-			/* ch3 = throttle -> sumd = ch2 */
-			channels[2] = (uint16_t)((_rxpacket.sumd_data[0 * 2 + 1] << 8) | _rxpacket.sumd_data[0 * 2 + 2]) >> 3;
-			/* ch4 = yaw -> sumd = ch2 */
-			channels[3] = (uint16_t)((_rxpacket.sumd_data[3 * 2 + 1] << 8) | _rxpacket.sumd_data[3 * 2 + 2]) >> 3;
+				for (i = 4; i < rxpacket->length; i++) {
+					if (_debug) {
+						printf("ch[%d] : %x %x [ %x    %d ]\n", i + 1, rxpacket->sumd_data[i * 2 + 1], rxpacket->sumd_data[i * 2 + 2],
+						       ((rxpacket->sumd_data[i * 2 + 1] << 8) | rxpacket->sumd_data[i * 2 + 2]) >> 3,
+						       ((rxpacket->sumd_data[i * 2 + 1] << 8) | rxpacket->sumd_data[i * 2 + 2]) >> 3);
+					}
 
-			/* we start at channel 5(index 4) */
-			unsigned chan_index = 4;
+					channels[chan_index] = (uint16_t)((rxpacket->sumd_data[i * 2 + 1] << 8) | rxpacket->sumd_data[i * 2 + 2]) >> 3;
+					/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
+					//channels[chan_index] = (uint16_t)(channels[chan_index] * SUMD_SCALE_FACTOR + .5f) + SUMD_SCALE_OFFSET;
 
-			for (i = 4; i < _rxpacket.length; i++) {
-				if (_debug) {
-					printf("ch[%d] : %x %x [ %x    %d ]\n", i + 1, _rxpacket.sumd_data[i * 2 + 1], _rxpacket.sumd_data[i * 2 + 2],
-					       ((_rxpacket.sumd_data[i * 2 + 1] << 8) | _rxpacket.sumd_data[i * 2 + 2]) >> 3,
-					       ((_rxpacket.sumd_data[i * 2 + 1] << 8) | _rxpacket.sumd_data[i * 2 + 2]) >> 3);
+					chan_index++;
 				}
 
-				channels[chan_index] = (uint16_t)((_rxpacket.sumd_data[i * 2 + 1] << 8) | _rxpacket.sumd_data[i * 2 + 2]) >> 3;
-				/* convert values to 1000-2000 ppm encoding in a not too sloppy fashion */
-				//channels[chan_index] = (uint16_t)(channels[chan_index] * SUMD_SCALE_FACTOR + .5f) + SUMD_SCALE_OFFSET;
-
-				chan_index++;
-			}
+			} else {
+				/* decoding failed */
+				ret = 4;
 
-		} else {
-			/* decoding failed */
-			ret = 4;
+				if (_debug) {
+					printf(" CRC - fail \n") ;
+				}
 
-			if (_debug) {
-				printf(" CRC - fail \n") ;
 			}
 
+			decoder->decode_state = SUMD_DECODE_STATE_UNSYNCED;
+			break;
 		}
 
-		_decode_state = SUMD_DECODE_STATE_UNSYNCED;
-		break;
+		if (ret == 0) {
+			decoded = true;
+		}
 	}
 
-	return ret;
+	return decoded ? 0 : ret;
 }
@@ -42,6 +42,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 __BEGIN_DECLS
 
@@ -60,7 +61,7 @@ typedef struct {
 	uint8_t	header;							///< 0xA8 for a valid packet
 	uint8_t	status;							///< 0x01 valid and live SUMD data frame / 0x00 = SUMH / 0x81 = Failsafe
 	uint8_t	length;							///< Channels
-	uint8_t	sumd_data[SUMD_MAX_CHANNELS * 2];	///< ChannelData (High Byte/ Low Byte)
+	uint8_t	sumd_data[SUMD_MAX_CHANNELS * 2 + 1];	///< ChannelData (High Byte/ Low Byte), starting at index 1
 	uint8_t	crc16_high;						///< High Byte of 16 Bit CRC
 	uint8_t	crc16_low;						///< Low Byte of 16 Bit CRC
 	uint8_t	telemetry;						///< Telemetry request
@@ -68,6 +69,22 @@ typedef struct {
 } ReceiverFcPacketHoTT;
 #pragma pack(pop)
 
+/**
+ * SUMD/SUMH decoder state
+ *
+ * Each receiver needs its own instance, sumd_decode() and sumd_parse()
+ * operate on a single shared one.
+ */
+typedef struct {
+	unsigned		decode_state;	///< from enum SUMD_DECODE_STATE
+	uint8_t			rxlen;		///< bytes received after the status field
+	uint8_t			crc8;		///< running SUMH checksum
+	uint16_t		crc16;		///< running SUMD checksum
+	bool			sumd;		///< true for SUMD, false for SUMH
+	bool			crcOK;		///< checksum of the last packet matched
+	ReceiverFcPacketHoTT	rxpacket;	///< packet being received
+} sumd_decoder_t;
+
 
 /**
  * CRC16 implementation for SUMD protocol
@@ -104,5 +121,28 @@ __EXPORT int sumd_decode(uint8_t byte, uint8_t *rssi, uint8_t *rx_count, uint16_
 __EXPORT int sumd_decode(uint8_t byte, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count,
 			 uint16_t *channels, uint16_t max_chan_count);
 
+/**
+ * Decode a buffer of SUMD/SUMH bytes
+ *
+ * Same as sumd_decode() for every byte of buf, but channel data is consumed in one go.
+ *
+ * @param buf received bytes
+ * @param len number of bytes in buf
+ * @return 0 if at least one packet was decoded (outputs hold the latest), else the result of the last byte
+ */
+__EXPORT int sumd_parse(const uint8_t *buf, unsigned len, uint8_t *rssi, uint8_t *rx_count, uint16_t *channel_count,
+			uint16_t *channels, uint16_t max_chan_count);
+
+/**
+ * Reset a decoder to the unsynced state
+ */
+__EXPORT void sumd_decoder_init(sumd_decoder_t *decoder);
+
+/**
+ * Decode a buffer of SUMD/SUMH bytes with the given decoder, see sumd_parse()
+ */
+__EXPORT int sumd_decoder_parse(sumd_decoder_t *decoder, const uint8_t *buf, unsigned len, uint8_t *rssi,
+				uint8_t *rx_count, uint16_t *channel_count, uint16_t *channels, uint16_t max_chan_count);
+
 
 __END_DECLS
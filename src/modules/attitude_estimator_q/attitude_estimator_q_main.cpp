@@ -71,6 +71,7 @@
 #include <systemlib/systemlib.h>
 #include <systemlib/param/param.h>
 #include <systemlib/perf_counter.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/err.h>
 #include <systemlib/mavlink_log.h>
 
@@ -241,7 +242,7 @@ AttitudeEstimatorQ::~AttitudeEstimatorQ()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -315,7 +316,7 @@ void AttitudeEstimatorQ::task_main()
 
 		if (ret < 0) {
 			// Poll error, sleep and try again
-			usleep(10000);
+			px4_usleep(10000);
 			PX4_WARN("Q POLL ERROR");
 			continue;
 
@@ -499,6 +500,7 @@ void AttitudeEstimatorQ::task_main()
 			struct control_state_s ctrl_state = {};
 
 			ctrl_state.timestamp = sensors.timestamp;
+			ctrl_state.timestamp_sample = sensors.timestamp;
 
 			/* attitude quaternions for control state */
 			ctrl_state.q[0] = _q(0);
@@ -544,6 +546,8 @@ void AttitudeEstimatorQ::task_main()
 			int ctrl_inst;
 			/* publish to control state topic */
 			orb_publish_auto(ORB_ID(control_state), &_ctrl_state_pub, &ctrl_state, &ctrl_inst, ORB_PRIO_HIGH);
+
+			latency_trace_stamp(LATENCY_TRACE_ESTIMATOR, ctrl_state.timestamp_sample);
 		}
 
 		{
@@ -202,7 +202,7 @@ BottleDrop::~BottleDrop()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -257,7 +257,7 @@ BottleDrop::open_bay()
 
 	actuators_publish();
 
-	usleep(500 * 1000);
+	px4_usleep(500 * 1000);
 }
 
 void
@@ -272,7 +272,7 @@ BottleDrop::close_bay()
 	actuators_publish();
 
 	// delay until the bay is closed
-	usleep(500 * 1000);
+	px4_usleep(500 * 1000);
 }
 
 void
@@ -288,7 +288,7 @@ BottleDrop::drop()
 	}
 
 	while (hrt_elapsed_time(&_doors_opened) < 500 * 1000 && hrt_elapsed_time(&starttime) < 2000000) {
-		usleep(50000);
+		px4_usleep(50000);
 		warnx("delayed by door!");
 	}
 
@@ -300,7 +300,7 @@ BottleDrop::drop()
 	warnx("dropping now");
 
 	// Give it time to drop
-	usleep(1000 * 1000);
+	px4_usleep(1000 * 1000);
 }
 
 void
@@ -719,7 +719,7 @@ BottleDrop::task_main()
 			// update_actuators();
 
 			// run at roughly 100 Hz
-			usleep(sleeptime_us);
+			px4_usleep(sleeptime_us);
 
 			dt_runs = hrt_elapsed_time(&last_run) / 1e6f;
 			last_run = hrt_absolute_time();
@@ -126,7 +126,7 @@ int do_airspeed_calibration(orb_advert_t *mavlink_log_pub)
 	}
 
 	calibration_log_critical(mavlink_log_pub, "[cal] Ensure sensor is not measuring wind");
-	usleep(500 * 1000);
+	px4_usleep(500 * 1000);
 
 	while (calibration_counter < calibration_count) {
 
@@ -194,7 +194,7 @@ int do_airspeed_calibration(orb_advert_t *mavlink_log_pub)
 	calibration_log_info(mavlink_log_pub, "[cal] Offset of %d Pascal", (int)diff_pres_offset);
 
 	/* wait 500 ms to ensure parameter propagated through the system */
-	usleep(500 * 1000);
+	px4_usleep(500 * 1000);
 
 	calibration_log_critical(mavlink_log_pub, "[cal] Blow across front of pitot without touching");
 
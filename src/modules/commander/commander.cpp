@@ -67,6 +67,7 @@
 #include <navigator/navigation.h>
 #include <px4_config.h>
 #include <px4_posix.h>
+#include <px4_sem.hpp>
 #include <px4_tasks.h>
 #include <px4_time.h>
 #include <systemlib/circuit_breaker.h>
@@ -160,6 +161,7 @@ static int autostart_id;
 static bool commander_initialized = false;
 static volatile bool thread_should_exit = false;	/**< daemon exit flag */
 static volatile bool thread_running = false;		/**< daemon status flag */
+static ReadySignal thread_ready;				/**< set by the daemon once initialized or failed */
 static int daemon_task;					/**< Handle of daemon task / thread */
 static bool need_param_autosave = false;		/**< Flag set to true if parameters should be autosaved in next iteration (happens on param update and if functionality is enabled) */
 static bool _usb_telemetry_active = false;
@@ -296,6 +298,7 @@ int commander_main(int argc, char *argv[])
 		}
 
 		thread_should_exit = false;
+		thread_ready.reset();
 		daemon_task = px4_task_spawn_cmd("commander",
 					     SCHED_DEFAULT,
 					     SCHED_PRIORITY_DEFAULT + 40,
@@ -303,18 +306,13 @@ int commander_main(int argc, char *argv[])
 					     commander_thread_main,
 					     (char * const *)&argv[0]);
 
-		unsigned constexpr max_wait_us = 1000000;
-		unsigned constexpr max_wait_steps = 2000;
-
-		unsigned i;
-		for (i = 0; i < max_wait_steps; i++) {
-			usleep(max_wait_us / max_wait_steps);
-			if (thread_running) {
-				break;
-			}
+		if (daemon_task < 0) {
+			warnx("task start failed");
+			return 1;
 		}
 
-		return !(i < max_wait_steps);
+		/* wait for the daemon to finish its initialization */
+		return !(thread_ready.wait(1000000) && thread_running);
 	}
 
 	if (!strcmp(argv[1], "stop")) {
@@ -327,7 +325,7 @@ int commander_main(int argc, char *argv[])
 		thread_should_exit = true;
 
 		while (thread_running) {
-			usleep(200000);
+			px4_usleep(200000);
 			warnx(".");
 		}
 
@@ -1314,6 +1312,7 @@ int commander_thread_main(int argc, char *argv[])
 	if (status_pub == nullptr) {
 		warnx("ERROR: orb_advertise for topic vehicle_status failed (uorb app running?).\n");
 		warnx("exiting.");
+		thread_ready.set_ready();
 		px4_task_exit(ERROR);
 	}
 
@@ -1506,6 +1505,7 @@ int commander_thread_main(int argc, char *argv[])
 	/* now initialized */
 	commander_initialized = true;
 	thread_running = true;
+	thread_ready.set_ready();
 
 	/* update vehicle status to find out vehicle type (required for preflight checks) */
 	param_get(_param_sys_type, &(status.system_type)); // get system type
@@ -1845,7 +1845,7 @@ int commander_thread_main(int argc, char *argv[])
 					 * so lets reset to a classic non-usb state.
 					 */
 					mavlink_log_critical(&mavlink_log_pub, "USB disconnected, rebooting.")
-					usleep(400000);
+					px4_usleep(400000);
 					px4_systemreset(false);
 				}
 
@@ -2464,7 +2464,7 @@ int commander_thread_main(int argc, char *argv[])
 						if (arming_ret == TRANSITION_CHANGED) {
 							arming_state_changed = true;
 						} else {
-							usleep(100000);
+							px4_usleep(100000);
 							print_reject_arm("NOT ARMING: Preflight checks failed");
 						}
 					}
@@ -2869,7 +2869,7 @@ int commander_thread_main(int argc, char *argv[])
 			commander_state_pub = orb_advertise(ORB_ID(commander_state), &internal_state);
 		}
 
-		usleep(COMMANDER_MONITORING_INTERVAL);
+		px4_usleep(COMMANDER_MONITORING_INTERVAL);
 	}
 
 	/* wait for threads to complete */
@@ -3708,13 +3708,13 @@ void *commander_low_prio_loop(void *arg)
 
 					if (((int)(cmd.param1)) == 1) {
 						answer_command(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED, command_ack_pub, command_ack);
-						usleep(100000);
+						px4_usleep(100000);
 						/* reboot */
 						px4_systemreset(false);
 
 					} else if (((int)(cmd.param1)) == 3) {
 						answer_command(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED, command_ack_pub, command_ack);
-						usleep(100000);
+						px4_usleep(100000);
 						/* reboot to bootloader */
 						px4_systemreset(true);
 
@@ -3875,7 +3875,7 @@ void *commander_low_prio_loop(void *arg)
 #ifdef __PX4_QURT
 						// TODO FIXME: on snapdragon the save happens to early when the params
 						// are not set yet. We therefore need to wait some time first.
-						usleep(1000000);
+						px4_usleep(1000000);
 #endif
 
 						int ret = param_save_default();
@@ -167,7 +167,7 @@ int do_esc_calibration(orb_advert_t *mavlink_log_pub, struct actuator_armed_s* a
 				}
 			}
 		}
-		usleep(50000);
+		px4_usleep(50000);
 	}
 
 Out:
@@ -213,29 +213,29 @@ int do_mag_calibration(orb_advert_t *mavlink_log_pub)
 				result = param_save_default();
 
 				/* if there is a any preflight-check system response, let the barrage of messages through */
-				usleep(200000);
+				px4_usleep(200000);
 
 				if (result == OK) {
 					calibration_log_info(mavlink_log_pub, CAL_QGC_PROGRESS_MSG, 100);
-					usleep(20000);
+					px4_usleep(20000);
 					calibration_log_info(mavlink_log_pub, CAL_QGC_DONE_MSG, sensor_name);
-					usleep(20000);
+					px4_usleep(20000);
 					break;
 				} else {
 					calibration_log_critical(mavlink_log_pub, CAL_ERROR_SAVE_PARAMS_MSG);
-					usleep(20000);
+					px4_usleep(20000);
 				}
 				// Fall through
 
 			default:
 				calibration_log_critical(mavlink_log_pub, CAL_QGC_FAILED_MSG, sensor_name);
-				usleep(20000);
+				px4_usleep(20000);
 				break;
 		}
 	}
 
 	/* give this message enough time to propagate */
-	usleep(600000);
+	px4_usleep(600000);
 
 	return result;
 }
@@ -408,7 +408,7 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 					calibration_log_info(worker_data->mavlink_log_pub,
 								     "[cal] %s side calibration: progress <%u>",
 								     detect_orientation_str(orientation), new_progress);
-					usleep(20000);
+					px4_usleep(20000);
 
 					_last_mag_progress = new_progress;
 				}
@@ -428,7 +428,7 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 		calibration_log_info(worker_data->mavlink_log_pub, "[cal] %s side done, rotate to a different side", detect_orientation_str(orientation));
 
 		worker_data->done_count++;
-		usleep(20000);
+		px4_usleep(20000);
 		calibration_log_info(worker_data->mavlink_log_pub, CAL_QGC_PROGRESS_MSG, progress_percentage(worker_data));
 	}
 
@@ -468,7 +468,7 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub)
 			calibration_log_info(mavlink_log_pub,
 				"[cal] %s side done, rotate to a different side",
 				detect_orientation_str(static_cast<enum detect_orientation_return>(i)));
-			usleep(100000);
+			px4_usleep(100000);
 		}
 	}
 
@@ -743,7 +743,7 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub)
 									     cur_mag,
 									     (double)mscale.x_scale, (double)mscale.y_scale, (double)mscale.z_scale);
 #endif
-						usleep(200000);
+						px4_usleep(200000);
 					}
 				}
 			}
@@ -58,6 +58,7 @@
 #include <systemlib/param/param.h>
 #include <systemlib/err.h>
 #include <systemlib/systemlib.h>
+#include <systemlib/latency_trace.h>
 #include <mathlib/mathlib.h>
 #include <mathlib/math/filter/LowPassFilter2p.hpp>
 #include <platforms/px4_defines.h>
@@ -425,7 +426,7 @@ void Ekf2::task_main()
 
 		if (ret < 0) {
 			// Poll error, sleep and try again
-			usleep(10000);
+			px4_usleep(10000);
 			continue;
 
 		} else if (ret == 0) {
@@ -638,6 +639,7 @@ void Ekf2::task_main()
 			float gyro_bias[3] = {};
 			_ekf.get_gyro_bias(gyro_bias);
 			ctrl_state.timestamp = hrt_absolute_time();
+			ctrl_state.timestamp_sample = sensors.timestamp;
 			float gyro_rad[3];
 			gyro_rad[0] = sensors.gyro_rad[0] - gyro_bias[0];
 			gyro_rad[1] = sensors.gyro_rad[1] - gyro_bias[1];
@@ -718,6 +720,8 @@ void Ekf2::task_main()
 				orb_publish(ORB_ID(control_state), _control_state_pub, &ctrl_state);
 			}
 
+			latency_trace_stamp(LATENCY_TRACE_ESTIMATOR, ctrl_state.timestamp_sample);
+
 
 			// generate remaining vehicle attitude data
 			att.timestamp = hrt_absolute_time();
@@ -1100,7 +1104,7 @@ int ekf2_main(int argc, char *argv[])
 
 		// wait for the destruction of the instance
 		while (ekf2::instance != nullptr) {
-			usleep(50000);
+			px4_usleep(50000);
 		}
 
 		return 0;
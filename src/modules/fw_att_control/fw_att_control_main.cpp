@@ -475,7 +475,7 @@ FixedwingAttitudeControl::~FixedwingAttitudeControl()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -1272,7 +1272,7 @@ int fw_att_control_main(int argc, char *argv[])
 
 			/* avoid memory fragmentation by not exiting start handler until the task has fully started */
 			while (att_control::g_control == nullptr || !att_control::g_control->task_running()) {
-				usleep(50000);
+				px4_usleep(50000);
 				printf(".");
 				fflush(stdout);
 			}
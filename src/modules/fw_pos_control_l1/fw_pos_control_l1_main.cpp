@@ -696,7 +696,7 @@ FixedwingPositionControl::~FixedwingPositionControl()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -2580,7 +2580,7 @@ int fw_pos_control_l1_main(int argc, char *argv[])
 
 		/* avoid memory fragmentation by not exiting start handler until the task has fully started */
 		while (l1_control::g_control == nullptr || !l1_control::g_control->task_running()) {
-			usleep(50000);
+			px4_usleep(50000);
 			printf(".");
 			fflush(stdout);
 		}
@@ -71,6 +71,7 @@ LandDetector::~LandDetector()
 int LandDetector::start()
 {
 	_taskShouldExit = false;
+	_ready.reset();
 
 	/* schedule a cycle to start things */
 	work_queue(HPWORK, &_work, (worker_t)&LandDetector::_cycle_trampoline, this, 0);
@@ -106,6 +107,7 @@ void LandDetector::_cycle()
 
 		// Task is now running, keep doing so until we need to stop.
 		_taskIsRunning = true;
+		_ready.set_ready();
 	}
 
 	_check_params(false);
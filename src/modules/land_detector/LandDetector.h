@@ -41,6 +41,7 @@ Land detector interface for multicopter, fixedwing and VTOL implementations.
 
 #pragma once
 
+#include <px4_sem.hpp>
 #include <px4_workqueue.h>
 #include <systemlib/hysteresis/hysteresis.h>
 #include <uORB/uORB.h>
@@ -70,6 +71,15 @@ public:
 		return _taskIsRunning;
 	}
 
+	/*
+	 * Wait until the first cycle has initialized the task.
+	 * @return true if the task is running, false on timeout.
+	 */
+	bool wait_until_running(unsigned timeout_us)
+	{
+		return _ready.wait(timeout_us) && _taskIsRunning;
+	}
+
 
 	/*
 	 * @return current state.
@@ -153,6 +163,7 @@ private:
 
 	bool _taskShouldExit;
 	bool _taskIsRunning;
+	ReadySignal _ready;
 
 	struct work_s	_work;
 };
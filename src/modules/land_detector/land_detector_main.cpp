@@ -91,7 +91,7 @@ static void land_detector_stop()
 
 	do {
 		/* wait 20ms */
-		usleep(20000);
+		px4_usleep(20000);
 
 	} while (land_detector_task->is_running() && ++i < 50);
 
@@ -141,22 +141,10 @@ static int land_detector_start(const char *mode)
 	}
 
 	/* avoid memory fragmentation by not exiting start handler until the task has fully started */
-	const uint64_t timeout = hrt_absolute_time() + 5000000; //5 second timeout
-
-	/* avoid printing dots just yet and do one sleep before the first check */
-	usleep(10000);
-
-	/* check if the waiting involving dots and a newline are still needed */
-	if (!land_detector_task->is_running()) {
-		while (!land_detector_task->is_running()) {
-			usleep(50000);
-
-			if (hrt_absolute_time() > timeout) {
-				PX4_WARN("start failed - timeout");
-				land_detector_stop();
-				return 1;
-			}
-		}
+	if (!land_detector_task->wait_until_running(5000000)) {
+		PX4_WARN("start failed - timeout");
+		land_detector_stop();
+		return 1;
 	}
 
 	//Remember current active mode
@@ -46,6 +46,7 @@
 #include <px4_config.h>
 #include <px4_workqueue.h>
 #include <px4_defines.h>
+#include <px4_tasks.h>
 
 #include <drivers/drv_hrt.h>
 
@@ -55,8 +56,11 @@
 
 #include <uORB/uORB.h>
 #include <uORB/topics/cpuload.h>
+#include <uORB/topics/task_load.h>
 
+#ifdef __PX4_NUTTX
 extern struct system_load_s system_load;
+#endif
 
 
 namespace load_mon
@@ -93,6 +97,11 @@ private:
 	/* Do a calculation of the CPU load and publish it. */
 	void _compute();
 
+#ifdef __PX4_LINUX
+	/* Compute the load and latencies of each task and publish them. */
+	void _compute_tasks();
+#endif
+
 	bool _taskShouldExit;
 	bool _taskIsRunning;
 	struct work_s _work;
@@ -100,6 +109,25 @@ private:
 	struct cpuload_s _cpuload;
 	orb_advert_t _cpuload_pub;
 	hrt_abstime _last_idle_time;
+
+#ifdef __PX4_LINUX
+	static const int TASK_SLOTS = 64;
+
+	/* counters of each task slot at the previous cycle */
+	struct TaskCounters {
+		uint64_t run_time_us;
+		uint64_t runq_time_us;
+		uint64_t timeslices;
+		uint32_t wakeup_count;
+		uint64_t wakeup_latency_sum_us;
+	};
+
+	TaskCounters _last_counters[TASK_SLOTS];
+	px4_task_stats_t _stats[TASK_SLOTS];
+	struct task_load_s _task_load;
+	orb_advert_t _task_load_pub;
+	hrt_abstime _last_task_time;
+#endif
 };
 
 
@@ -110,6 +138,13 @@ LoadMon::LoadMon() :
 	_cpuload{},
 	_cpuload_pub(nullptr),
 	_last_idle_time(0)
+#ifdef __PX4_LINUX
+	, _last_counters{},
+	_stats{},
+	_task_load{},
+	_task_load_pub(nullptr),
+	_last_task_time(0)
+#endif
 {}
 
 LoadMon::~LoadMon()
@@ -151,6 +186,11 @@ void LoadMon::_cycle()
 
 void LoadMon::_compute()
 {
+#if defined(__PX4_LINUX)
+	_compute_tasks();
+
+#elif defined(__PX4_NUTTX)
+
 	if (_last_idle_time == 0) {
 		/* Just get the time in the first iteration */
 		_last_idle_time = system_load.tasks[0].total_runtime;
@@ -164,6 +204,93 @@ void LoadMon::_compute()
 	_cpuload.timestamp = hrt_absolute_time();
 	_cpuload.load = 1.0f - (float)interval_idletime / (float)LOAD_MON_INTERVAL_US;
 
+	if (_cpuload_pub == nullptr) {
+		_cpuload_pub = orb_advertise(ORB_ID(cpuload), &_cpuload);
+
+	} else {
+		orb_publish(ORB_ID(cpuload), _cpuload_pub, &_cpuload);
+	}
+
+#endif
+}
+
+#ifdef __PX4_LINUX
+void LoadMon::_compute_tasks()
+{
+	const hrt_abstime now = hrt_absolute_time();
+	const hrt_abstime interval = now - _last_task_time;
+	const bool first = (_last_task_time == 0);
+	_last_task_time = now;
+
+	int count = px4_task_stats(_stats, TASK_SLOTS);
+
+	memset(&_task_load, 0, sizeof(_task_load));
+	float total_load = 0.0f;
+
+	for (int i = 0; i < count; i++) {
+		const px4_task_stats_t &task = _stats[i];
+
+		if (task.index >= TASK_SLOTS) {
+			continue;
+		}
+
+		TaskCounters &last = _last_counters[task.index];
+
+		/* a slot that was reused by a new task restarts its counters */
+		if (task.run_time_us < last.run_time_us || task.wakeup_count < last.wakeup_count) {
+			memset(&last, 0, sizeof(last));
+		}
+
+		float load = 0.0f;
+
+		if (!first && interval > 0) {
+			load = (float)(task.run_time_us - last.run_time_us) / (float)interval;
+		}
+
+		total_load += load;
+
+		if (_task_load.count < task_load_s::MAX_TASKS) {
+			const unsigned n = _task_load.count++;
+
+			strncpy(&_task_load.name[n * task_load_s::NAME_LEN], task.name, task_load_s::NAME_LEN - 1);
+			_task_load.tid[n] = task.tid;
+			_task_load.load[n] = load;
+
+			const uint64_t slices = task.timeslices - last.timeslices;
+			_task_load.runq_latency_avg[n] = (slices > 0) ? (task.runq_time_us - last.runq_time_us) / slices : 0;
+
+			const uint32_t wakeups = task.wakeup_count - last.wakeup_count;
+			_task_load.wakeup_latency_avg[n] = (wakeups > 0) ?
+							   (task.wakeup_latency_sum_us - last.wakeup_latency_sum_us) / wakeups : 0;
+			_task_load.wakeup_latency_max[n] = task.wakeup_latency_max_us;
+		}
+
+		last.run_time_us = task.run_time_us;
+		last.runq_time_us = task.runq_time_us;
+		last.timeslices = task.timeslices;
+		last.wakeup_count = task.wakeup_count;
+		last.wakeup_latency_sum_us = task.wakeup_latency_sum_us;
+	}
+
+	if (first) {
+		return;
+	}
+
+	_task_load.timestamp = now;
+
+	if (_task_load_pub == nullptr) {
+		_task_load_pub = orb_advertise(ORB_ID(task_load), &_task_load);
+
+	} else {
+		orb_publish(ORB_ID(task_load), _task_load_pub, &_task_load);
+	}
+
+	/* system load as the share of all cores used by PX4 tasks */
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	_cpuload.timestamp = now;
+	_cpuload.load = total_load / (float)((ncpus > 0) ? ncpus : 1);
+
 	if (_cpuload_pub == nullptr) {
 		_cpuload_pub = orb_advertise(ORB_ID(cpuload), &_cpuload);
 
@@ -171,6 +298,7 @@ void LoadMon::_compute()
 		orb_publish(ORB_ID(cpuload), _cpuload_pub, &_cpuload);
 	}
 }
+#endif
 
 
 
@@ -247,7 +375,7 @@ int load_mon_main(int argc, char *argv[])
 
 		do {
 			/* wait up to 3s */
-			usleep(100000);
+			px4_usleep(100000);
 
 		} while (load_mon->isRunning() && ++i < 30);
 
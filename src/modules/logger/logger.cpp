@@ -45,6 +45,7 @@
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/mavlink_log.h>
 #include <uORB/topics/parameter_update.h>
+#include <uORB/topics/perf_counter.h>
 #include <uORB/topics/vehicle_status.h>
 #include <uORB/topics/vehicle_gps_position.h>
 
@@ -345,6 +346,7 @@ Logger::Logger(size_t buffer_size, uint32_t log_interval, bool log_on_start,
 	_log_interval(log_interval)
 {
 	_log_utc_offset = param_find("SDLOG_UTC_OFFSET");
+	_perf_interval_param = param_find("SDLOG_PERF_INT");
 }
 
 Logger::~Logger()
@@ -358,7 +360,7 @@ Logger::~Logger()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 200) {
@@ -376,6 +378,10 @@ Logger::~Logger()
 	if (_msg_buffer) {
 		delete[](_msg_buffer);
 	}
+
+	if (_perf_msgs) {
+		delete[](_perf_msgs);
+	}
 }
 
 int Logger::add_topic(const orb_metadata *topic)
@@ -505,7 +511,10 @@ void Logger::add_default_topics()
 	add_topic("control_state", 20);
 	add_topic("camera_trigger");
 	add_topic("cpuload");
+	add_topic("task_load", 1000);
+	add_topic("gyro_spectrum", 100);
 	add_topic("gps_dump"); //this will only be published if GPS_DUMP_COMM is set
+	add_topic("perf_counter"); //published by the logger itself if SDLOG_PERF_INT > 0
 
 	/* for estimator replay (need to be at full rate) */
 	add_topic("sensor_combined");
@@ -656,6 +665,8 @@ void Logger::run()
 	px4_sem_init(&timer_semaphore, 0, 0);
 	hrt_call_every(&timer_call, _log_interval, _log_interval, timer_callback, &timer_semaphore);
 
+	param_get(_perf_interval_param, &_perf_interval);
+
 
 	while (!_task_should_exit) {
 
@@ -692,44 +703,26 @@ void Logger::run()
 			if (parameter_update_sub.check_updated()) {
 				parameter_update_sub.update();
 				write_changed_parameters();
+				param_get(_perf_interval_param, &_perf_interval);
 			}
 
 			/* wait for lock on log buffer */
 			_writer.lock();
 
 			for (LoggerSubscription &sub : _subscriptions) {
-				/* each message consists of a header followed by an orb data object
-				 */
-				size_t msg_size = sizeof(ulog_message_data_header_s) + sub.metadata->o_size_no_padding;
-
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
 				for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
-					if (copy_if_updated_multi(sub, instance, _msg_buffer + sizeof(ulog_message_data_header_s))) {
+					size_t msg_size = 0;
 
-						uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-						//write one byte after another (necessary because of alignment)
-						_msg_buffer[0] = (uint8_t)write_msg_size;
-						_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-						_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-						uint16_t write_msg_id = sub.msg_ids[instance];
-						_msg_buffer[3] = (uint8_t)write_msg_id;
-						_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
-
-						//PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.metadata->o_name, sub.metadata->o_size, msg_size);
-
-						if (write(_msg_buffer, msg_size)) {
+					if (!write_if_updated(sub, instance, msg_size)) {
+						break;	// Write buffer overflow, skip this record
+					}
 
+					if (msg_size > 0) {
 #ifdef DBGPRINT
-							total_bytes += msg_size;
+						total_bytes += msg_size;
 #endif /* DBGPRINT */
 
-							data_written = true;
-
-						} else {
-							break;	// Write buffer overflow, skip this record
-						}
+						data_written = true;
 					}
 				}
 			}
@@ -754,6 +747,14 @@ void Logger::run()
 				}
 			}
 
+			if (_perf_interval > 0 && hrt_elapsed_time(&_perf_last_write) >= (hrt_abstime)_perf_interval * 1000) {
+				_perf_last_write = hrt_absolute_time();
+
+				if (write_perf_counters()) {
+					data_written = true;
+				}
+			}
+
 			if (!_dropout_start && _writer.get_buffer_fill_count() > _high_water) {
 				_high_water = _writer.get_buffer_fill_count();
 			}
@@ -827,6 +828,132 @@ void Logger::run()
 	}
 }
 
+bool Logger::write_if_updated(LoggerSubscription &sub, uint8_t instance, size_t &bytes_written)
+{
+	/* each message consists of a header followed by an orb data object
+	 */
+	size_t msg_size = sizeof(ulog_message_data_header_s) + sub.metadata->o_size_no_padding;
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (!copy_if_updated_multi(sub, instance, _msg_buffer + sizeof(ulog_message_data_header_s))) {
+		return true;
+	}
+
+	uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+	//write one byte after another (necessary because of alignment)
+	_msg_buffer[0] = (uint8_t)write_msg_size;
+	_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	uint16_t write_msg_id = sub.msg_ids[instance];
+	_msg_buffer[3] = (uint8_t)write_msg_id;
+	_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+	//PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.metadata->o_name, sub.metadata->o_size, msg_size);
+
+	if (!write(_msg_buffer, msg_size)) {
+		return false;
+	}
+
+	bytes_written = msg_size;
+	return true;
+}
+
+namespace
+{
+struct perf_copy_context {
+	Logger *logger;
+	hrt_abstime timestamp;
+	unsigned count;
+};
+
+inline uint32_t clamp_us(uint64_t value)
+{
+	return (value > UINT32_MAX) ? UINT32_MAX : (uint32_t)value;
+}
+}
+
+bool Logger::write_perf_counters()
+{
+	// copy the counters out first, perf_iterate_all() holds the perf counter list lock
+	perf_copy_context context{this, hrt_absolute_time(), 0};
+	perf_iterate_all(&Logger::copy_perf_counter, &context);
+
+	LoggerSubscription *sub = nullptr;
+
+	for (LoggerSubscription &s : _subscriptions) {
+		if (s.metadata == ORB_ID(perf_counter)) {
+			sub = &s;
+			break;
+		}
+	}
+
+	for (unsigned i = 0; i < context.count; i++) {
+		if (_perf_pub == nullptr) {
+			_perf_pub = orb_advertise(ORB_ID(perf_counter), &_perf_msgs[i]);
+
+			// subscribe right away instead of waiting for the next subscribe retry
+			if (sub != nullptr) {
+				sub->time_tried_subscribe = 0;
+			}
+
+		} else {
+			orb_publish(ORB_ID(perf_counter), _perf_pub, &_perf_msgs[i]);
+		}
+
+		// the topic has a single slot, so log each counter right after publishing it
+		if (sub != nullptr) {
+			size_t msg_size = 0;
+
+			// once the buffer overflows, skip the rest of this snapshot
+			if (!write_if_updated(*sub, 0, msg_size)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void Logger::copy_perf_counter(const struct perf_counter_summary *summary, void *user)
+{
+	perf_copy_context *context = static_cast<perf_copy_context *>(user);
+	Logger *logger = context->logger;
+
+	if (context->count == logger->_perf_msgs_len) {
+		unsigned len = (logger->_perf_msgs_len > 0) ? 2 * logger->_perf_msgs_len : 32;
+		perf_counter_s *msgs = new perf_counter_s[len];
+
+		if (msgs == nullptr) {
+			return;
+		}
+
+		if (logger->_perf_msgs) {
+			memcpy(msgs, logger->_perf_msgs, context->count * sizeof(perf_counter_s));
+			delete[](logger->_perf_msgs);
+		}
+
+		logger->_perf_msgs = msgs;
+		logger->_perf_msgs_len = len;
+	}
+
+	perf_counter_s &msg = logger->_perf_msgs[context->count++];
+	memset(&msg, 0, sizeof(msg));
+	msg.timestamp = context->timestamp;
+	strncpy(msg.name, summary->name, sizeof(msg.name));
+	msg.counter_type = (uint8_t)summary->type;
+	msg.event_count = summary->event_count;
+	msg.event_overruns = clamp_us(summary->event_overruns);
+	msg.time_total = summary->time_total;
+	msg.time_least = clamp_us(summary->time_least);
+	msg.time_most = clamp_us(summary->time_most);
+	msg.time_avg = clamp_us(summary->time_avg);
+	msg.rms = summary->rms;
+	msg.p50 = clamp_us(summary->p50);
+	msg.p99 = clamp_us(summary->p99);
+}
+
 bool Logger::write(void *ptr, size_t size)
 {
 	if (_writer.write(ptr, size, _dropout_start)) {
@@ -1079,7 +1206,7 @@ bool Logger::write_wait(void *ptr, size_t size)
 	while (!_writer.write(ptr, size)) {
 		_writer.unlock();
 		_writer.notify();
-		usleep(_log_interval);
+		px4_usleep(_log_interval);
 		_writer.lock();
 	}
 
@@ -41,6 +41,8 @@
 #include <version/version.h>
 #include <systemlib/git_version.h>
 #include <systemlib/param/param.h>
+#include <systemlib/perf_counter.h>
+#include <uORB/topics/perf_counter.h>
 
 extern "C" __EXPORT int logger_main(int argc, char *argv[]);
 
@@ -172,6 +174,24 @@ private:
 
 	void write_changed_parameters();
 
+	/**
+	 * Write a snapshot of all performance counters, one message per counter.
+	 * Must be called with _writer.lock() held.
+	 * @return true if data written
+	 */
+	bool write_perf_counters();
+
+	/** perf_iterate_all() callback, copies one counter into _perf_msgs */
+	static void copy_perf_counter(const struct perf_counter_summary *summary, void *user);
+
+	/**
+	 * Copy a topic instance if it was updated and write it as a data message.
+	 * Must be called with _writer.lock() held.
+	 * @param bytes_written set to the message size if a message was written
+	 * @return false on write buffer overflow
+	 */
+	bool write_if_updated(LoggerSubscription &sub, uint8_t instance, size_t &bytes_written);
+
 	bool copy_if_updated_multi(LoggerSubscription &sub, int multi_instance, void *buffer);
 
 	/**
@@ -237,6 +257,12 @@ private:
 	LogWriter					_writer;
 	uint32_t					_log_interval;
 	param_t						_log_utc_offset;
+	param_t						_perf_interval_param;
+	int32_t						_perf_interval = 0; ///< perf snapshot interval [ms], 0 = disabled
+	hrt_abstime					_perf_last_write = 0;
+	orb_advert_t					_perf_pub = nullptr; ///< perf counter snapshots, logged as they are published
+	perf_counter_s					*_perf_msgs = nullptr; ///< snapshot copied out of the perf counter list
+	unsigned					_perf_msgs_len = 0;
 	orb_advert_t					_mavlink_log_pub = nullptr;
 	uint16_t					_next_topic_id; ///< id of next subscribed topic
 	char						*_replay_file_name = nullptr;
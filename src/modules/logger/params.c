@@ -48,3 +48,16 @@
  * @group SD Logging
  */
 PARAM_DEFINE_INT32(SDLOG_UTC_OFFSET, 0);
+
+/**
+ * Performance counter snapshot interval
+ *
+ * Interval at which a snapshot of all performance counters is written
+ * to the log. Set to 0 to disable.
+ *
+ * @unit ms
+ * @min 0
+ * @max 60000
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_PERF_INT, 0);
@@ -444,6 +444,15 @@ MavlinkFTP::_workOpen(PayloadHeader* payload, int oflag)
 	warnx("FTP: open '%s'", filename);
 #endif
 
+	// the packed parameter set is generated on request
+	if (oflag == O_RDONLY && strcmp(filename, MavlinkParametersManager::PACKED_FILE_VIRTUAL) == 0) {
+		if (MavlinkParametersManager::export_packed(MavlinkParametersManager::PACKED_FILE_TEMP) != 0) {
+			return kErrFailErrno;
+		}
+
+		filename = (char *)MavlinkParametersManager::PACKED_FILE_TEMP;
+	}
+
 	uint32_t fileSize = 0;
 	struct stat st;
 	if (stat(filename, &st) != 0) {
@@ -105,6 +105,7 @@ static const int ERROR = -1;
 #define FLOW_CONTROL_DISABLE_THRESHOLD		40	///< picked so that some messages still would fit it.
 
 static Mavlink *_mavlink_instances = nullptr;
+ReadySignal Mavlink::_instance_ready;
 
 /**
  * mavlink app start / stop handling function
@@ -186,6 +187,8 @@ Mavlink::Mavlink() :
 	_mavlink_ftp(nullptr),
 	_mavlink_log_handler(nullptr),
 	_mavlink_shell(nullptr),
+	_receiver(nullptr),
+	_receiver_mutex {},
 	_mode(MAVLINK_MODE_NORMAL),
 	_channel(MAVLINK_COMM_0),
 	_radio_id(0),
@@ -205,6 +208,8 @@ Mavlink::Mavlink() :
 	mavlink_link_termination_allowed(false),
 	_subscribe_to_stream(nullptr),
 	_subscribe_to_stream_rate(0.0f),
+	_subscribe_to_stream_mutex {},
+	_subscribe_to_stream_done(),
 	_udp_initialised(false),
 	_flow_control_enabled(false),
 	_last_write_success_time(0),
@@ -297,6 +302,9 @@ Mavlink::Mavlink() :
 		break;
 	}
 
+	pthread_mutex_init(&_receiver_mutex, nullptr);
+	pthread_mutex_init(&_subscribe_to_stream_mutex, nullptr);
+
 	_rstatus.type = telemetry_status_s::TELEMETRY_STATUS_RADIO_TYPE_GENERIC;
 }
 
@@ -324,6 +332,9 @@ Mavlink::~Mavlink()
 			}
 		} while (_task_running);
 	}
+
+	pthread_mutex_destroy(&_receiver_mutex);
+	pthread_mutex_destroy(&_subscribe_to_stream_mutex);
 }
 
 void
@@ -443,6 +454,9 @@ Mavlink::destroy_all_instances()
 		delete (inst_to_del);
 	}
 
+	/* no instance references the shared topic snapshots anymore */
+	MavlinkOrbCache::clear();
+
 	printf("\n");
 	warnx("all instances stopped");
 	return OK;
@@ -1361,9 +1375,7 @@ Mavlink::configure_stream_threadsafe(const char *stream_name, const float rate)
 	 * which polled in mavlink main loop */
 	if (!_task_should_exit) {
 		/* wait for previous subscription completion */
-		while (_subscribe_to_stream != nullptr) {
-			usleep(MAIN_LOOP_DELAY / 2);
-		}
+		pthread_mutex_lock(&_subscribe_to_stream_mutex);
 
 		/* copy stream name */
 		unsigned n = strlen(stream_name) + 1;
@@ -1371,15 +1383,16 @@ Mavlink::configure_stream_threadsafe(const char *stream_name, const float rate)
 		strcpy(s, stream_name);
 
 		/* set subscription task */
+		_subscribe_to_stream_done.reset();
 		_subscribe_to_stream_rate = rate;
 		_subscribe_to_stream = s;
 
-		/* wait for subscription */
-		do {
-			usleep(MAIN_LOOP_DELAY / 2);
-		} while (_subscribe_to_stream != nullptr);
+		/* wait for subscription, the main loop also signals when it exits */
+		_subscribe_to_stream_done.wait(0);
 
 		delete[] s;
+
+		pthread_mutex_unlock(&_subscribe_to_stream_mutex);
 	}
 }
 
@@ -2015,6 +2028,7 @@ Mavlink::task_main(int argc, char *argv[])
 
 	/* now the instance is fully initialized and we can bump the instance count */
 	LL_APPEND(_mavlink_instances, this);
+	_instance_ready.set_ready();
 
 	/* init socket if necessary */
 	if (get_protocol() == UDP) {
@@ -2028,7 +2042,7 @@ Mavlink::task_main(int argc, char *argv[])
 
 	while (!_task_should_exit) {
 		/* main loop */
-		usleep(_main_loop_delay);
+		px4_usleep(_main_loop_delay);
 
 		perf_begin(_loop_perf);
 
@@ -2148,6 +2162,7 @@ Mavlink::task_main(int argc, char *argv[])
 			}
 
 			_subscribe_to_stream = nullptr;
+			_subscribe_to_stream_done.set_ready();
 		}
 
 		/* update streams */
@@ -2228,8 +2243,9 @@ Mavlink::task_main(int argc, char *argv[])
 	/* first wait for threads to complete before tearing down anything */
 	pthread_join(_receive_thread, NULL);
 
-	delete _subscribe_to_stream;
+	/* release a pending configure_stream_threadsafe(), which owns the stream name */
 	_subscribe_to_stream = nullptr;
+	_subscribe_to_stream_done.set_ready();
 
 	/* delete streams */
 	MavlinkStream *stream_to_del = nullptr;
@@ -2298,6 +2314,9 @@ int Mavlink::start_helper(int argc, char *argv[])
 
 	}
 
+	/* release the start command if the task failed before it was listed */
+	_instance_ready.set_ready();
+
 	return res;
 }
 
@@ -2314,6 +2333,8 @@ Mavlink::start(int argc, char *argv[])
 		return 1;
 	}
 
+	_instance_ready.reset();
+
 	// Instantiate thread
 	char buf[24];
 	sprintf(buf, "mavlink_if%d", ic);
@@ -2336,18 +2357,8 @@ Mavlink::start(int argc, char *argv[])
 	// this is effectively a lock on concurrent
 	// instance starting. XXX do a real lock.
 
-	// Sleep 500 us between each attempt
-	const unsigned sleeptime = 500;
-
 	// Wait 100 ms max for the startup.
-	const unsigned limit = 100 * 1000 / sleeptime;
-
-	unsigned count = 0;
-
-	while (ic == Mavlink::instance_count() && count < limit) {
-		::usleep(sleeptime);
-		count++;
-	}
+	_instance_ready.wait(100 * 1000);
 
 	return OK;
 }
@@ -2398,6 +2409,15 @@ Mavlink::display_status()
 	printf("\trx: %.3f kB/s\n", (double)_rate_rx);
 	printf("\trate mult: %.3f\n", (double)_rate_mult);
 	printf("\taccepting commands: %s\n", (accepting_commands()) ? "YES" : "NO");
+
+	/* the receiver thread clears the pointer under this lock before deleting the receiver */
+	pthread_mutex_lock(&_receiver_mutex);
+
+	if (_receiver != nullptr) {
+		_receiver->print_status();
+	}
+
+	pthread_mutex_unlock(&_receiver_mutex);
 }
 
 int
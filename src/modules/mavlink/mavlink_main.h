@@ -53,6 +53,7 @@
 #include <systemlib/param/param.h>
 #include <systemlib/perf_counter.h>
 #include <pthread.h>
+#include <px4_sem.hpp>
 #include <systemlib/mavlink_log.h>
 #include <drivers/device/ringbuffer.h>
 
@@ -71,6 +72,8 @@
 #include "mavlink_log_handler.h"
 #include "mavlink_shell.h"
 
+class MavlinkReceiver;
+
 enum Protocol {
 	SERIAL = 0,
 	UDP,
@@ -225,6 +228,9 @@ public:
 
 	static int		start_helper(int argc, char *argv[]);
 
+	/** set once a new instance is in the instance list, or once its task has given up */
+	static ReadySignal	_instance_ready;
+
 	/**
 	 * Handle parameter related messages.
 	 */
@@ -427,6 +433,14 @@ public:
 	/** close the Mavlink shell if it is open */
 	void			close_shell();
 
+	/** set the receiver of this instance, used to display its status. The receiver is torn down after clearing it */
+	void			set_receiver(MavlinkReceiver *receiver)
+	{
+		pthread_mutex_lock(&_receiver_mutex);
+		_receiver = receiver;
+		pthread_mutex_unlock(&_receiver_mutex);
+	}
+
 protected:
 	Mavlink			*next;
 
@@ -459,6 +473,8 @@ private:
 	MavlinkFTP			*_mavlink_ftp;
 	MavlinkLogHandler		*_mavlink_log_handler;
 	MavlinkShell			*_mavlink_shell;
+	MavlinkReceiver			*_receiver;
+	pthread_mutex_t			_receiver_mutex;
 
 	MAVLINK_MODE 		_mode;
 
@@ -493,6 +509,8 @@ private:
 
 	char 			*_subscribe_to_stream;
 	float			_subscribe_to_stream_rate;
+	pthread_mutex_t		_subscribe_to_stream_mutex;	///< one configure_stream_threadsafe() request at a time
+	ReadySignal		_subscribe_to_stream_done;	///< set by the main loop once the request is applied
 	bool 			_udp_initialised;
 
 	bool			_flow_control_enabled;
@@ -824,13 +824,20 @@ protected:
 		if (_att_sub->update(&_att_time, &att)) {
 			mavlink_attitude_t msg;
 
-			msg.time_boot_ms = att.timestamp / 1000;
-			msg.roll = att.roll;
-			msg.pitch = att.pitch;
-			msg.yaw = att.yaw;
-			msg.rollspeed = att.rollspeed;
-			msg.pitchspeed = att.pitchspeed;
-			msg.yawspeed = att.yawspeed;
+			/* other instances might have built this message already */
+			const uint64_t key = _att_sub->get_generation();
+
+			if (!MavlinkOrbCache::get_packed(MAVLINK_MSG_ID_ATTITUDE, key, &msg, sizeof(msg))) {
+				msg.time_boot_ms = att.timestamp / 1000;
+				msg.roll = att.roll;
+				msg.pitch = att.pitch;
+				msg.yaw = att.yaw;
+				msg.rollspeed = att.rollspeed;
+				msg.pitchspeed = att.pitchspeed;
+				msg.yawspeed = att.yawspeed;
+
+				MavlinkOrbCache::set_packed(MAVLINK_MSG_ID_ATTITUDE, key, &msg, sizeof(msg));
+			}
 
 			mavlink_msg_attitude_send_struct(_mavlink->get_channel(), &msg);
 		}
@@ -1386,15 +1393,22 @@ protected:
 		if (updated) {
 			mavlink_global_position_int_t msg;
 
-			msg.time_boot_ms = pos.timestamp / 1000;
-			msg.lat = pos.lat * 1e7;
-			msg.lon = pos.lon * 1e7;
-			msg.alt = pos.alt * 1000.0f;
-			msg.relative_alt = (pos.alt - home.alt) * 1000.0f;
-			msg.vx = pos.vel_n * 100.0f;
-			msg.vy = pos.vel_e * 100.0f;
-			msg.vz = pos.vel_d * 100.0f;
-			msg.hdg = _wrap_2pi(pos.yaw) * M_RAD_TO_DEG_F * 100.0f;
+			/* the message depends on both topics, key it on both generations */
+			const uint64_t key = ((uint64_t)_pos_sub->get_generation() << 32) | _home_sub->get_generation();
+
+			if (!MavlinkOrbCache::get_packed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, key, &msg, sizeof(msg))) {
+				msg.time_boot_ms = pos.timestamp / 1000;
+				msg.lat = pos.lat * 1e7;
+				msg.lon = pos.lon * 1e7;
+				msg.alt = pos.alt * 1000.0f;
+				msg.relative_alt = (pos.alt - home.alt) * 1000.0f;
+				msg.vx = pos.vel_n * 100.0f;
+				msg.vy = pos.vel_e * 100.0f;
+				msg.vz = pos.vel_d * 100.0f;
+				msg.hdg = _wrap_2pi(pos.yaw) * M_RAD_TO_DEG_F * 100.0f;
+
+				MavlinkOrbCache::set_packed(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, key, &msg, sizeof(msg));
+			}
 
 			mavlink_msg_global_position_int_send_struct(_mavlink->get_channel(), &msg);
 		}
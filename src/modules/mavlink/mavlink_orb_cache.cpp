@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_orb_cache.cpp
+ * Process-wide uORB snapshot cache shared by all MAVLink instances.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <systemlib/uthash/utlist.h>
+
+#include "mavlink_orb_cache.h"
+
+pthread_mutex_t MavlinkOrbCache::_mutex = PTHREAD_MUTEX_INITIALIZER;
+MavlinkOrbCache::Entry *MavlinkOrbCache::_entries = nullptr;
+MavlinkOrbCache::Packed *MavlinkOrbCache::_packed = nullptr;
+
+MavlinkOrbCache::Entry *
+MavlinkOrbCache::get_entry(const orb_id_t topic, int instance)
+{
+	Entry *entry;
+
+	pthread_mutex_lock(&_mutex);
+
+	LL_FOREACH(_entries, entry) {
+		if (entry->topic == topic && entry->instance == instance) {
+			pthread_mutex_unlock(&_mutex);
+			return entry;
+		}
+	}
+
+	entry = new Entry();
+
+	if (entry != nullptr) {
+		entry->next = nullptr;
+		entry->topic = topic;
+		entry->instance = instance;
+		entry->time = 0;
+		entry->generation = 0;
+		entry->data = new uint8_t[topic->o_size];
+
+		if (entry->data == nullptr) {
+			delete entry;
+			entry = nullptr;
+
+		} else {
+			LL_APPEND(_entries, entry);
+		}
+	}
+
+	pthread_mutex_unlock(&_mutex);
+
+	return entry;
+}
+
+bool
+MavlinkOrbCache::copy(Entry *entry, int fd, uint64_t time_topic, void *data, uint32_t *generation)
+{
+	pthread_mutex_lock(&_mutex);
+
+	/* a publication time of 0 means orb_stat failed, always go to uORB then */
+	if (entry->generation == 0 || time_topic == 0 || entry->time != time_topic) {
+		if (orb_copy(entry->topic, fd, entry->data)) {
+			pthread_mutex_unlock(&_mutex);
+			return false;
+		}
+
+		entry->time = time_topic;
+
+		/* skip 0, it is reserved for "no data" */
+		if (++entry->generation == 0) {
+			entry->generation = 1;
+		}
+	}
+
+	memcpy(data, entry->data, entry->topic->o_size);
+	*generation = entry->generation;
+
+	pthread_mutex_unlock(&_mutex);
+
+	return true;
+}
+
+bool
+MavlinkOrbCache::get_packed(uint32_t msgid, uint64_t key, void *payload, size_t len)
+{
+	bool found = false;
+	Packed *packed;
+
+	pthread_mutex_lock(&_mutex);
+
+	LL_FOREACH(_packed, packed) {
+		if (packed->msgid == msgid) {
+			if (packed->key == key && packed->len == len) {
+				memcpy(payload, packed->payload, len);
+				found = true;
+			}
+
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&_mutex);
+
+	return found;
+}
+
+void
+MavlinkOrbCache::set_packed(uint32_t msgid, uint64_t key, const void *payload, size_t len)
+{
+	if (len > MAX_PAYLOAD_LEN) {
+		return;
+	}
+
+	Packed *packed;
+
+	pthread_mutex_lock(&_mutex);
+
+	LL_FOREACH(_packed, packed) {
+		if (packed->msgid == msgid) {
+			break;
+		}
+	}
+
+	if (packed == nullptr) {
+		packed = new Packed();
+
+		if (packed == nullptr) {
+			pthread_mutex_unlock(&_mutex);
+			return;
+		}
+
+		packed->next = nullptr;
+		packed->msgid = msgid;
+		LL_APPEND(_packed, packed);
+	}
+
+	packed->key = key;
+	packed->len = len;
+	memcpy(packed->payload, payload, len);
+
+	pthread_mutex_unlock(&_mutex);
+}
+
+void
+MavlinkOrbCache::clear()
+{
+	pthread_mutex_lock(&_mutex);
+
+	Entry *entry;
+	Entry *entry_tmp;
+
+	LL_FOREACH_SAFE(_entries, entry, entry_tmp) {
+		LL_DELETE(_entries, entry);
+		delete[] entry->data;
+		delete entry;
+	}
+
+	Packed *packed;
+	Packed *packed_tmp;
+
+	LL_FOREACH_SAFE(_packed, packed, packed_tmp) {
+		LL_DELETE(_packed, packed);
+		delete packed;
+	}
+
+	pthread_mutex_unlock(&_mutex);
+}
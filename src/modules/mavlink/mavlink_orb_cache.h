@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_orb_cache.h
+ * Process-wide uORB snapshot cache shared by all MAVLink instances.
+ *
+ * Every MAVLink instance streams largely the same topics. Instead of each
+ * instance copying (and encoding) the same data, the first instance that
+ * sees a new publication copies it into the cache and bumps the generation,
+ * the other instances copy from the cache. Encoded message payloads can be
+ * memoized per (message, generation) so additional links only pay for the
+ * channel specific framing.
+ */
+
+#ifndef MAVLINK_ORB_CACHE_H_
+#define MAVLINK_ORB_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <uORB/uORB.h>
+
+
+class MavlinkOrbCache
+{
+public:
+	/**
+	 * Cached snapshot of one topic instance.
+	 */
+	struct Entry {
+		Entry		*next;
+		orb_id_t	topic;
+		int		instance;
+		uint64_t	time;		///< publication time of the cached data
+		uint32_t	generation;	///< incremented on every new copy, 0 = no data yet
+		uint8_t		*data;
+	};
+
+	/**
+	 * Get (and create if required) the cache entry for a topic instance.
+	 *
+	 * @return entry, nullptr if out of memory
+	 */
+	static Entry *get_entry(const orb_id_t topic, int instance);
+
+	/**
+	 * Copy topic data through the cache.
+	 *
+	 * The topic is only copied from uORB if the cached snapshot is older
+	 * than time_topic, otherwise the cached data is returned.
+	 *
+	 * @param entry cache entry of the topic
+	 * @param fd subscription handle of the caller
+	 * @param time_topic last publication time of the topic (orb_stat)
+	 * @param data buffer to copy the topic data into
+	 * @param generation set to the generation of the returned data
+	 * @return true if data was copied
+	 */
+	static bool copy(Entry *entry, int fd, uint64_t time_topic, void *data, uint32_t *generation);
+
+	/**
+	 * Get a memoized message payload.
+	 *
+	 * @param msgid MAVLink message id
+	 * @param key generation(s) the payload was built from
+	 * @param payload buffer for the payload
+	 * @param len payload length
+	 * @return true if a payload for (msgid, key) was found and copied
+	 */
+	static bool get_packed(uint32_t msgid, uint64_t key, void *payload, size_t len);
+
+	/**
+	 * Memoize a message payload for (msgid, key).
+	 */
+	static void set_packed(uint32_t msgid, uint64_t key, const void *payload, size_t len);
+
+	/**
+	 * Free all entries. Only call this when no MAVLink instance is running.
+	 */
+	static void clear();
+
+private:
+	static constexpr size_t MAX_PAYLOAD_LEN = 255;
+
+	struct Packed {
+		Packed		*next;
+		uint32_t	msgid;
+		uint64_t	key;
+		size_t		len;
+		uint8_t		payload[MAX_PAYLOAD_LEN];
+	};
+
+	static pthread_mutex_t _mutex;
+	static Entry *_entries;
+	static Packed *_packed;
+
+	MavlinkOrbCache() = delete;
+};
+
+
+#endif /* MAVLINK_ORB_CACHE_H_ */
@@ -52,7 +52,9 @@ MavlinkOrbSubscription::MavlinkOrbSubscription(const orb_id_t topic, int instanc
 	_topic(topic),
 	_instance(instance),
 	_fd(orb_subscribe_multi(_topic, instance)),
-	_published(false)
+	_published(false),
+	_cache(MavlinkOrbCache::get_entry(topic, instance)),
+	_generation(0)
 {
 }
 
@@ -85,7 +87,7 @@ MavlinkOrbSubscription::update(uint64_t *time, void *data)
 		time_topic = 0;
 	}
 
-	if (orb_copy(_topic, _fd, data)) {
+	if (!copy_cached(time_topic, data)) {
 		if (data != nullptr) {
 			/* error copying topic data */
 			memset(data, 0, _topic->o_size);
@@ -108,7 +110,24 @@ MavlinkOrbSubscription::update(uint64_t *time, void *data)
 bool
 MavlinkOrbSubscription::update(void *data)
 {
-	return !orb_copy(_topic, _fd, data);
+	uint64_t time_topic;
+
+	if (orb_stat(_fd, &time_topic)) {
+		time_topic = 0;
+	}
+
+	return copy_cached(time_topic, data);
+}
+
+bool
+MavlinkOrbSubscription::copy_cached(uint64_t time_topic, void *data)
+{
+	/* the cache needs a buffer to copy into, callers passing none only poll */
+	if (_cache == nullptr || data == nullptr) {
+		return !orb_copy(_topic, _fd, data);
+	}
+
+	return MavlinkOrbCache::copy(_cache, _fd, time_topic, data, &_generation);
 }
 
 bool
@@ -44,6 +44,8 @@
 #include <systemlib/uthash/utlist.h>
 #include <drivers/drv_hrt.h>
 
+#include "mavlink_orb_cache.h"
+
 
 class MavlinkOrbSubscription
 {
@@ -90,11 +92,24 @@ public:
 	orb_id_t get_topic() const;
 	int get_instance() const;
 
+	/**
+	 * Get the cache generation of the data returned by the last update.
+	 *
+	 * The generation is shared between all MAVLink instances, so it can be
+	 * used as key to memoize messages built from this topic.
+	 * @return generation, 0 if no data has been copied yet
+	 */
+	uint32_t get_generation() const { return _generation; }
+
 private:
 	const orb_id_t _topic;		///< topic metadata
 	const int _instance;		///< get topic instance
 	int _fd;			///< subscription handle
 	bool _published;		///< topic was ever published
+	MavlinkOrbCache::Entry *_cache;	///< shared snapshot of the topic
+	uint32_t _generation;		///< cache generation of the last copied data
+
+	bool copy_cached(uint64_t time_topic, void *data);
 
 	/* do not allow copying this class */
 	MavlinkOrbSubscription(const MavlinkOrbSubscription&);
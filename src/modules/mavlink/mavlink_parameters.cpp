@@ -40,6 +40,11 @@
  */
 
 #include <stdio.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <px4_posix.h>
+#include <mathlib/mathlib.h>
 
 #include <uORB/topics/uavcan_parameter_request.h>
 #include <uORB/topics/uavcan_parameter_value.h>
@@ -48,9 +53,91 @@
 #include "mavlink_main.h"
 
 #define HASH_PARAM "_HASH_CHECK"
+#define GENERATION_PARAM "_PARAM_GEN"
+
+#define PACKED_MAGIC "PXPK"
+#define PACKED_VERSION 1
+
+#define EPOCH_FILE PX4_ROOTFSDIR"/fs/microsd/.param_epoch"
+
+/* boot counter on the SD card, 0 if there is no card */
+static uint16_t next_boot_count()
+{
+	uint16_t count = 0;
+
+	int fd = ::open(EPOCH_FILE, O_CREAT | O_RDWR, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return 0;
+	}
+
+	if (::read(fd, &count, sizeof(count)) != sizeof(count)) {
+		count = 0;
+	}
+
+	count++;
+
+	if (::lseek(fd, 0, SEEK_SET) != 0 || ::write(fd, &count, sizeof(count)) != sizeof(count)) {
+		count = 0;
+	}
+
+	::close(fd);
+	return count;
+}
+
+/*
+ * Boot epoch of the delta sync tokens. It must differ between boots, so that
+ * a token from an earlier boot does not match, and the time since boot does
+ * not (it repeats, and is fixed in lockstep). Use a random value where the
+ * platform has one, or else count the boots on the SD card.
+ */
+static uint16_t sync_epoch()
+{
+	static uint16_t epoch = 0;
+
+	if (epoch == 0) {
+		int fd = ::open("/dev/urandom", O_RDONLY);
+
+		if (fd >= 0) {
+			if (::read(fd, &epoch, sizeof(epoch)) != sizeof(epoch)) {
+				epoch = 0;
+			}
+
+			::close(fd);
+		}
+
+		if (epoch == 0) {
+			epoch = next_boot_count();
+		}
+
+		if (epoch == 0) {
+			const hrt_abstime now = hrt_absolute_time();
+			epoch = (uint16_t)(now ^ (now >> 16) ^ (now >> 32));
+		}
+
+		if (epoch == 0) {
+			epoch = 1;
+		}
+	}
+
+	return epoch;
+}
+
+/* epoch half of a token, moves on whenever the lower half of the generation wraps */
+static uint16_t sync_epoch_word(uint32_t generation)
+{
+	return sync_epoch() + (uint16_t)(generation >> 16);
+}
+
+constexpr const char *MavlinkParametersManager::PACKED_FILE_VIRTUAL;
+constexpr const char *MavlinkParametersManager::PACKED_FILE_TEMP;
+constexpr unsigned MavlinkParametersManager::PARAM_BURST_MAX;
 
 MavlinkParametersManager::MavlinkParametersManager(Mavlink *mavlink) : MavlinkStream(mavlink),
 	_send_all_index(-1),
+	_send_changed_only(false),
+	_send_changed_since(0),
+	_last_burst(0),
 	_rc_param_map_pub(nullptr),
 	_rc_param_map(),
 	_uavcan_parameter_request_pub(nullptr),
@@ -96,6 +183,8 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 					/* a restart should skip the hash check on the ground */
 					_send_all_index = 0;
 				}
+
+				_send_changed_only = false;
 			}
 
 			if (req_list.target_system == mavlink_system.sysid && req_list.target_component < 127 &&
@@ -136,6 +225,20 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 					return;
 				}
 
+				/*
+				 * The ground station has a cached copy up to the given token,
+				 * send only what changed after it. A token from another boot
+				 * or from the future requires a full list.
+				 */
+				if (strncmp(name, GENERATION_PARAM, sizeof(name)) == 0) {
+					uint32_t token;
+					memcpy(&token, &set.param_value, sizeof(token));
+
+					_send_changed_only = generation_from_token(token, _send_changed_since);
+					_send_all_index = 0;
+					return;
+				}
+
 				/* attempt to find parameter, set and send it */
 				param_t param = param_find_no_notification(name);
 
@@ -192,16 +295,12 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 					/* XXX: I left this in so older versions of QGC wouldn't break */
 					if (strncmp(req_read.param_id, HASH_PARAM, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN) == 0) {
 						/* return hash check for cached params */
-						uint32_t hash = param_hash_check();
-
-						/* build the one-off response message */
-						mavlink_param_value_t param_value;
-						param_value.param_count = param_count_used();
-						param_value.param_index = -1;
-						strncpy(param_value.param_id, HASH_PARAM, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
-						param_value.param_type = MAV_PARAM_TYPE_UINT32;
-						memcpy(&param_value.param_value, &hash, sizeof(hash));
-						mavlink_msg_param_value_send_struct(_mavlink->get_channel(), &param_value);
+						send_special(HASH_PARAM, param_hash_check());
+
+					} else if (strncmp(req_read.param_id, GENERATION_PARAM, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN) == 0) {
+						/* return the generation the cached params of the ground station are at */
+						send_special(GENERATION_PARAM, sync_token(param_generation()));
+
 					} else {
 						/* local name buffer to enforce null-terminated string */
 						char name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1];
@@ -331,16 +430,7 @@ MavlinkParametersManager::send(const hrt_abstime t)
 		 */
 		if (_send_all_index == PARAM_HASH) {
 			/* return hash check for cached params */
-			uint32_t hash = param_hash_check();
-
-			/* build the one-off response message */
-			mavlink_param_value_t msg;
-			msg.param_count = param_count_used();
-			msg.param_index = -1;
-			strncpy(msg.param_id, HASH_PARAM, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
-			msg.param_type = MAV_PARAM_TYPE_UINT32;
-			memcpy(&msg.param_value, &hash, sizeof(hash));
-			mavlink_msg_param_value_send_struct(_mavlink->get_channel(), &msg);
+			send_special(HASH_PARAM, param_hash_check());
 
 			/* after this we should start sending all params */
 			_send_all_index = 0;
@@ -349,21 +439,36 @@ MavlinkParametersManager::send(const hrt_abstime t)
 			return;
 		}
 
-		/* look for the first parameter which is used */
-		param_t p;
-		do {
-			/* walk through all parameters, including unused ones */
-			p = param_for_index(_send_all_index);
-			_send_all_index++;
-		} while (p != PARAM_INVALID && !param_used(p));
+		/* the generation the ground station is at after this list */
+		const uint32_t generation = param_generation();
+
+		for (unsigned burst = burst_size(t); burst > 0 && _send_all_index >= 0; burst--) {
+			/* look for the next parameter which is used (and changed, if requested) */
+			param_t p;
+			do {
+				/* walk through all parameters, including unused ones */
+				p = param_for_index(_send_all_index);
+				_send_all_index++;
+			} while (p != PARAM_INVALID && (!param_used(p) ||
+							(_send_changed_only && !param_changed_since(p, _send_changed_since))));
+
+			if (p != PARAM_INVALID) {
+				send_param(p);
+			}
 
-		if (p != PARAM_INVALID) {
-			send_param(p);
-		}
+			if ((p == PARAM_INVALID) || (_send_all_index >= (int) param_count())) {
+				_send_all_index = -1;
 
-		if ((p == PARAM_INVALID) || (_send_all_index >= (int) param_count())) {
-			_send_all_index = -1;
+				/* terminate a delta list, so the ground station knows where it is at */
+				if (_send_changed_only) {
+					send_special(GENERATION_PARAM, sync_token(generation));
+					_send_changed_only = false;
+				}
+			}
 		}
+
+		_last_burst = t;
+
 	} else if (_send_all_index == PARAM_HASH && hrt_absolute_time() > 20 * 1000 * 1000) {
 		/* the boot did not seem to ever complete, warn user and set boot complete */
 		_mavlink->send_statustext_critical("WARNING: SYSTEM BOOT INCOMPLETE. CHECK CONFIG.");
@@ -371,6 +476,145 @@ MavlinkParametersManager::send(const hrt_abstime t)
 	}
 }
 
+unsigned
+MavlinkParametersManager::burst_size(const hrt_abstime t)
+{
+	const unsigned msg_size = get_size();
+
+	/* bytes the link can take since the last burst */
+	const hrt_abstime dt = (_last_burst > 0 && t > _last_burst) ? (t - _last_burst) : get_interval();
+	unsigned budget = ((uint64_t)_mavlink->get_data_rate() * dt) / 1000000 / msg_size;
+
+	/* leave room for the closing special message of a delta list */
+	unsigned space = _mavlink->get_free_tx_buf() / msg_size;
+
+	if (space > 0) {
+		space--;
+	}
+
+	budget = math::min(budget, space);
+	budget = math::min(budget, PARAM_BURST_MAX);
+
+	/* always make progress, the caller checked for space for one message */
+	return math::max(budget, 1u);
+}
+
+void
+MavlinkParametersManager::send_special(const char *name, uint32_t value)
+{
+	/* build the one-off response message */
+	mavlink_param_value_t msg;
+	msg.param_count = param_count_used();
+	msg.param_index = -1;
+	strncpy(msg.param_id, name, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+	msg.param_type = MAV_PARAM_TYPE_UINT32;
+	memcpy(&msg.param_value, &value, sizeof(value));
+	mavlink_msg_param_value_send_struct(_mavlink->get_channel(), &msg);
+}
+
+uint32_t
+MavlinkParametersManager::sync_token(uint32_t generation)
+{
+	return ((uint32_t)sync_epoch_word(generation) << 16) | (generation & 0xffff);
+}
+
+bool
+MavlinkParametersManager::generation_from_token(uint32_t token, uint32_t &generation)
+{
+	const uint32_t current = param_generation();
+
+	if ((token >> 16) != sync_epoch_word(current)) {
+		return false;
+	}
+
+	generation = (current & 0xffff0000) | (token & 0xffff);
+
+	return generation <= current;
+}
+
+int
+MavlinkParametersManager::export_packed(const char *path)
+{
+	int fd = ::open(path, O_CREAT | O_TRUNC | O_WRONLY, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	/* header: magic, version, parameter count, hash and generation */
+	uint8_t header[16];
+	const uint16_t count = param_count_used();
+	const uint32_t hash = param_hash_check();
+	const uint32_t generation = sync_token(param_generation());
+
+	memcpy(&header[0], PACKED_MAGIC, 4);
+	header[4] = PACKED_VERSION;
+	header[5] = 0;
+	memcpy(&header[6], &count, sizeof(count));
+	memcpy(&header[8], &hash, sizeof(hash));
+	memcpy(&header[12], &generation, sizeof(generation));
+
+	bool ok = (::write(fd, header, sizeof(header)) == sizeof(header));
+
+	/* parameters are stored sorted by name, so neighbours share prefixes */
+	char last_name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1] = {};
+
+	for (unsigned i = 0; ok && i < param_count(); i++) {
+		param_t p = param_for_index(i);
+
+		if (p == PARAM_INVALID || !param_used(p)) {
+			continue;
+		}
+
+		param_type_t type = param_type(p);
+
+		if (type != PARAM_TYPE_INT32 && type != PARAM_TYPE_FLOAT) {
+			continue;
+		}
+
+		char name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1];
+		strncpy(name, param_name(p), MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+		name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN] = '\0';
+
+		uint8_t prefix = 0;
+
+		while (name[prefix] != '\0' && name[prefix] == last_name[prefix]) {
+			prefix++;
+		}
+
+		const uint8_t suffix = strlen(name) - prefix;
+
+		/* type, shared prefix length, suffix length, suffix, value */
+		uint8_t record[3 + MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 4];
+		record[0] = (type == PARAM_TYPE_INT32) ? MAVLINK_TYPE_INT32_T : MAVLINK_TYPE_FLOAT;
+		record[1] = prefix;
+		record[2] = suffix;
+		memcpy(&record[3], &name[prefix], suffix);
+
+		if (param_get(p, &record[3 + suffix]) != OK) {
+			errno = EIO;
+			ok = false;
+			break;
+		}
+
+		const ssize_t len = 3 + suffix + 4;
+		ok = (::write(fd, record, len) == len);
+
+		memcpy(last_name, name, sizeof(last_name));
+	}
+
+	::close(fd);
+
+	if (!ok) {
+		int err = errno;
+		unlink(path);
+		errno = err;
+		return -1;
+	}
+
+	return 0;
+}
+
 int
 MavlinkParametersManager::send_param(param_t param)
 {
@@ -41,6 +41,7 @@
 
 #pragma once
 
+#include <px4_defines.h>
 #include <systemlib/param/param.h>
 
 #include "mavlink_bridge_header.h"
@@ -77,9 +78,50 @@ public:
 
 	void handle_message(const mavlink_message_t *msg);
 
+	/**
+	 * Write all used parameters into a compact file for transfer via FTP.
+	 *
+	 * The file starts with a header (magic, version, count, hash, generation),
+	 * followed by one record per parameter: MAVLink type, length of the name
+	 * prefix shared with the previous record, suffix length, name suffix and
+	 * 4 byte value. Parameters are sorted by name, so the prefix coding
+	 * roughly halves the size compared to plain names.
+	 *
+	 * @param path file to write
+	 * @return 0 on success, -1 on error (errno is set)
+	 */
+	static int export_packed(const char *path);
+
+	/** virtual FTP path under which export_packed() output is served */
+	static constexpr const char *PACKED_FILE_VIRTUAL = "@PARAM/param.pck";
+
+	/** file the packed parameters are written to before being served */
+	static constexpr const char *PACKED_FILE_TEMP = PX4_ROOTFSDIR"/fs/microsd/.param.pck";
+
 private:
 	int		_send_all_index;
 
+	/* only send parameters changed since this generation if _send_changed_only is set */
+	bool		_send_changed_only;
+	uint32_t	_send_changed_since;
+	hrt_abstime	_last_burst;
+
+	/* maximum number of parameters sent in a single cycle */
+	static constexpr unsigned PARAM_BURST_MAX = 8;
+
+	/**
+	 * Token the ground station caches for a later delta list. The upper half
+	 * is a boot epoch, so a token from before a reboot never looks up to date.
+	 */
+	static uint32_t sync_token(uint32_t generation);
+
+	/**
+	 * Generation a token of this boot refers to
+	 *
+	 * @return false if the token is from another boot or from the future
+	 */
+	static bool generation_from_token(uint32_t token, uint32_t &generation);
+
 	/* do not allow top copying this class */
 	MavlinkParametersManager(MavlinkParametersManager &);
 	MavlinkParametersManager& operator = (const MavlinkParametersManager &);
@@ -92,6 +134,16 @@ protected:
 
 	int send_param(param_t param);
 
+	/**
+	 * Send a special PARAM_VALUE (index -1) carrying a 32 bit value
+	 */
+	void send_special(const char *name, uint32_t value);
+
+	/**
+	 * Number of parameters which fit into the link budget of this cycle
+	 */
+	unsigned burst_size(const hrt_abstime t);
+
 	orb_advert_t _rc_param_map_pub;
 	struct rc_parameter_map_s _rc_param_map;
 
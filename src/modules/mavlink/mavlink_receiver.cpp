@@ -142,13 +142,20 @@ MavlinkReceiver::MavlinkReceiver(Mavlink *parent) :
 	_time_offset(0),
 	_orb_class_instance(-1),
 	_mom_switch_pos{},
-	_mom_switch_state(0)
+	_mom_switch_state(0),
+	_rx_timestamp(0),
+	_latency_counters{},
+	_offboard_latency_perf(perf_alloc(PC_ELAPSED, "mavlink: offboard sp latency"))
 {
 }
 
+constexpr int MavlinkReceiver::IDLE_POLL_TIMEOUT_MS;
+constexpr uint16_t MavlinkReceiver::_latency_buckets[];
+
 MavlinkReceiver::~MavlinkReceiver()
 {
 	orb_unsubscribe(_control_mode_sub);
+	perf_free(_offboard_latency_perf);
 }
 
 void
@@ -784,6 +791,8 @@ MavlinkReceiver::handle_message_set_position_target_local_ned(mavlink_message_t
 						orb_publish(ORB_ID(vehicle_force_setpoint), _force_sp_pub, &force_sp);
 					}
 
+					record_offboard_latency();
+
 				} else {
 					/* It's not a pure force setpoint: publish to setpoint triplet  topic */
 					struct position_setpoint_triplet_s pos_sp_triplet = {};
@@ -872,6 +881,8 @@ MavlinkReceiver::handle_message_set_position_target_local_ned(mavlink_message_t
 							    &pos_sp_triplet);
 					}
 
+					record_offboard_latency();
+
 				}
 
 			}
@@ -947,6 +958,8 @@ MavlinkReceiver::handle_message_set_actuator_control_target(mavlink_message_t *m
 			} else {
 				orb_publish(ORB_ID(actuator_controls_0), _actuator_controls_pub, &actuator_controls);
 			}
+
+			record_offboard_latency();
 		}
 	}
 
@@ -1094,6 +1107,8 @@ MavlinkReceiver::handle_message_set_attitude_target(mavlink_message_t *msg)
 					} else {
 						orb_publish(ORB_ID(vehicle_attitude_setpoint), _att_sp_pub, &_att_sp);
 					}
+
+					record_offboard_latency();
 				}
 
 				/* Publish attitude rate setpoint if bodyrate and thrust ignore bits are not set */
@@ -1117,6 +1132,8 @@ MavlinkReceiver::handle_message_set_attitude_target(mavlink_message_t *msg)
 					} else {
 						orb_publish(ORB_ID(vehicle_rates_setpoint), _rates_sp_pub, &_rates_sp);
 					}
+
+					record_offboard_latency();
 				}
 			}
 
@@ -2077,7 +2094,6 @@ MavlinkReceiver::receive_thread(void *arg)
 	sprintf(thread_name, "mavlink_rcv_if%d", _mavlink->get_instance_id());
 	px4_prctl(PR_SET_NAME, thread_name, getpid());
 
-	const int timeout = 500;
 #ifdef __PX4_POSIX
 	/* 1500 is the Wifi MTU, so we make sure to fit a full packet */
 	uint8_t buf[1600 * 5];
@@ -2116,20 +2132,19 @@ MavlinkReceiver::receive_thread(void *arg)
 	ssize_t nread = 0;
 
 	while (!_mavlink->_task_should_exit) {
-		if (poll(&fds[0], 1, timeout) > 0) {
-			if (_mavlink->get_protocol() == SERIAL) {
+		const int timeout = poll_timeout();
+		const int ret = poll(&fds[0], 1, timeout);
 
-				/*
-				 * to avoid reading very small chunks wait for data before reading
-				 * this is designed to target one message, so >20 bytes at a time
-				 */
-				const unsigned character_count = 20;
+		if (ret == 0 && timeout < IDLE_POLL_TIMEOUT_MS) {
+			/* the rest of a started frame did not arrive in time, do not let it swallow the next one */
+			mavlink_get_channel_status(_mavlink->get_channel())->parse_state = MAVLINK_PARSE_STATE_IDLE;
+			continue;
+		}
 
-				/* non-blocking read. read may return negative values */
-				if ((nread = ::read(uart_fd, buf, sizeof(buf))) < (ssize_t)character_count) {
-					unsigned sleeptime = (1.0f / (_mavlink->get_baudrate() / 10)) * character_count * 1000000;
-					usleep(sleeptime);
-				}
+		if (ret > 0) {
+			if (_mavlink->get_protocol() == SERIAL) {
+				/* non-blocking read, read as soon as data arrives. read may return negative values */
+				nread = ::read(uart_fd, buf, sizeof(buf));
 			}
 
 #ifdef __PX4_POSIX
@@ -2164,6 +2179,9 @@ MavlinkReceiver::receive_thread(void *arg)
 			}
 
 #endif
+			/* all messages completed by this read share its receive time */
+			_rx_timestamp = hrt_absolute_time();
+
 			// only start accepting messages once we're sure who we talk to
 
 			if (_mavlink->get_client_source_initialized()) {
@@ -2187,15 +2205,97 @@ MavlinkReceiver::receive_thread(void *arg)
 					_mavlink->count_rxbytes(nread);
 				}
 			}
+
+			if (_mavlink->get_protocol() == SERIAL) {
+				/* latch the rest of a partially received frame with a single read */
+				unsigned sleeptime = frame_remaining_time();
+
+				if (sleeptime > 0) {
+					usleep(sleeptime);
+				}
+			}
 		}
 	}
 
 	return nullptr;
 }
 
+int
+MavlinkReceiver::poll_timeout()
+{
+	if (_mavlink->get_protocol() != SERIAL) {
+		return IDLE_POLL_TIMEOUT_MS;
+	}
+
+	const unsigned remaining = frame_remaining_time();
+
+	if (remaining == 0) {
+		/* between frames poll wakes us on the next byte, the timeout only bounds the exit check */
+		return IDLE_POLL_TIMEOUT_MS;
+	}
+
+	/* mid-frame, allow twice the wire time of the missing bytes before giving up on the frame */
+	return math::min(math::max((int)(2 * remaining / 1000), 1), IDLE_POLL_TIMEOUT_MS - 1);
+}
+
+unsigned
+MavlinkReceiver::frame_remaining_time()
+{
+	const mavlink_status_t *chan_status = mavlink_get_channel_status(_mavlink->get_channel());
+
+	/* parser is between frames, poll will wake us on the next byte */
+	if (chan_status->parse_state == MAVLINK_PARSE_STATE_IDLE ||
+	    chan_status->parse_state == MAVLINK_PARSE_STATE_UNINIT) {
+		return 0;
+	}
+
+	const mavlink_message_t *rxmsg = mavlink_get_channel_buffer(_mavlink->get_channel());
+
+	/* payload length is unknown before the header is in, wait for a minimal frame then */
+	unsigned remaining = MAVLINK_NUM_NON_PAYLOAD_BYTES;
+
+	if (chan_status->parse_state >= MAVLINK_PARSE_STATE_GOT_LENGTH) {
+		remaining += rxmsg->len;
+		remaining -= math::min((unsigned)chan_status->packet_idx, remaining);
+	}
+
+	/* time the remaining bytes need on the wire, 10 bits per byte */
+	return (1.0f / (_mavlink->get_baudrate() / 10)) * remaining * 1000000;
+}
+
+void
+MavlinkReceiver::record_offboard_latency()
+{
+	if (_rx_timestamp == 0) {
+		return;
+	}
+
+	const hrt_abstime latency = hrt_elapsed_time(&_rx_timestamp);
+
+	perf_set_elapsed(_offboard_latency_perf, latency);
+
+	unsigned index;
+
+	for (index = 0; index < LATENCY_BUCKET_COUNT; index++) {
+		if (latency <= _latency_buckets[index]) {
+			break;
+		}
+	}
+
+	/* the last counter takes everything above the last bucket */
+	_latency_counters[index]++;
+}
+
 void MavlinkReceiver::print_status()
 {
+	printf("\toffboard setpoint latency (receive to publish):\n");
+
+	for (unsigned i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+		printf("\t  %5u us : %u\n", _latency_buckets[i], (unsigned)_latency_counters[i]);
+	}
 
+	printf("\t >%5u us : %u\n", _latency_buckets[LATENCY_BUCKET_COUNT - 1],
+	       (unsigned)_latency_counters[LATENCY_BUCKET_COUNT]);
 }
 
 uint64_t MavlinkReceiver::sync_stamp(uint64_t usec)
@@ -2226,8 +2326,12 @@ void *MavlinkReceiver::start_helper(void *context)
 
 	MavlinkReceiver *rcv = new MavlinkReceiver((Mavlink *)context);
 
+	((Mavlink *)context)->set_receiver(rcv);
+
 	void *ret = rcv->receive_thread(nullptr);
 
+	((Mavlink *)context)->set_receiver(nullptr);
+
 	delete rcv;
 
 	return ret;
@@ -41,6 +41,7 @@
 
 #pragma once
 
+#include <drivers/drv_hrt.h>
 #include <systemlib/perf_counter.h>
 #include <uORB/uORB.h>
 #include <uORB/topics/sensor_combined.h>
@@ -147,6 +148,25 @@ private:
 
 	void *receive_thread(void *arg);
 
+	/**
+	 * Time to wait for the rest of a partially received frame on a serial link
+	 *
+	 * @return wait time in microseconds, 0 if the parser is between frames
+	 */
+	unsigned frame_remaining_time();
+
+	/**
+	 * Poll timeout for the next wait, short while a frame is partially received
+	 *
+	 * @return timeout in milliseconds
+	 */
+	int poll_timeout();
+
+	/**
+	 * Record the latency from receiving an offboard setpoint to publishing it
+	 */
+	void record_offboard_latency();
+
 	/**
 	 * Set the interval at which the given message stream is published.
 	 * The rate is the number of messages per second.
@@ -241,6 +261,17 @@ private:
 	uint8_t _mom_switch_pos[MOM_SWITCH_COUNT];
 	uint16_t _mom_switch_state;
 
+	static constexpr int IDLE_POLL_TIMEOUT_MS = 500;
+
+	static constexpr unsigned LATENCY_BUCKET_COUNT = 8;
+
+	/** upper bounds of the offboard latency histogram buckets in microseconds */
+	static constexpr uint16_t _latency_buckets[LATENCY_BUCKET_COUNT] = { 100, 200, 500, 1000, 2000, 5000, 10000, 20000 };
+
+	hrt_abstime _rx_timestamp;		///< time the bytes of the current frame were read
+	uint32_t _latency_counters[LATENCY_BUCKET_COUNT + 1];
+	perf_counter_t _offboard_latency_perf;
+
 	/* do not allow copying this class */
 	MavlinkReceiver(const MavlinkReceiver &);
 	MavlinkReceiver operator=(const MavlinkReceiver &);
@@ -83,6 +83,7 @@
 #include <systemlib/param/param.h>
 #include <systemlib/err.h>
 #include <systemlib/perf_counter.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/systemlib.h>
 #include <systemlib/circuit_breaker.h>
 #include <lib/mathlib/mathlib.h>
@@ -426,7 +427,7 @@ MulticopterAttitudeControl::~MulticopterAttitudeControl()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -841,7 +842,7 @@ MulticopterAttitudeControl::task_main()
 		if (pret < 0) {
 			warn("mc att ctrl: poll error %d, %d", pret, errno);
 			/* sleep a bit before next try */
-			usleep(100000);
+			px4_usleep(100000);
 			continue;
 		}
 
@@ -960,7 +961,9 @@ MulticopterAttitudeControl::task_main()
 				_actuators.control[2] = (PX4_ISFINITE(_att_control(2))) ? _att_control(2) : 0.0f;
 				_actuators.control[3] = (PX4_ISFINITE(_thrust_sp)) ? _thrust_sp : 0.0f;
 				_actuators.timestamp = hrt_absolute_time();
-				_actuators.timestamp_sample = _ctrl_state.timestamp;
+				/* pass the IMU sample time through if the estimator provides it */
+				_actuators.timestamp_sample = (_ctrl_state.timestamp_sample != 0) ?
+							      _ctrl_state.timestamp_sample : _ctrl_state.timestamp;
 
 				_controller_status.roll_rate_integ = _rates_int(0);
 				_controller_status.pitch_rate_integ = _rates_int(1);
@@ -972,6 +975,7 @@ MulticopterAttitudeControl::task_main()
 
 						orb_publish(_actuators_id, _actuators_0_pub, &_actuators);
 						perf_end(_controller_latency_perf);
+						latency_trace_stamp(LATENCY_TRACE_ATT_CONTROL, _actuators.timestamp_sample);
 
 					} else if (_actuators_id) {
 						_actuators_0_pub = orb_advertise(_actuators_id, &_actuators);
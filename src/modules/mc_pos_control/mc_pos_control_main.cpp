@@ -494,7 +494,7 @@ MulticopterPositionControl::~MulticopterPositionControl()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -0,0 +1,109 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBShmChannel.hpp"
+
+#include <px4_log.h>
+#include <uORB/uORB.h>
+#include <uORB/uORBTopics.h>
+
+uORB::ShmChannel *uORB::ShmChannel::_InstancePtr = nullptr;
+
+int uORB::ShmChannel::add_topic(const char *topic_name, uint8_t instance)
+{
+	if (_topic_count >= MAX_TOPICS) {
+		return -ENOSPC;
+	}
+
+	if (instance >= ORB_MULTI_MAX_INSTANCES) {
+		return -EINVAL;
+	}
+
+	const orb_metadata *const *topics = orb_get_topics();
+	const orb_metadata *meta = nullptr;
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if (strcmp(topic_name, topics[i]->o_name) == 0) {
+			meta = topics[i];
+			break;
+		}
+	}
+
+	if (meta == nullptr) {
+		return -ENOENT;
+	}
+
+	Topic &topic = _topics[_topic_count];
+	int ret = topic.ring.create(meta->o_name, instance, meta->o_size, SLOT_COUNT);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	topic.name = meta->o_name;
+	topic.instance = instance;
+	pthread_mutex_init(&topic.lock, nullptr);
+	_topic_count++;
+
+	return 0;
+}
+
+int16_t uORB::ShmChannel::send_multi_message(const char *messageName, uint8_t instance, int32_t length, uint8_t *data)
+{
+	// called for every publication, keep the miss path cheap
+	for (int i = 0; i < _topic_count; i++) {
+		Topic &topic = _topics[i];
+
+		if (topic.instance == instance &&
+		    (topic.name == messageName || strcmp(topic.name, messageName) == 0)) {
+			if ((uint32_t)length != topic.ring.header()->msg_size) {
+				return -1;
+			}
+
+			pthread_mutex_lock(&topic.lock);
+			topic.ring.write(data);
+			pthread_mutex_unlock(&topic.lock);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+void uORB::ShmChannel::status()
+{
+	for (int i = 0; i < _topic_count; i++) {
+		PX4_INFO("%-32s %u %8llu messages", _topics[i].name, _topics[i].instance,
+			 (unsigned long long)_topics[i].ring.written());
+	}
+}
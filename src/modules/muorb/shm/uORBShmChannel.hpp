@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <pthread.h>
+#include "uORB/uORBCommunicator.hpp"
+#include "uORBShmRing.hpp"
+
+namespace uORB
+{
+class ShmChannel;
+}
+
+/**
+ * uORB communicator channel exporting selected topics into shared memory
+ * ring buffers, see uORBShmRing.hpp. Topics only flow out of PX4.
+ */
+class uORB::ShmChannel : public uORBCommunicator::IChannel
+{
+public:
+	static constexpr int MAX_TOPICS = 16;
+	static constexpr uint32_t SLOT_COUNT = 64;
+
+	static uORB::ShmChannel *GetInstance()
+	{
+		if (_InstancePtr == nullptr) {
+			_InstancePtr = new uORB::ShmChannel();
+		}
+
+		return _InstancePtr;
+	}
+
+	static bool isInstance()
+	{
+		return (_InstancePtr != nullptr);
+	}
+
+	/**
+	 * Export an instance of a topic. Must be called before the channel is
+	 * registered with the uORB manager.
+	 * @return 0 on success, -errno otherwise
+	 */
+	int add_topic(const char *topic_name, uint8_t instance);
+
+	void status();
+
+	/* uORBCommunicator::IChannel, subscriptions are not forwarded */
+	virtual int16_t add_subscription(const char *messageName, int32_t msgRateInHz) { return 0; }
+	virtual int16_t remove_subscription(const char *messageName) { return 0; }
+	virtual int16_t register_handler(uORBCommunicator::IChannelRxHandler *handler) { return 0; }
+
+	virtual int16_t send_message(const char *messageName, int32_t length, uint8_t *data)
+	{
+		return send_multi_message(messageName, 0, length, data);
+	}
+
+	virtual int16_t send_multi_message(const char *messageName, uint8_t instance, int32_t length, uint8_t *data);
+
+private:
+	ShmChannel() = default;
+	~ShmChannel() = default;
+
+	static uORB::ShmChannel *_InstancePtr;
+
+	struct Topic {
+		const char *name;	///< orb metadata name, compared by pointer first
+		uint8_t instance;
+		ShmRingWriter ring;
+		pthread_mutex_t lock;	///< serializes publishers sharing the instance
+	};
+
+	Topic _topics[MAX_TOPICS];
+	int _topic_count{0};
+};
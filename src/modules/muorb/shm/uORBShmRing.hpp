@@ -0,0 +1,377 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBShmRing.hpp
+ *
+ * Shared memory ring buffers carrying uORB topics to other processes.
+ *
+ * Each exported topic instance is a POSIX shared memory object
+ * /px4_uorb_<topic><instance> (visible in /dev/shm on Linux) holding a
+ * header and a power of two number of slots. There is one writer, the
+ * uorb_shm module, and any number of readers. Slots are protected by a sequence counter, so neither side ever
+ * blocks: a reader that is lapped by the writer notices and skips ahead.
+ *
+ * This header has no PX4 dependencies and is the client library for
+ * companion software: open a ShmRingReader on a topic name and instance and
+ * copy the messages out with next() or latest().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uORB
+{
+
+static constexpr uint32_t SHM_RING_MAGIC = 0x50585242; // "PXRB"
+static constexpr uint32_t SHM_RING_VERSION = 1;
+
+struct ShmRingHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t msg_size;		///< size of one message
+	uint32_t slot_size;		///< msg_size plus the sequence counter, cache line aligned
+	uint32_t slot_count;		///< power of two
+	uint32_t instance;		///< multi-instance index of the topic
+	char name[64];			///< topic name
+	alignas(64) std::atomic<uint64_t> write_index;	///< number of messages written
+};
+
+struct ShmRingSlot {
+	/* 2 * index + 1 while the message index is written, 2 * index + 2 once complete */
+	std::atomic<uint64_t> seq;
+	uint8_t data[0];
+};
+
+/**
+ * Shared memory object name of a topic instance, named like the uORB nodes.
+ */
+static inline std::string shm_ring_path(const char *topic, uint8_t instance)
+{
+	return std::string("/px4_uorb_") + topic + std::to_string(instance);
+}
+
+/**
+ * Mapping of a ring, common to the writer and the readers.
+ */
+class ShmRing
+{
+public:
+	ShmRing() = default;
+	ShmRing(const ShmRing &) = delete;
+	ShmRing &operator=(const ShmRing &) = delete;
+
+	~ShmRing() { unmap(); }
+
+	bool valid() const { return _header != nullptr; }
+
+	const ShmRingHeader *header() const { return _header; }
+
+protected:
+	ShmRingSlot *slot(uint64_t index) const
+	{
+		uint8_t *base = reinterpret_cast<uint8_t *>(_header) + sizeof(ShmRingHeader);
+		return reinterpret_cast<ShmRingSlot *>(base + (index & (_header->slot_count - 1)) * _header->slot_size);
+	}
+
+	bool map(int fd, size_t size, int prot)
+	{
+		void *p = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+
+		if (p == MAP_FAILED) {
+			return false;
+		}
+
+		_header = static_cast<ShmRingHeader *>(p);
+		_size = size;
+		return true;
+	}
+
+	void unmap()
+	{
+		if (_header != nullptr) {
+			munmap(_header, _size);
+			_header = nullptr;
+		}
+	}
+
+	ShmRingHeader *_header{nullptr};
+	size_t _size{0};
+};
+
+/**
+ * Writer side, used by the uorb_shm module. Not thread-safe: callers
+ * publishing from several threads must serialize write().
+ */
+class ShmRingWriter : public ShmRing
+{
+public:
+	~ShmRingWriter() { close(); }
+
+	/**
+	 * Create (or recreate) the ring of a topic instance.
+	 *
+	 * An existing object is unlinked rather than truncated: readers still
+	 * mapping it keep the old ring instead of seeing the write index go
+	 * back to 0, and attach to the new one when they reopen.
+	 * @return 0 on success, -errno otherwise
+	 */
+	int create(const char *topic, uint8_t instance, uint32_t msg_size, uint32_t slot_count)
+	{
+		if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0) {
+			return -EINVAL;
+		}
+
+		// a ring this writer already has is closed, which marks it stale for its readers
+		close();
+
+		_path = shm_ring_path(topic, instance);
+		shm_unlink(_path.c_str());
+		int fd = shm_open(_path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+		if (fd < 0) {
+			return -errno;
+		}
+
+		uint32_t slot_size = (sizeof(ShmRingSlot) + msg_size + 63) & ~63u;
+		size_t size = sizeof(ShmRingHeader) + (size_t)slot_size * slot_count;
+
+		if (ftruncate(fd, size) != 0 || !map(fd, size, PROT_READ | PROT_WRITE)) {
+			int err = errno;
+			::close(fd);
+			shm_unlink(_path.c_str());
+			return -err;
+		}
+
+		::close(fd);
+
+		// the mapping is zero filled, so all slots read as never written
+		_header->version = SHM_RING_VERSION;
+		_header->msg_size = msg_size;
+		_header->slot_size = slot_size;
+		_header->slot_count = slot_count;
+		_header->instance = instance;
+		strncpy(_header->name, topic, sizeof(_header->name) - 1);
+		_header->write_index.store(0, std::memory_order_relaxed);
+
+		// readers check the magic last
+		std::atomic_thread_fence(std::memory_order_release);
+		_header->magic = SHM_RING_MAGIC;
+
+		return 0;
+	}
+
+	void close()
+	{
+		if (valid()) {
+			_header->magic = 0;
+			unmap();
+			shm_unlink(_path.c_str());
+		}
+	}
+
+	void write(const void *data)
+	{
+		uint64_t index = _header->write_index.load(std::memory_order_relaxed);
+		ShmRingSlot *s = slot(index);
+
+		s->seq.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		memcpy(s->data, data, _header->msg_size);
+
+		s->seq.store(2 * index + 2, std::memory_order_release);
+		_header->write_index.store(index + 1, std::memory_order_release);
+	}
+
+	uint64_t written() const { return _header->write_index.load(std::memory_order_relaxed); }
+
+private:
+	std::string _path;
+};
+
+/**
+ * Reader side, for companion software. The ring is mapped read-only.
+ */
+class ShmRingReader : public ShmRing
+{
+public:
+	/**
+	 * Attach to the ring of a topic instance. The reader starts at the newest message.
+	 * @return 0 on success, -errno otherwise (-ENOENT if the topic is not exported)
+	 */
+	int open(const char *topic, uint8_t instance = 0)
+	{
+		int fd = shm_open(shm_ring_path(topic, instance).c_str(), O_RDONLY, 0);
+
+		if (fd < 0) {
+			return -errno;
+		}
+
+		struct stat st;
+
+		if (fstat(fd, &st) != 0) {
+			int err = errno;
+			::close(fd);
+			return -err;
+		}
+
+		if ((size_t)st.st_size < sizeof(ShmRingHeader)) {
+			::close(fd);
+			return -EPROTO;
+		}
+
+		if (!map(fd, st.st_size, PROT_READ)) {
+			int err = errno;
+			::close(fd);
+			return -err;
+		}
+
+		::close(fd);
+
+		if (_header->magic != SHM_RING_MAGIC || _header->version != SHM_RING_VERSION) {
+			unmap();
+			return -EPROTO;
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// the slots must fit into the object, a corrupt header must not make us read past it
+		const uint64_t slots_size = (uint64_t)_header->slot_size * _header->slot_count;
+
+		if (_header->slot_count == 0 || (_header->slot_count & (_header->slot_count - 1)) != 0 ||
+		    _header->slot_size < sizeof(ShmRingSlot) + _header->msg_size ||
+		    (uint64_t)st.st_size < sizeof(ShmRingHeader) + slots_size) {
+			unmap();
+			return -EPROTO;
+		}
+
+		uint64_t written = _header->write_index.load(std::memory_order_acquire);
+		_next = (written > 0) ? written - 1 : 0;
+		return 0;
+	}
+
+	/** size of the messages of the topic */
+	uint32_t msg_size() const { return _header->msg_size; }
+
+	/**
+	 * True once the writer has closed the ring, e.g. because the topic was
+	 * recreated. Reopen to attach to the new ring.
+	 */
+	bool stale() const { return _header->magic != SHM_RING_MAGIC; }
+
+	/** number of messages skipped because the writer lapped this reader */
+	uint64_t lost() const { return _lost; }
+
+	/**
+	 * Copy the next message in publication order into data (msg_size() bytes).
+	 * @return true if a message was copied, false if there is no new message
+	 */
+	bool next(void *data)
+	{
+		for (;;) {
+			uint64_t written = _header->write_index.load(std::memory_order_acquire);
+
+			if (_next >= written) {
+				return false;
+			}
+
+			if (written - _next > _header->slot_count) {
+				// lapped, skip to the oldest message still in the ring
+				_lost += written - _header->slot_count - _next;
+				_next = written - _header->slot_count;
+			}
+
+			if (copy(_next, data)) {
+				_next++;
+				return true;
+			}
+
+			// overwritten while copying, try the following one
+			_lost++;
+			_next++;
+		}
+	}
+
+	/**
+	 * Copy the newest message into data, skipping any older ones.
+	 * @return true if a message was copied, false if there is no new message
+	 */
+	bool latest(void *data)
+	{
+		for (;;) {
+			uint64_t written = _header->write_index.load(std::memory_order_acquire);
+
+			if (_next >= written) {
+				return false;
+			}
+
+			_next = written - 1;
+
+			if (copy(_next, data)) {
+				_next++;
+				return true;
+			}
+		}
+	}
+
+private:
+	bool copy(uint64_t index, void *data) const
+	{
+		const ShmRingSlot *s = slot(index);
+
+		if (s->seq.load(std::memory_order_acquire) != 2 * index + 2) {
+			return false;
+		}
+
+		memcpy(data, s->data, _header->msg_size);
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		return s->seq.load(std::memory_order_relaxed) == 2 * index + 2;
+	}
+
+	uint64_t _next{0};
+	uint64_t _lost{0};
+};
+
+} // namespace uORB
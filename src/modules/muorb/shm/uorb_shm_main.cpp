@@ -0,0 +1,321 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uorb_shm_main.cpp
+ *
+ * Export uORB topics to other processes through shared memory, and compare
+ * the shared memory path against MAVLink over UDP loopback.
+ */
+
+#include <px4_config.h>
+#include <px4_log.h>
+#include <px4_posix.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <atomic>
+
+#include <drivers/drv_hrt.h>
+#include <systemlib/perf_counter.h>
+#include <v1.0/mavlink_types.h>
+#include <v1.0/common/mavlink.h>
+
+#include "modules/uORB/uORBManager.hpp"
+#include "uORBShmChannel.hpp"
+
+extern "C" { __EXPORT int uorb_shm_main(int argc, char *argv[]); }
+
+namespace
+{
+
+/* roughly the size of an attitude message */
+struct bench_msg_s {
+	uint64_t timestamp;
+	float data[10];
+};
+
+struct bench_context {
+	std::atomic<bool> done{false};
+	unsigned received{0};
+	perf_counter_t latency;
+	uORB::ShmRingReader reader;
+	int sock{-1};
+};
+
+void *shm_reader(void *arg)
+{
+	bench_context *ctx = static_cast<bench_context *>(arg);
+	bench_msg_s msg;
+
+	while (!ctx->done.load()) {
+		if (ctx->reader.next(&msg)) {
+			perf_set_elapsed(ctx->latency, hrt_absolute_time() - msg.timestamp);
+			ctx->received++;
+
+		} else {
+			sched_yield();
+		}
+	}
+
+	return nullptr;
+}
+
+void *mavlink_reader(void *arg)
+{
+	bench_context *ctx = static_cast<bench_context *>(arg);
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	mavlink_message_t msg;
+	mavlink_status_t status = {};
+
+	while (!ctx->done.load()) {
+		ssize_t len = recv(ctx->sock, buf, sizeof(buf), MSG_DONTWAIT);
+
+		if (len <= 0) {
+			sched_yield();
+			continue;
+		}
+
+		for (ssize_t i = 0; i < len; i++) {
+			if (mavlink_parse_char(MAVLINK_COMM_2, buf[i], &msg, &status)) {
+				perf_set_elapsed(ctx->latency, hrt_absolute_time() - mavlink_msg_highres_imu_get_time_usec(&msg));
+				ctx->received++;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void bench_report(const char *path, bench_context &ctx, perf_counter_t send, unsigned count, hrt_abstime elapsed)
+{
+	PX4_INFO("%s: %u of %u received, %.0f msg/s", path, ctx.received, count,
+		 (double)ctx.received * 1e6 / (double)elapsed);
+	perf_print_counter(send);
+	perf_print_counter(ctx.latency);
+}
+
+/**
+ * Send count messages at rate_hz (0: as fast as possible) through a
+ * shared memory ring and through MAVLink over UDP loopback, each read by
+ * a separate thread, and print the send cost, end to end latency and
+ * throughput of both paths.
+ */
+int bench(unsigned count, unsigned rate_hz)
+{
+	const unsigned interval = (rate_hz > 0) ? 1000000 / rate_hz : 0;
+	bench_msg_s msg = {};
+	pthread_t thread;
+
+	/* shared memory */
+	{
+		uORB::ShmRingWriter writer;
+		bench_context ctx;
+		perf_counter_t send = perf_alloc(PC_HISTOGRAM, "uorb_shm: shm write");
+		ctx.latency = perf_alloc(PC_HISTOGRAM, "uorb_shm: shm latency");
+
+		int ret = writer.create("uorb_shm_bench", 0, sizeof(msg), uORB::ShmChannel::SLOT_COUNT);
+
+		if (ret != 0 || ctx.reader.open("uorb_shm_bench") != 0) {
+			PX4_ERR("shm ring setup failed (%d)", ret);
+			perf_free(send);
+			perf_free(ctx.latency);
+			return 1;
+		}
+
+		pthread_create(&thread, nullptr, shm_reader, &ctx);
+
+		hrt_abstime start = hrt_absolute_time();
+
+		for (unsigned i = 0; i < count; i++) {
+			perf_begin(send);
+			msg.timestamp = hrt_absolute_time();
+			writer.write(&msg);
+			perf_end(send);
+
+			if (interval > 0) {
+				usleep(interval);
+			}
+		}
+
+		usleep(100000);
+		ctx.done.store(true);
+		pthread_join(thread, nullptr);
+
+		bench_report("shm", ctx, send, count, hrt_absolute_time() - start);
+		perf_free(send);
+		perf_free(ctx.latency);
+	}
+
+	/* MAVLink over UDP loopback */
+	{
+		bench_context ctx;
+		perf_counter_t send = perf_alloc(PC_HISTOGRAM, "uorb_shm: mavlink send");
+		ctx.latency = perf_alloc(PC_HISTOGRAM, "uorb_shm: mavlink latency");
+
+		struct sockaddr_in addr = {};
+		socklen_t addr_len = sizeof(addr);
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+
+		ctx.sock = socket(AF_INET, SOCK_DGRAM, 0);
+		int send_sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+		if (ctx.sock < 0 || send_sock < 0 ||
+		    bind(ctx.sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+		    getsockname(ctx.sock, (struct sockaddr *)&addr, &addr_len) != 0) {
+			PX4_ERR("udp setup failed: %s", strerror(errno));
+			close(ctx.sock);
+			close(send_sock);
+			perf_free(send);
+			perf_free(ctx.latency);
+			return 1;
+		}
+
+		pthread_create(&thread, nullptr, mavlink_reader, &ctx);
+
+		hrt_abstime start = hrt_absolute_time();
+
+		for (unsigned i = 0; i < count; i++) {
+			perf_begin(send);
+			mavlink_message_t mav_msg;
+			uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+			mavlink_msg_highres_imu_pack(1, 1, &mav_msg, hrt_absolute_time(),
+						     msg.data[0], msg.data[1], msg.data[2], msg.data[3], msg.data[4],
+						     msg.data[5], msg.data[6], msg.data[7], msg.data[8],
+						     msg.data[9], 0.f, 0.f, 0.f, 0);
+			uint16_t len = mavlink_msg_to_send_buffer(buf, &mav_msg);
+			sendto(send_sock, buf, len, 0, (struct sockaddr *)&addr, sizeof(addr));
+			perf_end(send);
+
+			if (interval > 0) {
+				usleep(interval);
+			}
+		}
+
+		usleep(100000);
+		ctx.done.store(true);
+		pthread_join(thread, nullptr);
+
+		bench_report("mavlink", ctx, send, count, hrt_absolute_time() - start);
+		close(ctx.sock);
+		close(send_sock);
+		perf_free(send);
+		perf_free(ctx.latency);
+	}
+
+	return 0;
+}
+
+void usage()
+{
+	PX4_INFO("Usage: uorb_shm {start <topic>[:<instance>] [...] | status | bench [count] [rate_hz]}");
+}
+
+} // namespace
+
+int uorb_shm_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		if (uORB::ShmChannel::isInstance()) {
+			PX4_WARN("already running");
+			return 1;
+		}
+
+		if (uORB::Manager::get_instance()->get_uorb_communicator() != nullptr) {
+			PX4_ERR("another uORB communicator is active");
+			return 1;
+		}
+
+		if (argc < 3) {
+			usage();
+			return 1;
+		}
+
+		uORB::ShmChannel *channel = uORB::ShmChannel::GetInstance();
+
+		for (int i = 2; i < argc; i++) {
+			// <topic>[:<instance>], instance 0 by default
+			char topic_name[64];
+			strncpy(topic_name, argv[i], sizeof(topic_name) - 1);
+			topic_name[sizeof(topic_name) - 1] = '\0';
+
+			unsigned instance = 0;
+			char *separator = strchr(topic_name, ':');
+
+			if (separator != nullptr) {
+				*separator = '\0';
+				instance = strtoul(separator + 1, nullptr, 10);
+			}
+
+			int ret = (instance < ORB_MULTI_MAX_INSTANCES) ? channel->add_topic(topic_name, instance) : -EINVAL;
+
+			if (ret != 0) {
+				PX4_WARN("cannot export %s (%d)", argv[i], ret);
+			}
+		}
+
+		uORB::Manager::get_instance()->set_uorb_communicator(channel);
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		if (uORB::ShmChannel::isInstance()) {
+			uORB::ShmChannel::GetInstance()->status();
+
+		} else {
+			PX4_INFO("not running");
+		}
+
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "bench")) {
+		unsigned count = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 10000;
+		unsigned rate_hz = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 1000;
+		return bench(count, rate_hz);
+	}
+
+	usage();
+	return 1;
+}
@@ -74,7 +74,7 @@ bool dsm_port_input(uint16_t *rssi, bool *dsm_updated, bool *st24_updated, bool
 {
 	perf_begin(c_gather_dsm);
 	uint8_t n_bytes = 0;
-	uint8_t *bytes;
+	uint8_t *bytes = NULL;
 	bool dsm_11_bit;
 	*dsm_updated = dsm_input(_dsm_fd, r_raw_rc_values, &r_raw_rc_count, &dsm_11_bit, &n_bytes, &bytes,
 				 PX4IO_RC_INPUT_CHANNELS);
@@ -99,14 +99,10 @@ bool dsm_port_input(uint16_t *rssi, bool *dsm_updated, bool *st24_updated, bool
 	uint8_t st24_rssi, rx_count;
 	uint16_t st24_channel_count = 0;
 
-	*st24_updated = false;
-
-	for (unsigned i = 0; i < n_bytes; i++) {
-		/* set updated flag if one complete packet was parsed */
-		st24_rssi = RC_INPUT_RSSI_MAX;
-		*st24_updated |= (OK == st24_decode(bytes[i], &st24_rssi, &rx_count,
-						    &st24_channel_count, r_raw_rc_values, PX4IO_RC_INPUT_CHANNELS));
-	}
+	/* set updated flag if one complete packet was parsed */
+	st24_rssi = RC_INPUT_RSSI_MAX;
+	*st24_updated = (OK == st24_parse(bytes, n_bytes, &st24_rssi, &rx_count,
+					  &st24_channel_count, r_raw_rc_values, PX4IO_RC_INPUT_CHANNELS));
 
 	if (*st24_updated) {
 
@@ -126,14 +122,10 @@ bool dsm_port_input(uint16_t *rssi, bool *dsm_updated, bool *st24_updated, bool
 	uint8_t sumd_rssi, sumd_rx_count;
 	uint16_t sumd_channel_count = 0;
 
-	*sumd_updated = false;
-
-	for (unsigned i = 0; i < n_bytes; i++) {
-		/* set updated flag if one complete packet was parsed */
-		sumd_rssi = RC_INPUT_RSSI_MAX;
-		*sumd_updated |= (OK == sumd_decode(bytes[i], &sumd_rssi, &sumd_rx_count,
-						    &sumd_channel_count, r_raw_rc_values, PX4IO_RC_INPUT_CHANNELS));
-	}
+	/* set updated flag if one complete packet was parsed */
+	sumd_rssi = RC_INPUT_RSSI_MAX;
+	*sumd_updated = (OK == sumd_parse(bytes, n_bytes, &sumd_rssi, &sumd_rx_count,
+					  &sumd_channel_count, r_raw_rc_values, PX4IO_RC_INPUT_CHANNELS));
 
 	if (*sumd_updated) {
 
@@ -421,6 +421,7 @@ mixer_callback(uintptr_t handle,
 
 static char mixer_text[200];		/* large enough for one mixer */
 static unsigned mixer_text_length = 0;
+static bool mixer_binary = false;	/* the buffer holds a precompiled image */
 
 int
 mixer_handle_text(const void *buffer, size_t length)
@@ -451,11 +452,13 @@ mixer_handle_text(const void *buffer, size_t length)
 
 	switch (msg->action) {
 	case F2I_MIXER_ACTION_RESET:
+	case F2I_MIXER_ACTION_RESET_BINARY:
 		isr_debug(2, "reset");
 
 		/* THEN actually delete it */
 		mixer_group.reset();
 		mixer_text_length = 0;
+		mixer_binary = (msg->action == F2I_MIXER_ACTION_RESET_BINARY);
 
 	/* FALLTHROUGH */
 	case F2I_MIXER_ACTION_APPEND:
@@ -475,7 +478,13 @@ mixer_handle_text(const void *buffer, size_t length)
 
 		/* process the text buffer, adding new mixers as their descriptions can be parsed */
 		unsigned resid = mixer_text_length;
-		mixer_group.load_from_buf(&mixer_text[0], resid);
+
+		if (mixer_binary) {
+			mixer_group.load_from_bin(&mixer_text[0], resid);
+
+		} else {
+			mixer_group.load_from_buf(&mixer_text[0], resid);
+		}
 
 		/* if anything was parsed */
 		if (resid != mixer_text_length) {
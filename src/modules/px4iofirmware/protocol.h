@@ -76,7 +76,7 @@
 #define REG_TO_FLOAT(_reg)	((float)REG_TO_SIGNED(_reg) / 10000.0f)
 #define FLOAT_TO_REG(_float)	SIGNED_TO_REG((int16_t)((_float) * 10000.0f))
 
-#define PX4IO_PROTOCOL_VERSION		4
+#define PX4IO_PROTOCOL_VERSION		5
 
 /* maximum allowable sizes on this protocol version */
 #define PX4IO_PROTOCOL_MAX_CONTROL_COUNT	8	/**< The protocol does not support more than set here, individual units might support less - see PX4IO_P_CONFIG_CONTROL_COUNT */
@@ -308,6 +308,7 @@ struct px4io_mixdata {
 	uint8_t		action;
 #define F2I_MIXER_ACTION_RESET			0
 #define F2I_MIXER_ACTION_APPEND			1
+#define F2I_MIXER_ACTION_RESET_BINARY		2	/* reset, the data that follows is a precompiled image */
 
 	char		text[0];	/* actual text size may vary */
 };
@@ -365,7 +365,7 @@ int sdlog2_main(int argc, char *argv[])
 
 		unsigned i;
 		for (i = 0; i < max_wait_steps; i++) {
-			usleep(max_wait_us / max_wait_steps);
+			px4_usleep(max_wait_us / max_wait_steps);
 			if (thread_running) {
 				break;
 			}
@@ -776,7 +776,7 @@ void sdlog2_start_log()
 	dprintf(perf_fd, "PERFORMANCE COUNTERS PRE-FLIGHT\n\n");
 	perf_print_all(perf_fd);
 	dprintf(perf_fd, "\nLOAD PRE-FLIGHT\n\n");
-	usleep(500 * 1000);
+	px4_usleep(500 * 1000);
 	print_load(hrt_absolute_time(), perf_fd, &load);
 	close(perf_fd);
 
@@ -1497,7 +1497,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 		}
 
 		if (!logging_enabled) {
-			usleep(50000);
+			px4_usleep(50000);
 			continue;
 		}
 
@@ -1513,7 +1513,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 		if (pret < 0) {
 			PX4_WARN("poll error %d, %d", pret, errno);
 			// sleep a bit before next try
-			usleep(100000);
+			px4_usleep(100000);
 			continue;
 		}
 
@@ -81,6 +81,7 @@
 #include <systemlib/param/param.h>
 #include <systemlib/err.h>
 #include <systemlib/perf_counter.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/battery.h>
 
 #include <conversion/rotation.h>
@@ -251,6 +252,10 @@ private:
 	orb_advert_t	_mavlink_log_pub;
 
 	perf_counter_t	_loop_perf;			/**< loop performance counter */
+	perf_counter_t	_latency_perf;			/**< gyro sample to sensor_combined publication */
+
+	px4_pollfd_struct_t _poll_fds[SENSOR_COUNT_MAX * 3];	/**< gyro, mag and baro instances to wait on */
+	unsigned	_poll_fd_count;
 
 	DataValidator	_airspeed_validator;		/**< data validator to monitor airspeed */
 
@@ -428,6 +433,24 @@ private:
 
 	void	init_sensor_class(const struct orb_metadata *meta, SensorData &sensor_data);
 
+	/**
+	 * Rebuild the set of subscriptions the main loop waits on.
+	 * Accels are not part of it, IMU drivers publish them together with the gyro.
+	 */
+	void	update_poll_fds();
+
+	/**
+	 * Add the instances of a sensor class to the poll set.
+	 */
+	void	add_poll_fds(const SensorData &sensor_data);
+
+	/**
+	 * Get the instances of a sensor class which signalled an update.
+	 *
+	 * @return			Bitmask of the updated instances.
+	 */
+	uint8_t	updated_instances(const SensorData &sensor_data) const;
+
 	/**
 	 * Update our local parameter cache.
 	 */
@@ -443,32 +466,40 @@ private:
 	 *
 	 * @param raw			Combined sensor data structure into which
 	 *				data should be returned.
+	 * @param updated_mask		Bitmask of the instances which signalled
+	 *				an update, other instances are not checked.
 	 */
-	void		accel_poll(struct sensor_combined_s &raw);
+	void		accel_poll(struct sensor_combined_s &raw, uint8_t updated_mask = 0xff);
 
 	/**
 	 * Poll the gyro for updated data.
 	 *
 	 * @param raw			Combined sensor data structure into which
 	 *				data should be returned.
+	 * @param updated_mask		Bitmask of the instances which signalled
+	 *				an update, other instances are not checked.
 	 */
-	void		gyro_poll(struct sensor_combined_s &raw);
+	void		gyro_poll(struct sensor_combined_s &raw, uint8_t updated_mask = 0xff);
 
 	/**
 	 * Poll the magnetometer for updated data.
 	 *
 	 * @param raw			Combined sensor data structure into which
 	 *				data should be returned.
+	 * @param updated_mask		Bitmask of the instances which signalled
+	 *				an update, other instances are not checked.
 	 */
-	void		mag_poll(struct sensor_combined_s &raw);
+	void		mag_poll(struct sensor_combined_s &raw, uint8_t updated_mask = 0xff);
 
 	/**
 	 * Poll the barometer for updated data.
 	 *
 	 * @param raw			Combined sensor data structure into which
 	 *				data should be returned.
+	 * @param updated_mask		Bitmask of the instances which signalled
+	 *				an update, other instances are not checked.
 	 */
-	void		baro_poll(struct sensor_combined_s &raw);
+	void		baro_poll(struct sensor_combined_s &raw, uint8_t updated_mask = 0xff);
 
 	/**
 	 * Poll the differential pressure sensor for updated data.
@@ -587,6 +618,9 @@ Sensors::Sensors() :
 
 	/* performance counters */
 	_loop_perf(perf_alloc(PC_ELAPSED, "sensors")),
+	_latency_perf(perf_alloc(PC_ELAPSED, "sensors_latency")),
+	_poll_fds{},
+	_poll_fd_count(0),
 	_airspeed_validator(),
 
 	_param_rc_values{},
@@ -751,7 +785,7 @@ Sensors::~Sensors()
 
 		do {
 			/* wait 20ms */
-			usleep(20000);
+			px4_usleep(20000);
 
 			/* if we have given up, kill it */
 			if (++i > 50) {
@@ -1074,11 +1108,15 @@ Sensors::adc_init()
 }
 
 void
-Sensors::accel_poll(struct sensor_combined_s &raw)
+Sensors::accel_poll(struct sensor_combined_s &raw, uint8_t updated_mask)
 {
 	bool got_update = false;
 
 	for (unsigned i = 0; i < _accel.subscription_count; i++) {
+		if (!(updated_mask & (1 << i))) {
+			continue;
+		}
+
 		bool accel_updated;
 		orb_check(_accel.subscription[i], &accel_updated);
 
@@ -1141,11 +1179,15 @@ Sensors::accel_poll(struct sensor_combined_s &raw)
 }
 
 void
-Sensors::gyro_poll(struct sensor_combined_s &raw)
+Sensors::gyro_poll(struct sensor_combined_s &raw, uint8_t updated_mask)
 {
 	bool got_update = false;
 
 	for (unsigned i = 0; i < _gyro.subscription_count; i++) {
+		if (!(updated_mask & (1 << i))) {
+			continue;
+		}
+
 		bool gyro_updated;
 		orb_check(_gyro.subscription[i], &gyro_updated);
 
@@ -1209,11 +1251,15 @@ Sensors::gyro_poll(struct sensor_combined_s &raw)
 }
 
 void
-Sensors::mag_poll(struct sensor_combined_s &raw)
+Sensors::mag_poll(struct sensor_combined_s &raw, uint8_t updated_mask)
 {
 	bool got_update = false;
 
 	for (unsigned i = 0; i < _mag.subscription_count; i++) {
+		if (!(updated_mask & (1 << i))) {
+			continue;
+		}
+
 		bool mag_updated;
 		orb_check(_mag.subscription[i], &mag_updated);
 
@@ -1254,11 +1300,15 @@ Sensors::mag_poll(struct sensor_combined_s &raw)
 }
 
 void
-Sensors::baro_poll(struct sensor_combined_s &raw)
+Sensors::baro_poll(struct sensor_combined_s &raw, uint8_t updated_mask)
 {
 	bool got_update = false;
 
 	for (unsigned i = 0; i < _baro.subscription_count; i++) {
+		if (!(updated_mask & (1 << i))) {
+			continue;
+		}
+
 		bool baro_updated;
 		orb_check(_baro.subscription[i], &baro_updated);
 
@@ -2260,6 +2310,47 @@ Sensors::init_sensor_class(const struct orb_metadata *meta, SensorData &sensor_d
 	sensor_data.subscription_count = group_count;
 }
 
+void
+Sensors::add_poll_fds(const SensorData &sensor_data)
+{
+	for (int i = 0; i < sensor_data.subscription_count; i++) {
+		_poll_fds[_poll_fd_count].fd = sensor_data.subscription[i];
+		_poll_fds[_poll_fd_count].events = POLLIN;
+		_poll_fds[_poll_fd_count].revents = 0;
+		_poll_fd_count++;
+	}
+}
+
+void
+Sensors::update_poll_fds()
+{
+	_poll_fd_count = 0;
+
+	add_poll_fds(_gyro);
+	add_poll_fds(_mag);
+	add_poll_fds(_baro);
+}
+
+uint8_t
+Sensors::updated_instances(const SensorData &sensor_data) const
+{
+	uint8_t mask = 0;
+
+	for (unsigned i = 0; i < _poll_fd_count; i++) {
+		if (!(_poll_fds[i].revents & POLLIN)) {
+			continue;
+		}
+
+		for (int j = 0; j < sensor_data.subscription_count; j++) {
+			if (_poll_fds[i].fd == sensor_data.subscription[j]) {
+				mask |= (1 << j);
+			}
+		}
+	}
+
+	return mask;
+}
+
 void
 Sensors::task_main()
 {
@@ -2337,10 +2428,8 @@ Sensors::task_main()
 	/* advertise the sensor_combined topic and make the initial publication */
 	_sensor_pub = orb_advertise(ORB_ID(sensor_combined), &raw);
 
-	/* wakeup source */
-	px4_pollfd_struct_t poll_fds = {};
-
-	poll_fds.events = POLLIN;
+	/* wakeup sources: all gyro, mag and baro instances */
+	update_poll_fds();
 
 	_task_should_exit = false;
 
@@ -2348,48 +2437,72 @@ Sensors::task_main()
 
 	while (!_task_should_exit) {
 
-		/* use the best-voted gyro to pace output */
-		poll_fds.fd = _gyro.subscription[_gyro.last_best_vote];
+		/* the gyro is a mandatory sensor, attempt to subscribe once again until there is one */
+		if (_gyro.subscription_count == 0) {
+			init_sensor_class(ORB_ID(sensor_gyro), _gyro);
+			update_poll_fds();
 
-		/* wait for up to 50ms for data (Note that this implies, we can have a fail-over time of 50ms,
-		 * if a gyro fails) */
-		int pret = px4_poll(&poll_fds, 1, 50);
+			if (_gyro.subscription_count == 0) {
+				px4_usleep(1000);
+				continue;
+			}
+		}
+
+		/* wait for up to 50ms for data on any instance, a failing gyro does not block the others */
+		int pret = px4_poll(_poll_fds, _poll_fd_count, 50);
 
 		/* if pret == 0 it timed out - periodic check for _task_should_exit, etc. */
 
 		/* this is undesirable but not much we can do - might want to flag unhappy status */
 		if (pret < 0) {
-			/* if the polling operation failed because no gyro sensor is available yet,
-			 * then attempt to subscribe once again
-			 */
-			if (_gyro.subscription_count == 0) {
-				init_sensor_class(ORB_ID(sensor_gyro), _gyro);
-			}
-
-			usleep(1000);
+			px4_usleep(1000);
 
 			continue;
 		}
 
+		const uint8_t gyro_updated = (pret > 0) ? updated_instances(_gyro) : 0;
+		const uint8_t mag_updated = (pret > 0) ? updated_instances(_mag) : 0;
+		const uint8_t baro_updated = (pret > 0) ? updated_instances(_baro) : 0;
+
 		perf_begin(_loop_perf);
 
 		/* check vehicle status for changes to publication state */
 		vehicle_control_mode_poll();
 
-		/* the timestamp of the raw struct is updated by the gyro_poll() method (this makes the gyro
-		 * a mandatory sensor) */
-		gyro_poll(raw);
-		accel_poll(raw);
-		mag_poll(raw);
-		baro_poll(raw);
+		/* only process the instances which signalled an update */
+		if (mag_updated) {
+			mag_poll(raw, mag_updated);
+		}
 
+		if (baro_updated) {
+			baro_poll(raw, baro_updated);
+		}
+
+		/* the best-voted gyro paces the output, everything else is only refreshed then
+		 * (or on timeout, to keep looking for sensors and parameter updates) */
+		if (!gyro_updated && pret > 0) {
+			perf_end(_loop_perf);
+			continue;
+		}
+
+		const uint8_t pacing_gyro = _gyro.last_best_vote;
+
+		/* the timestamp of the raw struct is updated by the gyro_poll() method (this makes the gyro
+		 * a mandatory sensor). IMU drivers publish the accel together with the gyro. */
+		if (gyro_updated) {
+			gyro_poll(raw, gyro_updated);
+			accel_poll(raw);
+		}
 
 		/* check battery voltage */
 		adc_poll(raw);
 
 		diff_pres_poll(raw);
 
-		if (_publishing && raw.timestamp > 0) {
+		/* a secondary gyro alone does not trigger an output, unless it just became the best one */
+		const bool pacing = (gyro_updated & (1 << pacing_gyro)) || (pacing_gyro != _gyro.last_best_vote);
+
+		if (_publishing && raw.timestamp > 0 && pacing) {
 
 			/* construct relative timestamps */
 			if (_last_accel_timestamp[_accel.last_best_vote]) {
@@ -2406,6 +2519,9 @@ Sensors::task_main()
 
 			orb_publish(ORB_ID(sensor_combined), _sensor_pub, &raw);
 
+			perf_set_elapsed(_latency_perf, hrt_elapsed_time(&raw.timestamp));
+			latency_trace_stamp(LATENCY_TRACE_SENSORS, raw.timestamp);
+
 			check_failover(_accel, "Accel");
 			check_failover(_gyro, "Gyro");
 			check_failover(_mag, "Mag");
@@ -2422,6 +2538,7 @@ Sensors::task_main()
 			init_sensor_class(ORB_ID(sensor_mag), _mag);
 			init_sensor_class(ORB_ID(sensor_accel), _accel);
 			init_sensor_class(ORB_ID(sensor_baro), _baro);
+			update_poll_fds();
 			_last_config_update = hrt_absolute_time();
 
 		} else {
@@ -2483,7 +2600,7 @@ Sensors::start()
 
 	/* wait until the task is up and running or has failed */
 	while (_sensors_task > 0 && _task_should_exit) {
-		usleep(100);
+		px4_usleep(100);
 	}
 
 	if (_sensors_task < 0) {
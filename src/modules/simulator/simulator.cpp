@@ -56,6 +56,7 @@ using namespace simulator;
 static px4_task_t g_sim_task = -1;
 
 Simulator *Simulator::_instance = NULL;
+ReadySignal Simulator::ready;
 
 Simulator *Simulator::getInstance()
 {
@@ -131,8 +132,13 @@ int Simulator::start(int argc, char *argv[])
 	if (_instance) {
 		drv_led_start();
 
-		if (argc == 5 && strcmp(argv[3], "-u") == 0) {
-			udp_port = atoi(argv[4]);
+		for (int i = 3; i < argc; i++) {
+			if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+				udp_port = atoi(argv[++i]);
+
+			} else if (strcmp(argv[i], "-l") == 0) {
+				_instance->_lockstep = true;
+			}
 		}
 
 		if (argv[2][1] == 's') {
@@ -149,6 +155,7 @@ int Simulator::start(int argc, char *argv[])
 		} else {
 			_instance->initializeSensorData();
 			_instance->_initialized = true;
+			ready.set_ready();
 		}
 
 	} else {
@@ -156,15 +163,21 @@ int Simulator::start(int argc, char *argv[])
 		ret = 1;
 	}
 
+	// do not leave the start command waiting if the task gave up before it was initialized
+	if (_instance == nullptr || !_instance->_initialized) {
+		ready.set_ready();
+	}
+
 	return ret;
 }
 
 static void usage()
 {
-	PX4_WARN("Usage: simulator {start -[spt] [-u udp_port] |stop}");
+	PX4_WARN("Usage: simulator {start -[spt] [-u udp_port] [-l] |stop}");
 	PX4_WARN("Simulate raw sensors:     simulator start -s");
 	PX4_WARN("Publish sensors combined: simulator start -p");
 	PX4_WARN("Dummy unit test data:     simulator start -t");
+	PX4_WARN("Lockstep with sim time:   simulator start -s -l");
 }
 
 __BEGIN_DECLS
@@ -190,6 +203,7 @@ extern "C" {
 				// enable lockstep support
 				px4_enable_sim_lockstep();
 
+				Simulator::ready.reset();
 				g_sim_task = px4_task_spawn_cmd("simulator",
 								SCHED_DEFAULT,
 								SCHED_PRIORITY_MAX,
@@ -197,14 +211,11 @@ extern "C" {
 								Simulator::start,
 								argv);
 
-				// now wait for the command to complete
-				while (true) {
-					if (Simulator::getInstance() && Simulator::getInstance()->isInitialized()) {
-						break;
-
-					} else {
-						usleep(100000);
-					}
+				// now wait for the command to complete, the simulator may take a while to connect
+				if (g_sim_task < 0 || !Simulator::ready.wait(0) ||
+				    Simulator::getInstance() == nullptr || !Simulator::getInstance()->isInitialized()) {
+					PX4_ERR("simulator start failed");
+					ret = 1;
 				}
 
 			} else {
@@ -39,6 +39,7 @@
 #pragma once
 
 #include <px4_posix.h>
+#include <px4_sem.hpp>
 #include <uORB/topics/hil_sensor.h>
 #include <uORB/topics/manual_control_setpoint.h>
 #include <uORB/topics/actuator_outputs.h>
@@ -202,6 +203,12 @@ public:
 
 	static int start(int argc, char *argv[]);
 
+	/**
+	 * Set by the simulator task once the sensor data is initialized, or
+	 * once the task has given up.
+	 */
+	static ReadySignal ready;
+
 	bool getRawAccelReport(uint8_t *buf, int len);
 	bool getMagReport(uint8_t *buf, int len);
 	bool getMPUReport(uint8_t *buf, int len);
@@ -241,7 +248,9 @@ private:
 		_flow_pub(nullptr),
 		_dist_pub(nullptr),
 		_battery_pub(nullptr),
-		_initialized(false)
+		_initialized(false),
+		_lockstep(false),
+		_lockstep_offset(0)
 #ifndef __PX4_QURT
 		,
 		_rc_channels_pub(nullptr),
@@ -295,6 +304,10 @@ private:
 
 	bool _initialized;
 
+	// advance the HRT with the simulator time instead of the wall clock
+	bool _lockstep;
+	uint64_t _lockstep_offset; ///< simulator time at HRT time 0 [us]
+
 	// Lib used to do the battery calculations.
 	Battery _battery;
 
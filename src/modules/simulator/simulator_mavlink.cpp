@@ -226,6 +226,16 @@ void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 			imu.temperature = 32.0f;
 
 			uint64_t sim_timestamp = imu.time_usec;
+
+			if (hrt_lockstep_enabled()) {
+				// the sensor data defines the time: advance the HRT before publishing it
+				if (_lockstep_offset == 0) {
+					_lockstep_offset = sim_timestamp - hrt_absolute_time();
+				}
+
+				hrt_lockstep_set_time(sim_timestamp - _lockstep_offset);
+			}
+
 			struct timespec ts;
 			px4_clock_gettime(CLOCK_REALTIME, &ts);
 			uint64_t timestamp = ts.tv_sec * 1000 * 1000 + ts.tv_nsec / 1000;
@@ -568,9 +578,15 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 	}
 
 	_initialized = true;
+	ready.set_ready();
 	// reset system time
 	(void)hrt_reset();
 
+	if (_lockstep) {
+		PX4_INFO("Running in lockstep with the simulator time");
+		hrt_lockstep_enable();
+	}
+
 	// subscribe to topics
 	for (unsigned i = 0; i < (sizeof(_actuator_outputs_sub) / sizeof(_actuator_outputs_sub[0])); i++) {
 		_actuator_outputs_sub[i] = orb_subscribe_multi(ORB_ID(actuator_outputs), i);
@@ -596,7 +612,8 @@ void Simulator::pollForMAVLinkMessages(bool publish, int udp_port)
 
 		//timed out
 		if (pret == 0) {
-			if (!sim_delay) {
+			// in lockstep the time simply does not advance while waiting
+			if (!sim_delay && !_lockstep) {
 				// we do not want to spam the console by default
 				// PX4_WARN("mavlink sim timeout for %d ms", max_wait_ms);
 				sim_delay = true;
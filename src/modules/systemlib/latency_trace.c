@@ -0,0 +1,195 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file latency_trace.c
+ *
+ * Sensor to actuator latency tracing.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <px4_posix.h>
+#include <drivers/drv_hrt.h>
+
+#include "latency_trace.h"
+
+#ifdef __PX4_QURT
+// There is presumably no dprintf on QURT. Therefore use the usual output to mini-dm.
+#define dprintf(_fd, _text, ...) ((_fd) == 1 ? PX4_INFO((_text), ##__VA_ARGS__) : (void)(_fd))
+#endif
+
+/* number of records, must be a power of two */
+#define LATENCY_TRACE_SIZE	512
+
+/* marks a record which is being written */
+#define LATENCY_TRACE_INVALID	0xff
+
+struct latency_trace_record {
+	uint64_t	sample;		/**< IMU sample timestamp (sample ID) */
+	uint32_t	latency;	/**< time from sample to stage in microseconds */
+	uint8_t		stage;		/**< enum latency_trace_stage, written last */
+};
+
+static const char *latency_trace_stage_names[LATENCY_TRACE_STAGE_COUNT] = {
+	"imu",
+	"sensors",
+	"estimator",
+	"att_control",
+	"output"
+};
+
+static struct latency_trace_record *latency_trace_buffer = NULL;
+static volatile bool latency_trace_active = false;
+static uint32_t latency_trace_head = 0;
+
+int
+latency_trace_start(void)
+{
+	if (latency_trace_buffer == NULL) {
+		/* the buffer is never freed, writers may still hold a pointer to it */
+		struct latency_trace_record *buffer = calloc(LATENCY_TRACE_SIZE, sizeof(struct latency_trace_record));
+
+		if (buffer == NULL) {
+			return -1;
+		}
+
+		for (unsigned i = 0; i < LATENCY_TRACE_SIZE; i++) {
+			buffer[i].stage = LATENCY_TRACE_INVALID;
+		}
+
+		latency_trace_buffer = buffer;
+	}
+
+	latency_trace_active = true;
+	return 0;
+}
+
+void
+latency_trace_stop(void)
+{
+	latency_trace_active = false;
+}
+
+void
+latency_trace_stamp(enum latency_trace_stage stage, uint64_t sample)
+{
+	if (!latency_trace_active || sample == 0) {
+		return;
+	}
+
+	hrt_abstime now = hrt_absolute_time();
+
+	/* claim a slot, concurrent writers get distinct slots */
+	uint32_t index = __sync_fetch_and_add(&latency_trace_head, 1) & (LATENCY_TRACE_SIZE - 1);
+	struct latency_trace_record *record = &latency_trace_buffer[index];
+
+	record->stage = LATENCY_TRACE_INVALID;
+	record->sample = sample;
+	record->latency = (now > sample) ? (uint32_t)(now - sample) : 0;
+	__sync_synchronize();
+	record->stage = stage;
+}
+
+void
+latency_trace_print(int fd)
+{
+	if (latency_trace_buffer == NULL) {
+		dprintf(fd, "latency trace not started\n");
+		return;
+	}
+
+	uint32_t count[LATENCY_TRACE_STAGE_COUNT] = {};
+	uint64_t total[LATENCY_TRACE_STAGE_COUNT] = {};
+	uint32_t most[LATENCY_TRACE_STAGE_COUNT] = {};
+
+	for (unsigned i = 0; i < LATENCY_TRACE_SIZE; i++) {
+		struct latency_trace_record record = latency_trace_buffer[i];
+
+		if (record.stage >= LATENCY_TRACE_STAGE_COUNT) {
+			continue;
+		}
+
+		count[record.stage]++;
+		total[record.stage] += record.latency;
+
+		if (record.latency > most[record.stage]) {
+			most[record.stage] = record.latency;
+		}
+	}
+
+	dprintf(fd, "latency trace (%s), time since IMU sample:\n", latency_trace_active ? "running" : "stopped");
+
+	for (unsigned stage = 0; stage < LATENCY_TRACE_STAGE_COUNT; stage++) {
+		dprintf(fd, "%-12s: %4u samples, avg: %6lluus, max: %6uus\n",
+			latency_trace_stage_names[stage], (unsigned)count[stage],
+			(unsigned long long)(count[stage] > 0 ? total[stage] / count[stage] : 0),
+			(unsigned)most[stage]);
+	}
+}
+
+int
+latency_trace_dump(const char *path)
+{
+	if (latency_trace_buffer == NULL) {
+		return -1;
+	}
+
+	int fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	dprintf(fd, "sample,stage,latency_us\n");
+
+	/* oldest first */
+	uint32_t head = latency_trace_head;
+
+	for (unsigned i = 0; i < LATENCY_TRACE_SIZE; i++) {
+		struct latency_trace_record record = latency_trace_buffer[(head + i) & (LATENCY_TRACE_SIZE - 1)];
+
+		if (record.stage >= LATENCY_TRACE_STAGE_COUNT) {
+			continue;
+		}
+
+		dprintf(fd, "%llu,%s,%u\n", (unsigned long long)record.sample,
+			latency_trace_stage_names[record.stage], (unsigned)record.latency);
+	}
+
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file latency_trace.h
+ * Sensor to actuator latency tracing.
+ *
+ * The timestamp of an IMU sample is passed through the control pipeline
+ * (sensor_combined.timestamp, control_state.timestamp_sample,
+ * actuator_controls.timestamp_sample) and serves as sample ID. Every stage
+ * stamps the sample ID when it publishes its result, the trace records the
+ * time since the sample was taken.
+ *
+ * Tracing is off by default and costs a single check per stamp then.
+ */
+
+#ifndef _SYSTEMLIB_LATENCY_TRACE_H
+#define _SYSTEMLIB_LATENCY_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <px4_defines.h>
+
+/**
+ * Pipeline stages, in the order a sample passes them.
+ */
+enum latency_trace_stage {
+	LATENCY_TRACE_IMU = 0,		/**< IMU driver published the sample */
+	LATENCY_TRACE_SENSORS,		/**< sensors published sensor_combined */
+	LATENCY_TRACE_ESTIMATOR,	/**< estimator published the attitude */
+	LATENCY_TRACE_ATT_CONTROL,	/**< attitude controller published actuator controls */
+	LATENCY_TRACE_OUTPUT,		/**< output driver updated the actuators */
+	LATENCY_TRACE_STAGE_COUNT
+};
+
+__BEGIN_DECLS
+
+/**
+ * Start tracing. Allocates the trace buffer on first use.
+ *
+ * @return			0 on success, -1 if the buffer could not be allocated
+ */
+__EXPORT extern int		latency_trace_start(void);
+
+/**
+ * Stop tracing. The recorded samples are kept until the next start.
+ */
+__EXPORT extern void		latency_trace_stop(void);
+
+/**
+ * Record that a sample passed a stage. Safe to call from any context.
+ *
+ * @param stage			The stage the sample passed.
+ * @param sample		Timestamp of the IMU sample (sample ID).
+ */
+__EXPORT extern void		latency_trace_stamp(enum latency_trace_stage stage, uint64_t sample);
+
+/**
+ * Print the latency statistics per stage.
+ *
+ * @param fd			File descriptor to print to - e.g. 1 for stdout
+ */
+__EXPORT extern void		latency_trace_print(int fd);
+
+/**
+ * Write all recorded samples as CSV (sample,stage,latency_us).
+ *
+ * @param path			File to write.
+ * @return			0 on success, -1 on error
+ */
+__EXPORT extern int		latency_trace_dump(const char *path);
+
+__END_DECLS
+
+#endif
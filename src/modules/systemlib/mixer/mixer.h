@@ -312,6 +312,30 @@ public:
 	 */
 	int				load_from_buf(const char *buf, unsigned &buflen);
 
+	/**
+	 * Adds mixers to the group from a precompiled image.
+	 *
+	 * The image format is described with struct mixer_binary_header_s in
+	 * drivers/drv_mixer.h.  A leading image header is checked and skipped,
+	 * after that complete records are consumed, so the image can be passed
+	 * in pieces the same way as the text.
+	 *
+	 * @param buf			The precompiled image.
+	 * @param buflen		The length of the buffer, updated to reflect
+	 *				bytes as they are consumed.
+	 * @return			Zero on successful load, nonzero otherwise.
+	 */
+	int				load_from_bin(const void *buf, unsigned &buflen);
+
+	/**
+	 * Get the total length of a precompiled image.
+	 *
+	 * @param buf			The precompiled image, starting with its header.
+	 * @return			The length including the header, or zero if
+	 *				the header is not valid.
+	 */
+	static unsigned			binary_length(const void *buf);
+
 private:
 	Mixer				*_first;	/**< linked list of mixers */
 
@@ -391,6 +415,23 @@ public:
 			const char *buf,
 			unsigned &buflen);
 
+	/**
+	 * Factory method for a precompiled mixer record.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param payload		Record payload, struct mixer_binary_simple_s
+	 *				followed by the controls.
+	 * @param length		Length of the payload in bytes.
+	 * @return			A new SimpleMixer instance, or nullptr
+	 *				if the record is bad.
+	 */
+	static SimpleMixer		*from_binary(Mixer::ControlCallback control_cb,
+			uintptr_t cb_handle,
+			const uint8_t *payload,
+			unsigned length);
+
 	/**
 	 * Factory method for PWM/PPM input to internal float representation.
 	 *
@@ -515,9 +556,43 @@ public:
 			const char *buf,
 			unsigned &buflen);
 
+	/**
+	 * Factory method for a precompiled mixer record.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param payload		Record payload, struct mixer_binary_multirotor_s.
+	 * @param length		Length of the payload in bytes.
+	 * @return			A new MultirotorMixer instance, or nullptr
+	 *				if the record is bad.
+	 */
+	static MultirotorMixer		*from_binary(Mixer::ControlCallback control_cb,
+			uintptr_t cb_handle,
+			const uint8_t *payload,
+			unsigned length);
+
 	virtual unsigned		mix(float *outputs, unsigned space, uint16_t *status_reg);
 	virtual void			groups_required(uint32_t &groups);
 
+	/**
+	 * Look up a geometry by the name used in mixer definitions.
+	 *
+	 * @param name			Geometry name, e.g. "4x".
+	 * @param geometry		Set to the geometry if found.
+	 * @return			true if the name is known.
+	 */
+	static bool			geometry_from_name(const char *name, MultirotorGeometry &geometry);
+
+	/**
+	 * Get the precalculated rotor mix of a geometry.
+	 *
+	 * @param geometry		The geometry.
+	 * @param rotor_count		Set to the number of rotors.
+	 * @return			The rotor mix table.
+	 */
+	static const Rotor		*get_rotors(MultirotorGeometry geometry, unsigned &rotor_count);
+
 private:
 	float				_roll_scale;
 	float				_pitch_scale;
@@ -535,4 +610,93 @@ private:
 	MultirotorMixer operator=(const MultirotorMixer &);
 };
 
+/**
+ * Multi-rotor mixer based on a control allocation matrix.
+ *
+ * Uses the same geometries and inputs as MultirotorMixer. The outputs are a
+ * single product of a precomputed allocation matrix with the control vector.
+ * Before that product the control vector is desaturated in a fixed number of
+ * steps that give roll and pitch priority over yaw, and yaw over thrust:
+ *
+ * 1) move thrust within the boost limits to fit roll and pitch,
+ * 2) scale roll and pitch if they still do not fit, and center thrust again,
+ * 3) lower thrust by up to 0.15 to make room for yaw,
+ * 4) scale yaw if it still does not fit.
+ */
+class __EXPORT AllocationMixer : public Mixer
+{
+public:
+	static const unsigned MAX_ROTORS = 8;
+
+	/**
+	 * Constructor, see MultirotorMixer.
+	 */
+	AllocationMixer(ControlCallback control_cb,
+			uintptr_t cb_handle,
+			MultirotorGeometry geometry,
+			float roll_scale,
+			float pitch_scale,
+			float yaw_scale,
+			float idle_speed);
+	~AllocationMixer();
+
+	/**
+	 * Factory method, see MultirotorMixer::from_text().
+	 *
+	 * The definition is "A: <geometry> <roll scale> <pitch scale> <yaw scale> <idle speed>".
+	 */
+	static AllocationMixer		*from_text(Mixer::ControlCallback control_cb,
+			uintptr_t cb_handle,
+			const char *buf,
+			unsigned &buflen);
+
+	/**
+	 * Factory method for a precompiled mixer record, see MultirotorMixer::from_binary().
+	 */
+	static AllocationMixer		*from_binary(Mixer::ControlCallback control_cb,
+			uintptr_t cb_handle,
+			const uint8_t *payload,
+			unsigned length);
+
+	virtual unsigned		mix(float *outputs, unsigned space, uint16_t *status_reg);
+	virtual void			groups_required(uint32_t &groups);
+
+	/**
+	 * Mix a control vector without going through the control callback.
+	 *
+	 * @param controls		Roll, pitch, yaw and thrust.
+	 * @param outputs		Rotor outputs, get_rotor_count() entries.
+	 * @param status_reg		Saturation flags, may be NULL.
+	 */
+	void				mix_controls(const float controls[4], float *outputs, uint16_t *status_reg) const;
+
+	/**
+	 * Mix count control vectors, e.g. for offline evaluation.
+	 *
+	 * @param controls		count control vectors.
+	 * @param outputs		count times get_rotor_count() outputs.
+	 * @param count			Number of control vectors.
+	 */
+	void				mix_n(const float (*controls)[4], float *outputs, unsigned count) const;
+
+	unsigned			get_rotor_count() const { return _rotor_count; }
+
+private:
+	float				_roll_scale;
+	float				_pitch_scale;
+	float				_yaw_scale;
+	float				_idle_speed;
+	unsigned			_rotor_count;
+
+	/* allocation matrix, one column per control */
+	float				_roll[MAX_ROTORS];
+	float				_pitch[MAX_ROTORS];
+	float				_yaw[MAX_ROTORS];
+	float				_thrust[MAX_ROTORS];
+
+	/* do not allow to copy */
+	AllocationMixer(const AllocationMixer &);
+	AllocationMixer operator=(const AllocationMixer &);
+};
+
 #endif
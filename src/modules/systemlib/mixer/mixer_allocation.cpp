@@ -0,0 +1,367 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mixer_allocation.cpp
+ *
+ * Multi-rotor mixer based on a control allocation matrix.
+ */
+#include <px4_config.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include <px4iofirmware/protocol.h>
+
+#include "mixer.h"
+
+#define debug(fmt, args...)	do { } while(0)
+//#define debug(fmt, args...)	do { printf("[mixer] " fmt "\n", ##args); } while(0)
+
+namespace
+{
+
+float constrain(float val, float min, float max)
+{
+	return (val < min) ? min : ((val > max) ? max : val);
+}
+
+bool saturated(const float *out, unsigned n)
+{
+	for (unsigned i = 0; i < n; i++) {
+		if (out[i] < 0.0f || out[i] > 1.0f) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Gain k along dir that moves the outputs back into [0, 1]: the sum of
+ * the gains needed for the worst violation below and above the range,
+ * so violations on both sides are traded against each other.
+ */
+float desaturation_gain(const float *dir, const float *out, unsigned n)
+{
+	float k_min = 0.0f;
+	float k_max = 0.0f;
+
+	for (unsigned i = 0; i < n; i++) {
+		float k;
+
+		if (fabsf(dir[i]) < FLT_EPSILON) {
+			continue;
+
+		} else if (out[i] < 0.0f) {
+			k = -out[i] / dir[i];
+
+		} else if (out[i] > 1.0f) {
+			k = (1.0f - out[i]) / dir[i];
+
+		} else {
+			continue;
+		}
+
+		k_min = fminf(k_min, k);
+		k_max = fmaxf(k_max, k);
+	}
+
+	return k_min + k_max;
+}
+
+/**
+ * Move the outputs along dir to minimize saturation, with the total gain
+ * bounded to [k_lower, k_upper]. The second pass splits what is left
+ * between both ends of the range.
+ *
+ * @return the applied gain
+ */
+float minimize_saturation(const float *dir, float *out, unsigned n, float k_lower, float k_upper)
+{
+	float k = constrain(desaturation_gain(dir, out, n), k_lower, k_upper);
+
+	if (k == 0.0f) {
+		return 0.0f;
+	}
+
+	for (unsigned i = 0; i < n; i++) {
+		out[i] += k * dir[i];
+	}
+
+	float k2 = constrain(0.5f * desaturation_gain(dir, out, n), k_lower - k, k_upper - k);
+
+	for (unsigned i = 0; i < n; i++) {
+		out[i] += k2 * dir[i];
+	}
+
+	return k + k2;
+}
+
+} // anonymous namespace
+
+AllocationMixer::AllocationMixer(ControlCallback control_cb,
+				 uintptr_t cb_handle,
+				 MultirotorGeometry geometry,
+				 float roll_scale,
+				 float pitch_scale,
+				 float yaw_scale,
+				 float idle_speed) :
+	Mixer(control_cb, cb_handle),
+	_roll_scale(roll_scale),
+	_pitch_scale(pitch_scale),
+	_yaw_scale(yaw_scale),
+	_idle_speed(-1.0f + idle_speed * 2.0f),	/* shift to output range here to avoid runtime calculation */
+	_rotor_count(0)
+{
+	const MultirotorMixer::Rotor *rotors = MultirotorMixer::get_rotors(geometry, _rotor_count);
+
+	if (_rotor_count > MAX_ROTORS) {
+		_rotor_count = MAX_ROTORS;
+	}
+
+	/* the output scale of a rotor applies to all of its controls */
+	for (unsigned i = 0; i < _rotor_count; i++) {
+		_roll[i] = rotors[i].roll_scale * rotors[i].out_scale;
+		_pitch[i] = rotors[i].pitch_scale * rotors[i].out_scale;
+		_yaw[i] = rotors[i].yaw_scale * rotors[i].out_scale;
+		_thrust[i] = rotors[i].out_scale;
+	}
+}
+
+AllocationMixer::~AllocationMixer()
+{
+}
+
+AllocationMixer *
+AllocationMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen)
+{
+	MultirotorGeometry geometry;
+	char geomname[8];
+	int s[4];
+	int used;
+
+	/* enforce that the mixer ends with space or a new line */
+	for (int i = buflen - 1; i >= 0; i--) {
+		if (buf[i] == '\0') {
+			continue;
+		}
+
+		/* require a space or newline at the end of the buffer, fail on printable chars */
+		if (buf[i] == ' ' || buf[i] == '\n' || buf[i] == '\r') {
+			break;
+
+		} else {
+			debug("allocation parser rejected: No newline / space at end of buf. (#%d/%d: 0x%02x)", i, buflen - 1, buf[i]);
+			return nullptr;
+		}
+	}
+
+	if (sscanf(buf, "A: %7s %d %d %d %d%n", geomname, &s[0], &s[1], &s[2], &s[3], &used) != 5) {
+		debug("allocation parse failed on '%s'", buf);
+		return nullptr;
+	}
+
+	if (used > (int)buflen) {
+		debug("OVERFLOW: allocation spec used %d of %u", used, buflen);
+		return nullptr;
+	}
+
+	buf = skipline(buf, buflen);
+
+	if (buf == nullptr) {
+		debug("no line ending, line is incomplete");
+		return nullptr;
+	}
+
+	if (!MultirotorMixer::geometry_from_name(geomname, geometry)) {
+		debug("unrecognised geometry '%s'", geomname);
+		return nullptr;
+	}
+
+	debug("adding allocation mixer '%s'", geomname);
+
+	return new AllocationMixer(
+		       control_cb,
+		       cb_handle,
+		       geometry,
+		       s[0] / 10000.0f,
+		       s[1] / 10000.0f,
+		       s[2] / 10000.0f,
+		       s[3] / 10000.0f);
+}
+
+AllocationMixer *
+AllocationMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *payload,
+			     unsigned length)
+{
+	MultirotorGeometry geometry;
+	mixer_binary_multirotor_s info;
+
+	if (length != sizeof(info)) {
+		debug("allocation record has %u bytes", length);
+		return nullptr;
+	}
+
+	memcpy(&info, payload, sizeof(info));
+	info.geometry[sizeof(info.geometry) - 1] = '\0';
+
+	if (!MultirotorMixer::geometry_from_name(info.geometry, geometry)) {
+		debug("unrecognised geometry '%s'", info.geometry);
+		return nullptr;
+	}
+
+	return new AllocationMixer(
+		       control_cb,
+		       cb_handle,
+		       geometry,
+		       info.roll_scale,
+		       info.pitch_scale,
+		       info.yaw_scale,
+		       info.idle_speed);
+}
+
+unsigned
+AllocationMixer::mix(float *outputs, unsigned space, uint16_t *status_reg)
+{
+	if (space < _rotor_count) {
+		return 0;
+	}
+
+	const float controls[4] = {
+		get_control(0, 0),
+		get_control(0, 1),
+		get_control(0, 2),
+		get_control(0, 3)
+	};
+
+	mix_controls(controls, outputs, status_reg);
+
+	return _rotor_count;
+}
+
+void
+AllocationMixer::mix_controls(const float controls[4], float *outputs, uint16_t *status_reg) const
+{
+	const unsigned n = _rotor_count;
+	float roll = constrain(controls[0] * _roll_scale, -1.0f, 1.0f);
+	float pitch = constrain(controls[1] * _pitch_scale, -1.0f, 1.0f);
+	float yaw = constrain(controls[2] * _yaw_scale, -1.0f, 1.0f);
+	float thrust = constrain(controls[3], 0.0f, 1.0f);
+	uint16_t status = 0;
+
+	/* thrust may move between 0.6 and 1.5 times the demand, as in MultirotorMixer */
+	const float boost_min = -0.4f * thrust;
+	const float boost_max = 0.5f * thrust;
+
+	float roll_pitch[MAX_ROTORS];
+	float out[MAX_ROTORS];
+
+	for (unsigned i = 0; i < n; i++) {
+		roll_pitch[i] = _roll[i] * roll + _pitch[i] * pitch;
+		out[i] = roll_pitch[i] + _thrust[i] * thrust;
+
+		if (out[i] < 0.0f) {
+			status |= PX4IO_P_STATUS_MIXER_LOWER_LIMIT;
+
+		} else if (out[i] > 1.0f) {
+			status |= PX4IO_P_STATUS_MIXER_UPPER_LIMIT;
+		}
+	}
+
+	/* 1) and 2) fit roll and pitch with thrust first, reduce them only if needed */
+	float boost = 0.0f;
+	float roll_pitch_scale = 1.0f;
+
+	if (status != 0) {
+		boost = minimize_saturation(_thrust, out, n, boost_min, boost_max);
+
+		if (saturated(out, n)) {
+			roll_pitch_scale += minimize_saturation(roll_pitch, out, n, -1.0f, 0.0f);
+			boost += minimize_saturation(_thrust, out, n, boost_min - boost, boost_max - boost);
+		}
+	}
+
+	/* 3) and 4) add yaw, give up some thrust for it, then reduce yaw */
+	float yaw_dir[MAX_ROTORS];
+
+	for (unsigned i = 0; i < n; i++) {
+		yaw_dir[i] = _yaw[i] * yaw;
+		out[i] += yaw_dir[i];
+	}
+
+	float yaw_scale = 1.0f;
+
+	if (saturated(out, n)) {
+		boost += minimize_saturation(_thrust, out, n, -0.15f, 0.0f);
+		yaw_scale += minimize_saturation(yaw_dir, out, n, -1.0f, 0.0f);
+
+		if (yaw_scale < 1.0f) {
+			status |= PX4IO_P_STATUS_MIXER_YAW_LIMIT;
+		}
+	}
+
+	/* the outputs are one product of the allocation matrix with the desaturated controls */
+	roll *= roll_pitch_scale;
+	pitch *= roll_pitch_scale;
+	yaw *= yaw_scale;
+	thrust += boost;
+
+	for (unsigned i = 0; i < n; i++) {
+		float output = _roll[i] * roll + _pitch[i] * pitch + _yaw[i] * yaw + _thrust[i] * thrust;
+
+		/* scale to range idle_speed...1 */
+		outputs[i] = constrain(_idle_speed + (output * (1.0f - _idle_speed)), _idle_speed, 1.0f);
+	}
+
+	if (status_reg != NULL) {
+		*status_reg = status;
+	}
+}
+
+void
+AllocationMixer::mix_n(const float (*controls)[4], float *outputs, unsigned count) const
+{
+	for (unsigned k = 0; k < count; k++) {
+		mix_controls(controls[k], outputs + k * _rotor_count, NULL);
+	}
+}
+
+void
+AllocationMixer::groups_required(uint32_t &groups)
+{
+	/* XXX for now, hardcoded to indexes 0-3 in control group zero */
+	groups |= (1 << 0);
+}
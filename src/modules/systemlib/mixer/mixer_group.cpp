@@ -168,6 +168,10 @@ MixerGroup::load_from_buf(const char *buf, unsigned &buflen)
 			m = MultirotorMixer::from_text(_control_cb, _cb_handle, p, resid);
 			break;
 
+		case 'A':
+			m = AllocationMixer::from_text(_control_cb, _cb_handle, p, resid);
+			break;
+
 		default:
 			/* it's probably junk or whitespace, skip a byte and retry */
 			buflen--;
@@ -200,3 +204,92 @@ MixerGroup::load_from_buf(const char *buf, unsigned &buflen)
 	/* nothing more in the buffer for us now */
 	return ret;
 }
+
+unsigned
+MixerGroup::binary_length(const void *buf)
+{
+	mixer_binary_header_s header;
+
+	memcpy(&header, buf, sizeof(header));
+
+	if ((header.magic != MIXER_BINARY_MAGIC) || (header.version != MIXER_BINARY_VERSION)) {
+		return 0;
+	}
+
+	return sizeof(header) + header.length;
+}
+
+int
+MixerGroup::load_from_bin(const void *buf, unsigned &buflen)
+{
+	int ret = -1;
+	const uint8_t *p = (const uint8_t *)buf;
+	mixer_binary_record_s record;
+
+	/* skip the image header, it is only present at the start */
+	if ((buflen >= 2) && (p[0] == (MIXER_BINARY_MAGIC & 0xff)) && (p[1] == (MIXER_BINARY_MAGIC >> 8))) {
+		if (buflen < sizeof(mixer_binary_header_s)) {
+			return ret;
+		}
+
+		if (binary_length(p) == 0) {
+			debug("unsupported mixer image version %u", p[2]);
+			return ret;
+		}
+
+		p += sizeof(mixer_binary_header_s);
+		buflen -= sizeof(mixer_binary_header_s);
+	}
+
+	/* construct mixers as long as there are complete records */
+	while (buflen >= sizeof(record)) {
+		Mixer *m = nullptr;
+
+		memcpy(&record, p, sizeof(record));
+
+		if (buflen < sizeof(record) + record.length) {
+			break;
+		}
+
+		const uint8_t *payload = p + sizeof(record);
+
+		switch (record.type) {
+		case 'Z':
+			if (record.length == 0) {
+				m = new NullMixer;
+			}
+
+			break;
+
+		case 'M':
+			m = SimpleMixer::from_binary(_control_cb, _cb_handle, payload, record.length);
+			break;
+
+		case 'R':
+			m = MultirotorMixer::from_binary(_control_cb, _cb_handle, payload, record.length);
+			break;
+
+		case 'A':
+			m = AllocationMixer::from_binary(_control_cb, _cb_handle, payload, record.length);
+			break;
+
+		default:
+			debug("unknown mixer record '%c'", record.type);
+			break;
+		}
+
+		if (m == nullptr) {
+			/* unlike text there is no junk to skip, the record is bad */
+			ret = -1;
+			break;
+		}
+
+		add_mixer(m);
+		ret = 0;
+
+		p += sizeof(record) + record.length;
+		buflen -= sizeof(record) + record.length;
+	}
+
+	return ret;
+}
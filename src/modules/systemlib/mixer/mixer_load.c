@@ -58,6 +58,32 @@ int load_mixer_file(const char *fname, char *buf, unsigned maxlen)
 		return -1;
 	}
 
+	/* a precompiled image is passed on as it is */
+	struct mixer_binary_header_s header;
+
+	if ((fread(&header, sizeof(header), 1, fp) == 1) && (header.magic == MIXER_BINARY_MAGIC)) {
+		unsigned length = sizeof(header) + header.length;
+
+		if ((header.version != MIXER_BINARY_VERSION) || (length > maxlen)) {
+			warnx("unsupported mixer image");
+			fclose(fp);
+			return -1;
+		}
+
+		memcpy(buf, &header, sizeof(header));
+
+		if (fread(buf + sizeof(header), 1, header.length, fp) != header.length) {
+			warnx("mixer image truncated");
+			fclose(fp);
+			return -1;
+		}
+
+		fclose(fp);
+		return length;
+	}
+
+	rewind(fp);
+
 	/* read valid lines from the file into a buffer */
 	buf[0] = '\0';
 
@@ -41,9 +41,22 @@
 #define _SYSTEMLIB_MIXER_LOAD_H value
 
 #include <px4_config.h>
+#include <drivers/drv_mixer.h>
 
 __BEGIN_DECLS
 
+/**
+ * Load a mixer file into a buffer.
+ *
+ * Text definitions are compacted and nul-terminated, precompiled images
+ * (see struct mixer_binary_header_s) are copied as they are.
+ *
+ * @param fname			The mixer file.
+ * @param buf			Buffer for the definitions.
+ * @param maxlen		Size of the buffer.
+ * @return			Zero for text, the image length for a precompiled
+ *				image, or -1 on error.
+ */
 __EXPORT int load_mixer_file(const char *fname, char *buf, unsigned maxlen);
 
 __END_DECLS
@@ -99,6 +99,71 @@ MultirotorMixer::~MultirotorMixer()
 {
 }
 
+bool
+MultirotorMixer::geometry_from_name(const char *name, MultirotorGeometry &geometry)
+{
+	if (!strcmp(name, "4+")) {
+		geometry = MultirotorGeometry::QUAD_PLUS;
+
+	} else if (!strcmp(name, "4x")) {
+		geometry = MultirotorGeometry::QUAD_X;
+
+	} else if (!strcmp(name, "4h")) {
+		geometry = MultirotorGeometry::QUAD_H;
+
+	} else if (!strcmp(name, "4v")) {
+		geometry = MultirotorGeometry::QUAD_V;
+
+	} else if (!strcmp(name, "4w")) {
+		geometry = MultirotorGeometry::QUAD_WIDE;
+
+	} else if (!strcmp(name, "4dc")) {
+		geometry = MultirotorGeometry::QUAD_DEADCAT;
+
+	} else if (!strcmp(name, "6+")) {
+		geometry = MultirotorGeometry::HEX_PLUS;
+
+	} else if (!strcmp(name, "6x")) {
+		geometry = MultirotorGeometry::HEX_X;
+
+	} else if (!strcmp(name, "6c")) {
+		geometry = MultirotorGeometry::HEX_COX;
+
+	} else if (!strcmp(name, "8+")) {
+		geometry = MultirotorGeometry::OCTA_PLUS;
+
+	} else if (!strcmp(name, "8x")) {
+		geometry = MultirotorGeometry::OCTA_X;
+
+	} else if (!strcmp(name, "8c")) {
+		geometry = MultirotorGeometry::OCTA_COX;
+
+#if 0
+
+	} else if (!strcmp(name, "8cw")) {
+		geometry = MultirotorGeometry::OCTA_COX_WIDE;
+#endif
+
+	} else if (!strcmp(name, "2-")) {
+		geometry = MultirotorGeometry::TWIN_ENGINE;
+
+	} else if (!strcmp(name, "3y")) {
+		geometry = MultirotorGeometry::TRI_Y;
+
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+const MultirotorMixer::Rotor *
+MultirotorMixer::get_rotors(MultirotorGeometry geometry, unsigned &rotor_count)
+{
+	rotor_count = _config_rotor_count[(MultirotorGeometryUnderlyingType)geometry];
+	return _config_index[(MultirotorGeometryUnderlyingType)geometry];
+}
+
 MultirotorMixer *
 MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen)
 {
@@ -144,55 +209,7 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 
 	debug("remaining in buf: %d, first char: %c", buflen, buf[0]);
 
-	if (!strcmp(geomname, "4+")) {
-		geometry = MultirotorGeometry::QUAD_PLUS;
-
-	} else if (!strcmp(geomname, "4x")) {
-		geometry = MultirotorGeometry::QUAD_X;
-
-	} else if (!strcmp(geomname, "4h")) {
-		geometry = MultirotorGeometry::QUAD_H;
-
-	} else if (!strcmp(geomname, "4v")) {
-		geometry = MultirotorGeometry::QUAD_V;
-
-	} else if (!strcmp(geomname, "4w")) {
-		geometry = MultirotorGeometry::QUAD_WIDE;
-
-	} else if (!strcmp(geomname, "4dc")) {
-		geometry = MultirotorGeometry::QUAD_DEADCAT;
-
-	} else if (!strcmp(geomname, "6+")) {
-		geometry = MultirotorGeometry::HEX_PLUS;
-
-	} else if (!strcmp(geomname, "6x")) {
-		geometry = MultirotorGeometry::HEX_X;
-
-	} else if (!strcmp(geomname, "6c")) {
-		geometry = MultirotorGeometry::HEX_COX;
-
-	} else if (!strcmp(geomname, "8+")) {
-		geometry = MultirotorGeometry::OCTA_PLUS;
-
-	} else if (!strcmp(geomname, "8x")) {
-		geometry = MultirotorGeometry::OCTA_X;
-
-	} else if (!strcmp(geomname, "8c")) {
-		geometry = MultirotorGeometry::OCTA_COX;
-
-#if 0
-
-	} else if (!strcmp(geomname, "8cw")) {
-		geometry = MultirotorGeometry::OCTA_COX_WIDE;
-#endif
-
-	} else if (!strcmp(geomname, "2-")) {
-		geometry = MultirotorGeometry::TWIN_ENGINE;
-
-	} else if (!strcmp(geomname, "3y")) {
-		geometry = MultirotorGeometry::TRI_Y;
-
-	} else {
+	if (!geometry_from_name(geomname, geometry)) {
 		debug("unrecognised geometry '%s'", geomname);
 		return nullptr;
 	}
@@ -209,6 +226,39 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 		       s[3] / 10000.0f);
 }
 
+MultirotorMixer *
+MultirotorMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *payload,
+			     unsigned length)
+{
+	MultirotorGeometry geometry;
+	mixer_binary_multirotor_s info;
+
+	if (length != sizeof(info)) {
+		debug("multirotor record has %u bytes", length);
+		return nullptr;
+	}
+
+	/* copy out, the record is not aligned */
+	memcpy(&info, payload, sizeof(info));
+	info.geometry[sizeof(info.geometry) - 1] = '\0';
+
+	if (!geometry_from_name(info.geometry, geometry)) {
+		debug("unrecognised geometry '%s'", info.geometry);
+		return nullptr;
+	}
+
+	debug("adding multirotor mixer '%s'", info.geometry);
+
+	return new MultirotorMixer(
+		       control_cb,
+		       cb_handle,
+		       geometry,
+		       info.roll_scale,
+		       info.pitch_scale,
+		       info.yaw_scale,
+		       info.idle_speed);
+}
+
 unsigned
 MultirotorMixer::mix(float *outputs, unsigned space, uint16_t *status_reg)
 {
@@ -212,6 +212,58 @@ out:
 	return sm;
 }
 
+SimpleMixer *
+SimpleMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *payload,
+			 unsigned length)
+{
+	SimpleMixer *sm = nullptr;
+	mixer_simple_s *mixinfo = nullptr;
+	mixer_binary_simple_s info;
+	mixer_binary_control_s control;
+
+	if (length < sizeof(info)) {
+		debug("simple record too short");
+		return nullptr;
+	}
+
+	/* copy out, the record is not aligned */
+	memcpy(&info, payload, sizeof(info));
+	payload += sizeof(info);
+
+	if (length != sizeof(info) + info.control_count * sizeof(control)) {
+		debug("simple record has %u bytes for %u inputs", length, info.control_count);
+		return nullptr;
+	}
+
+	mixinfo = (mixer_simple_s *)malloc(MIXER_SIMPLE_SIZE(info.control_count));
+
+	if (mixinfo == nullptr) {
+		debug("could not allocate memory for mixer info");
+		return nullptr;
+	}
+
+	mixinfo->control_count = info.control_count;
+	mixinfo->output_scaler = info.output_scaler;
+
+	for (unsigned i = 0; i < info.control_count; i++) {
+		memcpy(&control, payload, sizeof(control));
+		payload += sizeof(control);
+
+		mixinfo->controls[i].control_group = control.control_group;
+		mixinfo->controls[i].control_index = control.control_index;
+		mixinfo->controls[i].scaler = control.scaler;
+	}
+
+	sm = new SimpleMixer(control_cb, cb_handle, mixinfo);
+
+	if (sm == nullptr) {
+		debug("could not allocate memory for mixer");
+		free(mixinfo);
+	}
+
+	return sm;
+}
+
 SimpleMixer *
 SimpleMixer::pwm_input(Mixer::ControlCallback control_cb, uintptr_t cb_handle, unsigned input, uint16_t min,
 		       uint16_t mid, uint16_t max)
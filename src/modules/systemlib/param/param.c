@@ -54,6 +54,7 @@
 #include <systemlib/err.h>
 #include <errno.h>
 #include <semaphore.h>
+#include <pthread.h>
 
 #include <sys/stat.h>
 
@@ -112,8 +113,18 @@ struct param_wbuf_s {
 	param_t			param;
 	union param_value_u	val;
 	bool			unsaved;
+	uint32_t		generation;	/**< value of param_change_generation when last changed */
 };
 
+/** incremented on every parameter change */
+static uint32_t param_change_generation = 0;
+
+/** generation of the last reset, resets drop the per parameter generation */
+static uint32_t param_reset_generation = 0;
+
+
+/** protects param_values and the generations against concurrent access */
+static pthread_mutex_t param_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 uint8_t  *param_changed_storage = 0;
 int size_param_changed_storage_bytes = 0;
@@ -124,16 +135,24 @@ static unsigned
 get_param_info_count(void)
 {
 	/* Singleton creation of and array of bits to track changed values */
-	if (!param_changed_storage) {
+	if (!__atomic_load_n(&param_changed_storage, __ATOMIC_ACQUIRE)) {
 		size_param_changed_storage_bytes  = (param_info_count / bits_per_allocation_unit) + 1;
-		param_changed_storage = calloc(size_param_changed_storage_bytes, 1);
+		uint8_t *storage = calloc(size_param_changed_storage_bytes, 1);
 
 		/* If the allocation fails we need to indicate failure in the
 		 * API by returning PARAM_INVALID
 		 */
-		if (param_changed_storage == NULL) {
+		if (storage == NULL) {
 			return 0;
 		}
+
+		/* another thread may have been first */
+		uint8_t *expected = NULL;
+
+		if (!__atomic_compare_exchange_n(&param_changed_storage, &expected, storage, false,
+						 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			free(storage);
+		}
 	}
 
 	return param_info_count;
@@ -159,14 +178,14 @@ static param_t param_find_internal(const char *name, bool notification);
 static void
 param_lock(void)
 {
-	//do {} while (px4_sem_wait(&param_sem) != 0);
+	pthread_mutex_lock(&param_mutex);
 }
 
 /** unlock the parameter store */
 static void
 param_unlock(void)
 {
-	//px4_sem_post(&param_sem);
+	pthread_mutex_unlock(&param_mutex);
 }
 
 /** assert that the parameter store is locked */
@@ -413,15 +432,22 @@ param_name(param_t param)
 bool
 param_value_is_default(param_t param)
 {
-	return param_find_changed(param) ? false : true;
+	param_lock();
+	bool is_default = param_find_changed(param) ? false : true;
+	param_unlock();
+
+	return is_default;
 }
 
 bool
 param_value_unsaved(param_t param)
 {
-	static struct param_wbuf_s *s;
-	s = param_find_changed(param);
-	return (s && s->unsaved) ? true : false;
+	param_lock();
+	struct param_wbuf_s *s = param_find_changed(param);
+	bool unsaved = (s && s->unsaved) ? true : false;
+	param_unlock();
+
+	return unsaved;
 }
 
 enum param_type_e
@@ -540,9 +566,15 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 			struct param_wbuf_s buf = {
 				.param = param,
 				.val.p = NULL,
-				.unsaved = false
+				.unsaved = false,
+				.generation = 0
 			};
 
+			/* start from the default, the change check below compares against it */
+			if (param_type(param) < PARAM_TYPE_STRUCT) {
+				buf.val = param_info_base[param].val;
+			}
+
 			/* add it to the array and sort */
 			utarray_push_back(param_values, &buf);
 			utarray_sort(param_values, param_compare_values);
@@ -583,6 +615,10 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		}
 
 		s->unsaved = !mark_saved;
+
+		if (params_changed) {
+			s->generation = ++param_change_generation;
+		}
 		result = 0;
 	}
 
@@ -652,8 +688,9 @@ void param_set_used_internal(param_t param)
 		return;
 	}
 
-	param_changed_storage[param_index / bits_per_allocation_unit] |=
-		(1 << param_index % bits_per_allocation_unit);
+	/* modules look up their parameters concurrently */
+	__atomic_fetch_or(&param_changed_storage[param_index / bits_per_allocation_unit],
+			  (uint8_t)(1 << param_index % bits_per_allocation_unit), __ATOMIC_RELAXED);
 }
 
 int
@@ -673,6 +710,7 @@ param_reset(param_t param)
 		if (s != NULL) {
 			int pos = utarray_eltidx(param_values, s);
 			utarray_erase(param_values, pos, 1);
+			param_reset_generation = ++param_change_generation;
 		}
 
 		param_found = true;
@@ -698,6 +736,7 @@ param_reset_all(void)
 
 	/* mark as reset / deleted */
 	param_values = NULL;
+	param_reset_generation = ++param_change_generation;
 
 	param_unlock();
 
@@ -707,8 +746,6 @@ param_reset_all(void)
 void
 param_reset_excludes(const char *excludes[], int num_excludes)
 {
-	param_lock();
-
 	param_t	param;
 
 	for (param = 0; handle_in_range(param); param++) {
@@ -731,8 +768,6 @@ param_reset_excludes(const char *excludes[], int num_excludes)
 		}
 	}
 
-	param_unlock();
-
 	param_notify_changes(false);
 }
 
@@ -899,7 +934,7 @@ param_export(int fd, bool only_unsaved)
 		switch (param_type(s->param)) {
 
 		case PARAM_TYPE_INT32: {
-				param_get(s->param, &i);
+				i = s->val.i;
 				const char *name = param_name(s->param);
 
 				/* lock as short as possible */
@@ -915,7 +950,7 @@ param_export(int fd, bool only_unsaved)
 
 		case PARAM_TYPE_FLOAT: {
 
-				param_get(s->param, &f);
+				f = s->val.f;
 				const char *name = param_name(s->param);
 
 				/* lock as short as possible */
@@ -1142,7 +1177,7 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 	for (param = 0; handle_in_range(param); param++) {
 
 		/* if requested, skip unchanged values */
-		if (only_changed && (param_find_changed(param) == NULL)) {
+		if (only_changed && param_value_is_default(param)) {
 			continue;
 		}
 
@@ -1154,6 +1189,33 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 	}
 }
 
+uint32_t
+param_generation(void)
+{
+	return param_change_generation;
+}
+
+bool
+param_changed_since(param_t param, uint32_t generation)
+{
+	bool changed;
+
+	param_lock();
+
+	/* a reset does not leave a trace per parameter, consider all changed */
+	if (param_reset_generation > generation) {
+		changed = true;
+
+	} else {
+		struct param_wbuf_s *s = param_find_changed(param);
+		changed = (s != NULL && s->generation > generation);
+	}
+
+	param_unlock();
+
+	return changed;
+}
+
 uint32_t param_hash_check(void)
 {
 	uint32_t param_hash = 0;
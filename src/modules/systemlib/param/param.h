@@ -355,6 +355,25 @@ __EXPORT int 		param_load_default(void);
  */
 __EXPORT uint32_t	param_hash_check(void);
 
+/**
+ * Get the current parameter change generation.
+ *
+ * The generation is incremented on every parameter change and starts
+ * from zero on every boot.
+ *
+ * @return		The current generation.
+ */
+__EXPORT uint32_t	param_generation(void);
+
+/**
+ * Test whether a parameter changed after a given generation.
+ *
+ * @param param		A handle returned by param_find or passed by param_foreach.
+ * @param generation	A generation previously returned by param_generation.
+ * @return		True if the parameter changed after generation.
+ */
+__EXPORT bool		param_changed_since(param_t param, uint32_t generation);
+
 /*
  * Macros creating static parameter definitions.
  *
@@ -44,6 +44,8 @@
 //#include <debug.h>
 #include <px4_defines.h>
 #include <px4_posix.h>
+#include <float.h>
+#include <math.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -99,8 +101,15 @@ struct param_wbuf_s {
 	param_t			param;
 	union param_value_u	val;
 	bool			unsaved;
+	uint32_t		generation;	/**< value of param_change_generation when last changed */
 };
 
+/** incremented on every parameter change */
+static uint32_t param_change_generation = 0;
+
+/** generation of the last reset, resets drop the per parameter generation */
+static uint32_t param_reset_generation = 0;
+
 
 uint8_t  *param_changed_storage = 0;
 int size_param_changed_storage_bytes = 0;
@@ -557,6 +566,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 {
 	int result = -1;
 	bool params_changed = false;
+	bool value_changed = false;
 
 	PX4_DEBUG("param_set_internal params: param = %d, val = 0x%X, mark_saved: %d, notify_changes: %d",
 		  param, val, (int)mark_saved, (int)notify_changes);
@@ -588,9 +598,15 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 			struct param_wbuf_s buf = {
 				.param = param,
 				.val.p = NULL,
-				.unsaved = false
+				.unsaved = false,
+				.generation = 0
 			};
 
+			/* start from the default, the change check below compares against it */
+			if (param_type(param) < PARAM_TYPE_STRUCT) {
+				buf.val = param_info_base[param].val;
+			}
+
 			/* add it to the array and sort */
 			utarray_push_back(param_values, &buf);
 			utarray_sort(param_values, param_compare_values);
@@ -603,10 +619,12 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32:
+			value_changed = s->val.i != *(int32_t *)val;
 			s->val.i = *(int32_t *)val;
 			break;
 
 		case PARAM_TYPE_FLOAT:
+			value_changed = fabsf(s->val.f - * (float *)val) > FLT_EPSILON;
 			s->val.f = *(float *)val;
 			break;
 
@@ -621,6 +639,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 			}
 
 			memcpy(s->val.p, val, param_size(param));
+			value_changed = true;
 			break;
 
 		default:
@@ -628,6 +647,12 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		}
 
 		s->unsaved = !mark_saved;
+
+		/* same rule as param.c, setting the current value again is not a change */
+		if (value_changed) {
+			s->generation = ++param_change_generation;
+		}
+
 		params_changed = true;
 		result = 0;
 	}
@@ -732,6 +757,7 @@ param_reset(param_t param)
 		if (s != NULL) {
 			int pos = utarray_eltidx(param_values, s);
 			utarray_erase(param_values, pos, 1);
+			param_reset_generation = ++param_change_generation;
 		}
 
 		param_found = true;
@@ -757,6 +783,7 @@ param_reset_all(void)
 
 	/* mark as reset / deleted */
 	param_values = NULL;
+	param_reset_generation = ++param_change_generation;
 
 	param_unlock();
 
@@ -1205,6 +1232,33 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 	}
 }
 
+uint32_t
+param_generation(void)
+{
+	return param_change_generation;
+}
+
+bool
+param_changed_since(param_t param, uint32_t generation)
+{
+	bool changed;
+
+	param_lock();
+
+	/* a reset does not leave a trace per parameter, consider all changed */
+	if (param_reset_generation > generation) {
+		changed = true;
+
+	} else {
+		struct param_wbuf_s *s = param_find_changed(param);
+		changed = (s != NULL && s->generation > generation);
+	}
+
+	param_unlock();
+
+	return changed;
+}
+
 uint32_t param_hash_check(void)
 {
 	uint32_t param_hash = 0;
@@ -40,6 +40,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include <sys/queue.h>
 #include <drivers/drv_hrt.h>
 #include <math.h>
@@ -50,13 +51,52 @@
 #define dprintf(_fd, _text, ...) ((_fd) == 1 ? PX4_INFO((_text), ##__VA_ARGS__) : (void)(_fd))
 #endif
 
+/*
+ * Counter updates do not take a lock. PC_COUNT and PC_HISTOGRAM counters
+ * can be updated from several threads and use atomic operations where the
+ * platform has them; NuttX targets are single core and lack 64 bit atomics,
+ * so plain updates are used there as before. PC_ELAPSED and PC_INTERVAL
+ * counters are expected to be updated by a single thread.
+ */
+#if defined(__PX4_NUTTX)
+#define perf_atomic_add(_ptr, _val)	(*(_ptr) += (_val))
+#define perf_atomic_cas(_ptr, _old, _new)	((*(_ptr) == (_old)) ? (*(_ptr) = (_new), true) : false)
+#else
+#define perf_atomic_add(_ptr, _val)	__atomic_fetch_add((_ptr), (_val), __ATOMIC_RELAXED)
+#define perf_atomic_cas(_ptr, _old, _new)	__atomic_compare_exchange_n((_ptr), &(_old), (_new), false, \
+		__ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#endif
+
+/*
+ * On POSIX each counter gets its own cache lines so that counters updated
+ * from different cores do not contend.
+ */
+#if defined(__PX4_NUTTX) || defined(__PX4_QURT)
+#define PERF_CACHE_LINE		1
+#else
+#define PERF_CACHE_LINE		64
+#endif
+
+/*
+ * Histogram buckets: values below PERF_HIST_SUB_COUNT us get a bucket each,
+ * above that every power of two is split into PERF_HIST_SUB_COUNT buckets,
+ * giving a relative resolution of 25%. The last bucket collects all values
+ * from about 33 s.
+ */
+#define PERF_HIST_SUB_BITS	2
+#define PERF_HIST_SUB_COUNT	(1 << PERF_HIST_SUB_BITS)
+#define PERF_HIST_OCTAVES	24
+#define PERF_HIST_BUCKETS	((PERF_HIST_OCTAVES + 1) * PERF_HIST_SUB_COUNT)
+
 /**
  * Header common to all counters.
  */
 struct perf_ctr_header {
-	sq_entry_t		link;	/**< list linkage */
-	enum perf_counter_type	type;	/**< counter type */
-	const char		*name;	/**< counter name */
+	sq_entry_t		link;		/**< list linkage */
+	enum perf_counter_type	type;		/**< counter type */
+	const char		*name;		/**< counter name */
+	uint32_t		name_hash;	/**< hash of the name for perf_alloc_once */
+	uint32_t		generation;	/**< reset generation the values belong to */
 };
 
 /**
@@ -97,39 +137,214 @@ struct perf_ctr_interval {
 	float			M2;
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ */
+struct perf_ctr_histogram {
+	struct perf_ctr_header	hdr;
+	uint64_t		event_count;
+	uint64_t		event_overruns;
+	uint64_t		time_start;
+	uint64_t		time_total;
+	uint64_t		time_most;
+	uint32_t		buckets[PERF_HIST_BUCKETS];
+};
+
 /**
  * List of all known counters.
  */
 static sq_queue_t	perf_counters;
+static pthread_mutex_t	perf_counters_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/**
+ * Incremented by perf_reset_all(). Counters of an older generation are
+ * reset by their next update, and read as zero until then. The reset is
+ * lossy for counters with several writers: an update from another thread
+ * that lands while the first writer clears the counter is lost.
+ */
+static volatile uint32_t	perf_generation;
 
-perf_counter_t
-perf_alloc(enum perf_counter_type type, const char *name)
+static size_t
+perf_size(enum perf_counter_type type)
 {
-	perf_counter_t ctr = NULL;
-
 	switch (type) {
 	case PC_COUNT:
-		ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_count), 1);
-		break;
+		return sizeof(struct perf_ctr_count);
 
 	case PC_ELAPSED:
-		ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_elapsed), 1);
-		break;
+		return sizeof(struct perf_ctr_elapsed);
 
 	case PC_INTERVAL:
-		ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_interval), 1);
+		return sizeof(struct perf_ctr_interval);
 
-		break;
+	case PC_HISTOGRAM:
+		return sizeof(struct perf_ctr_histogram);
 
 	default:
-		break;
+		return 0;
+	}
+}
+
+static uint32_t
+perf_hash(const char *name)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+
+	while (*name != '\0') {
+		hash ^= (uint8_t) * name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+ * Reset the values of a counter, leaving the header intact.
+ */
+static void
+perf_clear(perf_counter_t handle)
+{
+	size_t size = perf_size(handle->type);
+
+	if (size > sizeof(struct perf_ctr_header)) {
+		memset((uint8_t *)handle + sizeof(struct perf_ctr_header), 0, size - sizeof(struct perf_ctr_header));
+	}
+}
+
+/**
+ * Bring a counter to the current reset generation before updating it.
+ * Only the writer that claims the new generation clears the counter.
+ */
+static inline void
+perf_sync(perf_counter_t handle)
+{
+	uint32_t generation = perf_generation;
+	uint32_t seen = handle->generation;
+
+	if (seen != generation && perf_atomic_cas(&handle->generation, seen, generation)) {
+		perf_clear(handle);
+	}
+}
+
+static unsigned
+perf_hist_index(uint64_t value)
+{
+	if (value < PERF_HIST_SUB_COUNT) {
+		return value;
+	}
+
+	if (value > UINT32_MAX) {
+		return PERF_HIST_BUCKETS - 1;
+	}
+
+	unsigned msb = 31 - __builtin_clz((uint32_t)value);
+	unsigned octave = msb - PERF_HIST_SUB_BITS + 1;
+	unsigned sub = (value >> (msb - PERF_HIST_SUB_BITS)) & (PERF_HIST_SUB_COUNT - 1);
+	unsigned index = octave * PERF_HIST_SUB_COUNT + sub;
+
+	return (index < PERF_HIST_BUCKETS) ? index : PERF_HIST_BUCKETS - 1;
+}
+
+/**
+ * Smallest value that falls into the bucket after index.
+ */
+static uint64_t
+perf_hist_upper(unsigned index)
+{
+	index++;
+
+	if (index < PERF_HIST_SUB_COUNT) {
+		return index;
+	}
+
+	unsigned octave = index / PERF_HIST_SUB_COUNT;
+	unsigned sub = index % PERF_HIST_SUB_COUNT;
+
+	return (uint64_t)(PERF_HIST_SUB_COUNT + sub) << (octave - 1);
+}
+
+/**
+ * Value below which the given percentage of the recorded events fall,
+ * to the resolution of the buckets.
+ */
+static uint64_t
+perf_hist_percentile(const struct perf_ctr_histogram *pch, unsigned percent)
+{
+	if (pch->event_count == 0) {
+		return 0;
+	}
+
+	uint64_t target = (pch->event_count * percent + 99) / 100;
+	uint64_t seen = 0;
+
+	for (unsigned i = 0; i < PERF_HIST_BUCKETS; i++) {
+		seen += pch->buckets[i];
+
+		if (seen >= target) {
+			uint64_t upper = perf_hist_upper(i) - 1;
+			return (upper < pch->time_most) ? upper : pch->time_most;
+		}
+	}
+
+	return pch->time_most;
+}
+
+static void
+perf_hist_record(struct perf_ctr_histogram *pch, uint64_t elapsed)
+{
+	perf_atomic_add(&pch->buckets[perf_hist_index(elapsed)], 1);
+	perf_atomic_add(&pch->time_total, elapsed);
+	perf_atomic_add(&pch->event_count, 1);
+
+#if defined(__PX4_NUTTX)
+
+	if (pch->time_most < elapsed) {
+		pch->time_most = elapsed;
+	}
+
+#else
+	uint64_t most = __atomic_load_n(&pch->time_most, __ATOMIC_RELAXED);
+
+	while (most < elapsed &&
+	       !__atomic_compare_exchange_n(&pch->time_most, &most, elapsed, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 	}
 
+#endif
+}
+
+perf_counter_t
+perf_alloc(enum perf_counter_type type, const char *name)
+{
+	perf_counter_t ctr = NULL;
+	size_t size = perf_size(type);
+
+	if (size == 0) {
+		return NULL;
+	}
+
+#if PERF_CACHE_LINE > 1
+	void *mem = NULL;
+	size = (size + PERF_CACHE_LINE - 1) & ~(size_t)(PERF_CACHE_LINE - 1);
+
+	if (posix_memalign(&mem, PERF_CACHE_LINE, size) == 0) {
+		memset(mem, 0, size);
+		ctr = (perf_counter_t)mem;
+	}
+
+#else
+	ctr = (perf_counter_t)calloc(size, 1);
+#endif
+
 	if (ctr != NULL) {
 		ctr->type = type;
 		ctr->name = name;
+		ctr->name_hash = perf_hash(name);
+		ctr->generation = perf_generation;
+
+		pthread_mutex_lock(&perf_counters_mutex);
 		sq_addfirst(&ctr->link, &perf_counters);
+		pthread_mutex_unlock(&perf_counters_mutex);
 	}
 
 	return ctr;
@@ -138,10 +353,16 @@ perf_alloc(enum perf_counter_type type, const char *name)
 perf_counter_t
 perf_alloc_once(enum perf_counter_type type, const char *name)
 {
+	uint32_t hash = perf_hash(name);
+
+	pthread_mutex_lock(&perf_counters_mutex);
+
 	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
 
 	while (handle != NULL) {
-		if (!strcmp(handle->name, name)) {
+		if (handle->name_hash == hash && !strcmp(handle->name, name)) {
+			pthread_mutex_unlock(&perf_counters_mutex);
+
 			if (type == handle->type) {
 				/* they are the same counter */
 				return handle;
@@ -155,6 +376,8 @@ perf_alloc_once(enum perf_counter_type type, const char *name)
 		handle = (perf_counter_t)sq_next(&handle->link);
 	}
 
+	pthread_mutex_unlock(&perf_counters_mutex);
+
 	/* if the execution reaches here, no existing counter of that name was found */
 	return perf_alloc(type, name);
 }
@@ -166,7 +389,10 @@ perf_free(perf_counter_t handle)
 		return;
 	}
 
+	pthread_mutex_lock(&perf_counters_mutex);
 	sq_rem(&handle->link, &perf_counters);
+	pthread_mutex_unlock(&perf_counters_mutex);
+
 	free(handle);
 }
 
@@ -177,9 +403,11 @@ perf_count(perf_counter_t handle)
 		return;
 	}
 
+	perf_sync(handle);
+
 	switch (handle->type) {
 	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count++;
+		perf_atomic_add(&((struct perf_ctr_count *)handle)->event_count, 1);
 		break;
 
 	case PC_INTERVAL: {
@@ -236,11 +464,17 @@ perf_begin(perf_counter_t handle)
 		return;
 	}
 
+	perf_sync(handle);
+
 	switch (handle->type) {
 	case PC_ELAPSED:
 		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
 		break;
 
+	case PC_HISTOGRAM:
+		((struct perf_ctr_histogram *)handle)->time_start = hrt_absolute_time();
+		break;
+
 	default:
 		break;
 	}
@@ -253,6 +487,8 @@ perf_end(perf_counter_t handle)
 		return;
 	}
 
+	perf_sync(handle);
+
 	switch (handle->type) {
 	case PC_ELAPSED: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
@@ -289,6 +525,23 @@ perf_end(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (pch->time_start != 0) {
+				int64_t elapsed = hrt_absolute_time() - pch->time_start;
+
+				if (elapsed < 0) {
+					perf_atomic_add(&pch->event_overruns, 1);
+
+				} else {
+					perf_hist_record(pch, elapsed);
+					pch->time_start = 0;
+				}
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -303,6 +556,8 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 		return;
 	}
 
+	perf_sync(handle);
+
 	switch (handle->type) {
 	case PC_ELAPSED: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
@@ -335,6 +590,18 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (elapsed < 0) {
+				perf_atomic_add(&pch->event_overruns, 1);
+
+			} else {
+				perf_hist_record(pch, elapsed);
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -347,6 +614,8 @@ perf_set_count(perf_counter_t handle, uint64_t count)
 		return;
 	}
 
+	perf_sync(handle);
+
 	switch (handle->type) {
 	case PC_COUNT: {
 			((struct perf_ctr_count *)handle)->event_count = count;
@@ -374,6 +643,13 @@ perf_cancel(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			pch->time_start = 0;
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -388,34 +664,43 @@ perf_reset(perf_counter_t handle)
 		return;
 	}
 
-	switch (handle->type) {
-	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count = 0;
-		break;
+	perf_clear(handle);
+	handle->generation = perf_generation;
+}
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			pce->event_count = 0;
-			pce->time_start = 0;
-			pce->time_total = 0;
-			pce->time_least = 0;
-			pce->time_most = 0;
-			break;
-		}
+/**
+ * Take a copy of a counter for printing. A counter that has not been
+ * updated since the last perf_reset_all() is returned cleared.
+ *
+ * @return		false if the counter type is unknown
+ */
+static bool
+perf_snapshot(perf_counter_t handle, void *copy)
+{
+	size_t size = perf_size(handle->type);
 
-	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
-			pci->event_count = 0;
-			pci->time_event = 0;
-			pci->time_first = 0;
-			pci->time_last = 0;
-			pci->time_least = 0;
-			pci->time_most = 0;
-			break;
-		}
+	if (size == 0) {
+		return false;
+	}
+
+	memcpy(copy, handle, size);
+
+	if (handle->generation != perf_generation) {
+		perf_clear((perf_counter_t)copy);
 	}
+
+	return true;
 }
 
+/* large enough for any counter type */
+union perf_ctr_any {
+	struct perf_ctr_header		hdr;
+	struct perf_ctr_count		count;
+	struct perf_ctr_elapsed		elapsed;
+	struct perf_ctr_interval	interval;
+	struct perf_ctr_histogram	histogram;
+};
+
 void
 perf_print_counter(perf_counter_t handle)
 {
@@ -429,7 +714,9 @@ perf_print_counter(perf_counter_t handle)
 void
 perf_print_counter_fd(int fd, perf_counter_t handle)
 {
-	if (handle == NULL) {
+	union perf_ctr_any ctr;
+
+	if (handle == NULL || !perf_snapshot(handle, &ctr)) {
 		return;
 	}
 
@@ -437,11 +724,11 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 	case PC_COUNT:
 		dprintf(fd, "%s: %llu events\n",
 			handle->name,
-			(unsigned long long)((struct perf_ctr_count *)handle)->event_count);
+			(unsigned long long)ctr.count.event_count);
 		break;
 
 	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+			struct perf_ctr_elapsed *pce = &ctr.elapsed;
 			float rms = sqrtf(pce->M2 / (pce->event_count - 1));
 			dprintf(fd, "%s: %llu events, %llu overruns, %lluus elapsed, %lluus avg, min %lluus max %lluus %5.3fus rms\n",
 				handle->name,
@@ -456,7 +743,7 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 		}
 
 	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
+			struct perf_ctr_interval *pci = &ctr.interval;
 			float rms = sqrtf(pci->M2 / (pci->event_count - 1));
 
 			dprintf(fd, "%s: %llu events, %lluus avg, min %lluus max %lluus %5.3fus rms\n",
@@ -469,15 +756,114 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = &ctr.histogram;
+
+			dprintf(fd, "%s: %llu events, %llu overruns, %lluus avg, p50 %lluus p99 %lluus max %lluus\n",
+				handle->name,
+				(unsigned long long)pch->event_count,
+				(unsigned long long)pch->event_overruns,
+				(pch->event_count == 0) ? 0 : (unsigned long long)pch->time_total / pch->event_count,
+				(unsigned long long)perf_hist_percentile(pch, 50),
+				(unsigned long long)perf_hist_percentile(pch, 99),
+				(unsigned long long)pch->time_most);
+			break;
+		}
+
+	default:
+		break;
+	}
+}
+
+/**
+ * Reduce a snapshot of a counter to the values common to all counter types.
+ */
+static void
+perf_summarize(perf_counter_t handle, const union perf_ctr_any *ctr, struct perf_counter_summary *summary)
+{
+	memset(summary, 0, sizeof(*summary));
+	summary->name = handle->name;
+	summary->type = handle->type;
+
+	switch (handle->type) {
+	case PC_COUNT:
+		summary->event_count = ctr->count.event_count;
+		break;
+
+	case PC_ELAPSED:
+		summary->event_count = ctr->elapsed.event_count;
+		summary->event_overruns = ctr->elapsed.event_overruns;
+		summary->time_total = ctr->elapsed.time_total;
+		summary->time_least = ctr->elapsed.time_least;
+		summary->time_most = ctr->elapsed.time_most;
+		summary->rms = (summary->event_count > 1) ?
+			       1e6f * sqrtf(ctr->elapsed.M2 / (summary->event_count - 1)) : 0.0f;
+		break;
+
+	case PC_INTERVAL:
+		summary->event_count = ctr->interval.event_count;
+		summary->time_total = ctr->interval.time_last - ctr->interval.time_first;
+		summary->time_least = ctr->interval.time_least;
+		summary->time_most = ctr->interval.time_most;
+		summary->rms = (summary->event_count > 1) ?
+			       1e6f * sqrtf(ctr->interval.M2 / (summary->event_count - 1)) : 0.0f;
+		break;
+
+	case PC_HISTOGRAM:
+		summary->event_count = ctr->histogram.event_count;
+		summary->event_overruns = ctr->histogram.event_overruns;
+		summary->time_total = ctr->histogram.time_total;
+		summary->time_most = ctr->histogram.time_most;
+		summary->p50 = perf_hist_percentile(&ctr->histogram, 50);
+		summary->p99 = perf_hist_percentile(&ctr->histogram, 99);
+		break;
+
 	default:
 		break;
 	}
+
+	summary->time_avg = (summary->event_count == 0) ? 0 : summary->time_total / summary->event_count;
+}
+
+/**
+ * Print one counter as a CSV record, see perf_dump_all().
+ */
+static void
+perf_dump_counter_fd(int fd, perf_counter_t handle)
+{
+	union perf_ctr_any ctr;
+	struct perf_counter_summary summary;
+
+	if (!perf_snapshot(handle, &ctr)) {
+		return;
+	}
+
+	perf_summarize(handle, &ctr, &summary);
+
+	static const char *const type_names[] = { "count", "elapsed", "interval", "histogram" };
+
+	dprintf(fd, "%s,%s,%llu,%llu,%llu,%llu,%llu,%llu,%.3f,%llu,%llu\n",
+		summary.name,
+		type_names[summary.type],
+		(unsigned long long)summary.event_count,
+		(unsigned long long)summary.event_overruns,
+		(unsigned long long)summary.time_total,
+		(unsigned long long)summary.time_least,
+		(unsigned long long)summary.time_most,
+		(unsigned long long)summary.time_avg,
+		(double)summary.rms,
+		(unsigned long long)summary.p50,
+		(unsigned long long)summary.p99);
 }
 
+/*
+ * The single value getters are called by drivers from the HRT callout, so
+ * they read the counter in place instead of taking a snapshot.
+ */
 uint64_t
 perf_event_count(perf_counter_t handle)
 {
-	if (handle == NULL) {
+	if (handle == NULL || handle->generation != perf_generation) {
 		return 0;
 	}
 
@@ -485,15 +871,14 @@ perf_event_count(perf_counter_t handle)
 	case PC_COUNT:
 		return ((struct perf_ctr_count *)handle)->event_count;
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			return pce->event_count;
-		}
+	case PC_ELAPSED:
+		return ((struct perf_ctr_elapsed *)handle)->event_count;
 
-	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
-			return pci->event_count;
-		}
+	case PC_INTERVAL:
+		return ((struct perf_ctr_interval *)handle)->event_count;
+
+	case PC_HISTOGRAM:
+		return ((struct perf_ctr_histogram *)handle)->event_count;
 
 	default:
 		break;
@@ -502,15 +887,68 @@ perf_event_count(perf_counter_t handle)
 	return 0;
 }
 
+uint64_t
+perf_percentile(perf_counter_t handle, unsigned percent)
+{
+	if (handle == NULL || handle->type != PC_HISTOGRAM || handle->generation != perf_generation) {
+		return 0;
+	}
+
+	return perf_hist_percentile((struct perf_ctr_histogram *)handle, (percent > 100) ? 100 : percent);
+}
+
 void
 perf_print_all(int fd)
 {
+	pthread_mutex_lock(&perf_counters_mutex);
+
 	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
 
 	while (handle != NULL) {
 		perf_print_counter_fd(fd, handle);
 		handle = (perf_counter_t)sq_next(&handle->link);
 	}
+
+	pthread_mutex_unlock(&perf_counters_mutex);
+}
+
+void
+perf_dump_all(int fd)
+{
+	dprintf(fd, "name,type,events,overruns,total_us,min_us,max_us,avg_us,rms_us,p50_us,p99_us\n");
+
+	pthread_mutex_lock(&perf_counters_mutex);
+
+	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
+
+	while (handle != NULL) {
+		perf_dump_counter_fd(fd, handle);
+		handle = (perf_counter_t)sq_next(&handle->link);
+	}
+
+	pthread_mutex_unlock(&perf_counters_mutex);
+}
+
+void
+perf_iterate_all(perf_callback cb, void *user)
+{
+	union perf_ctr_any ctr;
+	struct perf_counter_summary summary;
+
+	pthread_mutex_lock(&perf_counters_mutex);
+
+	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
+
+	while (handle != NULL) {
+		if (perf_snapshot(handle, &ctr)) {
+			perf_summarize(handle, &ctr, &summary);
+			cb(&summary, user);
+		}
+
+		handle = (perf_counter_t)sq_next(&handle->link);
+	}
+
+	pthread_mutex_unlock(&perf_counters_mutex);
 }
 
 extern const uint16_t latency_bucket_count;
@@ -533,12 +971,8 @@ perf_print_latency(int fd)
 void
 perf_reset_all(void)
 {
-	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
-
-	while (handle != NULL) {
-		perf_reset(handle);
-		handle = (perf_counter_t)sq_next(&handle->link);
-	}
+	/* all counters are reset at once by moving to a new generation */
+	perf_atomic_add(&perf_generation, 1);
 
 	for (int i = 0; i <= latency_bucket_count; i++) {
 		latency_counters[i] = 0;
@@ -48,12 +48,33 @@
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< distribution of the time elapsed performing an event */
 };
 
 struct perf_ctr_header;
 typedef struct perf_ctr_header	*perf_counter_t;
 
+/**
+ * Snapshot of one counter, reduced to the values shared by all counter types.
+ * Times are in microseconds; fields a counter type does not track are zero.
+ */
+struct perf_counter_summary {
+	const char		*name;
+	enum perf_counter_type	type;
+	uint64_t		event_count;
+	uint64_t		event_overruns;
+	uint64_t		time_total;
+	uint64_t		time_least;
+	uint64_t		time_most;
+	uint64_t		time_avg;
+	float			rms;
+	uint64_t		p50;		/**< PC_HISTOGRAM only */
+	uint64_t		p99;		/**< PC_HISTOGRAM only */
+};
+
+typedef void (*perf_callback)(const struct perf_counter_summary *summary, void *user);
+
 __BEGIN_DECLS
 
 /**
@@ -95,7 +116,8 @@ __EXPORT extern void		perf_count(perf_counter_t handle);
 /**
  * Begin a performance event.
  *
- * This call applies to counters that operate over ranges of time; PC_ELAPSED etc.
+ * This call applies to counters that operate over ranges of time; PC_ELAPSED,
+ * PC_HISTOGRAM.
  *
  * @param handle		The handle returned from perf_alloc.
  */
@@ -182,8 +204,31 @@ __EXPORT extern void		perf_print_all(int fd);
  */
 __EXPORT extern void		perf_print_latency(int fd);
 
+/**
+ * Print all of the performance counters as CSV, one counter per line
+ * after a header line naming the columns.
+ *
+ * @param fd			File descriptor to print to - e.g. 0 for stdout
+ */
+__EXPORT extern void		perf_dump_all(int fd);
+
+/**
+ * Call a function for a snapshot of each performance counter.
+ *
+ * The counter list is locked during the iteration, so the callback must
+ * not allocate or free counters.
+ *
+ * @param cb			Function called once per counter.
+ * @param user			Opaque pointer handed to the callback.
+ */
+__EXPORT extern void		perf_iterate_all(perf_callback cb, void *user);
+
 /**
  * Reset all of the performance counters.
+ *
+ * All counters read as reset from the moment this returns; each counter
+ * clears its values on its next update, so this never races with the
+ * thread updating it.
  */
 __EXPORT extern void		perf_reset_all(void);
 
@@ -195,6 +240,18 @@ __EXPORT extern void		perf_reset_all(void);
  */
 __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
 
+/**
+ * Return a percentile of a PC_HISTOGRAM counter
+ *
+ * The value is accurate to the histogram resolution of 25%.
+ *
+ * @param handle		The counter returned from perf_alloc.
+ * @param percent		The percentile, 0 to 100.
+ * @return			The time in us below which percent of the events fall,
+ *				0 for other counter types.
+ */
+__EXPORT extern uint64_t	perf_percentile(perf_counter_t handle, unsigned percent);
+
 __END_DECLS
 
 #endif
@@ -40,6 +40,7 @@
  */
 
 #include <px4_posix.h>
+#include <px4_tasks.h>
 
 #include <unistd.h>
 #include <string.h>
@@ -92,8 +93,52 @@ void print_load(uint64_t t, int fd, struct print_load_s *print_state)
 	}
 
 #if defined (__PX4_LINUX)
-	dprintf(fd, "%sTOP NOT IMPLEMENTED ON LINUX\n",
-		clear_line);
+	px4_task_stats_t stats[CONFIG_MAX_TASKS];
+	int count = px4_task_stats(stats, CONFIG_MAX_TASKS);
+
+	/* CPU times are compared against the previous call */
+	uint64_t interval = t - print_state->new_time;
+	print_state->new_time = t;
+	float percent_per_us = (interval > 0) ? 100.0f / interval : 0.0f;
+	float total_load = 0.0f;
+
+	dprintf(fd, "%sProcesses: %d total\n", clear_line, count);
+	dprintf(fd, "%s%6s %-16s %10s %7s %9s %9s %9s\n",
+		clear_line, "TID", "COMMAND", "CPU(ms)", "CPU(%)", "RUNQ(us)", "WAKE(us)", "WMAX(us)");
+
+	for (int i = 0; i < count; i++) {
+		const px4_task_stats_t *task = &stats[i];
+		float load = 0.0f;
+
+		if (task->index < CONFIG_MAX_TASKS) {
+			uint64_t last = print_state->last_times[task->index];
+
+			if (last > 0 && task->run_time_us >= last) {
+				load = (task->run_time_us - last) * percent_per_us;
+			}
+
+			print_state->last_times[task->index] = task->run_time_us;
+		}
+
+		total_load += load;
+
+		/* run queue time per timeslice is the average delay from becoming
+		 * runnable to getting a CPU */
+		uint64_t runq_avg = (task->timeslices > 0) ? task->runq_time_us / task->timeslices : 0;
+		uint64_t wakeup_avg = (task->wakeup_count > 0) ? task->wakeup_latency_sum_us / task->wakeup_count : 0;
+
+		dprintf(fd, "%s%6d %-16s %10llu %6.2f%% %9llu %9llu %9u\n",
+			clear_line,
+			task->tid,
+			task->name,
+			(unsigned long long)(task->run_time_us / 1000),
+			(double)load,
+			(unsigned long long)runq_avg,
+			(unsigned long long)wakeup_avg,
+			(unsigned)task->wakeup_latency_max_us);
+	}
+
+	dprintf(fd, "%sCPU usage: %.2f%% (of one core)\n\n", clear_line, (double)total_load);
 
 #elif defined (__PX4_QURT)
 	dprintf(fd, "%sTOP NOT IMPLEMENTED ON QURT\n",
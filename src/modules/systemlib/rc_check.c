@@ -77,7 +77,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: PARAM %s MISSING", rc_map_mandatory[j]); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 			map_fail_count++;
 			j++;
 			continue;
@@ -90,7 +90,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: %s >= # CHANS", rc_map_mandatory[j]); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 			map_fail_count++;
 		}
 
@@ -98,7 +98,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: Mandatory %s is unmapped", rc_map_mandatory[j]); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 			map_fail_count++;
 		}
 
@@ -151,7 +151,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: RC_%d_MIN < %u", i + 1, RC_INPUT_LOWEST_MIN_US); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 		}
 
 		if (param_max > RC_INPUT_HIGHEST_MAX_US) {
@@ -160,7 +160,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: RC_%d_MAX > %u", i + 1, RC_INPUT_HIGHEST_MAX_US); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 		}
 
 		if (param_trim < param_min) {
@@ -169,7 +169,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: RC_%d_TRIM < MIN (%d/%d)", i + 1, (int)param_trim, (int)param_min); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 		}
 
 		if (param_trim > param_max) {
@@ -178,7 +178,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: RC_%d_TRIM > MAX (%d/%d)", i + 1, (int)param_trim, (int)param_max); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 		}
 
 		/* assert deadzone is sane */
@@ -186,7 +186,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 			if (report_fail) { mavlink_and_console_log_critical(mavlink_log_pub, "RC ERR: RC_%d_DZ > %u", i + 1, RC_INPUT_MAX_DEADZONE_US); }
 
 			/* give system time to flush error message in case there are more */
-			usleep(100000);
+			px4_usleep(100000);
 			count++;
 		}
 
@@ -206,7 +206,7 @@ int rc_calibration_check(orb_advert_t *mavlink_log_pub, bool report_fail)
 							 (total_fail_count > 1) ? "s" : "", channels_failed, (channels_failed > 1) ? "s" : "");
 		}
 
-		usleep(100000);
+		px4_usleep(100000);
 	}
 
 	return total_fail_count + map_fail_count;
@@ -117,6 +117,26 @@ public:
 
 	virtual int16_t send_message(const char *messageName, int32_t length, uint8_t *data) = 0;
 
+	/**
+	 * @brief Sends the data message of one instance of a multi-instance topic.
+	 * Channels that do not distinguish instances keep the default, which
+	 * forwards to send_message().
+	 * @param messageName
+	 * 	The uORB message name.
+	 * @param instance
+	 * 	The topic instance the data was published on.
+	 * @param length
+	 * 	The length of the data buffer to be sent.
+	 * @param data
+	 * 	The actual data to be sent.
+	 * @return
+	 *  0 = success; otherwise = failure.
+	 */
+	virtual int16_t send_multi_message(const char *messageName, uint8_t instance, int32_t length, uint8_t *data)
+	{
+		return send_message(messageName, length, data);
+	}
+
 };
 
 /**
@@ -60,7 +60,7 @@ uORB::DeviceNode::SubscriberData  *uORB::DeviceNode::filp_to_sd(device::file_t *
 }
 
 uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const char *name, const char *path,
-			     int priority, unsigned int queue_size) :
+			     int priority, unsigned int queue_size, uint8_t instance) :
 	VDev(name, path),
 	_meta(meta),
 	_data(nullptr),
@@ -70,7 +70,8 @@ uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const char *name,
 	_priority(priority),
 	_published(false),
 	_queue_size(queue_size),
-	_subscriber_count(0)
+	_subscriber_count(0),
+	_instance(instance)
 {
 	// enable debug() calls
 	//_debug_enabled = true;
@@ -408,7 +409,7 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
 
 	if (ch != nullptr) {
-		if (ch->send_message(meta->o_name, meta->o_size, (uint8_t *)data) != 0) {
+		if (ch->send_multi_message(meta->o_name, devnode->_instance, meta->o_size, (uint8_t *)data) != 0) {
 			warnx("[uORB::DeviceNode::publish(%d)]: Error Sending [%s] topic data over comm_channel",
 			      __LINE__, meta->o_name);
 			return ERROR;
@@ -643,7 +644,7 @@ int16_t uORB::DeviceNode::process_add_subscription(int32_t rateInHz)
 	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
 
 	if (_data != nullptr && ch != nullptr) { // _data will not be null if there is a publisher.
-		ch->send_message(_meta->o_name, _meta->o_size, _data);
+		ch->send_multi_message(_meta->o_name, _instance, _meta->o_size, _data);
 	}
 
 	return PX4_OK;
@@ -756,7 +757,7 @@ uORB::DeviceMaster::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 				}
 
 				/* construct the new node */
-				node = new uORB::DeviceNode(meta, objname, devpath, adv->priority);
+				node = new uORB::DeviceNode(meta, objname, devpath, adv->priority, 1, group_tries);
 
 				/* if we didn't get a device, that's bad */
 				if (node == nullptr) {
@@ -50,7 +50,7 @@ class uORB::DeviceNode : public device::VDev
 {
 public:
 	DeviceNode(const struct orb_metadata *meta, const char *name, const char *path,
-		   int priority, unsigned int queue_size = 1);
+		   int priority, unsigned int queue_size = 1, uint8_t instance = 0);
 	~DeviceNode();
 
 	virtual int   open(device::file_t *filp);
@@ -161,6 +161,8 @@ private:
 
 	int32_t _subscriber_count;
 
+	uint8_t _instance; ///< multi-instance index of the topic
+
 	//statistics
 	uint32_t _lost_messages = 0; ///< nr of lost messages for all subscribers. If two subscribers lose the same
 	///message, it is counted as two.
@@ -1091,9 +1091,11 @@ UavcanNode::ioctl(file *filp, int cmd, unsigned long arg)
 
 		break;
 
-	case MIXERIOCLOADBUF: {
+	case MIXERIOCLOADBUF:
+	case MIXERIOCLOADBIN: {
 			const char *buf = (const char *)arg;
-			unsigned buflen = strnlen(buf, 1024);
+			bool binary = (cmd == MIXERIOCLOADBIN);
+			unsigned buflen = binary ? MixerGroup::binary_length(buf) : strnlen(buf, 1024);
 
 			if (_mixers == nullptr) {
 				_mixers = new MixerGroup(control_callback, (uintptr_t)_controls);
@@ -1105,7 +1107,7 @@ UavcanNode::ioctl(file *filp, int cmd, unsigned long arg)
 
 			} else {
 
-				ret = _mixers->load_from_buf(buf, buflen);
+				ret = binary ? _mixers->load_from_bin(buf, buflen) : _mixers->load_from_buf(buf, buflen);
 
 				if (ret != 0) {
 					warnx("mixer load failed with %d", ret);
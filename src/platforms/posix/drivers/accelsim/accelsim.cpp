@@ -142,7 +142,7 @@ private:
 	math::LowPassFilter2p	_accel_filter_y;
 	math::LowPassFilter2p	_accel_filter_z;
 
-	enum Rotation		_rotation;
+	RotationMatrix		_rotation;
 
 	// values used to
 	float			_last_accel[3];
@@ -957,7 +957,7 @@ ACCELSIM::mag_measure()
 
 
 	/* apply user specified rotation */
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+	_rotation.rotate(xraw_f, yraw_f, zraw_f);
 
 	/* remember the temperature. The datasheet isn't clear, but it
 	 * seems to be a signed offset from 25 degrees C in units of 0.125C
@@ -87,7 +87,8 @@ AirspeedSim::AirspeedSim(int bus, int address, unsigned conversion_interval, con
 	_class_instance(-1),
 	_conversion_interval(conversion_interval),
 	_sample_perf(perf_alloc(PC_ELAPSED, "airspeed_read")),
-	_comms_errors(perf_alloc(PC_COUNT, "airspeed_comms_errors"))
+	_comms_errors(perf_alloc(PC_COUNT, "airspeed_comms_errors")),
+	_wq(HPWORK)
 {
 	// enable debug() calls
 	_debug_enabled = false;
@@ -357,13 +358,14 @@ AirspeedSim::start()
 	_reports->flush();
 
 	/* schedule a cycle to start things */
-	work_queue(HPWORK, &_work, (worker_t)&AirspeedSim::cycle_trampoline, this, 1);
+	_wq = work_queue_find("wq_io2");
+	work_queue(_wq, &_work, (worker_t)&AirspeedSim::cycle_trampoline, this, 1);
 }
 
 void
 AirspeedSim::stop()
 {
-	work_cancel(HPWORK, &_work);
+	work_cancel(_wq, &_work);
 }
 
 void
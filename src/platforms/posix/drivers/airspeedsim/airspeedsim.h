@@ -152,6 +152,8 @@ protected:
 	perf_counter_t		_sample_perf;
 	perf_counter_t		_comms_errors;
 
+	int			_wq;		///< work queue the driver runs on
+
 
 	/**
 	* Test whether the device supported by the driver is present at a
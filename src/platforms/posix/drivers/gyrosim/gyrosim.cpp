@@ -62,6 +62,7 @@
 #include <simulator/simulator.h>
 
 #include <systemlib/perf_counter.h>
+#include <systemlib/latency_trace.h>
 #include <systemlib/err.h>
 #include <systemlib/conversions.h>
 
@@ -1153,6 +1154,7 @@ GYROSIM::_measure()
 		if (!(_pub_blocked)) {
 			/* publish it */
 			orb_publish(ORB_ID(sensor_gyro), _gyro->_gyro_topic, &grb);
+			latency_trace_stamp(LATENCY_TRACE_IMU, grb.timestamp);
 		}
 	}
 
@@ -43,7 +43,10 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <algorithm>
+#include <chrono>
 #include <signal.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <stdio.h>
 #include "apps.h"
@@ -66,6 +69,25 @@ static bool _ExitFlag = false;
 
 static struct termios orig_term;
 
+/* startup profile: wall time of each startup script command */
+struct startup_timing {
+	string line;
+	uint64_t elapsed_us;
+	bool background;
+};
+
+static bool _profile_startup = false;
+static vector<startup_timing> _startup_profile;
+static pthread_mutex_t _startup_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* commands started with a trailing '&', joined by 'wait' */
+struct background_thread {
+	pthread_t thread;
+	string command;
+};
+
+static vector<background_thread> _background_cmds;
+
 extern "C" {
 	void _SigIntHandler(int sig_num);
 	void _SigIntHandler(int sig_num)
@@ -92,6 +114,8 @@ static void print_prompt()
 	cout.flush();
 }
 
+static void wait_background_cmds(const vector<string> &commands = vector<string>());
+
 static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silently_fail = false)
 {
 	// command is appargs[0]
@@ -122,6 +146,16 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silen
 	} else if (command.compare("help") == 0) {
 		list_builtins();
 
+	} else if (command.compare("wait") == 0) {
+		// 'wait' joins all background commands, 'wait <command> [...]' only the given ones
+		vector<string> commands;
+
+		for (size_t i = 1; i < appargs.size() && !appargs[i].empty(); i++) {
+			commands.push_back(appargs[i]);
+		}
+
+		wait_background_cmds(commands);
+
 	} else if (command.length() == 0 || command[0] == '#') {
 		// Do nothing
 
@@ -134,21 +168,126 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail, bool silen
 static void usage()
 {
 
-	cout << "./px4 [-d] [startup_config] -h" << std::endl;
+	cout << "./px4 [-d] [-t] [startup_config] -h" << std::endl;
 	cout << "   -d            - Optional flag to run the app in daemon mode and does not listen for user input." <<
 	     std::endl;
 	cout << "                   This is needed if px4 is intended to be run as a upstart job on linux" << std::endl;
+	cout << "   -t            - Print the time taken by the startup_config commands" << std::endl;
 	cout << "<startup_config> - config file for starting/stopping px4 modules" << std::endl;
+	cout << "                   Lines ending with '&' run concurrently until a 'wait' line, 'wait <command>'" << std::endl;
+	cout << "                   only waits for the background lines running that command" << std::endl;
 	cout << "   -h            - help/usage information" << std::endl;
 }
 
+static uint64_t monotonic_us()
+{
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void record_timing(const string &line, uint64_t start_us, bool background)
+{
+	if (!_profile_startup) {
+		return;
+	}
+
+	startup_timing timing = { line, monotonic_us() - start_us, background };
+
+	pthread_mutex_lock(&_startup_mutex);
+	_startup_profile.push_back(timing);
+	pthread_mutex_unlock(&_startup_mutex);
+}
+
+struct background_cmd {
+	string line;
+	vector<string> appargs;
+	bool exit_on_fail;
+};
+
+static void *run_background_cmd(void *arg)
+{
+	background_cmd *cmd = static_cast<background_cmd *>(arg);
+
+	uint64_t start = monotonic_us();
+	run_cmd(cmd->appargs, cmd->exit_on_fail);
+	record_timing(cmd->line, start, true);
+
+	delete cmd;
+	return nullptr;
+}
+
+static void wait_background_cmds(const vector<string> &commands)
+{
+	vector<background_thread> pending;
+
+	pthread_mutex_lock(&_startup_mutex);
+
+	for (auto it = _background_cmds.begin(); it != _background_cmds.end();) {
+		if (commands.empty() || find(commands.begin(), commands.end(), it->command) != commands.end()) {
+			pending.push_back(*it);
+			it = _background_cmds.erase(it);
+
+		} else {
+			++it;
+		}
+	}
+
+	pthread_mutex_unlock(&_startup_mutex);
+
+	for (const background_thread &background : pending) {
+		pthread_join(background.thread, nullptr);
+	}
+}
+
 static void process_line(string &line, bool exit_on_fail)
 {
 	vector<string> appargs(10);
 
-	stringstream(line) >> appargs[0] >> appargs[1] >> appargs[2] >> appargs[3] >> appargs[4] >> appargs[5] >> appargs[6] >>
-			   appargs[7] >> appargs[8] >> appargs[9];
+	// a trailing '&' runs the command concurrently, until the next 'wait'
+	string cmdline = line;
+	size_t end = cmdline.find_last_not_of(" \t\r");
+	bool background = (end != string::npos && cmdline[end] == '&');
+
+	if (background) {
+		cmdline.erase(end);
+	}
+
+	stringstream(cmdline) >> appargs[0] >> appargs[1] >> appargs[2] >> appargs[3] >> appargs[4] >> appargs[5] >> appargs[6] >>
+			      appargs[7] >> appargs[8] >> appargs[9];
+
+	if (background && !appargs[0].empty()) {
+		background_cmd *cmd = new background_cmd{cmdline, appargs, exit_on_fail};
+		pthread_t thread;
+
+		if (pthread_create(&thread, nullptr, run_background_cmd, cmd) == 0) {
+			pthread_mutex_lock(&_startup_mutex);
+			_background_cmds.push_back(background_thread{thread, appargs[0]});
+			pthread_mutex_unlock(&_startup_mutex);
+			return;
+		}
+
+		// run it in the foreground instead
+		delete cmd;
+	}
+
+	uint64_t start = monotonic_us();
 	run_cmd(appargs, exit_on_fail);
+
+	if (appargs[0].length() > 0 && appargs[0][0] != '#') {
+		record_timing(cmdline, start, false);
+	}
+}
+
+static void print_startup_profile(uint64_t total_us)
+{
+	sort(_startup_profile.begin(), _startup_profile.end(),
+	[](const startup_timing & a, const startup_timing & b) { return a.elapsed_us > b.elapsed_us; });
+
+	printf("startup took %.3f s, slowest commands:\n", total_us / 1e6);
+
+	for (size_t i = 0; i < _startup_profile.size() && i < 15; i++) {
+		const startup_timing &timing = _startup_profile[i];
+		printf("  %9.3f ms %c %s\n", timing.elapsed_us / 1e3, timing.background ? '&' : ' ', timing.line.c_str());
+	}
 }
 
 static void restore_term(void)
@@ -217,6 +356,9 @@ int main(int argc, char **argv)
 			} else if (strcmp(argv[index], "-c") == 0) {
 				chroot_on = true;
 
+			} else if (strcmp(argv[index], "-t") == 0) {
+				_profile_startup = true;
+
 			} else {
 				PX4_WARN("Unknown/unhandled parameter: %s", argv[index]);
 				return 1;
@@ -250,6 +392,8 @@ int main(int argc, char **argv)
 		ifstream infile(commands_file);
 
 		if (infile.is_open()) {
+			uint64_t startup_start = monotonic_us();
+
 			for (string line; getline(infile, line, '\n');) {
 
 				if (px4_exit_requested()) {
@@ -260,6 +404,12 @@ int main(int argc, char **argv)
 				process_line(line, false);
 			}
 
+			wait_background_cmds();
+
+			if (_profile_startup) {
+				print_startup_profile(monotonic_us() - startup_start);
+			}
+
 		} else {
 			PX4_WARN("Error opening file: %s", commands_file);
 		}
@@ -47,9 +47,24 @@
 #include <string.h>
 #include <inttypes.h>
 #include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include "hrt_work.h"
 
-static struct sq_queue_s	callout_queue;
+#ifdef __PX4_LINUX
+/* callouts are dispatched by a dedicated thread blocking on a timerfd */
+#define HRT_USE_TIMERFD
+#include <sys/timerfd.h>
+#endif
+
+/*
+ * Pending callouts, kept as a binary min-heap ordered by deadline so that
+ * entering and dispatching a callout is O(log n).
+ */
+#define CALLOUT_HEAP_INITIAL_SIZE	32
+static struct hrt_call	**callout_heap;
+static unsigned		callout_heap_count;
+static unsigned		callout_heap_size;
 
 /* latency histogram */
 #define LATENCY_BUCKET_COUNT 8
@@ -58,13 +73,22 @@ __EXPORT const uint16_t	latency_buckets[LATENCY_BUCKET_COUNT] = { 1, 2, 5, 10, 2
 __EXPORT uint32_t	latency_counters[LATENCY_BUCKET_COUNT + 1];
 
 static void		hrt_call_reschedule(void);
+static void		hrt_latency_update(hrt_abstime deadline, hrt_abstime now);
 
 // Intervals in usec
+#ifdef HRT_USE_TIMERFD
+#define HRT_INTERVAL_MIN	1
+#else
 #define HRT_INTERVAL_MIN	50
+#endif
 #define HRT_INTERVAL_MAX	50000000
 
 static px4_sem_t 	_hrt_lock;
+#ifdef HRT_USE_TIMERFD
+static int		_hrt_timerfd = -1;
+#else
 static struct work_s	_hrt_work;
+#endif
 #ifndef __PX4_QURT
 static hrt_abstime px4_timestart = 0;
 #else
@@ -75,9 +99,29 @@ static hrt_abstime _delay_interval = 0;
 static hrt_abstime max_time = 0;
 pthread_mutex_t _hrt_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Lockstep: the time only advances with hrt_lockstep_set_time(), and timed
+ * waits are woken up by the time advancing instead of by the wall clock.
+ */
+struct lockstep_waiter {
+	px4_sem_t		*sem;
+	hrt_abstime		deadline;
+	bool			expired;	///< unlinked by hrt_lockstep_set_time()
+	bool			timed_out;	///< the semaphore was posted on expiry
+	struct lockstep_waiter	*next;
+};
+
+static volatile bool _lockstep = false;
+static hrt_abstime _lockstep_time = 0;
+static struct lockstep_waiter *_lockstep_waiters = NULL;
+static pthread_mutex_t _lockstep_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void
 hrt_call_invoke(void);
 
+static void
+hrt_tim_isr(void *p);
+
 static hrt_abstime
 _hrt_absolute_time_internal(void);
 
@@ -199,7 +243,10 @@ hrt_abstime hrt_absolute_time(void)
 
 	hrt_abstime ret;
 
-	if (_start_delay_time > 0) {
+	if (_lockstep) {
+		ret = _lockstep_time;
+
+	} else if (_start_delay_time > 0) {
 		ret = _start_delay_time;
 
 	} else {
@@ -277,13 +324,115 @@ bool	hrt_called(struct hrt_call *entry)
 	return (entry->deadline == 0);
 }
 
+static void
+callout_heap_swap(unsigned a, unsigned b)
+{
+	struct hrt_call *tmp = callout_heap[a];
+	callout_heap[a] = callout_heap[b];
+	callout_heap[b] = tmp;
+}
+
+static void
+callout_heap_sift_up(unsigned index)
+{
+	while (index > 0) {
+		unsigned parent = (index - 1) / 2;
+
+		if (callout_heap[parent]->deadline <= callout_heap[index]->deadline) {
+			break;
+		}
+
+		callout_heap_swap(parent, index);
+		index = parent;
+	}
+}
+
+static void
+callout_heap_sift_down(unsigned index)
+{
+	for (;;) {
+		unsigned smallest = index;
+		unsigned left = 2 * index + 1;
+		unsigned right = left + 1;
+
+		if (left < callout_heap_count && callout_heap[left]->deadline < callout_heap[smallest]->deadline) {
+			smallest = left;
+		}
+
+		if (right < callout_heap_count && callout_heap[right]->deadline < callout_heap[smallest]->deadline) {
+			smallest = right;
+		}
+
+		if (smallest == index) {
+			break;
+		}
+
+		callout_heap_swap(smallest, index);
+		index = smallest;
+	}
+}
+
+static struct hrt_call *
+callout_heap_peek(void)
+{
+	return (callout_heap_count > 0) ? callout_heap[0] : NULL;
+}
+
+static bool
+callout_heap_push(struct hrt_call *entry)
+{
+	if (callout_heap_count == callout_heap_size) {
+		unsigned new_size = (callout_heap_size > 0) ? callout_heap_size * 2 : CALLOUT_HEAP_INITIAL_SIZE;
+		struct hrt_call **new_heap = (struct hrt_call **)realloc(callout_heap, new_size * sizeof(*new_heap));
+
+		if (new_heap == NULL) {
+			return false;
+		}
+
+		callout_heap = new_heap;
+		callout_heap_size = new_size;
+	}
+
+	callout_heap[callout_heap_count] = entry;
+	callout_heap_sift_up(callout_heap_count++);
+	return true;
+}
+
+static void
+callout_heap_remove_at(unsigned index)
+{
+	callout_heap_count--;
+
+	if (index != callout_heap_count) {
+		callout_heap[index] = callout_heap[callout_heap_count];
+		callout_heap_sift_down(index);
+		callout_heap_sift_up(index);
+	}
+}
+
+/*
+ * Remove the entry from the heap if it is queued. The entry does not record
+ * its heap position (struct hrt_call is shared with NuttX), so this scans;
+ * cancellation and re-arming of a pending call are rare compared to dispatch.
+ */
+static void
+callout_heap_remove(struct hrt_call *entry)
+{
+	for (unsigned i = 0; i < callout_heap_count; i++) {
+		if (callout_heap[i] == entry) {
+			callout_heap_remove_at(i);
+			return;
+		}
+	}
+}
+
 /*
  * Remove the entry from the callout list.
  */
 void	hrt_cancel(struct hrt_call *entry)
 {
 	hrt_lock();
-	sq_rem(&entry->link, &callout_queue);
+	callout_heap_remove(entry);
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -314,12 +463,39 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
 	entry->deadline = hrt_absolute_time() + delay;
 }
 
+#ifdef HRT_USE_TIMERFD
+/*
+ * Callout thread. Blocks on the timerfd, which hrt_call_reschedule() keeps
+ * armed for the earliest pending deadline, and runs the expired callouts.
+ */
+static int
+hrt_callout_thread(int argc, char *argv[])
+{
+	for (;;) {
+		uint64_t expirations;
+
+		if (read(_hrt_timerfd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+			if (errno != EINTR && errno != EAGAIN) {
+				PX4_ERR("hrt timerfd read failed: %s", strerror(errno));
+				usleep(HRT_INTERVAL_MIN);
+			}
+
+			continue;
+		}
+
+		hrt_tim_isr(NULL);
+	}
+
+	return PX4_OK;
+}
+#endif
+
 /*
  * Initialise the HRT.
  */
 void	hrt_init(void)
 {
-	sq_init(&callout_queue);
+	callout_heap_count = 0;
 
 	int sem_ret = px4_sem_init(&_hrt_lock, 0, 1);
 
@@ -327,7 +503,28 @@ void	hrt_init(void)
 		PX4_ERR("SEM INIT FAIL: %s", strerror(errno));
 	}
 
+#ifdef HRT_USE_TIMERFD
+	_hrt_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+
+	if (_hrt_timerfd < 0) {
+		PX4_ERR("hrt timerfd_create failed: %s", strerror(errno));
+		return;
+	}
+
+	/* SCHED_DEFAULT is SCHED_FIFO; px4_task_spawn_cmd falls back to the
+	 * default policy when not permitted to run realtime threads */
+	if (px4_task_spawn_cmd("hrt_callout",
+			       SCHED_DEFAULT,
+			       SCHED_PRIORITY_MAX,
+			       2000,
+			       hrt_callout_thread,
+			       (char *const *)NULL) < 0) {
+		PX4_ERR("hrt callout thread start failed");
+	}
+
+#else
 	memset(&_hrt_work, 0, sizeof(_hrt_work));
+#endif
 }
 
 void	hrt_start_delay()
@@ -352,33 +549,186 @@ void	hrt_stop_delay()
 
 }
 
-static void
-hrt_call_enter(struct hrt_call *entry)
+void	hrt_lockstep_enable(void)
 {
-	struct hrt_call	*call, *next;
+	pthread_mutex_lock(&_hrt_mutex);
 
-	//PX4_INFO("hrt_call_enter");
-	call = (struct hrt_call *)sq_peek(&callout_queue);
+	if (!_lockstep) {
+		// continue from the current time
+		_lockstep_time = max_time;
+		_start_delay_time = 0;
+		_delay_interval = 0;
+		_lockstep = true;
+	}
 
-	if ((call == NULL) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
-		//if (call != NULL) PX4_INFO("call enter at head, reschedule (%lu %lu)", entry->deadline, call->deadline);
-		/* we changed the next deadline, reschedule the timer event */
-		hrt_call_reschedule();
+	pthread_mutex_unlock(&_hrt_mutex);
+}
+
+bool	hrt_lockstep_enabled(void)
+{
+	return _lockstep;
+}
+
+void	hrt_lockstep_set_time(hrt_abstime time)
+{
+	pthread_mutex_lock(&_hrt_mutex);
+
+	if (time > _lockstep_time) {
+		_lockstep_time = time;
+	}
+
+	pthread_mutex_unlock(&_hrt_mutex);
+
+	/* run the callouts that are due now */
+	hrt_tim_isr(NULL);
+
+	/* and wake up the expired timed waits */
+	hrt_abstime now = hrt_absolute_time();
+
+	pthread_mutex_lock(&_lockstep_mutex);
+
+	struct lockstep_waiter **link = &_lockstep_waiters;
+
+	while (*link != NULL) {
+		struct lockstep_waiter *w = *link;
+
+		if (w->deadline > now) {
+			link = &w->next;
+			continue;
+		}
+
+		/* unlink under the lock so that each waiter expires only once */
+		*link = w->next;
+		w->expired = true;
+
+		/* if the event already posted the semaphore, that post wakes the waiter */
+		int value = 0;
+
+		if (px4_sem_getvalue(w->sem, &value) == 0 && value <= 0) {
+			w->timed_out = true;
+			px4_sem_post(w->sem);
+		}
+	}
+
+	pthread_mutex_unlock(&_lockstep_mutex);
+}
+
+/*
+ * Wait on a semaphore until it is posted or the lockstep time passes the
+ * timeout. If interruptible, a signal ends the wait with -EINTR.
+ */
+static int
+lockstep_timedwait(px4_sem_t *sem, hrt_abstime timeout, bool interruptible)
+{
+	struct lockstep_waiter waiter;
+	waiter.sem = sem;
+	waiter.deadline = hrt_absolute_time() + timeout;
+	waiter.expired = false;
+	waiter.timed_out = false;
+
+	pthread_mutex_lock(&_lockstep_mutex);
+	waiter.next = _lockstep_waiters;
+	_lockstep_waiters = &waiter;
+	pthread_mutex_unlock(&_lockstep_mutex);
+
+	/* either posted by the waker or by hrt_lockstep_set_time() on expiry */
+	int ret = 0;
+
+	while (px4_sem_wait(sem) != 0) {
+		if (errno == EINTR && !interruptible) {
+			continue;
+		}
+
+		ret = -errno;
+		break;
+	}
+
+	pthread_mutex_lock(&_lockstep_mutex);
+
+	/* still linked if woken up by the event before the deadline */
+	if (!waiter.expired) {
+		struct lockstep_waiter **link = &_lockstep_waiters;
+
+		while (*link != &waiter) {
+			link = &(*link)->next;
+		}
+
+		*link = waiter.next;
+	}
+
+	pthread_mutex_unlock(&_lockstep_mutex);
+
+	if (ret == 0 && waiter.timed_out) {
+		ret = -ETIMEDOUT;
+	}
+
+	return ret;
+}
+
+int	hrt_sem_timedwait(px4_sem_t *sem, hrt_abstime timeout)
+{
+	if (!_lockstep) {
+		struct timespec ts;
+		px4_clock_gettime(CLOCK_REALTIME, &ts);
+
+		uint64_t nsecs = ts.tv_nsec + timeout * 1000;
+		ts.tv_sec += nsecs / 1000000000;
+		ts.tv_nsec = nsecs % 1000000000;
+
+		int ret;
 
-	} else {
 		do {
-			next = (struct hrt_call *)sq_next(&call->link);
+			errno = 0;
+			ret = px4_sem_timedwait(sem, &ts);
 
-			if ((next == NULL) || (entry->deadline < next->deadline)) {
-				//lldbg("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
-				break;
+			/* sem_timedwait() sets errno, the Darwin implementation returns it */
+			if (ret < 0) {
+				ret = errno;
 			}
-		} while ((call = next) != NULL);
+		} while (ret == EINTR);
+
+		return -ret;
 	}
 
-	//PX4_INFO("scheduled");
+	return lockstep_timedwait(sem, timeout, false);
+}
+
+#ifndef __PX4_QURT
+/* on QuRT px4_usleep is a macro for usleep, see px4_time.h */
+int px4_usleep(unsigned int usec)
+{
+	if (!_lockstep) {
+		return usleep(usec);
+	}
+
+	/* like usleep(), a signal ends the sleep early */
+	px4_sem_t sem;
+	px4_sem_init(&sem, 0, 0);
+	int ret = lockstep_timedwait(&sem, usec, true);
+	px4_sem_destroy(&sem);
+
+	if (ret == -EINTR) {
+		errno = EINTR;
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
+static void
+hrt_call_enter(struct hrt_call *entry)
+{
+	if (!callout_heap_push(entry)) {
+		PX4_ERR("hrt callout heap full");
+		entry->deadline = 0;
+		return;
+	}
+
+	if (callout_heap_peek() == entry) {
+		/* we changed the next deadline, reschedule the timer event */
+		hrt_call_reschedule();
+	}
 }
 
 /**
@@ -412,7 +762,7 @@ hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
 	hrt_abstime	delay = HRT_INTERVAL_MAX;
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = callout_heap_peek();
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	//PX4_INFO("hrt_call_reschedule");
@@ -429,6 +779,11 @@ hrt_call_reschedule()
 	 * interrupt fires sufficiently often that the base_time update in
 	 * hrt_absolute_time runs at least once per timer period.
 	 */
+	if (_lockstep) {
+		/* callouts are run by hrt_lockstep_set_time() */
+		return;
+	}
+
 	if (next != NULL) {
 		//lldbg("entry in queue\n");
 		if (next->deadline <= (now + HRT_INTERVAL_MIN)) {
@@ -442,6 +797,25 @@ hrt_call_reschedule()
 		}
 	}
 
+#ifdef HRT_USE_TIMERFD
+	// There is no timer ISR, so arm the timerfd the callout thread waits on.
+	// This replaces any pending expiry. The timer is armed with the absolute
+	// deadline on CLOCK_MONOTONIC, so that being preempted between reading
+	// the time and arming the timer does not delay the expiry.
+	pthread_mutex_lock(&_hrt_mutex);
+	hrt_abstime expiry = now + delay + _delay_interval + px4_timestart;
+	pthread_mutex_unlock(&_hrt_mutex);
+
+	struct itimerspec its;
+	memset(&its, 0, sizeof(its));
+	its.it_value.tv_sec = expiry / 1000000;
+	its.it_value.tv_nsec = (expiry % 1000000) * 1000;
+
+	if (timerfd_settime(_hrt_timerfd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+		PX4_ERR("hrt timerfd_settime failed: %s", strerror(errno));
+	}
+
+#else
 	// There is no timer ISR, so simulate one by putting an event on the
 	// high priority work queue
 
@@ -449,6 +823,7 @@ hrt_call_reschedule()
 	hrt_work_cancel(&_hrt_work);
 
 	hrt_work_queue(&_hrt_work, (worker_t)&hrt_tim_isr, NULL, delay);
+#endif
 }
 
 static void
@@ -459,15 +834,13 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 
 	//PX4_INFO("hrt_call_internal after lock");
 	/* if the entry is currently queued, remove it */
-	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
+	/* note that entry->deadline may be uninitialised here, but it
+	   is safe as callout_heap_remove() only compares pointers. So we
+	   potentially waste a bit of time searching the heap but we
+	   don't do anything actually unsafe.
 	*/
 	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
+		callout_heap_remove(entry);
 	}
 
 #if 1
@@ -546,7 +919,7 @@ hrt_call_invoke(void)
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
+		call = callout_heap_peek();
 
 		if (call == NULL) {
 			break;
@@ -556,9 +929,11 @@ hrt_call_invoke(void)
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		callout_heap_remove_at(0);
 		//PX4_INFO("call pop");
 
+		hrt_latency_update(call->deadline, now);
+
 		/* save the intended deadline for periodic calls */
 		deadline = call->deadline;
 
@@ -593,3 +968,20 @@ hrt_call_invoke(void)
 	hrt_unlock();
 }
 
+static void
+hrt_latency_update(hrt_abstime deadline, hrt_abstime now)
+{
+	hrt_abstime latency = now - deadline;
+	unsigned	index;
+
+	/* bounded buckets */
+	for (index = 0; index < LATENCY_BUCKET_COUNT; index++) {
+		if (latency <= latency_buckets[index]) {
+			latency_counters[index]++;
+			return;
+		}
+	}
+
+	/* catch-all at the end */
+	latency_counters[index]++;
+}
@@ -54,10 +54,16 @@
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <alloca.h>
+#ifdef __PX4_LINUX
+#include <sys/syscall.h>
+#endif
 #include <string>
 
 #include <px4_tasks.h>
 #include <px4_posix.h>
+#include <px4_workqueue.h>
 #include <systemlib/err.h>
 
 #define MAX_CMD_LEN 100
@@ -72,25 +78,105 @@ struct task_entry {
 	pthread_t pid;
 	std::string name;
 	bool isused;
-	task_entry() : isused(false) {}
+	int tid;
+	uint32_t wakeup_count;
+	uint64_t wakeup_latency_sum;
+	uint32_t wakeup_latency_max;
+	int req_policy;		// scheduling asked for by the spawner, after the realtime profile
+	int req_priority;
+	int cpu;
+	int policy;		// scheduling the thread actually got
+	int priority;
+	task_entry() : isused(false), tid(0), wakeup_count(0), wakeup_latency_sum(0), wakeup_latency_max(0),
+		req_policy(0), req_priority(0), cpu(-1), policy(0), priority(0) {}
 };
 
 static task_entry taskmap[PX4_MAX_TASKS] = {};
 
+#define PX4_MAX_RT_OVERRIDES 16
+
+/* stack left untouched by the prefault, for the frames above the task entry */
+#define PX4_STACK_PREFAULT_MARGIN 8192
+
+struct rt_override {
+	char prefix[16];
+	int priority;
+	int cpu;
+};
+
+/* realtime profile, protected by task_mutex */
+static rt_override rt_overrides[PX4_MAX_RT_OVERRIDES];
+static int rt_override_count = 0;
+static int rt_band_min = -1;
+static int rt_band_max = -1;
+static bool rt_memlock = false;
+
+/* taskmap slot of the calling thread, -1 for threads not started by px4_task_spawn_cmd */
+static __thread int _task_index = -1;
+
 typedef struct {
 	px4_main_t entry;
 	const char *name;
+	int taskid;
+	int cpu;
+	int prefault;
 	int argc;
 	char *argv[];
 	// strings are allocated after the
 } pthdata_t;
 
+/*
+ * Touch the pages the stack can grow into, so the task does not take page
+ * faults in its loop. Must not be inlined so that the alloca is released.
+ */
+static void __attribute__((noinline)) prefault_stack(size_t size)
+{
+	volatile uint8_t *stack = (volatile uint8_t *)alloca(size);
+	const size_t page_size = sysconf(_SC_PAGESIZE);
+
+	for (size_t i = 0; i < size; i += page_size) {
+		stack[i] = 0;
+	}
+}
+
 static void *entry_adapter(void *ptr)
 {
 	pthdata_t *data = (pthdata_t *) ptr;
 
 	int rv;
 
+	_task_index = data->taskid;
+	task_entry &task = taskmap[data->taskid];
+#ifdef __PX4_LINUX
+	task.tid = syscall(SYS_gettid);
+
+	if (data->cpu >= 0) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(data->cpu, &cpuset);
+
+		rv = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+
+		if (rv != 0) {
+			PX4_WARN("%s: failed to pin to cpu %d (%d)", data->name, data->cpu, rv);
+
+		} else {
+			task.cpu = data->cpu;
+		}
+	}
+
+#endif
+
+	if (data->prefault > 0) {
+		prefault_stack(data->prefault);
+	}
+
+	struct sched_param param;
+
+	if (pthread_getschedparam(pthread_self(), &task.policy, &param) == 0) {
+		task.priority = param.sched_priority;
+	}
+
 	// set the threads name
 #ifdef __PX4_DARWIN
 	rv = pthread_setname_np(data->name);
@@ -171,6 +257,31 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 
 	PX4_DEBUG("starting task %s", name);
 
+	// apply the realtime profile
+	int cpu = -1;
+	bool prefault;
+
+	pthread_mutex_lock(&task_mutex);
+
+	if ((scheduler == SCHED_FIFO || scheduler == SCHED_RR) && rt_band_min >= 0) {
+		int span = SCHED_PRIORITY_MAX - SCHED_PRIORITY_MIN;
+		priority = rt_band_min + ((priority - SCHED_PRIORITY_MIN) * (rt_band_max - rt_band_min) + span / 2) / span;
+	}
+
+	for (i = 0; i < rt_override_count; i++) {
+		if (strncmp(name, rt_overrides[i].prefix, strlen(rt_overrides[i].prefix)) == 0) {
+			if (rt_overrides[i].priority >= 0) {
+				priority = rt_overrides[i].priority;
+			}
+
+			cpu = rt_overrides[i].cpu;
+		}
+	}
+
+	prefault = rt_memlock;
+
+	pthread_mutex_unlock(&task_mutex);
+
 	rv = pthread_attr_init(&attr);
 
 	if (rv != 0) {
@@ -185,6 +296,10 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 		stack_size = PTHREAD_STACK_MIN;
 	}
 
+	if (prefault && stack_size > PX4_STACK_PREFAULT_MARGIN) {
+		taskdata->prefault = stack_size - PX4_STACK_PREFAULT_MARGIN;
+	}
+
 	rv = pthread_attr_setstacksize(&attr, stack_size);
 
 	if (rv != 0) {
@@ -233,6 +348,15 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 		if (taskmap[i].isused == false) {
 			taskmap[i].name = name;
 			taskmap[i].isused = true;
+			taskmap[i].tid = 0;
+			taskmap[i].wakeup_count = 0;
+			taskmap[i].wakeup_latency_sum = 0;
+			taskmap[i].wakeup_latency_max = 0;
+			taskmap[i].req_policy = scheduler;
+			taskmap[i].req_priority = priority;
+			taskmap[i].cpu = -1;
+			taskmap[i].policy = 0;
+			taskmap[i].priority = 0;
 			taskid = i;
 			break;
 		}
@@ -245,12 +369,21 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 		return -ENOSPC;
 	}
 
+	taskdata->taskid = taskid;
+	taskdata->cpu = cpu;
+
 	rv = pthread_create(&taskmap[taskid].pid, &attr, &entry_adapter, (void *) taskdata);
 
 	if (rv != 0) {
 
 		if (rv == EPERM) {
-			//printf("WARNING: NOT RUNING AS ROOT, UNABLE TO RUN REALTIME THREADS\n");
+			static bool warned = false;
+
+			if (!warned) {
+				PX4_WARN("no permission for realtime scheduling, tasks run with default attributes");
+				warned = true;
+			}
+
 			rv = pthread_create(&taskmap[taskid].pid, NULL, &entry_adapter, (void *) taskdata);
 
 			if (rv != 0) {
@@ -372,6 +505,8 @@ void px4_show_tasks()
 		PX4_INFO("   No running tasks");
 	}
 
+	PX4_INFO("Work queues:");
+	work_queues_status();
 }
 
 bool px4_task_is_running(const char *taskname)
@@ -410,6 +545,228 @@ const char *px4_get_taskname()
 	return prog_name;
 }
 
+void px4_task_wakeup_latency(uint32_t latency_us)
+{
+	if (_task_index < 0) {
+		return;
+	}
+
+	// only the task itself writes its counters
+	task_entry &task = taskmap[_task_index];
+	task.wakeup_count++;
+	task.wakeup_latency_sum += latency_us;
+
+	if (latency_us > task.wakeup_latency_max) {
+		task.wakeup_latency_max = latency_us;
+	}
+}
+
+#ifdef __PX4_LINUX
+/*
+ * Read the scheduler statistics of a thread: time on the CPU and time spent
+ * on the run queue in ns, and the number of timeslices.
+ */
+static bool read_schedstat(int tid, uint64_t *run_ns, uint64_t *wait_ns, uint64_t *slices)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/self/task/%d/schedstat", tid);
+
+	FILE *f = fopen(path, "r");
+
+	if (f == nullptr) {
+		return false;
+	}
+
+	unsigned long long run, wait, count;
+	int ret = fscanf(f, "%llu %llu %llu", &run, &wait, &count);
+	fclose(f);
+
+	if (ret != 3) {
+		return false;
+	}
+
+	*run_ns = run;
+	*wait_ns = wait;
+	*slices = count;
+	return true;
+}
+#endif
+
+int px4_task_stats(px4_task_stats_t *stats, int max)
+{
+	int count = 0;
+
+	pthread_mutex_lock(&task_mutex);
+
+	for (int i = 0; i < PX4_MAX_TASKS && count < max; i++) {
+		if (!taskmap[i].isused) {
+			continue;
+		}
+
+		px4_task_stats_t &s = stats[count++];
+		memset(&s, 0, sizeof(s));
+		s.index = i;
+		snprintf(s.name, sizeof(s.name), "%s", taskmap[i].name.c_str());
+		s.tid = taskmap[i].tid;
+		s.wakeup_count = taskmap[i].wakeup_count;
+		s.wakeup_latency_sum_us = taskmap[i].wakeup_latency_sum;
+		s.wakeup_latency_max_us = taskmap[i].wakeup_latency_max;
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+#ifdef __PX4_LINUX
+
+	// read /proc outside of the lock, it is not needed for the tid
+	for (int i = 0; i < count; i++) {
+		uint64_t run_ns, wait_ns, slices;
+
+		if (stats[i].tid != 0 && read_schedstat(stats[i].tid, &run_ns, &wait_ns, &slices)) {
+			stats[i].run_time_us = run_ns / 1000;
+			stats[i].runq_time_us = wait_ns / 1000;
+			stats[i].timeslices = slices;
+		}
+	}
+
+#endif
+
+	return count;
+}
+
+int px4_task_rt_memlock(void)
+{
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+		int err = errno;
+		PX4_ERR("mlockall failed: %s", strerror(err));
+		return -err;
+	}
+
+	pthread_mutex_lock(&task_mutex);
+	rt_memlock = true;
+	pthread_mutex_unlock(&task_mutex);
+
+	return 0;
+}
+
+int px4_task_rt_band(int min, int max)
+{
+	if (min < SCHED_PRIORITY_MIN || max > SCHED_PRIORITY_MAX || min > max) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&task_mutex);
+	rt_band_min = min;
+	rt_band_max = max;
+	pthread_mutex_unlock(&task_mutex);
+
+	return 0;
+}
+
+int px4_task_rt_set(const char *prefix, int priority, int cpu)
+{
+	if (priority > SCHED_PRIORITY_MAX || (priority >= 0 && priority < SCHED_PRIORITY_MIN)) {
+		return -EINVAL;
+	}
+
+#ifdef __PX4_LINUX
+
+	if (cpu >= CPU_SETSIZE) {
+		return -EINVAL;
+	}
+
+#else
+
+	// CPU affinity is only supported on Linux
+	if (cpu >= 0) {
+		return -ENOTSUP;
+	}
+
+#endif
+
+	int ret = 0;
+
+	pthread_mutex_lock(&task_mutex);
+
+	int i;
+
+	for (i = 0; i < rt_override_count; i++) {
+		if (strcmp(rt_overrides[i].prefix, prefix) == 0) {
+			break;
+		}
+	}
+
+	if (i < PX4_MAX_RT_OVERRIDES) {
+		snprintf(rt_overrides[i].prefix, sizeof(rt_overrides[i].prefix), "%s", prefix);
+		rt_overrides[i].priority = priority;
+		rt_overrides[i].cpu = cpu;
+
+		if (i == rt_override_count) {
+			rt_override_count++;
+		}
+
+	} else {
+		ret = -ENOSPC;
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	return ret;
+}
+
+static const char *policy_name(int policy)
+{
+	switch (policy) {
+	case SCHED_FIFO:
+		return "FIFO";
+
+	case SCHED_RR:
+		return "RR";
+
+	case SCHED_OTHER:
+		return "OTHER";
+
+	default:
+		return "?";
+	}
+}
+
+void px4_task_rt_status(void)
+{
+	int rt_count = 0;
+	int count = 0;
+
+	PX4_INFO("memory locked: %s", rt_memlock ? "yes" : "no");
+	PX4_INFO("%-16s %6s %-14s %-14s %4s", "task", "tid", "requested", "granted", "cpu");
+
+	pthread_mutex_lock(&task_mutex);
+
+	for (int i = 0; i < PX4_MAX_TASKS; i++) {
+		const task_entry &task = taskmap[i];
+
+		if (!task.isused) {
+			continue;
+		}
+
+		char requested[16];
+		char granted[16];
+		snprintf(requested, sizeof(requested), "%s %d", policy_name(task.req_policy), task.req_priority);
+		snprintf(granted, sizeof(granted), "%s %d", policy_name(task.policy), task.priority);
+
+		PX4_INFO("%-16.16s %6d %-14s %-14s %4d%s", task.name.c_str(), task.tid, requested, granted, task.cpu,
+			 (task.policy != task.req_policy || task.priority != task.req_priority) ? "  !" : "");
+
+		if (task.policy == SCHED_FIFO || task.policy == SCHED_RR) {
+			rt_count++;
+		}
+
+		count++;
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	PX4_INFO("%d of %d tasks run with realtime scheduling", rt_count, count);
+}
+
 int px4_prctl(int option, const char *arg2, unsigned pid)
 {
 	int rv;
@@ -40,10 +40,13 @@
  */
 
 #include <px4_time.h>
+#include <px4_log.h>
 #include <drivers/drv_hrt.h>
 #include "hrt_test.h"
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 
 px4::AppState HRTTest::appState;
 
@@ -61,6 +64,111 @@ static void timer_expired(void *arg)
 	}
 }
 
+static struct hrt_call jitter_call;
+static hrt_abstime jitter_start;
+static hrt_abstime jitter_period;
+static volatile unsigned jitter_samples;
+static unsigned jitter_count;
+static int64_t jitter_min;
+static int64_t jitter_max;
+static double jitter_sum;
+static double jitter_sum_sq;
+
+static const unsigned jitter_bucket_count = 8;
+static const unsigned jitter_buckets[jitter_bucket_count] = { 1, 2, 5, 10, 20, 50, 100, 1000 };
+static unsigned jitter_counters[jitter_bucket_count + 1];
+
+static void jitter_expired(void *arg)
+{
+	hrt_abstime now = hrt_absolute_time();
+
+	if (jitter_samples >= jitter_count) {
+		return;
+	}
+
+	/* hrt_call_every() schedules from the previous deadline, so the n-th
+	 * call is due at start + n * period */
+	int64_t late = (int64_t)(now - (jitter_start + (jitter_samples + 1) * jitter_period));
+
+	if (late < jitter_min) {
+		jitter_min = late;
+	}
+
+	if (late > jitter_max) {
+		jitter_max = late;
+	}
+
+	jitter_sum += late;
+	jitter_sum_sq += (double)late * late;
+
+	unsigned index;
+	unsigned abs_late = (late < 0) ? -late : late;
+
+	for (index = 0; index < jitter_bucket_count; index++) {
+		if (abs_late <= jitter_buckets[index]) {
+			break;
+		}
+	}
+
+	jitter_counters[index]++;
+	jitter_samples = jitter_samples + 1;
+}
+
+int HRTTest::jitter(unsigned period_us, unsigned count)
+{
+	if (period_us == 0 || count == 0) {
+		PX4_ERR("invalid period or count");
+		return 1;
+	}
+
+	memset(&jitter_call, 0, sizeof(jitter_call));
+	memset(jitter_counters, 0, sizeof(jitter_counters));
+	jitter_period = period_us;
+	jitter_count = count;
+	jitter_samples = 0;
+	jitter_min = INT64_MAX;
+	jitter_max = INT64_MIN;
+	jitter_sum = 0.0;
+	jitter_sum_sq = 0.0;
+
+	PX4_INFO("sampling %u callouts at %u us", count, period_us);
+
+	jitter_start = hrt_absolute_time();
+	hrt_call_every(&jitter_call, period_us, period_us, jitter_expired, (void *)0);
+
+	/* allow for twice the nominal duration before giving up */
+	hrt_abstime timeout = jitter_start + 2 * (hrt_abstime)period_us * count + 1000000;
+
+	while (jitter_samples < count && hrt_absolute_time() < timeout) {
+		usleep(10000);
+	}
+
+	hrt_cancel(&jitter_call);
+
+	unsigned samples = jitter_samples;
+
+	if (samples == 0) {
+		PX4_ERR("no callouts received");
+		return 1;
+	}
+
+	double mean = jitter_sum / samples;
+	double stddev = sqrt(fmax(jitter_sum_sq / samples - mean * mean, 0.0));
+
+	PX4_INFO("%u samples: min %lld us, max %lld us, mean %.1f us, stddev %.1f us",
+		 samples, (long long)jitter_min, (long long)jitter_max, mean, stddev);
+
+	printf("  |late| us : events\n");
+
+	for (unsigned i = 0; i < jitter_bucket_count; i++) {
+		printf("  %8u : %u\n", jitter_buckets[i], jitter_counters[i]);
+	}
+
+	printf(" >%8u : %u\n", jitter_buckets[jitter_bucket_count - 1], jitter_counters[jitter_bucket_count]);
+
+	return (samples == count) ? 0 : 1;
+}
+
 int HRTTest::main()
 {
 	appState.setRunning(true);
@@ -50,5 +50,13 @@ public:
 
 	int main();
 
+	/**
+	 * Measure the wakeup jitter of a periodic hrt_call_every() callout.
+	 *
+	 * @param period_us	callout period in microseconds
+	 * @param count		number of callouts to sample
+	 */
+	int jitter(unsigned period_us, unsigned count);
+
 	static px4::AppState appState; /* track requests to terminate app */
 };
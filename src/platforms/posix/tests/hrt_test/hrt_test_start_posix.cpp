@@ -42,6 +42,7 @@
 #include <px4_tasks.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <sched.h>
 
 static int daemon_task;             /* Handle of deamon task / thread */
@@ -50,10 +51,18 @@ extern "C" __EXPORT int hrttest_main(int argc, char *argv[]);
 int hrttest_main(int argc, char *argv[])
 {
 	if (argc < 2) {
-		PX4_WARN("usage: hrttest_main {start|stop|status}\n");
+		PX4_WARN("usage: hrttest_main {start|stop|status|jitter [period_us] [count]}\n");
 		return 1;
 	}
 
+	if (!strcmp(argv[1], "jitter")) {
+		unsigned period_us = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000;
+		unsigned count = (argc > 3) ? strtoul(argv[3], NULL, 10) : 5000;
+
+		HRTTest test;
+		return test.jitter(period_us, count);
+	}
+
 	if (!strcmp(argv[1], "start")) {
 
 		if (HRTTest::appState.isRunning()) {
@@ -88,6 +97,6 @@ int hrttest_main(int argc, char *argv[])
 		return 0;
 	}
 
-	PX4_WARN("usage: hrttest_main {start|stop|status}\n");
+	PX4_WARN("usage: hrttest_main {start|stop|status|jitter [period_us] [count]}\n");
 	return 1;
 }
@@ -37,6 +37,7 @@
 
 
 extern px4_sem_t _work_lock[];
+extern px4_sem_t _work_wakeup[];
 
 void work_lock(int id)
 {
@@ -47,3 +48,15 @@ void work_unlock(int id)
 {
 	px4_sem_post(&_work_lock[id]);
 }
+
+void work_wakeup(int id)
+{
+	int value = 0;
+
+	/* one pending wakeup is enough, the worker rescans the whole list */
+	if (px4_sem_getvalue(&_work_wakeup[id], &value) == 0 && value > 0) {
+		return;
+	}
+
+	px4_sem_post(&_work_wakeup[id]);
+}
@@ -40,4 +40,7 @@
 void work_lock(int id);
 void work_unlock(int id);
 
+/* wake the worker thread of queue id to re-evaluate its work list */
+void work_wakeup(int id);
+
 #endif // _work_lock_h_
@@ -37,6 +37,10 @@
  * Included Files
  ****************************************************************************/
 
+#ifdef __PX4_LINUX
+#define _GNU_SOURCE /* pthread_setaffinity_np */
+#endif
+
 #include <px4_config.h>
 #include <px4_defines.h>
 #include <px4_posix.h>
@@ -46,6 +50,10 @@
 #include <unistd.h>
 #include <queue.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
 #include <px4_workqueue.h>
 #include <drivers/drv_hrt.h>
 #include "work_lock.h"
@@ -65,12 +73,26 @@
  ****************************************************************************/
 
 /* The state of each work queue. */
-struct wqueue_s g_work[NWORKERS];
+struct wqueue_s g_work[NWORKERS] = {
+	[HPWORK]  = { .name = "hpwork", .cpu = -1 },
+	[LPWORK]  = { .name = "lpwork", .cpu = -1 },
+
+	/* default pool: leave CPU 0 to everything else and spread the I/O queues
+	 * over the remaining cores, they are left unpinned on smaller systems.
+	 * work_queue_configure() changes these or adds more before first use. */
+	[WORK_POOL_FIRST]     = { .name = "wq_io0", .priority = -1, .cpu = 1 },
+	[WORK_POOL_FIRST + 1] = { .name = "wq_io1", .priority = -1, .cpu = 2 },
+	[WORK_POOL_FIRST + 2] = { .name = "wq_io2", .priority = -1, .cpu = 3 },
+};
 
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
 px4_sem_t _work_lock[NWORKERS];
+px4_sem_t _work_wakeup[NWORKERS];
+
+/* serializes configuring and starting the pool queues */
+static pthread_mutex_t _work_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /****************************************************************************
  * Private Functions
@@ -96,6 +118,7 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 	worker_t  worker;
 	void *arg;
 	uint64_t elapsed;
+	uint64_t delay;
 	uint32_t remaining;
 	uint32_t next;
 
@@ -116,10 +139,11 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 		 * zero.  Therefore a delay of zero will always execute immediately.
 		 */
 
-		elapsed = USEC2TICK(clock_systimer() - work->qtime);
+		elapsed = hrt_absolute_time() - work->qtime;
+		delay = (uint64_t)work->delay * USEC_PER_TICK;
 
-		//printf("work_process: in ticks elapsed=%lu delay=%u\n", elapsed, work->delay);
-		if (elapsed >= work->delay) {
+		//printf("work_process: in usec elapsed=%lu delay=%lu\n", elapsed, delay);
+		if (elapsed >= delay) {
 			/* Remove the ready-to-execute work from the list */
 
 			(void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
@@ -161,8 +185,8 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 			 * scheduled wakeup interval?
 			 */
 
-			/* Here: elapsed < work->delay */
-			remaining = USEC_PER_TICK * (work->delay - elapsed);
+			/* Here: elapsed < delay */
+			remaining = delay - elapsed;
 
 			if (remaining < next) {
 				/* Yes.. Then schedule to wake up when the work is ready */
@@ -177,11 +201,42 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 	}
 
 	/* Wait awhile to check the work list.  We will wait here until either
-	 * the time elapses or until we are awakened by a signal.
+	 * the time elapses or until work_queue() posts the wakeup semaphore.
 	 */
 	work_unlock(lock_id);
 
-	usleep(next);
+	hrt_sem_timedwait(&_work_wakeup[lock_id], next);
+}
+
+/****************************************************************************
+ * Name: work_pin_cpu
+ *
+ * Description:
+ *   Pin the calling worker thread to the CPU configured for its queue, if
+ *   the system has that many CPUs.
+ *
+ ****************************************************************************/
+
+static void work_pin_cpu(struct wqueue_s *wqueue)
+{
+#ifdef __PX4_LINUX
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (wqueue->cpu < 0 || wqueue->cpu >= ncpus) {
+		return;
+	}
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(wqueue->cpu, &cpuset);
+
+	int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+
+	if (ret != 0) {
+		PX4_WARN("%s: failed to pin to CPU %d: %s", wqueue->name, wqueue->cpu, strerror(ret));
+	}
+
+#endif
 }
 
 /****************************************************************************
@@ -189,28 +244,133 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
  ****************************************************************************/
 void work_queues_init(void)
 {
-	px4_sem_init(&_work_lock[HPWORK], 0, 1);
-	px4_sem_init(&_work_lock[LPWORK], 0, 1);
-#ifdef CONFIG_SCHED_USRWORK
-	px4_sem_init(&_work_lock[USRWORK], 0, 1);
-#endif
+	for (int qid = 0; qid < NWORKERS; qid++) {
+		px4_sem_init(&_work_lock[qid], 0, 1);
+		px4_sem_init(&_work_wakeup[qid], 0, 0);
+		g_work[qid].pid = -1;
+	}
+
+	g_work[HPWORK].priority = SCHED_PRIORITY_MAX - 1;
+	g_work[LPWORK].priority = SCHED_PRIORITY_MIN;
 
 	// Create high priority worker thread
-	g_work[HPWORK].pid = px4_task_spawn_cmd("hpwork",
+	g_work[HPWORK].pid = px4_task_spawn_cmd(g_work[HPWORK].name,
 						SCHED_DEFAULT,
-						SCHED_PRIORITY_MAX - 1,
+						g_work[HPWORK].priority,
 						2000,
 						work_hpthread,
 						(char *const *)NULL);
 
 	// Create low priority worker thread
-	g_work[LPWORK].pid = px4_task_spawn_cmd("lpwork",
+	g_work[LPWORK].pid = px4_task_spawn_cmd(g_work[LPWORK].name,
 						SCHED_DEFAULT,
-						SCHED_PRIORITY_MIN,
+						g_work[LPWORK].priority,
 						2000,
 						work_lpthread,
 						(char *const *)NULL);
 
+	/* the pool queues are started by work_queue_find() on first use */
+}
+
+int work_queue_configure(const char *name, int priority, int cpu)
+{
+	int ret = -ENOSPC;
+
+	pthread_mutex_lock(&_work_pool_mutex);
+
+	for (int qid = WORK_POOL_FIRST; qid < NWORKERS; qid++) {
+		struct wqueue_s *wqueue = &g_work[qid];
+
+		/* take the queue with this name or else the first unused slot */
+		if (wqueue->name[0] != '\0' && strncmp(wqueue->name, name, sizeof(wqueue->name)) != 0) {
+			continue;
+		}
+
+		if (wqueue->pid >= 0) {
+			ret = -EBUSY;
+			break;
+		}
+
+		strncpy(wqueue->name, name, sizeof(wqueue->name) - 1);
+		wqueue->priority = priority;
+		wqueue->cpu = cpu;
+		ret = 0;
+		break;
+	}
+
+	pthread_mutex_unlock(&_work_pool_mutex);
+
+	return ret;
+}
+
+int work_queue_find(const char *name)
+{
+	int ret = HPWORK;
+
+	pthread_mutex_lock(&_work_pool_mutex);
+
+	for (int qid = WORK_POOL_FIRST; qid < NWORKERS; qid++) {
+		struct wqueue_s *wqueue = &g_work[qid];
+
+		if (wqueue->name[0] == '\0' || strncmp(wqueue->name, name, sizeof(wqueue->name)) != 0) {
+			continue;
+		}
+
+		if (wqueue->pid < 0) {
+			/* the pool runs just below the high priority queue unless configured otherwise */
+			if (wqueue->priority < 0) {
+				wqueue->priority = SCHED_PRIORITY_MAX - 2;
+			}
+
+			/* the queue id is passed as argument */
+			char qid_str[4];
+			snprintf(qid_str, sizeof(qid_str), "%d", qid);
+			char *const argv[2] = { qid_str, NULL };
+
+			wqueue->pid = px4_task_spawn_cmd(wqueue->name,
+							 SCHED_DEFAULT,
+							 wqueue->priority,
+							 2000,
+							 work_iothread,
+							 argv);
+		}
+
+		if (wqueue->pid >= 0) {
+			ret = qid;
+		}
+
+		break;
+	}
+
+	pthread_mutex_unlock(&_work_pool_mutex);
+
+	if (ret == HPWORK) {
+		PX4_WARN("work queue %s not available, using hpwork", name);
+	}
+
+	return ret;
+}
+
+void work_queues_status(void)
+{
+	for (int qid = 0; qid < NWORKERS; qid++) {
+		unsigned pending = 0;
+
+		if (g_work[qid].name[0] == '\0') {
+			continue;
+		}
+
+		work_lock(qid);
+
+		for (dq_entry_t *entry = g_work[qid].q.head; entry != NULL; entry = entry->flink) {
+			pending++;
+		}
+
+		work_unlock(qid);
+
+		PX4_INFO("%-8s prio %3d cpu %2d pending %u%s", g_work[qid].name, g_work[qid].priority,
+			 g_work[qid].cpu, pending, (g_work[qid].pid >= 0) ? "" : " (not started)");
+	}
 }
 
 /****************************************************************************
@@ -299,6 +459,26 @@ int work_lpthread(int argc, char *argv[])
 }
 
 #endif /* CONFIG_SCHED_LPWORK */
+
+int work_iothread(int argc, char *argv[])
+{
+	int qid = (argc > 0) ? atoi(argv[0]) : -1;
+
+	if (qid < WORK_POOL_FIRST || qid >= NWORKERS) {
+		PX4_ERR("work_iothread: invalid queue %d", qid);
+		return PX4_ERROR;
+	}
+
+	work_pin_cpu(&g_work[qid]);
+
+	/* Loop forever */
+
+	for (;;) {
+		work_process(&g_work[qid], qid);
+	}
+
+	return PX4_OK; /* To keep some compilers happy */
+}
 #endif /* CONFIG_SCHED_HPWORK */
 
 #ifdef CONFIG_SCHED_USRWORK
@@ -94,6 +94,7 @@ typedef struct {
 	/* Required for PX4 compatibility */
 	px4_sem_t   *sem;  	/* Pointer to semaphore used to post output event */
 	void   *priv;     	/* For use by drivers */
+	uint64_t notify_time;	/* Time the waiter was woken, for wakeup latency */
 } px4_pollfd_struct_t;
 
 __BEGIN_DECLS
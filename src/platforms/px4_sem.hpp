@@ -39,7 +39,11 @@
 
 #pragma once
 
+#include <errno.h>
+#include <stdint.h>
+
 #include "px4_sem.h"
+#include "px4_time.h"
 
 
 /**
@@ -66,3 +70,68 @@ public:
 private:
 	px4_sem_t &_sem;
 };
+
+/**
+ * @class Readiness signal between a module start command and the task it
+ * spawns. The task calls set_ready() once it is initialized, or once it has
+ * given up, and the start command blocks in wait() instead of sleeping and
+ * polling a flag. Use like this:
+ *
+ *   static ReadySignal ready;
+ *
+ *   start:  ready.reset(); spawn the task; ready.wait(timeout) && running
+ *   task:   initialize; running = true; ready.set_ready();
+ */
+class ReadySignal
+{
+public:
+	ReadySignal() { px4_sem_init(&_sem, 0, 0); }
+	~ReadySignal() { px4_sem_destroy(&_sem); }
+
+	/**
+	 * Drop a signal left over from a previous run of the task.
+	 * Call before spawning the task.
+	 */
+	void reset()
+	{
+		int value = 0;
+
+		while (px4_sem_getvalue(&_sem, &value) == 0 && value > 0) {
+			px4_sem_wait(&_sem);
+		}
+	}
+
+	void set_ready() { px4_sem_post(&_sem); }
+
+	/**
+	 * Wait for set_ready(), for at most timeout_us of wall time.
+	 * @param timeout_us timeout, 0 to wait forever
+	 * @return true if signalled, false on timeout
+	 */
+	bool wait(unsigned timeout_us)
+	{
+		if (timeout_us == 0) {
+			while (px4_sem_wait(&_sem) != 0) {}
+
+			return true;
+		}
+
+		struct timespec abstime;
+		px4_clock_gettime(CLOCK_REALTIME, &abstime);
+
+		uint64_t nsecs = abstime.tv_nsec + (uint64_t)timeout_us * 1000;
+		abstime.tv_sec += nsecs / 1000000000;
+		abstime.tv_nsec = nsecs % 1000000000;
+
+		while (px4_sem_timedwait(&_sem, &abstime) != 0) {
+			if (errno != EINTR) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+private:
+	px4_sem_t _sem;
+};
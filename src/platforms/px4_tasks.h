@@ -41,6 +41,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __PX4_ROS
 
@@ -95,6 +96,19 @@ typedef struct {
 	int argc;
 	char **argv;
 } px4_task_args_t;
+
+/** Scheduling statistics of a task started with px4_task_spawn_cmd */
+typedef struct {
+	int		index;			/**< task slot, stable while the task runs */
+	char		name[16];		/**< task name */
+	int		tid;			/**< kernel thread id, 0 if unknown */
+	uint64_t	run_time_us;		/**< CPU time consumed */
+	uint64_t	runq_time_us;		/**< time spent runnable but waiting for a CPU */
+	uint64_t	timeslices;		/**< number of times the task got a CPU */
+	uint32_t	wakeup_count;		/**< number of px4_poll() wakeups */
+	uint64_t	wakeup_latency_sum_us;	/**< sum of poll_notify to resume latencies */
+	uint32_t	wakeup_latency_max_us;	/**< maximum poll_notify to resume latency */
+} px4_task_stats_t;
 #else
 #error "No target OS defined"
 #endif
@@ -132,6 +146,29 @@ __EXPORT bool px4_task_is_running(const char *taskname);
 #ifdef __PX4_POSIX
 /** set process (and thread) options */
 __EXPORT int px4_prctl(int option, const char *arg2, unsigned pid);
+
+/** Get the scheduling statistics of up to max running tasks, returns the number filled in */
+__EXPORT int px4_task_stats(px4_task_stats_t *stats, int max);
+
+/** Record the latency between a poll notification and the calling task resuming */
+__EXPORT void px4_task_wakeup_latency(uint32_t latency_us);
+
+/*
+ * Realtime profile, applied to the tasks spawned after it is configured
+ * (typically from the first lines of the startup script).
+ */
+
+/** Lock all current and future memory and prefault the stack of new tasks, returns 0 or -errno */
+__EXPORT int px4_task_rt_memlock(void);
+
+/** Map the priorities of SCHED_FIFO and SCHED_RR tasks linearly onto [min, max] */
+__EXPORT int px4_task_rt_band(int min, int max);
+
+/** Override the priority (-1 to keep) and CPU (-1 for any) of tasks whose name starts with prefix */
+__EXPORT int px4_task_rt_set(const char *prefix, int priority, int cpu);
+
+/** Print the requested and the granted scheduling of the running tasks */
+__EXPORT void px4_task_rt_status(void);
 #endif
 
 /** return the name of the current task */
@@ -43,3 +43,18 @@ __EXPORT unsigned int sleep(unsigned int sec);
 
 __END_DECLS
 #endif
+
+#if defined(__PX4_NUTTX) || defined(__PX4_QURT)
+
+#define px4_usleep usleep
+
+#else
+
+__BEGIN_DECLS
+
+/** usleep() in HRT time, which is the simulated time when the HRT runs in lockstep */
+__EXPORT int px4_usleep(unsigned int usec);
+
+__END_DECLS
+
+#endif
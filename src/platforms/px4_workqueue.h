@@ -41,6 +41,13 @@
 #include <nuttx/arch.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/clock.h>
+
+/* NuttX has no work queue pool, every pool queue is the high priority queue */
+static inline int work_queue_find(const char *name)
+{
+	(void)name;
+	return HPWORK;
+}
 #elif defined(__PX4_POSIX)
 
 #include <stdint.h>
@@ -55,11 +62,23 @@ __BEGIN_DECLS
 
 #define HPWORK 0
 #define LPWORK 1
-#define NWORKERS 2
+
+/* Pool of named work queues for I/O bound drivers. Each one is served by its
+ * own thread with a configurable priority and CPU, so that their cycle()
+ * callbacks do not serialize behind the other drivers. Drivers look their
+ * queue up by name with work_queue_find(). */
+#define WORK_POOL_FIRST 2
+#define WORK_POOL_SIZE 8
+#define NWORKERS (WORK_POOL_FIRST + WORK_POOL_SIZE)
+
+#define WORK_QUEUE_NAME_LEN 16
 
 struct wqueue_s {
-	pid_t             pid; /* The task ID of the worker thread */
+	pid_t             pid; /* The task ID of the worker thread, -1 if not started */
 	struct dq_queue_s q;   /* The queue of pending work */
+	char              name[WORK_QUEUE_NAME_LEN]; /* Name of the queue and its thread, empty if unused */
+	int               priority;  /* Scheduling priority of the worker thread, -1 for the pool default */
+	int               cpu;       /* CPU the worker thread is pinned to, -1 for any */
 };
 
 extern struct wqueue_s g_work[NWORKERS];
@@ -139,6 +158,50 @@ uint32_t clock_systimer(void);
 
 int work_hpthread(int argc, char *argv[]);
 int work_lpthread(int argc, char *argv[]);
+int work_iothread(int argc, char *argv[]);
+
+/****************************************************************************
+ * Name: work_queue_configure
+ *
+ * Description:
+ *   Define a pool queue or change the priority and CPU of one that has not
+ *   been started yet.
+ *
+ * Input parameters:
+ *   name     - Name of the queue
+ *   priority - Scheduling priority of its thread, -1 for the pool default
+ *   cpu      - CPU to pin its thread to, -1 for any
+ *
+ * Returned Value:
+ *   Zero on success, -EBUSY if the queue is running, -ENOSPC if the pool
+ *   is full
+ *
+ ****************************************************************************/
+
+int work_queue_configure(const char *name, int priority, int cpu);
+
+/****************************************************************************
+ * Name: work_queue_find
+ *
+ * Description:
+ *   Look up a pool queue by name, starting its thread on first use.
+ *
+ * Returned Value:
+ *   The work queue ID, HPWORK if there is no queue with that name
+ *
+ ****************************************************************************/
+
+int work_queue_find(const char *name);
+
+/****************************************************************************
+ * Name: work_queues_status
+ *
+ * Description:
+ *   Print the configuration and backlog of each work queue.
+ *
+ ****************************************************************************/
+
+void work_queues_status(void);
 
 __END_DECLS
 
@@ -326,6 +326,48 @@ void px4_show_tasks()
 
 }
 
+void px4_task_wakeup_latency(uint32_t latency_us)
+{
+	/* not tracked on QURT */
+}
+
+int px4_task_rt_memlock(void)
+{
+	return -ENOTSUP;
+}
+
+int px4_task_rt_band(int min, int max)
+{
+	return -ENOTSUP;
+}
+
+int px4_task_rt_set(const char *prefix, int priority, int cpu)
+{
+	return -ENOTSUP;
+}
+
+void px4_task_rt_status(void)
+{
+	PX4_INFO("realtime profile not supported on QURT");
+}
+
+int px4_task_stats(px4_task_stats_t *stats, int max)
+{
+	int count = 0;
+
+	/* no scheduler statistics on QURT, only report the running tasks */
+	for (int i = 0; i < PX4_MAX_TASKS && count < max; i++) {
+		if (taskmap[i].isused) {
+			px4_task_stats_t &s = stats[count++];
+			memset(&s, 0, sizeof(s));
+			s.index = i;
+			snprintf(s.name, sizeof(s.name), "%s", taskmap[i].name.c_str());
+		}
+	}
+
+	return count;
+}
+
 unsigned long px4_getpid()
 {
 	pthread_t pid = pthread_self();
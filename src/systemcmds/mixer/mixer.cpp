@@ -123,13 +123,15 @@ load(const char *devname, const char *fname)
 
 	char buf[2048];
 
-	if (load_mixer_file(fname, &buf[0], sizeof(buf)) < 0) {
+	int len = load_mixer_file(fname, &buf[0], sizeof(buf));
+
+	if (len < 0) {
 		warnx("can't load mixer: %s", fname);
 		return 1;
 	}
 
-	/* Pass the buffer to the device */
-	int ret = px4_ioctl(dev, MIXERIOCLOADBUF, (unsigned long)buf);
+	/* Pass the buffer to the device, precompiled images skip the text parser */
+	int ret = px4_ioctl(dev, (len > 0) ? MIXERIOCLOADBIN : MIXERIOCLOADBUF, (unsigned long)buf);
 
 	if (ret < 0) {
 		warnx("error loading mixers from %s", fname);
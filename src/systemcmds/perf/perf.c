@@ -42,6 +42,7 @@
 #include <string.h>
 
 #include "systemlib/perf_counter.h"
+#include "systemlib/latency_trace.h"
 
 
 /****************************************************************************
@@ -69,13 +70,45 @@ int perf_main(int argc, char *argv[])
 			perf_reset_all();
 			return 0;
 
+		} else if (strcmp(argv[1], "dump") == 0) {
+			perf_dump_all(1 /* stdout */);
+			fflush(stdout);
+
+			/* reset right after the dump so that consecutive dumps cover
+			 * consecutive periods */
+			if (argc > 2 && strcmp(argv[2], "-r") == 0) {
+				perf_reset_all();
+			}
+
+			return 0;
+
 		} else if (strcmp(argv[1], "latency") == 0) {
 			perf_print_latency(1 /* stdout */);
 			fflush(stdout);
 			return 0;
+
+		} else if (strcmp(argv[1], "trace") == 0) {
+			if (argc > 2 && strcmp(argv[2], "start") == 0) {
+				return latency_trace_start();
+
+			} else if (argc > 2 && strcmp(argv[2], "stop") == 0) {
+				latency_trace_stop();
+				return 0;
+
+			} else if (argc > 3 && strcmp(argv[2], "dump") == 0) {
+				return latency_trace_dump(argv[3]);
+
+			} else if (argc == 2) {
+				latency_trace_print(1 /* stdout */);
+				fflush(stdout);
+				return 0;
+			}
+
+			printf("Usage: perf trace [start | stop | dump <file>]\n");
+			return -1;
 		}
 
-		printf("Usage: perf [reset | latency]\n");
+		printf("Usage: perf [reset | dump [-r] | latency | trace]\n");
 		return -1;
 	}
 
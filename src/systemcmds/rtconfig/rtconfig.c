@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2016 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file rtconfig.c
+ * Configure the realtime profile of the tasks spawned on POSIX: memory
+ * locking, the priority band, per-task priority and CPU overrides and the
+ * pool of named work queues.
+ * Run it before the tasks it should affect are started.
+ */
+
+#include <px4_config.h>
+#include <px4_tasks.h>
+#include <px4_workqueue.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+__EXPORT int rtconfig_main(int argc, char *argv[]);
+
+static void usage(void)
+{
+	printf("Usage: rtconfig <command>\n"
+	       "  memlock                       lock memory and prefault task stacks\n"
+	       "  band <min> <max>              map task priorities onto [min, max]\n"
+	       "  task <prefix> <prio> <cpu>    override tasks whose name starts with prefix,\n"
+	       "                                -1 keeps the priority / allows any CPU\n"
+	       "  wq <name> <prio> <cpu>        define or change a pool work queue before\n"
+	       "                                its first use, -1 for the defaults\n"
+	       "  status                        show requested and granted scheduling\n");
+}
+
+int rtconfig_main(int argc, char *argv[])
+{
+	int ret;
+
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "memlock")) {
+		ret = px4_task_rt_memlock();
+
+	} else if (!strcmp(argv[1], "band") && argc == 4) {
+		ret = px4_task_rt_band(atoi(argv[2]), atoi(argv[3]));
+
+	} else if (!strcmp(argv[1], "task") && argc == 5) {
+		ret = px4_task_rt_set(argv[2], atoi(argv[3]), atoi(argv[4]));
+
+	} else if (!strcmp(argv[1], "wq") && argc == 5) {
+		ret = work_queue_configure(argv[2], atoi(argv[3]), atoi(argv[4]));
+
+	} else if (!strcmp(argv[1], "status")) {
+		px4_task_rt_status();
+		work_queues_status();
+		return 0;
+
+	} else {
+		usage();
+		return 1;
+	}
+
+	if (ret != 0) {
+		printf("rtconfig %s failed (%d)\n", argv[1], ret);
+		return 1;
+	}
+
+	return 0;
+}
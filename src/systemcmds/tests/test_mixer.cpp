@@ -64,6 +64,7 @@ static int	mixer_callback(uintptr_t handle,
 			       uint8_t control_group,
 			       uint8_t control_index,
 			       float &control);
+static int	load_mixer(MixerGroup &group, bool binary, const char *buf, unsigned &buflen);
 
 const unsigned output_max = 8;
 static float actuator_controls[output_max];
@@ -103,8 +104,10 @@ int test_mixer(int argc, char *argv[])
 
 	char		buf[2048];
 
-	load_mixer_file(filename, &buf[0], sizeof(buf));
-	unsigned loaded = strlen(buf);
+	/* the ROMFS mixers are precompiled on NuttX */
+	int image_length = load_mixer_file(filename, &buf[0], sizeof(buf));
+	bool binary = (image_length > 0);
+	unsigned loaded = binary ? image_length : strlen(buf);
 
 	//fprintf(stderr, "loaded: \n\"%s\"\n (%d chars)", &buf[0], loaded);
 
@@ -119,7 +122,7 @@ int test_mixer(int argc, char *argv[])
 
 	/* load at once test */
 	unsigned xx = loaded;
-	mixer_group.load_from_buf(&buf[0], xx);
+	load_mixer(mixer_group, binary, &buf[0], xx);
 	//ASSERT_EQ(mixer_group.count(), 8);
 
 	unsigned empty_load = 2;
@@ -163,7 +166,7 @@ int test_mixer(int argc, char *argv[])
 
 		/* process the text buffer, adding new mixers as their descriptions can be parsed */
 		unsigned resid = mixer_text_length;
-		mixer_group.load_from_buf(&mixer_text[0], resid);
+		load_mixer(mixer_group, binary, &mixer_text[0], resid);
 
 		/* if anything was parsed */
 		if (resid != mixer_text_length) {
@@ -409,13 +412,14 @@ int test_mixer(int argc, char *argv[])
 	filename = "../../../../ROMFS/px4fmu_test/mixers/quad_test.mix";
 #endif
 
-	load_mixer_file(filename, &buf[0], sizeof(buf));
-	loaded = strlen(buf);
+	image_length = load_mixer_file(filename, &buf[0], sizeof(buf));
+	binary = (image_length > 0);
+	loaded = binary ? image_length : strlen(buf);
 
 	//fprintf(stderr, "loaded: \n\"%s\"\n (%d chars)", &buf[0], loaded);
 
 	unsigned mc_loaded = loaded;
-	mixer_group.load_from_buf(&buf[0], mc_loaded);
+	load_mixer(mixer_group, binary, &buf[0], mc_loaded);
 	//PX4_INFO("complete buffer load: loaded %u mixers", mixer_group.count());
 
 	if (mixer_group.count() != 5) {
@@ -427,6 +431,12 @@ int test_mixer(int argc, char *argv[])
 	return 0;
 }
 
+static int
+load_mixer(MixerGroup &group, bool binary, const char *buf, unsigned &buflen)
+{
+	return binary ? group.load_from_bin(buf, buflen) : group.load_from_buf(buf, buflen);
+}
+
 static int
 mixer_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
 {
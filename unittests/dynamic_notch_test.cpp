@@ -0,0 +1,133 @@
+#include <math.h>
+#include <stdio.h>
+
+#include <mathlib/math/filter/DynamicNotch.hpp>
+
+#include "gtest/gtest.h"
+#include "timing.h"
+
+// slow body motion plus a motor vibration line and some broadband noise
+static void gyro_sample(unsigned i, float rate, float vibration_freq, float sample[3])
+{
+	float t = i / rate;
+	float vibration = 0.5f * sinf(2.0f * M_PI_F * vibration_freq * t);
+	float noise = 0.02f * ((float)((i * 7919) % 101) / 50.0f - 1.0f);
+
+	sample[0] = 0.3f * sinf(2.0f * M_PI_F * 2.0f * t) + vibration + noise;
+	sample[1] = 0.1f + 0.7f * vibration - noise;
+	sample[2] = -0.2f + 0.2f * vibration + noise;
+}
+
+TEST(DynamicNotchTest, TracksVibrationPeak)
+{
+	const float rate = 1000.0f;
+	math::DynamicNotch notch;
+	notch.init(rate, 60.0f, 400.0f, 3.0f);
+
+	float residual = 0.0f;
+
+	for (unsigned i = 0; i < 4000; i++) {
+		float vibration_freq = (i < 2000) ? 180.0f : 250.0f;
+		float sample[3];
+		gyro_sample(i, rate, vibration_freq, sample);
+		notch.apply(sample);
+
+		if (i == 1999) {
+			EXPECT_NEAR(180.0f, notch.get_notch_freq(), 8.0f);
+		}
+
+		// the z axis carries only the vibration around its offset
+		if (i > 3500) {
+			residual = fmaxf(residual, fabsf(sample[2] + 0.2f));
+		}
+	}
+
+	EXPECT_NEAR(250.0f, notch.get_peak_freq(), 8.0f);
+	EXPECT_NEAR(250.0f, notch.get_notch_freq(), 8.0f);
+	// 0.1 vibration amplitude plus 0.02 noise going in
+	EXPECT_LT(residual, 0.06f);
+}
+
+TEST(DynamicNotchTest, NoPeakNoNotch)
+{
+	const float rate = 1000.0f;
+	math::DynamicNotch notch;
+	notch.init(rate, 60.0f, 400.0f, 3.0f);
+
+	for (unsigned i = 0; i < 2000; i++) {
+		float t = i / rate;
+		float sample[3] = {0.3f * sinf(2.0f * M_PI_F * 2.0f * t), 0.0f, 0.0f};
+		float input = sample[0];
+		notch.apply(sample);
+		EXPECT_FLOAT_EQ(input, sample[0]);
+	}
+
+	EXPECT_EQ(0.0f, notch.get_notch_freq());
+}
+
+TEST(DynamicNotchTest, Spectrum)
+{
+	const float rate = 8000.0f;
+	math::DynamicNotch notch;
+	notch.init(rate, 60.0f, 400.0f, 3.0f);
+
+	for (unsigned i = 0; i < 8000; i++) {
+		float sample[3];
+		gyro_sample(i, rate, 150.0f, sample);
+		notch.apply(sample);
+	}
+
+	ASSERT_TRUE(notch.spectrum_updated());
+
+	float magnitude[math::DynamicNotch::MAX_BINS];
+	float start_freq, resolution, analysis_freq;
+	unsigned bins = notch.get_spectrum(magnitude, start_freq, resolution, analysis_freq);
+
+	EXPECT_FALSE(notch.spectrum_updated());
+	ASSERT_GT(bins, 0u);
+
+	// high rates are averaged down before the analysis
+	EXPECT_LT(analysis_freq, 1100.0f);
+	EXPECT_NEAR(analysis_freq / math::DynamicNotch::WINDOW, resolution, 1e-3f);
+
+	unsigned best = 0;
+
+	for (unsigned i = 0; i < bins; i++) {
+		if (magnitude[i] > magnitude[best]) {
+			best = i;
+		}
+	}
+
+	EXPECT_NEAR(150.0f, start_freq + best * resolution, resolution);
+}
+
+TEST(DynamicNotchTest, DISABLED_Benchmark)
+{
+	const float rates[] = {1000.0f, 8000.0f};
+
+	for (float rate : rates) {
+		math::DynamicNotch notch;
+		notch.init(rate, 60.0f, 400.0f, 3.0f);
+
+		static const unsigned count = 100000;
+		static float input[1000][3];
+
+		for (unsigned i = 0; i < 1000; i++) {
+			gyro_sample(i, rate, 180.0f, input[i]);
+		}
+
+		volatile float sink = 0.0f;
+		uint64_t start = now_ns();
+
+		for (unsigned i = 0; i < count; i++) {
+			float sample[3] = {input[i % 1000][0], input[i % 1000][1], input[i % 1000][2]};
+			notch.apply(sample);
+			sink = sample[0];
+		}
+
+		double ns_per_sample = (double)(now_ns() - start) / count;
+		printf("%.0f Hz: %.1f ns/sample, %.3f%% of one core\n", (double)rate, ns_per_sample,
+		       ns_per_sample * rate / 1e7);
+		(void)sink;
+	}
+}
@@ -0,0 +1,184 @@
+#include <math.h>
+#include <stdio.h>
+
+#include <mathlib/math/filter/FilterBank.hpp>
+#include <mathlib/math/filter/LowPassFilter2p.hpp>
+
+#include "gtest/gtest.h"
+#include "timing.h"
+
+static const unsigned CHANNELS = 6;
+
+// deterministic broadband input: a few tones plus a sawtooth
+static float test_input(unsigned i, unsigned ch)
+{
+	return 3.0f * sinf(0.01f * i + ch) + 0.5f * sinf(1.3f * i) + (float)((i * 7 + ch * 13) % 17) * 0.1f;
+}
+
+TEST(FilterBankTest, MatchesLowPassFilter2p)
+{
+	math::FilterBank<CHANNELS> bank;
+	bank.set_stage(0, math::BiquadCoefficients::lowpass2p(1000.0f, 30.0f));
+
+	math::LowPassFilter2p *lpf[CHANNELS];
+
+	for (unsigned ch = 0; ch < CHANNELS; ch++) {
+		lpf[ch] = new math::LowPassFilter2p(1000.0f, 30.0f);
+	}
+
+	for (unsigned i = 0; i < 5000; i++) {
+		float sample[CHANNELS];
+
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			sample[ch] = test_input(i, ch);
+		}
+
+		// a bad sample must not poison the state of either filter
+		if (i == 1000) {
+			sample[2] = NAN;
+			sample[5] = INFINITY;
+		}
+
+		float expected[CHANNELS];
+
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			expected[ch] = lpf[ch]->apply(sample[ch]);
+		}
+
+		bank.apply(sample);
+
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			if (isfinite(expected[ch])) {
+				ASSERT_NEAR(expected[ch], sample[ch], 1e-5f * (1.0f + fabsf(expected[ch]))) << "sample " << i << " channel " << ch;
+
+			} else {
+				ASSERT_FALSE(isfinite(sample[ch])) << "sample " << i << " channel " << ch;
+			}
+		}
+	}
+
+	for (unsigned ch = 0; ch < CHANNELS; ch++) {
+		delete lpf[ch];
+	}
+}
+
+TEST(FilterBankTest, BlockMatchesSingleSamples)
+{
+	math::FilterBank<CHANNELS, 2> single;
+	math::FilterBank<CHANNELS, 2> block;
+	single.set_stage(0, math::BiquadCoefficients::lowpass2p(8000.0f, 250.0f));
+	single.set_stage(1, math::BiquadCoefficients::notch(8000.0f, 120.0f, 40.0f));
+	block.set_stage(0, single.get_stage(0));
+	block.set_stage(1, single.get_stage(1));
+
+	static const unsigned count = 64;
+	float in[count * CHANNELS];
+	float out[count * CHANNELS];
+
+	for (unsigned i = 0; i < count; i++) {
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			in[i * CHANNELS + ch] = test_input(i, ch);
+		}
+	}
+
+	block.apply(in, out, count);
+
+	for (unsigned i = 0; i < count; i++) {
+		float sample[CHANNELS];
+		memcpy(sample, &in[i * CHANNELS], sizeof(sample));
+		single.apply(sample);
+
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			EXPECT_EQ(sample[ch], out[i * CHANNELS + ch]);
+		}
+	}
+}
+
+TEST(FilterBankTest, NotchRemovesCenterFrequency)
+{
+	const float fs = 1000.0f;
+	const float f0 = 50.0f;
+
+	math::FilterBank<1> notch;
+	notch.set_stage(0, math::BiquadCoefficients::notch(fs, f0, 10.0f));
+
+	float peak = 0.0f;
+
+	for (unsigned i = 0; i < 4000; i++) {
+		float sample = sinf(2.0f * M_PI_F * f0 * i / fs);
+		notch.apply(&sample);
+
+		// skip the transient
+		if (i > 2000) {
+			peak = fmaxf(peak, fabsf(sample));
+		}
+	}
+
+	EXPECT_LT(peak, 0.05f);
+}
+
+TEST(FilterBankTest, ResetSettlesToInput)
+{
+	math::FilterBank<CHANNELS, 2> bank;
+	bank.set_stage(0, math::BiquadCoefficients::lowpass2p(1000.0f, 30.0f));
+	bank.set_stage(1, math::BiquadCoefficients::lowpass2p(1000.0f, 80.0f));
+
+	float sample[CHANNELS] = {1.0f, -2.0f, 3.0f, 9.81f, 0.0f, -100.0f};
+	float value[CHANNELS];
+	memcpy(value, sample, sizeof(value));
+	bank.reset(value);
+
+	for (unsigned ch = 0; ch < CHANNELS; ch++) {
+		EXPECT_NEAR(sample[ch], value[ch], 1e-3f * (1.0f + fabsf(sample[ch])));
+	}
+}
+
+TEST(FilterBankTest, DISABLED_Benchmark)
+{
+	static const unsigned samples = 200000;
+
+	math::FilterBank<CHANNELS> bank;
+	bank.set_stage(0, math::BiquadCoefficients::lowpass2p(1000.0f, 30.0f));
+	math::LowPassFilter2p *lpf[CHANNELS];
+
+	for (unsigned ch = 0; ch < CHANNELS; ch++) {
+		lpf[ch] = new math::LowPassFilter2p(1000.0f, 30.0f);
+	}
+
+	volatile float sink = 0.0f;
+
+	uint64_t start = now_ns();
+
+	for (unsigned i = 0; i < samples; i++) {
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			sink = lpf[ch]->apply(test_input(i, ch));
+		}
+	}
+
+	uint64_t per_axis = now_ns() - start;
+
+	start = now_ns();
+
+	for (unsigned i = 0; i < samples; i++) {
+		float sample[CHANNELS];
+
+		for (unsigned ch = 0; ch < CHANNELS; ch++) {
+			sample[ch] = test_input(i, ch);
+		}
+
+		bank.apply(sample);
+		sink = sample[CHANNELS - 1];
+	}
+
+	uint64_t bank_ns = now_ns() - start;
+
+	// timing includes generating the input, only report it
+	printf("%u samples x %u channels: LowPassFilter2p %.1f ns/sample, FilterBank %.1f ns/sample\n",
+	       samples, CHANNELS, (double)per_axis / samples, (double)bank_ns / samples);
+
+	(void)sink;
+
+	for (unsigned ch = 0; ch < CHANNELS; ch++) {
+		delete lpf[ch];
+	}
+}
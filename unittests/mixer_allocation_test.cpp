@@ -0,0 +1,205 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <systemlib/mixer/mixer.h>
+
+#include "gtest/gtest.h"
+#include "timing.h"
+
+static const char *geometries[] = {"4x", "4+", "4h", "4v", "4w", "4dc", "6x", "6+", "6c", "8x", "8+", "8c", "2-", "3y"};
+
+static float controls[4];
+
+static int control_cb(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
+{
+	control = controls[control_index];
+	return 0;
+}
+
+template<typename M>
+static M *load(const char *prefix, const char *geometry)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%s %s 10000 10000 10000 0\n", prefix, geometry);
+	unsigned buflen = strlen(buf);
+	return M::from_text(control_cb, 0, buf, buflen);
+}
+
+static float rand_unit(unsigned &seed)
+{
+	seed = seed * 1103515245u + 12345u;
+	return (float)((seed >> 8) & 0xffff) / 65535.0f;
+}
+
+// roll and pitch actually produced by the outputs, least squares against the rotor table
+static void achieved_roll_pitch(const char *geometry, const float *outputs, unsigned n, float &roll, float &pitch)
+{
+	MultirotorGeometry geom;
+	unsigned count;
+	MultirotorMixer::geometry_from_name(geometry, geom);
+	const MultirotorMixer::Rotor *rotors = MultirotorMixer::get_rotors(geom, count);
+	float rr = 0.0f, rp = 0.0f, pp = 0.0f, ru = 0.0f, pu = 0.0f;
+
+	for (unsigned i = 0; i < n; i++) {
+		// back from [-1, 1] with zero idle speed to [0, 1]
+		float u = (outputs[i] + 1.0f) * 0.5f;
+		rr += rotors[i].roll_scale * rotors[i].roll_scale;
+		rp += rotors[i].roll_scale * rotors[i].pitch_scale;
+		pp += rotors[i].pitch_scale * rotors[i].pitch_scale;
+		ru += rotors[i].roll_scale * u;
+		pu += rotors[i].pitch_scale * u;
+	}
+
+	float det = rr * pp - rp * rp;
+
+	if (fabsf(det) < 1e-6f) {
+		// no pitch authority, e.g. the twin engine
+		roll = (rr > 0.0f) ? ru / rr : 0.0f;
+		pitch = 0.0f;
+		return;
+	}
+
+	roll = (pp * ru - rp * pu) / det;
+	pitch = (rr * pu - rp * ru) / det;
+}
+
+TEST(AllocationMixerTest, MatchesUnsaturated)
+{
+	for (const char *geometry : geometries) {
+		MultirotorMixer *reference = load<MultirotorMixer>("R:", geometry);
+		AllocationMixer *mixer = load<AllocationMixer>("A:", geometry);
+		ASSERT_TRUE(reference != nullptr) << geometry;
+		ASSERT_TRUE(mixer != nullptr) << geometry;
+
+		float a[8], b[8];
+		uint16_t status_a, status_b;
+		controls[0] = 0.05f;
+		controls[1] = -0.05f;
+		controls[2] = 0.05f;
+		controls[3] = 0.5f;
+
+		unsigned n = reference->mix(a, 8, &status_a);
+		ASSERT_EQ(n, mixer->mix(b, 8, &status_b)) << geometry;
+		EXPECT_EQ(0, status_b) << geometry;
+
+		for (unsigned i = 0; i < n; i++) {
+			EXPECT_NEAR(a[i], b[i], 0.05f) << geometry << " rotor " << i;
+		}
+
+		delete reference;
+		delete mixer;
+	}
+}
+
+TEST(AllocationMixerTest, SaturationQuality)
+{
+	// large random demands, compare how well roll and pitch are kept
+	for (const char *geometry : geometries) {
+		MultirotorMixer *reference = load<MultirotorMixer>("R:", geometry);
+		AllocationMixer *mixer = load<AllocationMixer>("A:", geometry);
+		ASSERT_TRUE(reference != nullptr && mixer != nullptr) << geometry;
+
+		unsigned seed = 42;
+		double error_reference = 0.0;
+		double error_allocation = 0.0;
+		static const unsigned samples = 2000;
+
+		for (unsigned k = 0; k < samples; k++) {
+			controls[0] = 0.6f * (2.0f * rand_unit(seed) - 1.0f);
+			controls[1] = 0.6f * (2.0f * rand_unit(seed) - 1.0f);
+			controls[2] = 2.0f * rand_unit(seed) - 1.0f;
+			controls[3] = 0.1f + 0.8f * rand_unit(seed);
+
+			float a[8], b[8];
+			unsigned n = reference->mix(a, 8, nullptr);
+			mixer->mix(b, 8, nullptr);
+
+			for (unsigned i = 0; i < n; i++) {
+				ASSERT_GE(b[i], -1.0f);
+				ASSERT_LE(b[i], 1.0f);
+			}
+
+			float roll, pitch;
+			achieved_roll_pitch(geometry, a, n, roll, pitch);
+			error_reference += hypotf(roll - controls[0], pitch - controls[1]);
+			achieved_roll_pitch(geometry, b, n, roll, pitch);
+			error_allocation += hypotf(roll - controls[0], pitch - controls[1]);
+		}
+
+		error_reference /= samples;
+		error_allocation /= samples;
+		printf("%-4s roll/pitch error: multirotor %.4f, allocation %.4f\n", geometry, error_reference, error_allocation);
+
+		// pitch of the 4v is the same column as thrust, so its outputs do not tell pitch from thrust
+		if (strcmp(geometry, "4v") != 0) {
+			EXPECT_LE(error_allocation, error_reference + 0.01) << geometry;
+		}
+
+		delete reference;
+		delete mixer;
+	}
+}
+
+TEST(AllocationMixerTest, DISABLED_Benchmark)
+{
+	static const unsigned count = 100000;
+	static float batch[64][4];
+	unsigned seed = 7;
+
+	// mostly hover with small corrections, every fourth demand saturates
+	for (unsigned k = 0; k < 64; k++) {
+		float amplitude = (k % 4 == 0) ? 1.0f : 0.1f;
+
+		for (unsigned c = 0; c < 3; c++) {
+			batch[k][c] = amplitude * (2.0f * rand_unit(seed) - 1.0f);
+		}
+
+		batch[k][3] = 0.3f + 0.4f * rand_unit(seed);
+	}
+
+	for (const char *geometry : geometries) {
+		MultirotorMixer *reference = load<MultirotorMixer>("R:", geometry);
+		AllocationMixer *mixer = load<AllocationMixer>("A:", geometry);
+		ASSERT_TRUE(reference != nullptr && mixer != nullptr) << geometry;
+
+		float outputs[64 * 8];
+		volatile float sink = 0.0f;
+
+		uint64_t start = now_ns();
+
+		for (unsigned k = 0; k < count; k++) {
+			memcpy(controls, batch[k % 64], sizeof(controls));
+			reference->mix(outputs, 8, nullptr);
+			sink = outputs[0];
+		}
+
+		double reference_ns = (double)(now_ns() - start) / count;
+
+		start = now_ns();
+
+		for (unsigned k = 0; k < count; k++) {
+			memcpy(controls, batch[k % 64], sizeof(controls));
+			mixer->mix(outputs, 8, nullptr);
+			sink = outputs[0];
+		}
+
+		double allocation_ns = (double)(now_ns() - start) / count;
+
+		start = now_ns();
+
+		for (unsigned k = 0; k < count; k += 64) {
+			mixer->mix_n(batch, outputs, 64);
+			sink = outputs[0];
+		}
+
+		double batch_ns = (double)(now_ns() - start) / count;
+
+		printf("%-4s multirotor %.1f ns, allocation %.1f ns, mix_n %.1f ns per mix\n",
+		       geometry, reference_ns, allocation_ns, batch_ns);
+		(void)sink;
+
+		delete reference;
+		delete mixer;
+	}
+}
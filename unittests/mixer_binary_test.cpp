@@ -0,0 +1,210 @@
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <systemlib/mixer/mixer.h>
+
+#include "gtest/gtest.h"
+#include "timing.h"
+
+// text mixers as shipped and the images generated from them at build time
+static const char *text_dir = "../ROMFS/px4fmu_common/mixers";
+static const char *binary_dir = MIXER_BINARY_DIR;
+
+static float controls[4][8];
+
+static int control_cb(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
+{
+	if (control_group >= 4 || control_index >= 8) {
+		return -1;
+	}
+
+	control = controls[control_group][control_index];
+	return 0;
+}
+
+static std::vector<std::string> mixer_files()
+{
+	std::vector<std::string> files;
+	DIR *dir = opendir(text_dir);
+
+	if (dir == nullptr) {
+		return files;
+	}
+
+	struct dirent *entry;
+
+	while ((entry = readdir(dir)) != nullptr) {
+		std::string name(entry->d_name);
+
+		if (name.size() > 4 && name.compare(name.size() - 4, 4, ".mix") == 0) {
+			files.push_back(name);
+		}
+	}
+
+	closedir(dir);
+	return files;
+}
+
+TEST(MixerBinaryTest, MatchesText)
+{
+	std::vector<std::string> files = mixer_files();
+	ASSERT_FALSE(files.empty());
+
+	for (const std::string &name : files) {
+		std::string text_path = std::string(text_dir) + "/" + name;
+		std::string binary_path = std::string(binary_dir) + "/" + name;
+		char text[2048];
+		char image[2048];
+
+		ASSERT_EQ(0, load_mixer_file(text_path.c_str(), text, sizeof(text))) << name;
+		int image_length = load_mixer_file(binary_path.c_str(), image, sizeof(image));
+		ASSERT_GT(image_length, 0) << name;
+		ASSERT_EQ((unsigned)image_length, MixerGroup::binary_length(image)) << name;
+
+		MixerGroup text_group(control_cb, 0);
+		MixerGroup binary_group(control_cb, 0);
+		unsigned buflen = strlen(text);
+		text_group.load_from_buf(text, buflen);
+
+		if (text_group.count() == 0) {
+			// e.g. a geometry that is not built in, the image has to be rejected as well
+			buflen = image_length;
+			EXPECT_NE(0, binary_group.load_from_bin(image, buflen)) << name;
+			EXPECT_EQ(0u, binary_group.count()) << name;
+			continue;
+		}
+
+		buflen = image_length;
+		EXPECT_EQ(0, binary_group.load_from_bin(image, buflen)) << name;
+		EXPECT_EQ(0u, buflen) << name;
+		ASSERT_EQ(text_group.count(), binary_group.count()) << name;
+
+		// both groups have to produce the same outputs
+		unsigned seed = 3;
+
+		for (unsigned k = 0; k < 50; k++) {
+			for (unsigned g = 0; g < 4; g++) {
+				for (unsigned i = 0; i < 8; i++) {
+					seed = seed * 1103515245u + 12345u;
+					controls[g][i] = (float)((seed >> 8) & 0xffff) / 32767.5f - 1.0f;
+				}
+			}
+
+			float a[16], b[16];
+			uint16_t status_a = 0, status_b = 0;
+			unsigned n = text_group.mix(a, 16, &status_a);
+			ASSERT_EQ(n, binary_group.mix(b, 16, &status_b)) << name;
+			EXPECT_EQ(status_a, status_b) << name;
+
+			for (unsigned i = 0; i < n; i++) {
+				EXPECT_NEAR(a[i], b[i], 1e-5f) << name << " output " << i;
+			}
+		}
+	}
+}
+
+TEST(MixerBinaryTest, DISABLED_Benchmark)
+{
+	std::vector<std::string> files = mixer_files();
+	ASSERT_FALSE(files.empty());
+
+	static const unsigned loads = 200;
+	uint64_t text_total = 0;
+	uint64_t binary_total = 0;
+
+	for (const std::string &name : files) {
+		std::string text_path = std::string(text_dir) + "/" + name;
+		std::string binary_path = std::string(binary_dir) + "/" + name;
+		char text[2048];
+		char image[2048];
+
+		ASSERT_EQ(0, load_mixer_file(text_path.c_str(), text, sizeof(text))) << name;
+		int image_length = load_mixer_file(binary_path.c_str(), image, sizeof(image));
+		ASSERT_GT(image_length, 0) << name;
+
+		MixerGroup text_group(control_cb, 0);
+		MixerGroup binary_group(control_cb, 0);
+		unsigned buflen = strlen(text);
+		text_group.load_from_buf(text, buflen);
+
+		if (text_group.count() == 0) {
+			continue;
+		}
+
+		uint64_t text_ns = 0;
+		uint64_t binary_ns = 0;
+
+		for (unsigned k = 0; k < loads; k++) {
+			text_group.reset();
+			buflen = strlen(text);
+			uint64_t start = now_ns();
+			text_group.load_from_buf(text, buflen);
+			text_ns += now_ns() - start;
+
+			binary_group.reset();
+			buflen = image_length;
+			start = now_ns();
+			binary_group.load_from_bin(image, buflen);
+			binary_ns += now_ns() - start;
+		}
+
+		text_total += text_ns;
+		binary_total += binary_ns;
+		printf("%-24s %2u mixers, text %6.2f us, binary %5.2f us\n", name.c_str(), text_group.count(),
+		       text_ns / 1000.0 / loads, binary_ns / 1000.0 / loads);
+	}
+
+	printf("all %u mixer files: text %.1f us, binary %.1f us\n", (unsigned)files.size(),
+	       text_total / 1000.0 / loads, binary_total / 1000.0 / loads);
+}
+
+TEST(MixerBinaryTest, Chunked)
+{
+	// deliver the image in small pieces like the PX4IO mixer upload
+	std::string binary_path = std::string(binary_dir) + "/octo_cox.main.mix";
+	char image[2048];
+	int image_length = load_mixer_file(binary_path.c_str(), image, sizeof(image));
+	ASSERT_GT(image_length, 0);
+
+	MixerGroup group(control_cb, 0);
+	char buffer[200];
+	unsigned buffered = 0;
+
+	for (int sent = 0; sent < image_length; sent += 7) {
+		unsigned count = (image_length - sent > 7) ? 7 : image_length - sent;
+		memcpy(&buffer[buffered], &image[sent], count);
+		buffered += count;
+
+		unsigned resid = buffered;
+		group.load_from_bin(buffer, resid);
+		memmove(&buffer[0], &buffer[buffered - resid], resid);
+		buffered = resid;
+	}
+
+	EXPECT_EQ(0u, buffered);
+	EXPECT_EQ(1u, group.count());
+}
+
+TEST(MixerBinaryTest, RejectsBadImage)
+{
+	MixerGroup group(control_cb, 0);
+	uint8_t image[] = {0xa5, 0x4d, 0x7f, 1, 2, 0, 'Z', 0};
+	unsigned buflen = sizeof(image);
+
+	// unknown version
+	EXPECT_EQ(0u, MixerGroup::binary_length(image));
+	EXPECT_NE(0, group.load_from_bin(image, buflen));
+	EXPECT_EQ(0u, group.count());
+
+	// unknown record type
+	image[2] = MIXER_BINARY_VERSION;
+	image[6] = 'Q';
+	buflen = sizeof(image);
+	EXPECT_NE(0, group.load_from_bin(image, buflen));
+	EXPECT_EQ(0u, group.count());
+}
@@ -152,3 +152,44 @@ TEST(ParamTest, ResetAllExcludesWildcard)
 	_assert_parameter_int_value((param_t)2, 50);
 	_assert_parameter_int_value((param_t)3, 50);
 }
+
+TEST(ParamTest, ChangedSinceGeneration)
+{
+	_add_parameters();
+	param_reset_all();
+
+	uint32_t generation = param_generation();
+
+	int32_t value = 42;
+	param_set((param_t)1, &value);
+
+	ASSERT_FALSE(param_changed_since((param_t)0, generation));
+	ASSERT_TRUE(param_changed_since((param_t)1, generation));
+
+	/* setting the same value again is not a change */
+	generation = param_generation();
+	param_set((param_t)1, &value);
+
+	ASSERT_FALSE(param_changed_since((param_t)1, generation));
+
+	/* a reset marks all parameters as changed */
+	param_reset((param_t)1);
+
+	ASSERT_TRUE(param_changed_since((param_t)0, generation));
+	ASSERT_TRUE(param_changed_since((param_t)3, generation));
+}
+
+TEST(ParamTest, ChangedSinceGenerationToZero)
+{
+	_add_parameters();
+	param_reset_all();
+
+	uint32_t generation = param_generation();
+
+	/* the default of TEST_2 is 4, so setting it to 0 is a change */
+	int32_t value = 0;
+	param_set((param_t)1, &value);
+
+	ASSERT_TRUE(param_changed_since((param_t)1, generation));
+	_assert_parameter_int_value((param_t)1, 0);
+}
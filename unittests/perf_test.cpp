@@ -0,0 +1,61 @@
+#include <systemlib/perf_counter.h>
+
+#include "gtest/gtest.h"
+
+TEST(PerfTest, HistogramPercentiles)
+{
+	perf_counter_t hist = perf_alloc(PC_HISTOGRAM, "test_hist");
+	ASSERT_NE(nullptr, hist);
+
+	for (int64_t i = 1; i <= 100; i++) {
+		perf_set_elapsed(hist, i);
+	}
+
+	perf_set_elapsed(hist, -1);
+
+	EXPECT_EQ(100u, perf_event_count(hist));
+
+	// buckets are 25% wide, percentiles report the bucket upper bound
+	uint64_t p50 = perf_percentile(hist, 50);
+	EXPECT_GE(p50, 50u);
+	EXPECT_LE(p50, 63u);
+
+	// never above the largest recorded value
+	EXPECT_EQ(100u, perf_percentile(hist, 99));
+	EXPECT_EQ(100u, perf_percentile(hist, 100));
+
+	perf_free(hist);
+}
+
+TEST(PerfTest, AllocOnceReturnsExisting)
+{
+	perf_counter_t count = perf_alloc_once(PC_COUNT, "test_once");
+	ASSERT_NE(nullptr, count);
+	EXPECT_EQ(count, perf_alloc_once(PC_COUNT, "test_once"));
+	EXPECT_EQ(nullptr, perf_alloc_once(PC_ELAPSED, "test_once"));
+	perf_free(count);
+}
+
+TEST(PerfTest, ResetAll)
+{
+	perf_counter_t count = perf_alloc(PC_COUNT, "test_reset");
+	perf_counter_t hist = perf_alloc(PC_HISTOGRAM, "test_reset_hist");
+
+	for (int i = 0; i < 5; i++) {
+		perf_count(count);
+		perf_set_elapsed(hist, 10);
+	}
+
+	perf_reset_all();
+
+	// counters read as reset before they are updated again
+	EXPECT_EQ(0u, perf_event_count(count));
+	EXPECT_EQ(0u, perf_event_count(hist));
+	EXPECT_EQ(0u, perf_percentile(hist, 50));
+
+	perf_count(count);
+	EXPECT_EQ(1u, perf_event_count(count));
+
+	perf_free(count);
+	perf_free(hist);
+}
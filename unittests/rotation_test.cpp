@@ -0,0 +1,111 @@
+#include <stdio.h>
+
+#include <conversion/rotation.h>
+
+#include "gtest/gtest.h"
+#include "timing.h"
+
+TEST(RotationTest, MatrixMatchesSwitch)
+{
+	for (int r = 0; r < ROTATION_MAX; r++) {
+		enum Rotation rot = (enum Rotation)r;
+		RotationMatrix matrix(rot);
+
+		float x = 0.3f, y = -1.7f, z = 9.81f;
+		float mx = x, my = y, mz = z;
+		rotate_3f(rot, x, y, z);
+		matrix.rotate(mx, my, mz);
+
+		EXPECT_FLOAT_EQ(x, mx) << "rotation " << r;
+		EXPECT_FLOAT_EQ(y, my) << "rotation " << r;
+		EXPECT_FLOAT_EQ(z, mz) << "rotation " << r;
+
+		float batch[4][3];
+
+		for (unsigned k = 0; k < 4; k++) {
+			batch[k][0] = 0.3f;
+			batch[k][1] = -1.7f;
+			batch[k][2] = 9.81f;
+		}
+
+		matrix.rotate_n(&batch[0][0], 4);
+
+		for (unsigned k = 0; k < 4; k++) {
+			EXPECT_FLOAT_EQ(x, batch[k][0]) << "rotation " << r;
+			EXPECT_FLOAT_EQ(y, batch[k][1]) << "rotation " << r;
+			EXPECT_FLOAT_EQ(z, batch[k][2]) << "rotation " << r;
+		}
+	}
+}
+
+TEST(RotationTest, Template)
+{
+	float x = 1.0f, y = 2.0f, z = 3.0f;
+	rotate_3f<ROTATION_YAW_90>(x, y, z);
+	EXPECT_FLOAT_EQ(-2.0f, x);
+	EXPECT_FLOAT_EQ(1.0f, y);
+	EXPECT_FLOAT_EQ(3.0f, z);
+
+	x = 1.0f; y = 2.0f; z = 3.0f;
+	rotate_3f<ROTATION_ROLL_180_YAW_45>(x, y, z);
+	float rx = 1.0f, ry = 2.0f, rz = 3.0f;
+	rotate_3f(ROTATION_ROLL_180_YAW_45, rx, ry, rz);
+	EXPECT_FLOAT_EQ(rx, x);
+	EXPECT_FLOAT_EQ(ry, y);
+	EXPECT_FLOAT_EQ(rz, z);
+}
+
+TEST(RotationTest, DISABLED_Benchmark)
+{
+	static const unsigned count = 1000000;
+	static const unsigned batch = 16;
+	static float samples[batch][3];
+	// the rotation is only known at runtime, as in the drivers
+	volatile int runtime_rot = ROTATION_ROLL_180_YAW_90;
+	enum Rotation rot = (enum Rotation)runtime_rot;
+
+	for (unsigned k = 0; k < batch; k++) {
+		samples[k][0] = k;
+		samples[k][1] = 2.0f * k;
+		samples[k][2] = 3.0f * k;
+	}
+
+	uint64_t start = now_ns();
+
+	for (unsigned i = 0; i < count; i++) {
+		float *s = samples[i % batch];
+		rotate_3f(rot, s[0], s[1], s[2]);
+	}
+
+	double switch_ns = (double)(now_ns() - start) / count;
+
+	RotationMatrix matrix(rot);
+	start = now_ns();
+
+	for (unsigned i = 0; i < count; i++) {
+		float *s = samples[i % batch];
+		matrix.rotate(s[0], s[1], s[2]);
+	}
+
+	double matrix_ns = (double)(now_ns() - start) / count;
+
+	start = now_ns();
+
+	for (unsigned i = 0; i < count; i += batch) {
+		matrix.rotate_n(&samples[0][0], batch);
+	}
+
+	double batch_ns = (double)(now_ns() - start) / count;
+
+	start = now_ns();
+
+	for (unsigned i = 0; i < count; i++) {
+		float *s = samples[i % batch];
+		rotate_3f<ROTATION_ROLL_180_YAW_90>(s[0], s[1], s[2]);
+	}
+
+	double template_ns = (double)(now_ns() - start) / count;
+
+	printf("switch: %.2f ns, matrix: %.2f ns, rotate_n: %.2f ns, template: %.2f ns per sample\n",
+	       switch_ns, matrix_ns, batch_ns, template_ns);
+}
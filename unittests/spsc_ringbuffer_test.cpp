@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <drivers/device/ringbuffer.h>
+#include <drivers/device/spsc_ringbuffer.h>
+
+#include "gtest/gtest.h"
+#include "timing.h"
+
+// roughly the size of a sensor report, the check field detects torn copies
+struct Item {
+	uint32_t seq;
+	uint32_t payload[10];
+	uint32_t check;
+};
+
+static Item make_item(uint32_t seq)
+{
+	Item item;
+	item.seq = seq;
+
+	for (unsigned i = 0; i < 10; i++) {
+		item.payload[i] = seq * 31 + i;
+	}
+
+	item.check = ~seq;
+	return item;
+}
+
+static bool item_valid(const Item &item)
+{
+	for (unsigned i = 0; i < 10; i++) {
+		if (item.payload[i] != item.seq * 31 + i) {
+			return false;
+		}
+	}
+
+	return item.check == ~item.seq;
+}
+
+TEST(SPSCRingBufferTest, PutGetWrap)
+{
+	// capacity is kept exactly even though the storage is rounded up
+	ringbuffer::SPSCRingBuffer buffer(3, sizeof(Item));
+	ASSERT_EQ(3u, buffer.size());
+	EXPECT_TRUE(buffer.empty());
+
+	uint32_t next_put = 0;
+	uint32_t next_get = 0;
+
+	for (unsigned round = 0; round < 10; round++) {
+		while (!buffer.full()) {
+			Item item = make_item(next_put++);
+			ASSERT_TRUE(buffer.put(&item));
+		}
+
+		Item item = make_item(next_put);
+		EXPECT_FALSE(buffer.put(&item));
+		EXPECT_EQ(0u, buffer.space());
+
+		for (unsigned i = 0; i < 2; i++) {
+			ASSERT_TRUE(buffer.get(&item));
+			EXPECT_EQ(next_get++, item.seq);
+		}
+	}
+
+	EXPECT_EQ(1u, buffer.count());
+	buffer.flush();
+	EXPECT_TRUE(buffer.empty());
+}
+
+TEST(SPSCRingBufferTest, ForceDropsOldest)
+{
+	ringbuffer::SPSCRingBuffer buffer(2, sizeof(Item));
+
+	for (uint32_t seq = 0; seq < 5; seq++) {
+		Item item = make_item(seq);
+		EXPECT_EQ(seq >= 2, buffer.force(&item));
+	}
+
+	Item items[4];
+	ASSERT_EQ(2u, buffer.get_n(items, 4));
+	EXPECT_EQ(3u, items[0].seq);
+	EXPECT_EQ(4u, items[1].seq);
+}
+
+TEST(SPSCRingBufferTest, BulkAcrossWrap)
+{
+	ringbuffer::SPSCRingBuffer buffer(10, sizeof(Item));
+	Item in[7];
+	Item out[7];
+	uint32_t next_put = 0;
+	uint32_t next_get = 0;
+
+	for (unsigned round = 0; round < 20; round++) {
+		for (unsigned i = 0; i < 7; i++) {
+			in[i] = make_item(next_put + i);
+		}
+
+		unsigned put = buffer.put_n(in, 7);
+		next_put += put;
+		EXPECT_EQ(7u, put);
+
+		unsigned got = buffer.get_n(out, 7);
+		ASSERT_EQ(7u, got);
+
+		for (unsigned i = 0; i < got; i++) {
+			EXPECT_EQ(next_get++, out[i].seq);
+			EXPECT_TRUE(item_valid(out[i]));
+		}
+	}
+
+	// a full buffer only accepts what fits
+	for (unsigned i = 0; i < 7; i++) {
+		in[i] = make_item(next_put + i);
+	}
+
+	EXPECT_EQ(7u, buffer.put_n(in, 7));
+	EXPECT_EQ(3u, buffer.put_n(in, 7));
+}
+
+struct Concurrent {
+	ringbuffer::SPSCRingBuffer *buffer;
+	uint32_t count;
+	volatile bool done;
+};
+
+static void *force_producer(void *arg)
+{
+	Concurrent *c = static_cast<Concurrent *>(arg);
+
+	for (uint32_t seq = 0; seq < c->count; seq++) {
+		Item item = make_item(seq);
+		c->buffer->force(&item);
+
+		// bursts of a few samples, like a FIFO drained by the interrupt
+		if (seq % 4 == 3) {
+			sched_yield();
+		}
+	}
+
+	c->done = true;
+	return nullptr;
+}
+
+TEST(SPSCRingBufferTest, ConcurrentForce)
+{
+	// the producer overwrites while the consumer copies, like a sensor
+	// interrupt running into a slow reader
+	ringbuffer::SPSCRingBuffer buffer(4, sizeof(Item));
+	Concurrent c = {&buffer, 200000, false};
+
+	pthread_t producer;
+	ASSERT_EQ(0, pthread_create(&producer, nullptr, force_producer, &c));
+
+	Item items[3];
+	int64_t last = -1;
+	unsigned received = 0;
+	bool ordered = true;
+	bool valid = true;
+
+	while (!c.done || !buffer.empty()) {
+		unsigned got = buffer.get_n(items, 3);
+
+		for (unsigned i = 0; i < got; i++) {
+			valid = valid && item_valid(items[i]);
+			ordered = ordered && (int64_t)items[i].seq > last;
+			last = items[i].seq;
+		}
+
+		received += got;
+	}
+
+	pthread_join(producer, nullptr);
+
+	EXPECT_TRUE(valid);
+	EXPECT_TRUE(ordered);
+	EXPECT_EQ(c.count - 1, (uint32_t)last);
+	EXPECT_GT(received, 0u);
+	printf("received %u of %u items\n", received, c.count);
+}
+
+TEST(SPSCRingBufferTest, DISABLED_Benchmark)
+{
+	static const unsigned count = 1000000;
+	static const unsigned batch = 8;
+	Item items[batch];
+
+	for (unsigned i = 0; i < batch; i++) {
+		items[i] = make_item(i);
+	}
+
+	ringbuffer::RingBuffer ring(batch, sizeof(Item));
+	uint64_t start = now_ns();
+
+	for (unsigned i = 0; i < count; i += batch) {
+		for (unsigned j = 0; j < batch; j++) {
+			ring.force(&items[j]);
+		}
+
+		for (unsigned j = 0; j < batch; j++) {
+			ring.get(&items[j]);
+		}
+	}
+
+	double ring_ns = (double)(now_ns() - start) / count;
+
+	ringbuffer::SPSCRingBuffer spsc(batch, sizeof(Item));
+	start = now_ns();
+
+	for (unsigned i = 0; i < count; i += batch) {
+		for (unsigned j = 0; j < batch; j++) {
+			spsc.force(&items[j]);
+		}
+
+		for (unsigned j = 0; j < batch; j++) {
+			spsc.get(&items[j]);
+		}
+	}
+
+	double spsc_ns = (double)(now_ns() - start) / count;
+
+	start = now_ns();
+
+	for (unsigned i = 0; i < count; i += batch) {
+		spsc.put_n(items, batch);
+		spsc.get_n(items, batch);
+	}
+
+	double bulk_ns = (double)(now_ns() - start) / count;
+
+	printf("RingBuffer: %.1f ns/item, SPSCRingBuffer: %.1f ns/item, bulk: %.1f ns/item\n",
+	       ring_ns, spsc_ns, bulk_ns);
+	EXPECT_TRUE(item_valid(items[0]));
+}
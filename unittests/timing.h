@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Helpers for the timing tests.
+ *
+ * Benchmarks only print their numbers, so they are registered as
+ * DISABLED_Benchmark and kept out of the regular run. Run them with
+ * --gtest_also_run_disabled_tests.
+ */
+
+// monotonic time in ns
+static inline uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}